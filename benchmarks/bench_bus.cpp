@@ -0,0 +1,412 @@
+/**
+ * @file bench_bus.cpp
+ * @author Maxime Verreault
+ * @date 2026-10-19
+ * @copyright COPYRIGHT(c) Maxime Verreault All rights reserved.
+ * @brief Bus occupancy of the frames written through the HTH flag variants of Can_XLdriver_Write
+ * @details The controllers are opened by Can_XLdriver_Init on the simulated driver, all polled so
+ *          no RX thread competes for the XL queue. The frames received by the second controller are
+ *          read back and their bus time summed at 500 kbit/s and 2 Mbit/s, stuff bits excluded.
+ *          The bursts of a stalled reader check the receive queue sized from the bus load, the
+ *          writes at full TX load the cost of the TX timeouts. The wait modes of the RX thread are
+ *          compared on controllers processed by interrupt, at paced bus loads.
+ * @ingroup Benchmarks
+ * @addtogroup bench_bus
+ * @{
+ */
+
+
+/*==================================================================================================
+*                                        INCLUDE FILES
+* 1) system and project includes
+* 2) needed interfaces from external units
+* 3) internal and external interfaces from this unit
+==================================================================================================*/
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstring>
+#include <numeric>
+#include <thread>
+#include <vector>
+#include <benchmark/benchmark.h>
+#include "Can_XLdriver.h"
+#include "xldriver.h"
+#include "xlframe.h"
+#include "bench_canif.h"
+
+
+/*==================================================================================================
+*                                       LOCAL CONSTANTS
+==================================================================================================*/
+namespace
+{
+constexpr uint32 BusBitRate = 500000;
+constexpr uint32 BusDataBitRate = 2000000;
+constexpr std::array<Can_XLdriver_BaudrateConfigType, 1> BusBaudrates{{{BusBitRate, BusDataBitRate, 0, 0}}};
+
+/** @brief One HTH per variant: bitrate switch and minimal DLC, each on and off, then one per identifier type */
+constexpr std::array<Can_XLdriver_HthConfigType, 7> BusHths{{
+    {0, CAN_XLDRIVER_ID_MIXED, 1, 0, 0, 1, 0x55},
+    {0, CAN_XLDRIVER_ID_MIXED, 0, 0, 0, 1, 0x55},
+    {0, CAN_XLDRIVER_ID_MIXED, 1, 0, 0, 0, 0x55},
+    {0, CAN_XLDRIVER_ID_MIXED, 0, 0, 0, 0, 0x55},
+    {0, CAN_XLDRIVER_ID_STANDARD, 1, 0, 0, 1, 0x55},
+    {0, CAN_XLDRIVER_ID_EXTENDED, 1, 0, 0, 1, 0x55},
+    {0, CAN_XLDRIVER_ID_MIXED, 1, 0, 0, 1, 0x55},
+}};
+
+/** @brief Standard classic, standard FD, extended classic and extended FD, on their HTHs */
+constexpr std::array<Can_IdType, 4> FrameKindIds{0x123, 0x40000123, 0x80012345, 0xC0012345};
+constexpr std::array<std::array<Can_HwHandleType, 4>, 2> FrameKindHths{{{4, 4, 5, 5}, {6, 6, 6, 6}}};
+
+constexpr std::array<Can_XLdriver_ControllerConfigType, 2> BusControllers{{
+    {0, nullptr, nullptr, nullptr, 0, 0, BusBaudrates.data(), 1, 0, CAN_XLDRIVER_POLLING, CAN_XLDRIVER_POLLING, CAN_XLDRIVER_POLLING, CAN_XLDRIVER_POLLING,
+     nullptr, 0, 0, 0},
+    {1, nullptr, nullptr, nullptr, 0, 0, BusBaudrates.data(), 1, 0, CAN_XLDRIVER_POLLING, CAN_XLDRIVER_POLLING, CAN_XLDRIVER_POLLING, CAN_XLDRIVER_POLLING,
+     nullptr, 0, 0, 0},
+}};
+
+constexpr Can_XLdriver_ConfigType BusConfig{BusControllers.data(), BusHths.data(), nullptr, "xlCANbench", 0, 0,
+                                            static_cast<uint8>(BusControllers.size()), static_cast<uint16>(BusHths.size()), 0, 256, nullptr, nullptr};
+
+/** @brief BusControllers, the first one waits at most 100 ms for each transmit confirmation */
+constexpr std::array<Can_XLdriver_ControllerConfigType, 2> SupervisedControllers{{
+    {0, nullptr, nullptr, nullptr, 0, 0, BusBaudrates.data(), 1, 0, CAN_XLDRIVER_POLLING, CAN_XLDRIVER_POLLING, CAN_XLDRIVER_POLLING, CAN_XLDRIVER_POLLING,
+     nullptr, 0, 100000, CAN_XLDRIVER_TX_TIMEOUT_NOTIFY},
+    BusControllers[1],
+}};
+
+constexpr Can_XLdriver_ConfigType SupervisedConfig{SupervisedControllers.data(), BusHths.data(), nullptr, "xlCANbench", 0, 0,
+                                                   static_cast<uint8>(SupervisedControllers.size()), static_cast<uint16>(BusHths.size()), 0, 256,
+                                                   nullptr, nullptr};
+
+/** @brief BusControllers processed by interrupt, indicated by the RX thread */
+constexpr std::array<Can_XLdriver_ControllerConfigType, 2> InterruptControllers{{
+    {0, nullptr, nullptr, nullptr, 0, 0, BusBaudrates.data(), 1, 0, CAN_XLDRIVER_INTERRUPT, CAN_XLDRIVER_INTERRUPT, CAN_XLDRIVER_INTERRUPT, CAN_XLDRIVER_INTERRUPT,
+     nullptr, 0, 0, 0},
+    {1, nullptr, nullptr, nullptr, 0, 0, BusBaudrates.data(), 1, 0, CAN_XLDRIVER_INTERRUPT, CAN_XLDRIVER_INTERRUPT, CAN_XLDRIVER_INTERRUPT, CAN_XLDRIVER_INTERRUPT,
+     nullptr, 0, 0, 0},
+}};
+
+/** @brief One configuration per RxWaitMode, so openBus restarts the RX thread with the next mode */
+constexpr std::array<Can_XLdriver_ConfigType, 3> WaitModeConfigs{{
+    {InterruptControllers.data(), BusHths.data(), nullptr, "xlCANbench", 0, 0,
+     static_cast<uint8>(InterruptControllers.size()), static_cast<uint16>(BusHths.size()), 0, 256, nullptr, nullptr},
+    {InterruptControllers.data(), BusHths.data(), nullptr, "xlCANbench", 0, 0,
+     static_cast<uint8>(InterruptControllers.size()), static_cast<uint16>(BusHths.size()), 0, 256, nullptr, nullptr},
+    {InterruptControllers.data(), BusHths.data(), nullptr, "xlCANbench", 0, 0,
+     static_cast<uint8>(InterruptControllers.size()), static_cast<uint16>(BusHths.size()), 0, 256, nullptr, nullptr},
+}};
+
+/** @brief Bus loads of our networks */
+constexpr std::array<uint8, 3> BurstBusLoads{30, 60, 80};
+
+/** @brief BusConfig with the XL receive queue sized for each of BurstBusLoads */
+constexpr std::array<Can_XLdriver_ConfigType, 3> BurstConfigs{{
+    {BusControllers.data(), BusHths.data(), nullptr, "xlCANbench", 0, BurstBusLoads[0],
+     static_cast<uint8>(BusControllers.size()), static_cast<uint16>(BusHths.size()), 0, 256, nullptr, nullptr},
+    {BusControllers.data(), BusHths.data(), nullptr, "xlCANbench", 0, BurstBusLoads[1],
+     static_cast<uint8>(BusControllers.size()), static_cast<uint16>(BusHths.size()), 0, 256, nullptr, nullptr},
+    {BusControllers.data(), BusHths.data(), nullptr, "xlCANbench", 0, BurstBusLoads[2],
+     static_cast<uint8>(BusControllers.size()), static_cast<uint16>(BusHths.size()), 0, 256, nullptr, nullptr},
+}};
+
+
+/*==================================================================================================
+*                                       LOCAL FUNCTIONS
+==================================================================================================*/
+/** @brief Open and start both controllers with a configuration, the driver is reopened when it changes */
+bool openBus(const Can_XLdriver_ConfigType& config = BusConfig)
+{
+    static const Can_XLdriver_ConfigType* opened = nullptr;
+    if(opened == &config)
+    {
+        return true;
+    }
+    if(opened != nullptr)
+    {
+        Can_XLdriver_SetControllerMode(0, CAN_CS_STOPPED);
+        Can_XLdriver_SetControllerMode(1, CAN_CS_STOPPED);
+        Can_XLdriver_DeInit();
+    }
+    g_silent = 1;
+    Can_XLdriver_Init(&config);
+    const auto started = Can_XLdriver_SetControllerMode(0, CAN_CS_STARTED) == E_OK && Can_XLdriver_SetControllerMode(1, CAN_CS_STARTED) == E_OK;
+    opened = started ? &config : nullptr;
+    return started;
+}
+
+/** @brief Run the main functions until the XL receive queue is empty */
+void drainMainFunctions()
+{
+    int level = 0;
+    do
+    {
+        Can_XLdriver_MainFunction_Write();
+        Can_XLdriver_MainFunction_Read();
+    } while(xlGetReceiveQueueLevel(g_xlPortHandle, &level) == XL_SUCCESS && level > 0);
+    Can_XLdriver_MainFunction_Write();
+    Can_XLdriver_MainFunction_Read();
+}
+
+/** @brief Bus time (ns) of the frames received by the second controller, the rest of the queue is dropped */
+uint64 drainBusTime(uint64& frames)
+{
+    XLcanRxEvent event;
+    uint64 busTime = 0;
+    while(xlCanReceive(g_xlPortHandle, &event) == XL_SUCCESS)
+    {
+        if(event.tag != XL_CAN_EV_TAG_RX_OK || event.channelIndex != BusControllers[1].ChannelIndex)
+        {
+            continue;
+        }
+        const auto& msg = event.tagData.canRxOkMsg;
+        busTime += frameBits((msg.canId & XL_CAN_EXT_MSG_ID) != 0, (msg.msgFlags & XL_CAN_RXMSG_FLAG_EDL) != 0,
+                             (msg.msgFlags & XL_CAN_RXMSG_FLAG_BRS) != 0, (msg.msgFlags & XL_CAN_RXMSG_FLAG_RTR) != 0,
+                             msg.dlc).durationNs(BusBitRate, BusDataBitRate);
+        ++frames;
+    }
+    return busTime;
+}
+
+/**
+ * @brief CAN FD PDUs written on one HTH variant, the arguments are the HTH and the SDU length
+ * @details bus_us is the mean bus time of one frame, payload_kbps the PDU throughput the bus would
+ *          carry at 100 % load with these frames.
+ */
+void busOccupancy(benchmark::State& state)
+{
+    if(!openBus())
+    {
+        state.SkipWithError("simulated driver not available");
+        return;
+    }
+    std::array<uint8, 64> data{};
+    std::iota(data.begin(), data.end(), uint8{1});
+    const auto hth = static_cast<Can_HwHandleType>(state.range(0));
+    const auto length = static_cast<uint8>(state.range(1));
+    const Can_PduType pduInfo{0x123 | 0x40000000, 0, length, data.data()};
+    uint64 busTime = 0;
+    uint64 frames = 0;
+    uint32 count = 0;
+
+    drainBusTime(frames);
+    frames = 0;
+    for(auto _ : state)
+    {
+        benchmark::DoNotOptimize(Can_XLdriver_Write(hth, &pduInfo));
+        if((++count & 0x1F) == 0)
+        {
+            busTime += drainBusTime(frames);
+        }
+    }
+    busTime += drainBusTime(frames);
+    state.SetItemsProcessed(static_cast<int64_t>(state.iterations()));
+    const auto busUs = frames != 0 ? static_cast<double>(busTime) / static_cast<double>(frames) / 1000.0 : 0.0;
+    state.counters["bus_us"] = busUs;
+    state.counters["payload_kbps"] = busUs > 0.0 ? 8.0 * length / busUs * 1000.0 : 0.0;
+}
+BENCHMARK(busOccupancy)->ArgsProduct({{0, 1, 2, 3}, {8, 20, 64}})->ArgNames({"hth", "length"});
+
+/**
+ * @brief Can_XLdriver_Write of the four frame kinds in turn, so the branch predictor cannot learn one
+ * @details The argument selects the HTHs: 0 one per identifier type, 1 a single MIXED one. The
+ *          controller is stopped so the simulated driver refuses the frames right after its lock,
+ *          what is left is the cost of the write path itself.
+ */
+void writeFrameKinds(benchmark::State& state)
+{
+    if(!openBus() || Can_XLdriver_SetControllerMode(0, CAN_CS_STOPPED) != E_OK)
+    {
+        state.SkipWithError("simulated driver not available");
+        return;
+    }
+    std::array<uint8, 64> data{};
+    std::iota(data.begin(), data.end(), uint8{1});
+    const auto& hths = FrameKindHths[static_cast<std::size_t>(state.range(0))];
+    std::array<Can_PduType, 4> pdus{};
+    for(std::size_t kind = 0; kind < pdus.size(); ++kind)
+    {
+        pdus[kind] = Can_PduType{FrameKindIds[kind], 0, 8, data.data()};
+    }
+    std::size_t i = 0;
+
+    for(auto _ : state)
+    {
+        const auto kind = i++ & 3;
+        benchmark::DoNotOptimize(Can_XLdriver_Write(hths[kind], &pdus[kind]));
+    }
+    state.SetItemsProcessed(static_cast<int64_t>(state.iterations()));
+    Can_XLdriver_SetControllerMode(0, CAN_CS_STARTED);
+}
+BENCHMARK(writeFrameKinds)->Arg(0)->Arg(1)->ArgName("mixed");
+
+/**
+ * @brief Burst of the frames a bus carries during RX_QUEUE_STALL_MS, read once the burst is over
+ * @details The arguments are the bus load (%) and the queue: 0 the default size, 1 sized for the
+ *          load. The frames are the shortest ones, the most events per second of bus time. lost
+ *          counts the frames never indicated to CanIf, overflows the events flagged by the driver
+ *          and polling_drops the events dropped by the polling queues.
+ */
+void rxBurst(benchmark::State& state)
+{
+    const auto busLoad = static_cast<uint32>(state.range(0));
+    const auto load = static_cast<std::size_t>(std::find(BurstBusLoads.begin(), BurstBusLoads.end(), busLoad) - BurstBusLoads.begin());
+    if(load == BurstBusLoads.size() || !openBus(state.range(1) != 0 ? BurstConfigs[load] : BusConfig))
+    {
+        state.SkipWithError("simulated driver not available");
+        return;
+    }
+    const auto burst = busFrameRate(BusBitRate, busLoad) * RX_QUEUE_STALL_MS / 1000;
+    std::array<uint8, 8> data{};
+    const Can_PduType pduInfo{0x123, 0, 0, data.data()};
+    uint64 written = 0;
+    Can_XLdriver_RxStatisticsType sender{};
+    Can_XLdriver_RxStatisticsType receiver{};
+
+    drainMainFunctions();
+    Can_XLdriver_GetRxStatistics(0, &sender);
+    Can_XLdriver_GetRxStatistics(1, &receiver);
+    const auto overflows = sender.QueueOverflows + receiver.QueueOverflows;
+    const auto pollingDrops = sender.PollingQueueDrops + receiver.PollingQueueDrops;
+    const auto indications = g_BenchRxIndications;
+    for(auto _ : state)
+    {
+        for(uint64 frame = 0; frame < burst; ++frame)
+        {
+            written += Can_XLdriver_Write(4, &pduInfo) == E_OK ? 1 : 0;
+        }
+        drainMainFunctions();
+    }
+    Can_XLdriver_GetRxStatistics(0, &sender);
+    Can_XLdriver_GetRxStatistics(1, &receiver);
+    state.SetItemsProcessed(static_cast<int64_t>(written));
+    state.counters["burst"] = static_cast<double>(burst);
+    state.counters["lost"] = static_cast<double>(written - std::min<uint64>(written, g_BenchRxIndications - indications));
+    state.counters["overflows"] = static_cast<double>(sender.QueueOverflows + receiver.QueueOverflows - overflows);
+    state.counters["polling_drops"] = static_cast<double>(sender.PollingQueueDrops + receiver.PollingQueueDrops - pollingDrops);
+    state.counters["high_water"] = receiver.QueueHighWater;
+    state.counters["queue_kb"] = receiver.QueueSize / 1024.0;
+}
+BENCHMARK(rxBurst)->ArgsProduct({{30, 60, 80}, {0, 1}})->ArgNames({"load", "sized"})->Iterations(20);
+
+/**
+ * @brief Can_XLdriver_Write at full TX load, the confirmations read back by the main functions
+ * @details The argument selects the first controller: 0 without TX timeout, 1 with a timeout on
+ *          every frame. The difference is the supervision: a slot claimed by each write, a timer
+ *          armed and cancelled by each confirmation. busy counts the writes refused with CAN_BUSY.
+ */
+void txSupervision(benchmark::State& state)
+{
+    const auto supervised = state.range(0) != 0;
+    if(!openBus(supervised ? SupervisedConfig : BusConfig))
+    {
+        state.SkipWithError("simulated driver not available");
+        return;
+    }
+    std::array<uint8, 8> data{};
+    const Can_PduType pduInfo{0x123, 0, 8, data.data()};
+    uint64 busy = 0;
+    uint32 count = 0;
+    Can_XLdriver_TxStatisticsType before{};
+    Can_XLdriver_TxStatisticsType after{};
+
+    drainMainFunctions();
+    Can_XLdriver_GetTxStatistics(0, &before);
+    for(auto _ : state)
+    {
+        busy += Can_XLdriver_Write(4, &pduInfo) == CAN_BUSY ? 1 : 0;
+        if((++count & 0x1F) == 0)
+        {
+            drainMainFunctions();
+        }
+    }
+    drainMainFunctions();
+    Can_XLdriver_GetTxStatistics(0, &after);
+    state.SetItemsProcessed(static_cast<int64_t>(state.iterations()));
+    state.counters["busy"] = static_cast<double>(busy);
+    state.counters["confirmed"] = static_cast<double>(after.Confirmed - before.Confirmed);
+    state.counters["timeouts"] = static_cast<double>(after.Timeouts - before.Timeouts);
+}
+BENCHMARK(txSupervision)->Arg(0)->Arg(1)->ArgName("supervised");
+
+/** @brief Write to indication latencies (ns) of the frames received by the second controller, appended by the RX thread */
+std::vector<sint64> g_WaitModeLatencies(1u << 20);
+std::atomic<std::size_t> g_WaitModeLatencyCount{0};
+
+void recordLatency(const Can_HwType* Mailbox, const PduInfoType* PduInfoPtr)
+{
+    if(Mailbox->ControllerId != 1 || PduInfoPtr->SduLength < sizeof(sint64))
+    {
+        return;
+    }
+    const auto index = g_WaitModeLatencyCount.load(std::memory_order_relaxed);
+    if(index < g_WaitModeLatencies.size())
+    {
+        sint64 writtenAt = 0;
+        std::memcpy(&writtenAt, PduInfoPtr->SduDataPtr, sizeof(writtenAt));
+        g_WaitModeLatencies[index] = std::chrono::steady_clock::now().time_since_epoch().count() - writtenAt;
+        g_WaitModeLatencyCount.store(index + 1, std::memory_order_release);
+    }
+}
+
+/**
+ * @brief Frames written at a paced bus load and indicated by the RX thread in each wait mode
+ * @details The arguments are the RxWaitMode (0 spin, 1 block, 2 adaptive) and the bus load (%) of
+ *          8 byte classic frames, one frame per iteration. The time is the frame period, the CPU time
+ *          the process CPU time of one frame: writer and RX thread. Each frame carries its write
+ *          time, p50_us and p99_us are the write to CanIf_RxIndication latencies on the receiver.
+ */
+void rxWaitModes(benchmark::State& state)
+{
+    const auto mode = static_cast<std::size_t>(state.range(0));
+    const auto busLoad = static_cast<uint64>(state.range(1));
+    g_RxWaitMode = static_cast<RxWaitMode>(mode);
+    if(!openBus(WaitModeConfigs[mode]))
+    {
+        state.SkipWithError("simulated driver not available");
+        return;
+    }
+    const auto frameRate = BusBitRate * busLoad / 100 / frameBits(false, false, false, false, 8).nominal;
+    const auto period = std::chrono::nanoseconds(1000000000ull / frameRate);
+    std::array<uint8, 8> data{};
+    const Can_PduType pduInfo{0x123, 0, 8, data.data()};
+    g_WaitModeLatencyCount = 0;
+    g_BenchRxHook = recordLatency;
+    uint64 written = 0;
+    auto next = std::chrono::steady_clock::now();
+
+    for(auto _ : state)
+    {
+        std::this_thread::sleep_until(next);
+        next += period;
+        const auto now = std::chrono::steady_clock::now().time_since_epoch().count();
+        std::memcpy(data.data(), &now, sizeof(now));
+        // one frame in the simulated queue at a time, the receiver gets every one
+        written += Can_XLdriver_Write(4, &pduInfo) == E_OK ? 1 : 0;
+    }
+    const auto deadline = std::chrono::steady_clock::now() + std::chrono::milliseconds(100);
+    while(g_WaitModeLatencyCount.load(std::memory_order_acquire) < std::min<uint64>(written, g_WaitModeLatencies.size()) &&
+          std::chrono::steady_clock::now() < deadline)
+    {
+        std::this_thread::yield();
+    }
+    g_BenchRxHook = nullptr;
+    // back to the polled controllers, no RX thread left running at exit
+    openBus();
+    std::vector<sint64> latencies(g_WaitModeLatencies.begin(), g_WaitModeLatencies.begin() + static_cast<std::ptrdiff_t>(g_WaitModeLatencyCount.load()));
+    std::ranges::sort(latencies);
+    const auto percentile = [&latencies](double fraction) {
+        return latencies.empty() ? 0.0 : static_cast<double>(latencies[static_cast<std::size_t>(fraction * static_cast<double>(latencies.size() - 1))]) / 1000.0;
+    };
+    state.SetItemsProcessed(static_cast<int64_t>(state.iterations()));
+    state.counters["lost"] = static_cast<double>(written - std::min<uint64>(written, latencies.size()));
+    state.counters["p50_us"] = percentile(0.50);
+    state.counters["p99_us"] = percentile(0.99);
+}
+BENCHMARK(rxWaitModes)->ArgsProduct({{0, 1, 2}, {10, 40, 80}})->ArgNames({"mode", "load"})->UseRealTime()->MeasureProcessCPUTime();
+}
+
+/**@} */ // END OF addtogroup bench_bus
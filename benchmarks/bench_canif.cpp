@@ -0,0 +1,68 @@
+/**
+ * @file bench_canif.cpp
+ * @author Maxime Verreault
+ * @date 2026-10-19
+ * @copyright COPYRIGHT(c) Maxime Verreault All rights reserved.
+ * @brief CanIf callbacks of the benchmarks, counting the calls instead of printing them
+ * @ingroup Benchmarks
+ * @addtogroup bench_canif
+ * @{
+ */
+
+
+/*==================================================================================================
+*                                        INCLUDE FILES
+* 1) system and project includes
+* 2) needed interfaces from external units
+* 3) internal and external interfaces from this unit
+==================================================================================================*/
+#include <CanIf_Can.h>
+#include "bench_canif.h"
+
+
+/*==================================================================================================
+*                                      GLOBAL VARIABLES
+==================================================================================================*/
+volatile uint64 g_BenchRxIndications = 0;
+volatile uint64 g_BenchTxConfirmations = 0;
+void (*volatile g_BenchRxHook)(const Can_HwType* Mailbox, const PduInfoType* PduInfoPtr) = nullptr;
+
+
+/*==================================================================================================
+*                                       GLOBAL FUNCTIONS
+==================================================================================================*/
+extern "C" void CanIf_ControllerBusOff(uint8 ControllerId)
+{
+    (void) ControllerId;
+}
+
+extern "C" void CanIf_ControllerModeIndication(uint8 ControllerId, Can_ControllerStateType ControllerMode)
+{
+    (void) ControllerId;
+    (void) ControllerMode;
+}
+
+extern "C" void CanIf_RxIndication(const Can_HwType* Mailbox, const PduInfoType* PduInfoPtr)
+{
+    if(g_BenchRxHook != nullptr)
+    {
+        g_BenchRxHook(Mailbox, PduInfoPtr);
+    }
+    g_BenchRxIndications = g_BenchRxIndications + 1;
+}
+
+extern "C" void CanIf_ControllerErrorStatePassive(void)
+{
+}
+
+extern "C" void CanIf_ErrorNotification(void)
+{
+}
+
+extern "C" void CanIf_TxConfirmation(PduIdType CanTxPduId)
+{
+    (void) CanTxPduId;
+    g_BenchTxConfirmations = g_BenchTxConfirmations + 1;
+}
+
+/**@} */ // END OF addtogroup bench_canif
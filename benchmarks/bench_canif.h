@@ -0,0 +1,35 @@
+/**
+ * @file bench_canif.h
+ * @author Maxime Verreault
+ * @date 2026-10-19
+ * @copyright COPYRIGHT(c) Maxime Verreault All rights reserved.
+ * @brief CanIf callbacks of the benchmarks, counting the calls instead of printing them
+ * @ingroup Benchmarks
+ * @addtogroup bench_canif
+ * @{
+ */
+
+
+#ifndef BENCH_CANIF_H
+#define BENCH_CANIF_H
+
+/*==================================================================================================
+*                                         INCLUDE FILES
+* 1) system and project includes
+* 2) needed interfaces from external units
+* 3) internal and external interfaces from this unit
+==================================================================================================*/
+#include <Platform_Types.h>
+#include <Can_GeneralTypes.h>
+
+
+/*==================================================================================================
+*                                GLOBAL VARIABLE DECLARATIONS
+==================================================================================================*/
+extern volatile uint64 g_BenchRxIndications;
+extern volatile uint64 g_BenchTxConfirmations;
+extern void (*volatile g_BenchRxHook)(const Can_HwType* Mailbox, const PduInfoType* PduInfoPtr);   //!< called by CanIf_RxIndication when set
+
+#endif //BENCH_CANIF_H
+
+/**@} */ // END OF addtogroup bench_canif
@@ -0,0 +1,507 @@
+/**
+ * @file bench_capture.cpp
+ * @author Maxime Verreault
+ * @date 2026-10-19
+ * @copyright COPYRIGHT(c) Maxime Verreault All rights reserved.
+ * @brief Benchmarks of the recorder, the log export writers and the replay loop
+ * @details On the simulated driver, 8 channels at full CAN FD load are captured through the RX
+ *          thread and the recorder.
+ * @ingroup Benchmarks
+ * @addtogroup bench_capture
+ * @{
+ */
+
+
+/*==================================================================================================
+*                                        INCLUDE FILES
+* 1) system and project includes
+* 2) needed interfaces from external units
+* 3) internal and external interfaces from this unit
+==================================================================================================*/
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <iterator>
+#include <memory>
+#include <numeric>
+#include <string>
+#include <thread>
+#include <vector>
+#include <benchmark/benchmark.h>
+#include <zlib.h>
+#include "xlrecorder.h"
+#include "xlexport.h"
+#include "xlasc.h"
+#include "xlblf.h"
+#include "xlpcapng.h"
+#include "xlreplay.h"
+#include "xlframe.h"
+#include "xldriver.h"
+#ifdef BENCHMARKS_SIMULATED
+#include "xlsim.h"
+#endif
+
+
+/*==================================================================================================
+*                                       LOCAL FUNCTIONS
+==================================================================================================*/
+namespace
+{
+std::string temporaryPath(const std::string& name)
+{
+    return (std::filesystem::temp_directory_path() / name).string();
+}
+
+/** @brief Content of a written file, removed once read */
+std::vector<uint8> readBack(const std::string& path)
+{
+    std::ifstream file(path, std::ios::binary);
+    std::vector<uint8> content{std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>()};
+    file.close();
+    std::filesystem::remove(path);
+    return content;
+}
+
+/** @brief A classic frame, a CAN FD frame with BRS and an error, on both channels, one per export object */
+std::array<RecordEntry, 3> goldenEntries(RecordKind errorKind)
+{
+    std::array<RecordEntry, 3> entries{};
+    entries[0].timeStamp = 0x10;
+    entries[0].canId = 0x123;
+    entries[0].kind = RecordKind::Rx;
+    entries[0].dlc = 2;
+    entries[0].length = 2;
+    entries[0].data[0] = 0x11;
+    entries[0].data[1] = 0x22;
+    entries[1].timeStamp = 0x20;
+    entries[1].canId = 0x18DAF110u | XL_CAN_EXT_MSG_ID;
+    entries[1].msgFlags = XL_CAN_RXMSG_FLAG_EDL | XL_CAN_RXMSG_FLAG_BRS;
+    entries[1].channel = 1;
+    entries[1].kind = RecordKind::TxOk;
+    entries[1].dlc = 9;
+    entries[1].length = 12;
+    std::iota(entries[1].data, entries[1].data + entries[1].length, uint8{1});
+    entries[2].timeStamp = 0x30;
+    entries[2].kind = errorKind;
+    return entries;
+}
+
+/** @brief A mix of classic and 64 byte CAN FD frames with a few error frames, 1 kHz per channel */
+std::vector<RecordEntry> traffic(std::size_t count)
+{
+    std::vector<RecordEntry> entries(count);
+    for(std::size_t i = 0; i < count; ++i)
+    {
+        auto& entry = entries[i];
+        entry.timeStamp = 1000000ull * i;
+        entry.channel = static_cast<uint16>(i & 1);
+        entry.kind = (i % 100 == 99) ? RecordKind::ErrorFrame : ((i & 2) ? RecordKind::TxOk : RecordKind::Rx);
+        entry.canId = (i % 3 == 0) ? (0x18DAF110u | XL_CAN_EXT_MSG_ID) : static_cast<uint32>(0x100 + (i & 0xFF));
+        if(i % 4 == 0)
+        {
+            entry.msgFlags = XL_CAN_RXMSG_FLAG_EDL | XL_CAN_RXMSG_FLAG_BRS;
+            entry.dlc = 15;
+            entry.length = 64;
+        }
+        else
+        {
+            entry.dlc = 8;
+            entry.length = 8;
+        }
+        std::iota(entry.data, entry.data + entry.length, static_cast<uint8>(i));
+    }
+    return entries;
+}
+
+void recorderToRecord(benchmark::State& state)
+{
+    XLcanRxEvent event{};
+    event.tag = XL_CAN_EV_TAG_RX_OK;
+    event.tagData.canRxOkMsg.canId = 0x123;
+    event.tagData.canRxOkMsg.msgFlags = XL_CAN_RXMSG_FLAG_EDL;
+    event.tagData.canRxOkMsg.dlc = 15;
+    RecordEntry entry;
+    for(auto _ : state)
+    {
+        benchmark::DoNotOptimize(Recorder::toRecord(event, entry));
+        benchmark::ClobberMemory();
+    }
+    state.SetItemsProcessed(static_cast<int64_t>(state.iterations()));
+}
+BENCHMARK(recorderToRecord);
+
+void recorderRecord(benchmark::State& state)
+{
+    const auto basePath = temporaryPath("bench_recorder");
+    Recorder recorder;
+    if(!recorder.open({basePath, 16ull * 1024 * 1024, 64ull * 1024 * 1024}))
+    {
+        state.SkipWithError("cannot create the record segments");
+        return;
+    }
+    const auto entries = traffic(1024);
+    std::size_t i = 0;
+    for(auto _ : state)
+    {
+        benchmark::DoNotOptimize(recorder.record(entries[i++ & 1023]));
+    }
+    const auto statistics = recorder.statistics();
+    recorder.close();
+    for(uint64 segment = 0; segment < statistics.segments + 1; ++segment)
+    {
+        std::filesystem::remove(Recorder::segmentPath(basePath, segment));
+    }
+    state.SetItemsProcessed(static_cast<int64_t>(state.iterations()));
+    state.SetBytesProcessed(static_cast<int64_t>(state.iterations() * sizeof(RecordEntry)));
+    state.counters["dropped"] = static_cast<double>(statistics.dropped);
+}
+BENCHMARK(recorderRecord);
+
+/** @brief Writer dropping everything, isolates the queue from the formatting */
+class DiscardWriter : public LogWriter
+{
+public:
+    void write(const RecordEntry& entry) override { benchmark::DoNotOptimize(entry.kind); }
+    void close() override {}
+    [[nodiscard]] uint64 bytesWritten() const override { return 0; }
+};
+
+/** @brief Cost of handing an event to the export thread, as paid by the RX thread */
+void exportPush(benchmark::State& state)
+{
+    ExportPipeline pipeline;
+    pipeline.addWriter(std::make_unique<DiscardWriter>());
+    pipeline.start();
+    const auto entries = traffic(1024);
+    std::size_t i = 0;
+    for(auto _ : state)
+    {
+        benchmark::DoNotOptimize(pipeline.push(entries[i++ & 1023]));
+    }
+    pipeline.stop();
+    state.SetItemsProcessed(static_cast<int64_t>(state.iterations()));
+    state.counters["dropped"] = static_cast<double>(pipeline.dropped());
+}
+BENCHMARK(exportPush);
+
+/**
+ * @brief Sustained throughput of one log writer fed on the calling thread
+ * @details Bytes per second are the bytes of the produced file, items per second the events.
+ */
+template<typename Writer>
+void writerThroughput(benchmark::State& state, const std::string& name)
+{
+    const auto path = temporaryPath(name);
+    const auto entries = traffic(4096);
+    uint64 bytes = 0;
+    for(auto _ : state)
+    {
+        state.PauseTiming();
+        auto writer = std::make_unique<Writer>(path);
+        state.ResumeTiming();
+        for(const auto& entry : entries)
+        {
+            writer->write(entry);
+        }
+        writer->close();
+        bytes += writer->bytesWritten();
+    }
+    std::filesystem::remove(path);
+    state.SetItemsProcessed(static_cast<int64_t>(state.iterations() * entries.size()));
+    state.SetBytesProcessed(static_cast<int64_t>(bytes));
+}
+
+void ascWriter(benchmark::State& state)
+{
+    writerThroughput<AscWriter>(state, "bench_export.asc");
+}
+BENCHMARK(ascWriter)->Unit(benchmark::kMicrosecond);
+
+/**
+ * @brief Log container of isBlfGolden(), written by hand from the BLF object layouts of python-can
+ * @details Each object has the V1 header (LOBJ, header size 32, object size, type, time in
+ *          nanoseconds from the first frame), then CAN_MESSAGE "<HBBL8s", CAN_FD_MESSAGE
+ *          "<HBBLLBBB5x64s" and CAN_ERROR_EXT "<HHLBBBxLLH2x8s", with the channels counted from 1.
+ */
+constexpr uint8 BlfGolden[] = {
+    // CAN_MESSAGE 0x123 on channel 1
+    0x4C, 0x4F, 0x42, 0x4A, 0x20, 0x00, 0x01, 0x00, 0x30, 0x00, 0x00, 0x00, 0x01, 0x00, 0x00, 0x00,
+    0x02, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x01, 0x00, 0x00, 0x02, 0x23, 0x01, 0x00, 0x00, 0x11, 0x22, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    // CAN_FD_MESSAGE 0x18DAF110x transmitted on channel 2, EDL and BRS, 12 valid bytes
+    0x4C, 0x4F, 0x42, 0x4A, 0x20, 0x00, 0x01, 0x00, 0x74, 0x00, 0x00, 0x00, 0x64, 0x00, 0x00, 0x00,
+    0x02, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x10, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x02, 0x00, 0x01, 0x09, 0x10, 0xF1, 0xDA, 0x98, 0x00, 0x00, 0x00, 0x00, 0x00, 0x03, 0x0C, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x01, 0x02, 0x03, 0x04, 0x05, 0x06, 0x07, 0x08, 0x09, 0x0A, 0x0B, 0x0C,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00,
+    // CAN_ERROR_EXT of a frame 0x456 with DLC 8 on channel 1
+    0x4C, 0x4F, 0x42, 0x4A, 0x20, 0x00, 0x01, 0x00, 0x40, 0x00, 0x00, 0x00, 0x49, 0x00, 0x00, 0x00,
+    0x02, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x20, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x01, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x08, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x56, 0x04, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+};
+
+/** @brief BlfWriter gives BlfGolden once its log container is inflated, and counts its 3 objects, checked once per run */
+bool isBlfGolden()
+{
+    static const bool golden = []() {
+        auto entries = goldenEntries(RecordKind::TxError);
+        entries[2].canId = 0x456;
+        entries[2].dlc = 8;
+
+        const auto path = temporaryPath("bench_golden.blf");
+        BlfWriter writer(path);
+        for(const auto& entry : entries)
+        {
+            writer.write(entry);
+        }
+        writer.close();
+        const auto written = readBack(path);
+
+        // file header, then one LOG_CONTAINER: base header, method, reserved, uncompressed size, reserved, deflated objects
+        constexpr std::size_t containerOffset = BLF_FILE_HEADER_SIZE;
+        constexpr std::size_t dataOffset = containerOffset + 32;
+        uint32 objectCount = 0;
+        uint32 objectSize = 0;
+        uint32 uncompressedSize = 0;
+        if(written.size() < dataOffset)
+        {
+            return false;
+        }
+        std::memcpy(&objectCount, written.data() + 32, sizeof(objectCount));
+        std::memcpy(&objectSize, written.data() + containerOffset + 8, sizeof(objectSize));
+        std::memcpy(&uncompressedSize, written.data() + containerOffset + 24, sizeof(uncompressedSize));
+        if(objectCount != entries.size() || objectSize < 32 || written.size() < containerOffset + objectSize)
+        {
+            return false;
+        }
+        std::vector<uint8> objects(uncompressedSize);
+        auto length = static_cast<uLongf>(objects.size());
+        return uncompress(objects.data(), &length, written.data() + dataOffset, objectSize - 32) == Z_OK && std::ranges::equal(objects, BlfGolden);
+    }();
+    return golden;
+}
+
+void blfWriter(benchmark::State& state)
+{
+    if(!isBlfGolden())
+    {
+        state.SkipWithError("the log container differs from BlfGolden");
+        return;
+    }
+    writerThroughput<BlfWriter>(state, "bench_export.blf");
+}
+BENCHMARK(blfWriter)->Unit(benchmark::kMicrosecond);
+
+/**
+ * @brief Capture of isPcapngGolden(), written by hand from the PCAP-NG and SocketCAN layouts
+ * @details Section header, one interface description per channel (LINKTYPE_CAN_SOCKETCAN, snap length
+ *          72, if_name, if_tsresol 9) before its first packet, then enhanced packets with the
+ *          timestamp high word first and the can_id in network byte order.
+ */
+constexpr uint8 PcapngGolden[] = {
+    // section header
+    0x0A, 0x0D, 0x0D, 0x0A, 0x1C, 0x00, 0x00, 0x00, 0x4D, 0x3C, 0x2B, 0x1A, 0x01, 0x00, 0x00, 0x00,
+    0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0x1C, 0x00, 0x00, 0x00,
+    // interface 0, channel 0
+    0x01, 0x00, 0x00, 0x00, 0x2C, 0x00, 0x00, 0x00, 0xE3, 0x00, 0x00, 0x00, 0x48, 0x00, 0x00, 0x00,
+    0x02, 0x00, 0x06, 0x00, 0x78, 0x6C, 0x63, 0x61, 0x6E, 0x31, 0x00, 0x00, 0x09, 0x00, 0x01, 0x00,
+    0x09, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x2C, 0x00, 0x00, 0x00,
+    // classic frame 0x123
+    0x06, 0x00, 0x00, 0x00, 0x30, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x02, 0x00, 0x00, 0x00,
+    0x10, 0x00, 0x00, 0x00, 0x10, 0x00, 0x00, 0x00, 0x10, 0x00, 0x00, 0x00, 0x00, 0x00, 0x01, 0x23,
+    0x02, 0x00, 0x00, 0x00, 0x11, 0x22, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x30, 0x00, 0x00, 0x00,
+    // interface 1, channel 1
+    0x01, 0x00, 0x00, 0x00, 0x2C, 0x00, 0x00, 0x00, 0xE3, 0x00, 0x00, 0x00, 0x48, 0x00, 0x00, 0x00,
+    0x02, 0x00, 0x06, 0x00, 0x78, 0x6C, 0x63, 0x61, 0x6E, 0x32, 0x00, 0x00, 0x09, 0x00, 0x01, 0x00,
+    0x09, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x2C, 0x00, 0x00, 0x00,
+    // CAN FD frame 0x18DAF110x with BRS
+    0x06, 0x00, 0x00, 0x00, 0x68, 0x00, 0x00, 0x00, 0x01, 0x00, 0x00, 0x00, 0x02, 0x00, 0x00, 0x00,
+    0x20, 0x00, 0x00, 0x00, 0x48, 0x00, 0x00, 0x00, 0x48, 0x00, 0x00, 0x00, 0x98, 0xDA, 0xF1, 0x10,
+    0x0C, 0x05, 0x00, 0x00, 0x01, 0x02, 0x03, 0x04, 0x05, 0x06, 0x07, 0x08, 0x09, 0x0A, 0x0B, 0x0C,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x68, 0x00, 0x00, 0x00,
+    // error frame on channel 0
+    0x06, 0x00, 0x00, 0x00, 0x30, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x02, 0x00, 0x00, 0x00,
+    0x30, 0x00, 0x00, 0x00, 0x10, 0x00, 0x00, 0x00, 0x10, 0x00, 0x00, 0x00, 0x20, 0x00, 0x00, 0x80,
+    0x08, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x30, 0x00, 0x00, 0x00,
+};
+
+/** @brief PcapngWriter gives PcapngGolden byte for byte, checked once per run */
+bool isPcapngGolden()
+{
+    static const bool golden = []() {
+        const auto path = temporaryPath("bench_golden.pcapng");
+        PcapngWriter writer(path, 0x200000000);
+        for(const auto& entry : goldenEntries(RecordKind::ErrorFrame))
+        {
+            writer.write(entry);
+        }
+        writer.close();
+        return std::ranges::equal(readBack(path), PcapngGolden);
+    }();
+    return golden;
+}
+
+void pcapngWriter(benchmark::State& state)
+{
+    if(!isPcapngGolden())
+    {
+        state.SkipWithError("the capture differs from PcapngGolden");
+        return;
+    }
+    writerThroughput<PcapngWriter>(state, "bench_export.pcapng");
+}
+BENCHMARK(pcapngWriter)->Unit(benchmark::kMicrosecond);
+
+void replayAsFastAsPossible(benchmark::State& state)
+{
+    const auto entries = traffic(4096);
+    const std::atomic<bool> keepRunning{true};
+    ReplaySettings settings;
+    settings.timing = ReplayTiming::AsFastAsPossible;
+    const Replayer replayer(settings);
+    for(auto _ : state)
+    {
+        std::size_t i = 0;
+        const auto report = replayer.run([&](RecordEntry& entry) {
+            if(i == entries.size())
+            {
+                return false;
+            }
+            entry = entries[i++];
+            return true;
+        }, [](const RecordEntry& entry) {
+            benchmark::DoNotOptimize(entry.canId);
+            return true;
+        }, keepRunning);
+        benchmark::DoNotOptimize(report.frames);
+    }
+    state.SetItemsProcessed(static_cast<int64_t>(state.iterations() * entries.size()));
+}
+BENCHMARK(replayAsFastAsPossible)->Unit(benchmark::kMicrosecond);
+
+#ifdef BENCHMARKS_SIMULATED
+constexpr unsigned int CaptureChannels = 8;
+constexpr uint32 CaptureBitRate = 500000;
+constexpr uint32 CaptureDataBitRate = 2000000;
+constexpr auto CaptureBatch = std::chrono::microseconds(100);   // events injected at once, the driver notifies about as often
+constexpr auto CapturePeriod = std::chrono::milliseconds(10);   // bus time of one iteration
+
+/** @brief Inject the CAN FD frames one channel receives during CapturePeriod at 100 % load */
+void produceChannel(unsigned short channel, uint8 dlc, std::chrono::nanoseconds framePeriod, std::atomic<uint64>& injected)
+{
+    XLcanRxEvent event{};
+    event.size = XL_CANFD_RX_EVENT_HEADER_SIZE + sizeof(XL_CAN_EV_RX_MSG);
+    event.tag = XL_CAN_EV_TAG_RX_OK;
+    event.channelIndex = channel;
+    event.tagData.canRxOkMsg.canId = 0x100u + channel;
+    event.tagData.canRxOkMsg.msgFlags = XL_CAN_RXMSG_FLAG_EDL | XL_CAN_RXMSG_FLAG_BRS;
+    event.tagData.canRxOkMsg.dlc = dlc;
+    const auto start = std::chrono::steady_clock::now();
+    auto frame = std::chrono::nanoseconds::zero();
+    uint64 count = 0;
+    for(auto batch = CaptureBatch; batch <= CapturePeriod; batch += CaptureBatch)
+    {
+        std::this_thread::sleep_until(start + batch);
+        for(; frame < batch; frame += framePeriod)
+        {
+            event.timeStampSync = static_cast<XLuint64>(frame.count());
+            count += xlSimInjectCanFdEvent(g_xlPortHandle, &event) == XL_SUCCESS ? 1 : 0;
+        }
+    }
+    injected.fetch_add(count, std::memory_order_relaxed);
+}
+
+uint64 rxQueueOverflows()
+{
+    uint64 overflows = 0;
+    for(const auto& channelOverflows : g_RxQueueStatistics.overflows)
+    {
+        overflows += channelOverflows.load(std::memory_order_relaxed);
+    }
+    return overflows;
+}
+
+/**
+ * @brief 8 channels receiving CAN FD frames at 100 % bus load, recorded by the RX thread
+ * @details The argument is the payload length (bytes), the frames switch to 2 Mbit/s. One producer
+ *          thread per channel injects its frames into the simulated driver every CaptureBatch,
+ *          timed to the bus, the RX thread reads and records them as it would live traffic. dropped
+ *          counts the records refused by the recorder, overflows the events lost by the XL queue
+ *          and lost every injected frame missing from the recording.
+ */
+void captureFullLoad(benchmark::State& state)
+{
+    const auto dlc = CanData::getDLC(static_cast<uint8>(state.range(0)));
+    const auto bits = frameBits(false, true, true, false, dlc);
+    const auto framePeriod = std::chrono::nanoseconds(bits.durationNs(CaptureBitRate, CaptureDataBitRate));
+    const auto basePath = temporaryPath("bench_capture");
+    g_silent = 1;
+    g_RxBusLoad = 100;
+    unsigned int channelIndex = 0;
+    xlSimSetChannelCount(CaptureChannels);
+    if(demoInitDriver(xlChanMaskTx, channelIndex) != XL_SUCCESS || !g_Recorder.open({basePath, 64ull * 1024 * 1024, 256ull * 1024 * 1024}))
+    {
+        state.SkipWithError("cannot open the simulated driver or the record segments");
+        return;
+    }
+    xlActivateChannel(g_xlPortHandle, g_xlChannelMask, XL_BUS_TYPE_CAN, XL_ACTIVATE_RESET_CLOCK);
+    demoCreateRxThread();
+    // the recorder counts since the first open
+    const auto before = g_Recorder.statistics();
+    const auto overflows = rxQueueOverflows();
+    std::atomic<uint64> injected{0};
+
+    for(auto _ : state)
+    {
+        std::vector<std::thread> producers;
+        for(unsigned short channel = 0; channel < CaptureChannels; ++channel)
+        {
+            producers.emplace_back(produceChannel, channel, dlc, framePeriod, std::ref(injected));
+        }
+        for(auto& producer : producers)
+        {
+            producer.join();
+        }
+    }
+    const auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(1);
+    const auto captured = []() { const auto statistics = g_Recorder.statistics(); return statistics.records + statistics.dropped; };
+    while(captured() - before.records - before.dropped < injected && std::chrono::steady_clock::now() < deadline)
+    {
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+    demoStopRxThread();
+    const auto statistics = g_Recorder.statistics();
+    g_Recorder.close();
+    xlDeactivateChannel(g_xlPortHandle, g_xlChannelMask);
+    xlClosePort(g_xlPortHandle);
+    xlCloseDriver();
+    g_xlPortHandle = XL_INVALID_PORTHANDLE;
+    xlSimSetChannelCount(XLSIM_DEFAULT_CHANNEL_COUNT);
+    for(uint64 segment = 0; segment < statistics.segments + 1; ++segment)
+    {
+        std::filesystem::remove(Recorder::segmentPath(basePath, segment));
+    }
+    const auto records = statistics.records - before.records;
+    state.SetItemsProcessed(static_cast<int64_t>(records));
+    state.SetBytesProcessed(static_cast<int64_t>(records * sizeof(RecordEntry)));
+    state.counters["frames_per_channel_s"] = 1e9 / static_cast<double>(framePeriod.count());
+    state.counters["dropped"] = static_cast<double>(statistics.dropped - before.dropped);
+    state.counters["overflows"] = static_cast<double>(rxQueueOverflows() - overflows);
+    state.counters["lost"] = static_cast<double>(injected - std::min<uint64>(injected, records));
+}
+BENCHMARK(captureFullLoad)->Arg(8)->Arg(64)->ArgName("length")->Iterations(100)->UseRealTime()->MeasureProcessCPUTime()->Unit(benchmark::kMillisecond);
+#endif
+}
+
+/**@} */ // END OF addtogroup bench_capture
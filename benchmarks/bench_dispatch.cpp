@@ -0,0 +1,387 @@
+/**
+ * @file bench_dispatch.cpp
+ * @author Maxime Verreault
+ * @date 2026-10-19
+ * @copyright COPYRIGHT(c) Maxime Verreault All rights reserved.
+ * @brief Benchmarks of the RX event decoding, CanIf dispatch and transmit path against the simulated driver, and of the per-identifier statistics, deadlines and TX timeouts
+ * @ingroup Benchmarks
+ * @addtogroup bench_dispatch
+ * @{
+ */
+
+
+/*==================================================================================================
+*                                        INCLUDE FILES
+* 1) system and project includes
+* 2) needed interfaces from external units
+* 3) internal and external interfaces from this unit
+==================================================================================================*/
+#include <array>
+#include <numeric>
+#include <vector>
+#include <benchmark/benchmark.h>
+#include "xlsim.h"
+#include "Can_XLdriver.h"
+#include "xlbitstream.h"
+#include "xldriver.h"
+#include "bench_canif.h"
+
+
+/*==================================================================================================
+*                                       LOCAL FUNCTIONS
+==================================================================================================*/
+namespace
+{
+/** @brief Classic frame event, with the bus length (intermission excluded) the XL driver reports */
+XLcanRxEvent canFdRxEvent(unsigned short tag, unsigned char dlc)
+{
+    XLcanRxEvent event{};
+    event.tag = tag;
+    event.channelIndex = 0;
+    event.timeStampSync = 1000;
+    event.tagData.canRxOkMsg.canId = 0x123;
+    event.tagData.canRxOkMsg.dlc = dlc;
+    std::iota(std::begin(event.tagData.canRxOkMsg.data), std::end(event.tagData.canRxOkMsg.data), uint8{1});
+    event.tagData.canRxOkMsg.totalBitCnt = classicFrameBits(false, false, 0x123, dlc, event.tagData.canRxOkMsg.data).nominal - 3;
+    return event;
+}
+
+/** @brief Open the simulated driver once, with the adapter globals set as main() does */
+bool openDriver()
+{
+    static const bool opened = []() {
+        g_silent = 1;
+        unsigned int channelIndex = 0;
+        auto xlStatus = demoInitDriver(xlChanMaskTx, channelIndex);
+        if(xlStatus == XL_SUCCESS)
+        {
+            xlStatus = xlActivateChannel(g_xlPortHandle, g_xlChannelMask, XL_BUS_TYPE_CAN, XL_ACTIVATE_RESET_CLOCK);
+        }
+        return xlStatus == XL_SUCCESS;
+    }();
+    return opened;
+}
+
+void handleCanFdRxOk(benchmark::State& state)
+{
+    g_silent = 1;
+    auto event = canFdRxEvent(XL_CAN_EV_TAG_RX_OK, static_cast<unsigned char>(state.range(0)));
+    for(auto _ : state)
+    {
+        handleCanFdEvent(event);
+    }
+    state.SetItemsProcessed(static_cast<int64_t>(state.iterations()));
+    state.counters["indications"] = static_cast<double>(g_BenchRxIndications);
+}
+BENCHMARK(handleCanFdRxOk)->Arg(8)->Arg(15);
+
+void handleCanFdTxOk(benchmark::State& state)
+{
+    g_silent = 1;
+    auto event = canFdRxEvent(XL_CAN_EV_TAG_TX_OK, 8);
+    for(auto _ : state)
+    {
+        handleCanFdEvent(event);
+    }
+    state.SetItemsProcessed(static_cast<int64_t>(state.iterations()));
+}
+BENCHMARK(handleCanFdTxOk);
+
+void handleClassicTxCompleted(benchmark::State& state)
+{
+    g_silent = 1;
+    XLevent event{};
+    event.tag = XL_RECEIVE_MSG;
+    event.tagData.msg.id = 0x123;
+    event.tagData.msg.dlc = 8;
+    event.tagData.msg.flags = XL_CAN_MSG_FLAG_TX_COMPLETED;
+    for(auto _ : state)
+    {
+        handleEvent(event);
+    }
+    state.SetItemsProcessed(static_cast<int64_t>(state.iterations()));
+}
+BENCHMARK(handleClassicTxCompleted);
+
+/** @brief Event mixes of handleCanFdMix */
+enum EventMix
+{
+    RxOnly,         //!< receptions only
+    Traffic,        //!< receptions, transmit requests and confirmations of a loaded bus
+    ErrorBursts,    //!< traffic broken by bursts of error frames and error passive chip states
+    Overflows       //!< traffic with one event in 16 flagged with a driver queue overflow
+};
+
+/** @brief 1024 events of a mix, in a fixed pseudo-random order */
+std::vector<XLcanRxEvent> canFdEventMix(EventMix mix)
+{
+    std::vector<XLcanRxEvent> events;
+    uint32 seed = 1;
+    const auto next = [&seed]() {
+        seed = seed * 1664525u + 1013904223u;
+        return seed >> 24;
+    };
+    for(std::size_t i = 0; i < 1024; ++i)
+    {
+        const auto draw = next();
+        unsigned short tag = XL_CAN_EV_TAG_RX_OK;
+        if(mix != RxOnly)
+        {
+            tag = draw < 150 ? XL_CAN_EV_TAG_RX_OK : draw < 230 ? XL_CAN_EV_TAG_TX_OK : XL_CAN_EV_TAG_TX_REQUEST;
+        }
+        // a burst of 64 error frames every 256 events, opened by an error passive chip state
+        if(mix == ErrorBursts && i % 256 >= 192)
+        {
+            tag = i % 256 == 192 ? XL_CAN_EV_TAG_CHIP_STATE : (i & 1) ? XL_CAN_EV_TAG_RX_ERROR : XL_CAN_EV_TAG_TX_ERROR;
+        }
+        auto event = canFdRxEvent(tag, 8);
+        if(tag == XL_CAN_EV_TAG_CHIP_STATE)
+        {
+            event.tagData.canChipState = XL_CAN_EV_CHIP_STATE{XL_CHIPSTAT_ERROR_PASSIVE, 128, 0, 0, 0};
+        }
+        else if(tag == XL_CAN_EV_TAG_RX_ERROR || tag == XL_CAN_EV_TAG_TX_ERROR)
+        {
+            event.tagData.canError.errorCode = XL_CAN_ERRC_STUFF_ERROR;
+        }
+        if(mix == Overflows && (draw & 0x0F) == 0)
+        {
+            event.flagsChip = XL_CAN_QUEUE_OVERFLOW;
+        }
+        events.push_back(event);
+    }
+    return events;
+}
+
+/** @brief Dispatch of a mix of CAN FD events through handleCanFdEvent, the argument is the EventMix */
+void handleCanFdMix(benchmark::State& state)
+{
+    g_silent = 1;
+    auto events = canFdEventMix(static_cast<EventMix>(state.range(0)));
+    std::size_t i = 0;
+    for(auto _ : state)
+    {
+        handleCanFdEvent(events[i++ & 1023]);
+    }
+    state.SetItemsProcessed(static_cast<int64_t>(state.iterations()));
+}
+BENCHMARK(handleCanFdMix)->DenseRange(RxOnly, Overflows)->ArgName("mix");
+
+/** @brief One turn of the CAN FD consumer loop: receive from the driver queue, then dispatch */
+void canFdConsumerTurn(benchmark::State& state)
+{
+    if(!openDriver())
+    {
+        state.SkipWithError("simulated driver not available");
+        return;
+    }
+    xlFlushReceiveQueue(g_xlPortHandle);
+    const auto injected = canFdRxEvent(XL_CAN_EV_TAG_RX_OK, 8);
+    XLcanRxEvent event;
+    for(auto _ : state)
+    {
+        xlSimInjectCanFdEvent(g_xlPortHandle, &injected);
+        if(xlCanReceive(g_xlPortHandle, &event) == XL_SUCCESS)
+        {
+            handleCanFdEvent(event);
+        }
+    }
+    state.SetItemsProcessed(static_cast<int64_t>(state.iterations()));
+}
+BENCHMARK(canFdConsumerTurn);
+
+/** @brief Identifiers of the statistics benchmarks: count spread over the standard range, or extended J1939-like ones */
+std::vector<uint32> statisticsIds(uint32 count, bool extended)
+{
+    std::vector<uint32> ids(count);
+    for(uint32 i = 0; i < count; ++i)
+    {
+        ids[i] = extended ? (0x18FF0000u + i * 0x101u) | XL_CAN_EXT_MSG_ID : (i * 7) & 0x7FF;
+    }
+    return ids;
+}
+
+/** @brief Update of the statistics of one frame, the arguments are the identifier count and the extended flag */
+void idStatisticsAddFrame(benchmark::State& state)
+{
+    IdStatisticsTable statistics;
+    statistics.reset(1);
+    const auto ids = statisticsIds(static_cast<uint32>(state.range(0)), state.range(1) != 0);
+    XLuint64 timeStamp = 0;
+    std::size_t i = 0;
+    for(auto _ : state)
+    {
+        // every identifier in turn, 10 us apart: one cycle for all of them
+        timeStamp += 10000;
+        statistics.addFrame(0, ids[i], timeStamp);
+        i = i + 1 == ids.size() ? 0 : i + 1;
+    }
+    state.SetItemsProcessed(static_cast<int64_t>(state.iterations()));
+    IdStatistics first{};
+    statistics.snapshot(0, ids[0], first);
+    state.counters["missed"] = static_cast<double>(first.missedCycles);
+}
+BENCHMARK(idStatisticsAddFrame)->Args({64, 0})->Args({2048, 0})->Args({512, 1});
+
+/** @brief Snapshot of one identifier while nobody updates it, the argument is the extended flag */
+void idStatisticsSnapshot(benchmark::State& state)
+{
+    IdStatisticsTable statistics;
+    statistics.reset(1);
+    const auto ids = statisticsIds(512, state.range(0) != 0);
+    for(uint32 cycle = 0; cycle < 16; ++cycle)
+    {
+        for(std::size_t i = 0; i < ids.size(); ++i)
+        {
+            statistics.addFrame(0, ids[i], (cycle * ids.size() + i) * 10000ull);
+        }
+    }
+    IdStatistics snapshot{};
+    std::size_t i = 0;
+    for(auto _ : state)
+    {
+        benchmark::DoNotOptimize(statistics.snapshot(0, ids[i++ & (ids.size() - 1)], snapshot));
+    }
+    state.SetItemsProcessed(static_cast<int64_t>(state.iterations()));
+}
+BENCHMARK(idStatisticsSnapshot)->Arg(0)->Arg(1);
+
+/** @brief Deadline monitor of extended identifiers on channel 0, active, with a timeout of each */
+void configureDeadlines(DeadlineMonitor& monitor, const std::vector<uint32>& ids, uint64 timeout)
+{
+    std::vector<RxDeadline> deadlines;
+    for(const auto id : ids)
+    {
+        deadlines.push_back({0, id, timeout});
+    }
+    monitor.configure(deadlines, nullptr);
+    monitor.setActive(0, true);
+}
+
+/** @brief Frame of a monitored identifier re-arming its deadline, the argument is the identifier count */
+void rxDeadlineOnFrame(benchmark::State& state)
+{
+    DeadlineMonitor monitor;
+    const auto ids = statisticsIds(static_cast<uint32>(state.range(0)), true);
+    // every identifier in turn, 10 us apart, with a timeout of two cycles: no deadline is missed
+    configureDeadlines(monitor, ids, 2 * 10000ull * ids.size());
+    XLuint64 timeStamp = 10000;
+    monitor.onFrame(0, ids[0], timeStamp);
+    std::size_t i = 1;
+    for(auto _ : state)
+    {
+        timeStamp += 10000;
+        monitor.onFrame(0, ids[i], timeStamp);
+        i = i + 1 == ids.size() ? 0 : i + 1;
+    }
+    state.SetItemsProcessed(static_cast<int64_t>(state.iterations()));
+    RxDeadlineStatistics first{};
+    monitor.snapshot(0, ids[0], first);
+    state.counters["timeouts"] = static_cast<double>(first.timeouts);
+}
+BENCHMARK(rxDeadlineOnFrame)->Arg(1000)->Arg(10000)->Arg(50000);
+
+/** @brief Missed deadlines of silent identifiers, 1 ms of bus time per iteration, the argument is the identifier count */
+void rxDeadlineTimeouts(benchmark::State& state)
+{
+    DeadlineMonitor monitor;
+    const auto ids = statisticsIds(static_cast<uint32>(state.range(0)), true);
+    // the timeouts of 10 ms are spread over the cycle by the first frame of each identifier
+    configureDeadlines(monitor, ids, 10000000);
+    XLuint64 timeStamp = 0;
+    for(std::size_t i = 0; i < ids.size(); ++i)
+    {
+        timeStamp = i * 10000000ull / ids.size();
+        monitor.onFrame(0, ids[i], timeStamp);
+    }
+    for(auto _ : state)
+    {
+        // a frame of an unmonitored identifier moves the driver time
+        timeStamp += 1000000;
+        monitor.onFrame(0, 0x7FF, timeStamp);
+    }
+    uint64 timeouts = 0;
+    for(const auto id : ids)
+    {
+        RxDeadlineStatistics statistics{};
+        monitor.snapshot(0, id, statistics);
+        timeouts += statistics.timeouts;
+    }
+    state.SetItemsProcessed(static_cast<int64_t>(timeouts));
+    state.counters["timeouts"] = static_cast<double>(timeouts);
+}
+BENCHMARK(rxDeadlineTimeouts)->Arg(1000)->Arg(10000)->Arg(50000);
+
+/**
+ * @brief Supervision of one transmitted frame: its write, its confirmation and its share of the RX thread timer work
+ * @details The argument is the frames in flight when a confirmation arrives, the identifiers all
+ *          differ so each confirmation matches the oldest frame. The timeout of 100 ms never expires.
+ */
+void txSupervisorFrame(benchmark::State& state)
+{
+    TxSupervisor supervisor;
+    supervisor.configure({{0, 100000000, TX_TIMEOUT_NOTIFY}}, XL_INVALID_PORTHANDLE, nullptr);
+    const auto inFlight = static_cast<uint32>(state.range(0));
+    uint32 written = 0;
+    uint32 confirmed = 0;
+    while(written < inFlight)
+    {
+        supervisor.onWrite(0, written++ & 0x7FF, 0);
+    }
+    for(auto _ : state)
+    {
+        benchmark::DoNotOptimize(supervisor.onWrite(0, written++ & 0x7FF, 0));
+        benchmark::DoNotOptimize(supervisor.onConfirmation(0, confirmed++ & 0x7FF));
+        // the RX thread expires the timers every 64 events
+        if((confirmed & 0x3F) == 0)
+        {
+            supervisor.expire();
+        }
+    }
+    TxSupervisionStatistics statistics{};
+    supervisor.snapshot(0, statistics);
+    state.SetItemsProcessed(static_cast<int64_t>(state.iterations()));
+    state.counters["late"] = static_cast<double>(statistics.lateConfirmations);
+    state.counters["timeouts"] = static_cast<double>(statistics.timeouts);
+}
+BENCHMARK(txSupervisorFrame)->Arg(1)->Arg(16)->Arg(128);
+
+/** @brief Can_XLdriver_Write down to the simulated xlCanTransmitEx, the argument is the SDU length */
+void canXLdriverWrite(benchmark::State& state)
+{
+    if(!openDriver())
+    {
+        state.SkipWithError("simulated driver not available");
+        return;
+    }
+    std::array<uint8, 64> data{};
+    std::iota(data.begin(), data.end(), uint8{1});
+    const Can_PduType pduInfo{0x69 | 0x40000000, 0, static_cast<uint8>(state.range(0)), data.data()};
+    uint32 count = 0;
+    for(auto _ : state)
+    {
+        benchmark::DoNotOptimize(Can_XLdriver_Write(0, &pduInfo));
+        /* nobody consumes the confirmations, keep the simulated queue from saturating */
+        if((++count & 0x1F) == 0)
+        {
+            xlFlushReceiveQueue(g_xlPortHandle);
+        }
+    }
+    state.SetItemsProcessed(static_cast<int64_t>(state.iterations()));
+}
+BENCHMARK(canXLdriverWrite)->Arg(8)->Arg(64);
+
+void rxWaitOnEvent(benchmark::State& state)
+{
+    RxWaitStrategy rxWait(RxWaitMode::Adaptive, std::chrono::microseconds(50), reinterpret_cast<XLhandle>(1));
+    XLuint64 timeStamp = 0;
+    for(auto _ : state)
+    {
+        timeStamp += 1000;
+        rxWait.onEvent(timeStamp);
+    }
+    state.SetItemsProcessed(static_cast<int64_t>(state.iterations()));
+}
+BENCHMARK(rxWaitOnEvent);
+}
+
+/**@} */ // END OF addtogroup bench_dispatch
@@ -0,0 +1,390 @@
+/**
+ * @file bench_frame.cpp
+ * @author Maxime Verreault
+ * @date 2026-10-19
+ * @copyright COPYRIGHT(c) Maxime Verreault All rights reserved.
+ * @brief Benchmarks of the frame classification, DLC conversion, TX event building, stuffed frame lengths and CRCs
+ * @ingroup Benchmarks
+ * @addtogroup bench_frame
+ * @{
+ */
+
+
+/*==================================================================================================
+*                                        INCLUDE FILES
+* 1) system and project includes
+* 2) needed interfaces from external units
+* 3) internal and external interfaces from this unit
+==================================================================================================*/
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <cstring>
+#include <numeric>
+#include <vector>
+#include <benchmark/benchmark.h>
+#include "xlframe.h"
+#include "xlbitstream.h"
+
+
+/*==================================================================================================
+*                                       LOCAL FUNCTIONS
+==================================================================================================*/
+namespace
+{
+/** @brief All four frame types, so the branch predictor cannot learn a single one */
+constexpr std::array<Can_IdType, 4> CanIds{0x123, 0x40000123, 0x80012345, 0xC0012345};
+
+std::array<uint8, 64> payload()
+{
+    std::array<uint8, 64> data{};
+    std::iota(data.begin(), data.end(), uint8{1});
+    return data;
+}
+
+void frameTypeClassify(benchmark::State& state)
+{
+    std::size_t i = 0;
+    for(auto _ : state)
+    {
+        const auto frameType = FrameType(CanIds[i++ & 3]);
+        const auto isFd = frameType == FrameType::StandardCanFd || frameType == FrameType::ExtendedCanFd;
+        benchmark::DoNotOptimize(isFd);
+    }
+    state.SetItemsProcessed(static_cast<int64_t>(state.iterations()));
+}
+BENCHMARK(frameTypeClassify);
+
+void canDataGetDlc(benchmark::State& state)
+{
+    uint8 length = 0;
+    for(auto _ : state)
+    {
+        length = static_cast<uint8>((length + 1) % 65);
+        benchmark::DoNotOptimize(CanData::getDLC(length));
+    }
+    state.SetItemsProcessed(static_cast<int64_t>(state.iterations()));
+}
+BENCHMARK(canDataGetDlc);
+
+void canDataGetPayloadSize(benchmark::State& state)
+{
+    uint8 dlc = 0;
+    for(auto _ : state)
+    {
+        dlc = static_cast<uint8>((dlc + 1) & 0x0F);
+        benchmark::DoNotOptimize(CanData::getPayloadSize(dlc));
+    }
+    state.SetItemsProcessed(static_cast<int64_t>(state.iterations()));
+}
+BENCHMARK(canDataGetPayloadSize);
+
+/** @brief Payload copy and padding of one PDU, the argument is the SDU length */
+void canDataBuild(benchmark::State& state)
+{
+    const auto data = payload();
+    const auto length = static_cast<uint8>(state.range(0));
+    for(auto _ : state)
+    {
+        auto canFrame = CanData(data.data(), length);
+        benchmark::DoNotOptimize(canFrame.data.data());
+    }
+    state.SetItemsProcessed(static_cast<int64_t>(state.iterations()));
+}
+BENCHMARK(canDataBuild)->Arg(8)->Arg(13)->Arg(64);
+
+/** @brief copyPadded gives the frame of copyPaddedScalar for every length, the SDU at the end of its buffer */
+bool isCopyPaddedEquivalent()
+{
+    std::array<uint8, 2 * XL_CAN_MAX_DATA_LEN> sdus{};
+    std::iota(sdus.begin(), sdus.end(), uint8{1});
+    for(uint8 length = 0; length <= XL_CAN_MAX_DATA_LEN; ++length)
+    {
+        unsigned char vector[XL_CAN_MAX_DATA_LEN];
+        unsigned char scalar[XL_CAN_MAX_DATA_LEN];
+        const auto* sdu = sdus.data() + sdus.size() - length;
+        std::ranges::fill(vector, 0);
+        copyPadded(vector, sdu, length, 0x55);
+        copyPaddedScalar(scalar, sdu, length, 0x55);
+        if(!std::ranges::equal(vector, scalar))
+        {
+            return false;
+        }
+    }
+    return true;
+}
+
+/** @brief SIMD copy and padding of a CAN FD frame, the argument is the SDU length */
+void copyPaddedFd(benchmark::State& state)
+{
+    if(!isCopyPaddedEquivalent())
+    {
+        state.SkipWithError("copyPadded differs from copyPaddedScalar");
+        return;
+    }
+    const auto data = payload();
+    const auto length = static_cast<uint8>(state.range(0));
+    unsigned char frame[XL_CAN_MAX_DATA_LEN];
+    for(auto _ : state)
+    {
+        copyPadded(frame, data.data(), length, 0x55);
+        benchmark::DoNotOptimize(frame);
+        benchmark::ClobberMemory();
+    }
+    state.SetItemsProcessed(static_cast<int64_t>(state.iterations()));
+}
+BENCHMARK(copyPaddedFd)->DenseRange(0, XL_CAN_MAX_DATA_LEN);
+
+/** @brief Byte-wise copy and padding of a CAN FD frame, the argument is the SDU length */
+void copyPaddedFdScalar(benchmark::State& state)
+{
+    const auto data = payload();
+    const auto length = static_cast<uint8>(state.range(0));
+    unsigned char frame[XL_CAN_MAX_DATA_LEN];
+    for(auto _ : state)
+    {
+        copyPaddedScalar(frame, data.data(), length, 0x55);
+        benchmark::DoNotOptimize(frame);
+        benchmark::ClobberMemory();
+    }
+    state.SetItemsProcessed(static_cast<int64_t>(state.iterations()));
+}
+BENCHMARK(copyPaddedFdScalar)->DenseRange(0, XL_CAN_MAX_DATA_LEN);
+
+void initToZeroCanTxEvent(benchmark::State& state)
+{
+    XLcanTxEvent event;
+    for(auto _ : state)
+    {
+        initToZero(event);
+        benchmark::DoNotOptimize(event);
+        benchmark::ClobberMemory();
+    }
+}
+BENCHMARK(initToZeroCanTxEvent);
+
+void initToZeroEvent(benchmark::State& state)
+{
+    XLevent event;
+    for(auto _ : state)
+    {
+        initToZero(event);
+        benchmark::DoNotOptimize(event);
+        benchmark::ClobberMemory();
+    }
+}
+BENCHMARK(initToZeroEvent);
+
+/** @brief What Can_XLdriver_Write does before xlCanTransmitEx, the argument is the SDU length */
+void buildCanFdTxEvent(benchmark::State& state)
+{
+    const auto data = payload();
+    const auto length = static_cast<uint8>(state.range(0));
+    XLcanTxEvent txEvent;
+    initToZero(txEvent);
+    txEvent.tag = XL_CAN_EV_TAG_TX_MSG;
+    txEvent.tagData.canMsg.msgFlags = XL_CAN_TXMSG_FLAG_EDL | XL_CAN_TXMSG_FLAG_BRS;
+    for(auto _ : state)
+    {
+        XLcanTxEvent canTxEvt;
+        std::memcpy(&canTxEvt, &txEvent, offsetof(XLcanTxEvent, tagData.canMsg.data));
+        canTxEvt.tagData.canMsg.canId = CanIds[1] & ~0x40000000u;
+        copyPadded(canTxEvt.tagData.canMsg.data, data.data(), length, 0x55);
+        canTxEvt.tagData.canMsg.dlc = CanData::getDLC(length);
+        benchmark::DoNotOptimize(canTxEvt);
+        benchmark::ClobberMemory();
+    }
+    state.SetItemsProcessed(static_cast<int64_t>(state.iterations()));
+}
+BENCHMARK(buildCanFdTxEvent)->Arg(8)->Arg(64);
+
+/** @brief What Can_XLdriver_Write does before xlCanTransmit */
+void buildClassicTxEvent(benchmark::State& state)
+{
+    const auto data = payload();
+    XLevent txEvent;
+    initToZero(txEvent);
+    txEvent.tag = XL_TRANSMIT_MSG;
+    for(auto _ : state)
+    {
+        XLevent xlEvent = txEvent;
+        xlEvent.tagData.msg.id = CanIds[0];
+        copyPadded(xlEvent.tagData.msg.data, data.data(), 8, 0x55);
+        xlEvent.tagData.msg.dlc = CanData::getDLC(8);
+        benchmark::DoNotOptimize(xlEvent);
+        benchmark::ClobberMemory();
+    }
+    state.SetItemsProcessed(static_cast<int64_t>(state.iterations()));
+}
+BENCHMARK(buildClassicTxEvent);
+
+/** @brief A frame of the stuffed length benchmarks */
+struct Frame
+{
+    bool extended;
+    bool fd;
+    bool brs;
+    uint32 id;
+    uint8 dlc;
+    std::array<uint8, XL_CAN_MAX_DATA_LEN> data;
+};
+
+/** @brief Linear congruential generator of the frame payloads, reproducible across runs */
+struct FrameRandom
+{
+    uint32 seed = 1;
+
+    uint32 operator()()
+    {
+        seed = seed * 1664525u + 1013904223u;
+        return seed;
+    }
+
+    void fill(Frame& frame)
+    {
+        for(auto& byte : frame.data)
+        {
+            byte = static_cast<uint8>((*this)() >> 24);
+        }
+    }
+};
+
+/**
+ * @brief 1024 frames of random identifiers and payloads, in a fixed order
+ * @param fd classic frames with a DLC up to 8, else CAN FD frames with a DLC from minDlc to maxDlc
+ */
+std::vector<Frame> randomFrames(bool fd, uint8 minDlc, uint8 maxDlc)
+{
+    std::vector<Frame> frames(1024);
+    FrameRandom random;
+    for(auto& frame : frames)
+    {
+        frame.extended = (random() >> 31) != 0;
+        frame.fd = fd;
+        frame.brs = fd && (random() >> 31) != 0;
+        frame.id = random() & (frame.extended ? 0x1FFFFFFFu : 0x7FFu);
+        frame.dlc = static_cast<uint8>(minDlc + (random() >> 24) % (maxDlc - minDlc + 1));
+        random.fill(frame);
+    }
+    return frames;
+}
+
+bool isSameFrame(const StuffedFrame& frame, const StuffedFrame& reference)
+{
+    return frame.bits.nominal == reference.bits.nominal && frame.bits.data == reference.bits.data &&
+           frame.crc == reference.crc && frame.stuffBits == reference.stuffBits;
+}
+
+/**
+ * @brief The tables give the frames of the bit-by-bit reference
+ * @details Every standard identifier with every DLC, classic and CAN FD with and without bitrate
+ *          switch, then 2^18 extended frames, all with random payloads. Checked once per run.
+ */
+bool isStuffedFrameExhaustive()
+{
+    static const bool equivalent = []() {
+        FrameRandom random;
+        Frame frame{};
+        const auto check = [&frame]() {
+            const auto fast = frame.fd ? fdFrame(frame.extended, frame.brs, false, frame.id, frame.dlc, frame.data.data())
+                                       : classicFrame(frame.extended, false, frame.id, frame.dlc, frame.data.data());
+            const auto reference = stuffedFrameReference(frame.extended, frame.fd, false, frame.brs, false, frame.id, frame.dlc, frame.data.data());
+            return isSameFrame(fast, reference);
+        };
+        for(uint32 id = 0; id <= 0x7FF; ++id)
+        {
+            for(uint8 dlc = 0; dlc < 16; ++dlc)
+            {
+                for(const auto kind : {0, 1, 2})
+                {
+                    frame = Frame{false, kind != 0, kind == 2, id, dlc, {}};
+                    random.fill(frame);
+                    if(!check())
+                    {
+                        return false;
+                    }
+                }
+            }
+        }
+        for(uint32 i = 0; i < (1u << 18); ++i)
+        {
+            frame = Frame{true, (i & 1) != 0, (i & 2) != 0, random() & 0x1FFFFFFFu, static_cast<uint8>(random() >> 28), {}};
+            random.fill(frame);
+            if(!check())
+            {
+                return false;
+            }
+        }
+        return true;
+    }();
+    return equivalent;
+}
+
+/** @brief Stuffed length and CRC of classic frames, as the RX path measures the bus load of a classic port */
+void classicFrameMix(benchmark::State& state)
+{
+    if(!isStuffedFrameExhaustive())
+    {
+        state.SkipWithError("the stuffed frames differ from stuffedFrameReference");
+        return;
+    }
+    const auto frames = randomFrames(false, 0, MAX_MSG_LEN);
+    std::size_t i = 0;
+    for(auto _ : state)
+    {
+        const auto& frame = frames[i++ & (frames.size() - 1)];
+        benchmark::DoNotOptimize(classicFrame(frame.extended, false, frame.id, frame.dlc, frame.data.data()));
+    }
+    state.SetItemsProcessed(static_cast<int64_t>(state.iterations()));
+}
+BENCHMARK(classicFrameMix);
+
+/** @brief Stuffed length and CRC of CAN FD frames, the arguments are the smallest and the largest DLC */
+void fdFrameMix(benchmark::State& state)
+{
+    if(!isStuffedFrameExhaustive())
+    {
+        state.SkipWithError("the stuffed frames differ from stuffedFrameReference");
+        return;
+    }
+    const auto frames = randomFrames(true, static_cast<uint8>(state.range(0)), static_cast<uint8>(state.range(1)));
+    std::size_t i = 0;
+    for(auto _ : state)
+    {
+        const auto& frame = frames[i++ & (frames.size() - 1)];
+        benchmark::DoNotOptimize(fdFrame(frame.extended, frame.brs, false, frame.id, frame.dlc, frame.data.data()));
+    }
+    state.SetItemsProcessed(static_cast<int64_t>(state.iterations()));
+}
+// CRC-17 payloads, CRC-21 payloads, 64 bytes only
+BENCHMARK(fdFrameMix)->Args({0, 10})->Args({11, 15})->Args({15, 15});
+
+/** @brief Bit-by-bit reference of the CAN FD frames, the arguments are the smallest and the largest DLC */
+void fdFrameReferenceMix(benchmark::State& state)
+{
+    const auto frames = randomFrames(true, static_cast<uint8>(state.range(0)), static_cast<uint8>(state.range(1)));
+    std::size_t i = 0;
+    for(auto _ : state)
+    {
+        const auto& frame = frames[i++ & (frames.size() - 1)];
+        benchmark::DoNotOptimize(stuffedFrameReference(frame.extended, true, false, frame.brs, false, frame.id, frame.dlc, frame.data.data()));
+    }
+    state.SetItemsProcessed(static_cast<int64_t>(state.iterations()));
+}
+BENCHMARK(fdFrameReferenceMix)->Args({0, 10})->Args({15, 15});
+
+/** @brief Frame of a PDU as Can_XLdriver_Write sends it, padding included, the argument is the SDU length */
+void stuffedFrameOfPdu(benchmark::State& state)
+{
+    auto data = payload();
+    const Can_PduType pdu{0x40000123, 0, static_cast<uint8>(state.range(0)), data.data()};
+    for(auto _ : state)
+    {
+        benchmark::DoNotOptimize(stuffedFrameOf(pdu, true, 0x55));
+    }
+    state.SetItemsProcessed(static_cast<int64_t>(state.iterations()));
+}
+BENCHMARK(stuffedFrameOfPdu)->Arg(8)->Arg(13)->Arg(64);
+}
+
+/**@} */ // END OF addtogroup bench_frame
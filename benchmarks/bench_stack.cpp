@@ -0,0 +1,158 @@
+/**
+ * @file bench_stack.cpp
+ * @author Maxime Verreault
+ * @date 2026-10-19
+ * @copyright COPYRIGHT(c) Maxime Verreault All rights reserved.
+ * @brief Benchmarks of the adapter and reference CanIf path with production-like PDU tables
+ * @details Linked with the canif_ref library instead of the counting CanIf of the other benchmarks,
+ *          the tables are sized by CANIF_REF_RX_PDUS and CANIF_REF_TX_PDUS at configure time.
+ * @ingroup Benchmarks
+ * @addtogroup bench_stack
+ * @{
+ */
+
+
+/*==================================================================================================
+*                                        INCLUDE FILES
+* 1) system and project includes
+* 2) needed interfaces from external units
+* 3) internal and external interfaces from this unit
+==================================================================================================*/
+#include <numeric>
+#include <vector>
+#include <benchmark/benchmark.h>
+#include "CanIf_Ref_Cfg.h"
+#include "xldriver.h"
+
+
+/*==================================================================================================
+*                                       DEFINES AND MACROS
+==================================================================================================*/
+#define BENCH_STACK_UNKNOWN_CAN_ID      0x9FFFFFFFu  // extended identifier never synthesized by tools/canif_ref_cfg.py
+
+
+/*==================================================================================================
+*                                       LOCAL FUNCTIONS
+==================================================================================================*/
+namespace
+{
+volatile uint64 g_StackRxIndications = 0;
+volatile uint64 g_StackTxConfirmations = 0;
+
+void stackRxIndication(PduIdType, const PduInfoType*)
+{
+    g_StackRxIndications = g_StackRxIndications + 1;
+}
+
+void stackTxConfirmation(PduIdType, Std_ReturnType)
+{
+    g_StackTxConfirmations = g_StackTxConfirmations + 1;
+}
+
+/** @brief Select the generated tables, every user counting its callbacks */
+void initStack()
+{
+    g_silent = 1;
+    CanIf_RefInit(&CanIf_RefConfig);
+    for(uint8 user = 0; user < CANIF_REF_MAX_USERS; ++user)
+    {
+        CanIf_RefSetUser(user, stackRxIndication, stackTxConfirmation);
+    }
+}
+
+XLcanRxEvent canFdEvent(unsigned short tag, unsigned int canId, unsigned char dlc)
+{
+    XLcanRxEvent event{};
+    event.tag = tag;
+    event.channelIndex = 0;
+    event.timeStampSync = 1000;
+    event.tagData.canRxOkMsg.canId = canId;
+    event.tagData.canRxOkMsg.dlc = dlc;
+    std::iota(std::begin(event.tagData.canRxOkMsg.data), std::end(event.tagData.canRxOkMsg.data), uint8{1});
+    return event;
+}
+
+/** @brief One 64 byte frame per RX PDU, in a shuffled order so the search does not hit the same path */
+std::vector<XLcanRxEvent> rxOkEvents()
+{
+    std::vector<XLcanRxEvent> events;
+    events.reserve(CANIF_REF_RX_PDU_COUNT);
+    for(uint32 i = 0; i < CANIF_REF_RX_PDU_COUNT; ++i)
+    {
+        /* odd stride, visits every PDU once when the table size is a power of two */
+        const auto& rxPdu = CanIf_RefConfig.RxPdus[(i * 2654435761u) % CANIF_REF_RX_PDU_COUNT];
+        events.push_back(canFdEvent(XL_CAN_EV_TAG_RX_OK, rxPdu.CanId, 15));
+    }
+    return events;
+}
+
+void stackRxIndicated(benchmark::State& state)
+{
+    initStack();
+    auto events = rxOkEvents();
+    std::size_t next = 0;
+    for(auto _ : state)
+    {
+        handleCanFdEvent(events[next]);
+        next = (next + 1 == events.size()) ? 0 : next + 1;
+    }
+    CanIf_RefStatisticsType statistics;
+    CanIf_RefGetStatistics(&statistics);
+    state.SetItemsProcessed(static_cast<int64_t>(state.iterations()));
+    state.counters["rxPdus"] = CANIF_REF_RX_PDU_COUNT;
+    state.counters["indicated"] = static_cast<double>(statistics.RxIndicated);
+}
+BENCHMARK(stackRxIndicated);
+
+void stackRxFiltered(benchmark::State& state)
+{
+    initStack();
+    auto event = canFdEvent(XL_CAN_EV_TAG_RX_OK, BENCH_STACK_UNKNOWN_CAN_ID, 8);
+    for(auto _ : state)
+    {
+        handleCanFdEvent(event);
+    }
+    CanIf_RefStatisticsType statistics;
+    CanIf_RefGetStatistics(&statistics);
+    state.SetItemsProcessed(static_cast<int64_t>(state.iterations()));
+    state.counters["filtered"] = static_cast<double>(statistics.RxFiltered);
+}
+BENCHMARK(stackRxFiltered);
+
+/** @brief Frames of a configured identifier without payload, rejected by the DLC check */
+void stackRxDlcFailed(benchmark::State& state)
+{
+    initStack();
+    auto event = canFdEvent(XL_CAN_EV_TAG_RX_OK, CanIf_RefConfig.RxPdus[0].CanId, 0);
+    for(auto _ : state)
+    {
+        handleCanFdEvent(event);
+    }
+    CanIf_RefStatisticsType statistics;
+    CanIf_RefGetStatistics(&statistics);
+    state.SetItemsProcessed(static_cast<int64_t>(state.iterations()));
+    state.counters["dlcFailed"] = static_cast<double>(statistics.RxDlcFailed);
+}
+BENCHMARK(stackRxDlcFailed);
+
+/** @brief Confirmations of every TX PDU, the adapter passes the identifier as the PDU handle */
+void stackTxConfirmed(benchmark::State& state)
+{
+    initStack();
+    auto event = canFdEvent(XL_CAN_EV_TAG_TX_OK, 0, 8);
+    uint32 pduId = 0;
+    for(auto _ : state)
+    {
+        event.tagData.canRxOkMsg.canId = pduId;
+        handleCanFdEvent(event);
+        pduId = (pduId + 1 == CANIF_REF_TX_PDU_COUNT) ? 0 : pduId + 1;
+    }
+    CanIf_RefStatisticsType statistics;
+    CanIf_RefGetStatistics(&statistics);
+    state.SetItemsProcessed(static_cast<int64_t>(state.iterations()));
+    state.counters["confirmed"] = static_cast<double>(statistics.TxConfirmed);
+}
+BENCHMARK(stackTxConfirmed);
+}
+
+/**@} */ // END OF addtogroup bench_stack
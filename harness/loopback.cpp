@@ -0,0 +1,619 @@
+/**
+ * @file loopback.cpp
+ * @author Maxime Verreault
+ * @date 2026-10-19
+ * @copyright COPYRIGHT(c) Maxime Verreault All rights reserved.
+ * @brief End-to-end loopback harness: throughput, loss and latency from Can_XLdriver_Write to the CanIf callbacks
+ * @details Producer threads write frames on the first channel, the other channels of the port
+ *          receive them back through the bus. Each write is matched to its CanIf_TxConfirmation
+ *          and to its CanIf_RxIndication on every receiving channel, recorded by the canif_trace stub.
+ *          With --switch-ms the channels are opened by Can_XLdriver_Init and the transmitting
+ *          controller switches its bitrate periodically while the producers write. With --tx-timeout-us
+ *          the transmitting controller supervises its confirmations, --noack-ms removes the simulated
+ *          acknowledge for a while and the TX statistics are checked once the run is drained.
+ *          The simulated bus delivers the frames at its bitrates, --unpaced at once like the Vector
+ *          virtual bus. A write refused with CAN_BUSY, transmit queue full, is retried.
+ * @ingroup Harness
+ * @addtogroup loopback
+ * @{
+ */
+
+
+/*==================================================================================================
+*                                        INCLUDE FILES
+* 1) system and project includes
+* 2) needed interfaces from external units
+* 3) internal and external interfaces from this unit
+==================================================================================================*/
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <bit>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <tuple>
+#include <vector>
+#include <boost/program_options.hpp>
+#include <fmt/format.h>
+#include "Can_XLdriver.h"
+#include "xldriver.h"
+#include "xlframe.h"
+#include <CanIf_Trace.h>
+#include "loopback_probe.h"
+#ifdef LOOPBACK_SIMULATED
+#include "xlsim.h"
+#endif
+
+
+namespace po = boost::program_options;
+
+
+/*==================================================================================================
+*                                      LOCAL CONSTANTS
+==================================================================================================*/
+namespace
+{
+constexpr std::array<const char*, 4> FrameTypeNames{"classic", "fd", "ext", "extfd"};
+constexpr std::array<double, 4> Percentiles{0.50, 0.90, 0.99, 0.999};
+constexpr std::array<Can_XLdriver_BaudrateConfigType, 2> SwitchBaudrates{{{500000, 2000000, 0, 0}, {500000, 5000000, 0, 0}}};
+constexpr Can_XLdriver_HthConfigType SwitchHth{0, CAN_XLDRIVER_ID_MIXED, 1, 0, 0, 1, 0x55};
+constexpr auto BusyRetryPeriod = std::chrono::microseconds(20);     // below the shortest frame of the paced bus
+
+
+/*==================================================================================================
+*                          LOCAL TYPEDEFS (STRUCTURES, UNIONS, ENUMS)
+==================================================================================================*/
+struct LoopbackSettings
+{
+    unsigned int producers{1};
+    unsigned int frames{10000};                 //!< frames per producer and per frame type
+    std::vector<uint8> frameTypes{FrameType::StandardCan, FrameType::StandardCanFd};
+    uint8 fdLength{64};
+    double rate{0.0};                           //!< frames per second per producer, 0 writes as fast as possible
+    std::chrono::milliseconds drainTimeout{2000};
+    std::chrono::milliseconds switchPeriod{0};  //!< bitrate switch period of the transmitting controller
+    uint32 txTimeout{0};                        //!< TxTimeout of the transmitting controller (us), 0 unsupervised
+    uint8 txTimeoutActions{CAN_XLDRIVER_TX_TIMEOUT_NOTIFY};
+    std::chrono::milliseconds noAckPeriod{0};   //!< time without acknowledge once the producers start
+};
+
+/**
+ * @brief Can driver configuration of the runs opened by Can_XLdriver_Init: one controller per channel,
+ *        every frame on HRH 0, the transmitting controller supervised by a TxTimeout
+ */
+struct SwitchConfig
+{
+    std::vector<Can_XLdriver_ControllerConfigType> controllers;
+    Can_XLdriver_ConfigType config{};
+
+    SwitchConfig(unsigned int channelCount, uint32 rxQueueSize, unsigned int busLoad, uint32 txTimeout, uint8 txTimeoutActions)
+    {
+        for(unsigned int channel = 0; channel < channelCount; ++channel)
+        {
+            controllers.push_back({static_cast<uint8>(channel), nullptr, nullptr, nullptr, 0, 0,
+                                   SwitchBaudrates.data(), static_cast<uint16>(SwitchBaudrates.size()), 0,
+                                   CAN_XLDRIVER_INTERRUPT, CAN_XLDRIVER_INTERRUPT, CAN_XLDRIVER_INTERRUPT, CAN_XLDRIVER_INTERRUPT,
+                                   nullptr, 0, channel == 0 ? txTimeout : 0, channel == 0 ? txTimeoutActions : uint8{0}});
+        }
+        config = {controllers.data(), &SwitchHth, nullptr, "xlCANloopback", rxQueueSize, static_cast<uint8>(busLoad),
+                  static_cast<uint8>(controllers.size()), 1, 0, 1, nullptr, nullptr};
+    }
+};
+
+/** @brief Durations of the bitrate switches */
+struct SwitchResults
+{
+    std::vector<sint64> durations{};
+    unsigned int refused{0};
+};
+
+/** @brief Results of one direction, channel and frame type */
+struct LoopbackRow
+{
+    bool transmit{false};
+    unsigned int channel{0};
+    uint8 frameType{0};
+    uint64 sent{0};
+    uint64 delivered{0};
+    std::vector<sint64> latencies{};
+};
+
+
+/*==================================================================================================
+*                                       LOCAL FUNCTIONS
+==================================================================================================*/
+void produce(const LoopbackSettings& settings, const std::vector<LoopbackStream*>& streams, LoopbackProbe::Clock::time_point start)
+{
+    std::array<uint8, 64> data{};
+    const auto period = settings.rate > 0.0 ? std::chrono::duration<double>(1.0 / settings.rate) : std::chrono::duration<double>::zero();
+    std::size_t writes = 0;
+    for(unsigned int i = 0; i < settings.frames; ++i)
+    {
+        for(auto* stream : streams)
+        {
+            if(period.count() > 0.0)
+            {
+                std::this_thread::sleep_until(start + std::chrono::duration_cast<LoopbackProbe::Clock::duration>(period * static_cast<double>(writes++)));
+            }
+            const auto frameType = FrameType(stream->canId);
+            const auto isFd = frameType == FrameType::StandardCanFd || frameType == FrameType::ExtendedCanFd;
+            const auto sequence = stream->written.load(std::memory_order_relaxed);
+            for(unsigned int b = 0; b < LOOPBACK_SEQUENCE_SIZE; ++b)
+            {
+                data[b] = static_cast<uint8>(sequence >> (8 * b));
+            }
+            // the stream index as PDU, for the confirmations of the supervised frames
+            const Can_PduType pduInfo{stream->canId, static_cast<PduIdType>(stream->canId & 0x7FF),
+                                      static_cast<uint8>(isFd ? settings.fdLength : 8), data.data()};
+
+            Std_ReturnType result = CAN_BUSY;
+            for(;;)
+            {
+                stream->sentAt[sequence] = LoopbackProbe::now();
+                result = Can_XLdriver_Write(0, &pduInfo);
+                if(result != CAN_BUSY)
+                {
+                    break;
+                }
+                stream->busy.fetch_add(1, std::memory_order_relaxed);
+                std::this_thread::sleep_for(BusyRetryPeriod);
+            }
+            if(result == E_OK)
+            {
+                stream->written.store(sequence + 1, std::memory_order_release);
+            }
+            else
+            {
+                stream->rejected.fetch_add(1, std::memory_order_relaxed);
+            }
+        }
+    }
+}
+
+void switchBaudrates(const LoopbackSettings& settings, const std::atomic<bool>& producing, SwitchResults& results)
+{
+    uint16 baudrate = 0;
+    while(producing.load(std::memory_order_relaxed))
+    {
+        std::this_thread::sleep_for(settings.switchPeriod);
+        baudrate = static_cast<uint16>((baudrate + 1) % SwitchBaudrates.size());
+        const auto start = LoopbackProbe::now();
+        if(Can_XLdriver_SetBaudrate(0, baudrate) == E_OK)
+        {
+            results.durations.push_back(static_cast<sint64>(LoopbackProbe::now() - start));
+        }
+        else
+        {
+            ++results.refused;
+        }
+    }
+}
+
+/**
+ * @brief Check the TX statistics of the supervised controller against the CanIf confirmations
+ * @details Every frame is confirmed, given up by its timeout or given up by a flush. A frame given up
+ *          without flush is transmitted once the acknowledge comes back, its confirmation is late and
+ *          is not handed to CanIf: the timeout reported its PDU already. A flush misses the frame
+ *          already on the bus, flushed frames may be confirmed late too.
+ */
+bool checkTxSupervision(const LoopbackSettings& settings)
+{
+    Can_XLdriver_TxStatisticsType statistics{};
+    if(Can_XLdriver_GetTxStatistics(0, &statistics) != E_OK)
+    {
+        fmt::print("- TX supervision   : no statistics\n");
+        return false;
+    }
+    const auto confirmations = CanIf_TraceGetKindCount(CANIF_TRACE_TX_CONFIRMATION);
+    const auto flushing = (settings.txTimeoutActions & CAN_XLDRIVER_TX_TIMEOUT_FLUSH) != 0;
+    const auto outage = settings.noAckPeriod > std::chrono::microseconds(settings.txTimeout);
+    fmt::print("- TX supervision   : {} supervised, {} confirmed, {} timeouts, {} late, {} flushes, {} flushed, {} busy, {} in flight\n",
+               statistics.Supervised, statistics.Confirmed, statistics.Timeouts, statistics.LateConfirmations,
+               statistics.Flushes, statistics.FlushedFrames, statistics.Busy, statistics.InFlight);
+    const std::array<std::tuple<const char*, bool>, 5> checks{{
+        {"every frame completed", statistics.InFlight == 0 &&
+                                  statistics.Supervised == statistics.Confirmed + statistics.Timeouts + statistics.FlushedFrames},
+        {"only the timely confirmations reached CanIf", confirmations == statistics.Confirmed},
+        {"timeouts during the outage", !outage || statistics.Timeouts > 0},
+        {"flushes after the timeouts", !flushing || statistics.Timeouts == 0 || statistics.Flushes > 0},
+        {"late confirmations of the frames given up", flushing ? statistics.LateConfirmations <= statistics.Timeouts + statistics.FlushedFrames
+                                                               : statistics.LateConfirmations == statistics.Timeouts},
+    }};
+    auto passed = true;
+    for(const auto& [name, result] : checks)
+    {
+        fmt::print("- TX check         : {:<44}{}\n", name, result ? "ok" : "FAILED");
+        passed = passed && result;
+    }
+    return passed;
+}
+
+bool drained(const LoopbackSettings& settings, XLaccess rxChannels)
+{
+    const auto receivers = static_cast<uint64>(std::popcount(static_cast<uint64>(rxChannels)));
+    Can_XLdriver_TxStatisticsType statistics{};
+    if(settings.txTimeout > 0 && Can_XLdriver_GetTxStatistics(0, &statistics) == E_OK)
+    {
+        // a frame given up is only received, and never when a flush removed it
+        const auto flushing = (settings.txTimeoutActions & CAN_XLDRIVER_TX_TIMEOUT_FLUSH) != 0;
+        return statistics.InFlight == 0 && (flushing || statistics.LateConfirmations >= statistics.Timeouts) &&
+               CanIf_TraceGetKindCount(CANIF_TRACE_RX_INDICATION) >= (statistics.Confirmed + statistics.LateConfirmations) * receivers;
+    }
+    uint64 written = 0;
+    for(const auto& stream : g_LoopbackProbe.streams())
+    {
+        written += stream->written.load(std::memory_order_relaxed);
+    }
+    return CanIf_TraceGetKindCount(CANIF_TRACE_TX_CONFIRMATION) >= written &&
+           CanIf_TraceGetKindCount(CANIF_TRACE_RX_INDICATION) >= written * receivers;
+}
+
+double percentile(const std::vector<sint64>& sorted, double fraction)
+{
+    if(sorted.empty())
+    {
+        return 0.0;
+    }
+    const auto index = std::min(sorted.size() - 1, static_cast<std::size_t>(fraction * static_cast<double>(sorted.size())));
+    return static_cast<double>(sorted[index]) / 1000.0;
+}
+
+std::vector<LoopbackRow> collect(unsigned int txChannel, XLaccess rxChannels)
+{
+    std::vector<LoopbackRow> rows;
+    const auto rowOf = [&rows](bool transmit, unsigned int channel, uint8 frameType) -> LoopbackRow& {
+        const auto found = std::ranges::find_if(rows, [&](const LoopbackRow& row) {
+            return row.transmit == transmit && row.channel == channel && row.frameType == frameType;
+        });
+        if(found != rows.end())
+        {
+            return *found;
+        }
+        return rows.emplace_back(LoopbackRow{transmit, channel, frameType});
+    };
+
+    for(const auto& stream : g_LoopbackProbe.streams())
+    {
+        const auto frameType = FrameType(stream->canId).selected;
+        const auto written = stream->written.load(std::memory_order_acquire);
+        auto& txRow = rowOf(true, txChannel, frameType);
+        txRow.sent += written;
+        txRow.delivered += stream->confirmed;
+        txRow.latencies.insert(txRow.latencies.end(), stream->txLatency.begin(), stream->txLatency.end());
+        for(unsigned int channel = 0; channel < stream->rxLatency.size(); ++channel)
+        {
+            if(channel == txChannel || !(rxChannels & (XLaccess{1} << channel)))
+            {
+                continue;
+            }
+            auto& rxRow = rowOf(false, channel, frameType);
+            rxRow.sent += written;
+            rxRow.delivered += stream->received[channel];
+            rxRow.latencies.insert(rxRow.latencies.end(), stream->rxLatency[channel].begin(), stream->rxLatency[channel].end());
+        }
+    }
+    for(auto& row : rows)
+    {
+        std::ranges::sort(row.latencies);
+    }
+    std::ranges::sort(rows, [](const LoopbackRow& a, const LoopbackRow& b) {
+        return std::tuple(!a.transmit, a.channel, a.frameType) < std::tuple(!b.transmit, b.channel, b.frameType);
+    });
+    return rows;
+}
+
+void report(const std::vector<LoopbackRow>& rows, double seconds)
+{
+    fmt::print("\n{:<4}{:>4} {:<8}{:>11}{:>11}{:>9}{:>8}{:>12}{:>10}{:>10}{:>10}{:>10}{:>10}\n",
+               "dir", "ch", "type", "sent", "done", "lost", "loss%", "frames/s", "p50 us", "p90 us", "p99 us", "p99.9 us", "max us");
+    for(const auto& row : rows)
+    {
+        const auto lost = row.sent - std::min(row.sent, row.delivered);
+        fmt::print("{:<4}{:>4} {:<8}{:>11}{:>11}{:>9}{:>8.2f}{:>12.0f}",
+                   row.transmit ? "tx" : "rx", row.channel, FrameTypeNames[row.frameType], row.sent, row.delivered, lost,
+                   row.sent > 0 ? 100.0 * static_cast<double>(lost) / static_cast<double>(row.sent) : 0.0,
+                   seconds > 0.0 ? static_cast<double>(row.delivered) / seconds : 0.0);
+        for(const auto fraction : Percentiles)
+        {
+            fmt::print("{:>10.1f}", percentile(row.latencies, fraction));
+        }
+        fmt::print("{:>10.1f}\n", row.latencies.empty() ? 0.0 : static_cast<double>(row.latencies.back()) / 1000.0);
+    }
+}
+
+bool parseFrameTypes(const std::string& list, std::vector<uint8>& frameTypes)
+{
+    frameTypes.clear();
+    std::stringstream stream(list);
+    std::string name;
+    while(std::getline(stream, name, ','))
+    {
+        const auto found = std::ranges::find(FrameTypeNames, name);
+        if(found == FrameTypeNames.end())
+        {
+            fmt::print("Unknown frame type \"{}\"\n", name);
+            return false;
+        }
+        frameTypes.push_back(static_cast<uint8>(std::distance(FrameTypeNames.begin(), found)));
+    }
+    return !frameTypes.empty();
+}
+}
+
+
+/*==================================================================================================
+*                                       GLOBAL FUNCTIONS
+==================================================================================================*/
+int main(int argc, char *argv[])
+{
+    LoopbackSettings settings;
+
+    po::options_description desc("Allowed options");
+    desc.add_options()
+            ("help", "produce help message")
+            ("producers", po::value<unsigned int>(), "number of threads calling Can_XLdriver_Write (default 1)")
+            ("frames", po::value<unsigned int>(), "frames written by each producer for each frame type (default 10000)")
+            ("types", po::value<std::string>(), "comma separated frame types among classic, fd, ext and extfd (default classic,fd)")
+            ("length", po::value<unsigned int>(), "payload length of the CAN FD frames, 4 to 64 bytes (default 64)")
+            ("rate", po::value<double>(), "frames per second written by each producer, unpaced by default")
+            ("channels", po::value<unsigned int>(), "number of simulated channels, 1 transmitting and the others receiving (default 2)")
+            ("rxwait", po::value<std::string>(), "RX thread wait strategy on an empty queue: spin, block or adaptive (default)")
+            ("spinbudget", po::value<unsigned int>(), "maximum spin time after the last received event (us)")
+            ("drain-ms", po::value<unsigned int>(), "time given to the last confirmations and receptions once the producers are done (default 2000)")
+            ("busload", po::value<unsigned int>(), "bus load (%) the XL receive queue is sized for, the default size otherwise")
+            ("switch-ms", po::value<unsigned int>(), "open the channels with Can_XLdriver_Init and switch the bitrate of the transmitting controller at this period")
+            ("tx-timeout-us", po::value<unsigned int>(), "open the channels with Can_XLdriver_Init and supervise the confirmations of the transmitting controller")
+            ("tx-flush", "flush the transmit queue after a TX timeout, besides the notification")
+            ("noack-ms", po::value<unsigned int>(), "simulated bus without acknowledge for this time once the producers start, the TX statistics are checked")
+            ("unpaced", "simulated bus delivering the frames at once instead of at its bitrates")
+            ;
+
+    po::variables_map vm;
+    po::store(po::parse_command_line(argc, argv, desc), vm);
+    po::notify(vm);
+
+    if (vm.count("help")) {
+        std::stringstream str{};
+        str << desc;
+        fmt::print("{}\n", str.str());
+        return 1;
+    }
+    if (vm.count("producers")) {
+        settings.producers = std::max(vm["producers"].as<unsigned int>(), 1u);
+    }
+    if (vm.count("frames")) {
+        settings.frames = vm["frames"].as<unsigned int>();
+    }
+    if (vm.count("types") && !parseFrameTypes(vm["types"].as<std::string>(), settings.frameTypes)) {
+        return 1;
+    }
+    if (vm.count("length")) {
+        settings.fdLength = static_cast<uint8>(std::clamp(vm["length"].as<unsigned int>(), LOOPBACK_SEQUENCE_SIZE, 64u));
+    }
+    if (vm.count("rate")) {
+        settings.rate = vm["rate"].as<double>();
+    }
+    if (vm.count("drain-ms")) {
+        settings.drainTimeout = std::chrono::milliseconds(vm["drain-ms"].as<unsigned int>());
+    }
+    if (vm.count("switch-ms")) {
+        settings.switchPeriod = std::chrono::milliseconds(std::max(vm["switch-ms"].as<unsigned int>(), 1u));
+    }
+    if (vm.count("tx-timeout-us")) {
+        settings.txTimeout = vm["tx-timeout-us"].as<unsigned int>();
+    }
+    if (vm.count("tx-flush")) {
+        settings.txTimeoutActions |= CAN_XLDRIVER_TX_TIMEOUT_FLUSH;
+    }
+    if (vm.count("noack-ms")) {
+#ifdef LOOPBACK_SIMULATED
+        settings.noAckPeriod = std::chrono::milliseconds(vm["noack-ms"].as<unsigned int>());
+#else
+        fmt::print("--noack-ms needs the simulated XL driver\n");
+        return 1;
+#endif
+    }
+    if (settings.noAckPeriod.count() > 0 && settings.txTimeout == 0) {
+        fmt::print("--noack-ms needs --tx-timeout-us\n");
+        return 1;
+    }
+    if (vm.count("rxwait")) {
+        const auto& mode = vm["rxwait"].as<std::string>();
+        if (mode == "spin") {
+            g_RxWaitMode = RxWaitMode::Spin;
+        } else if (mode == "block") {
+            g_RxWaitMode = RxWaitMode::Block;
+        } else if (mode != "adaptive") {
+            fmt::print("Unknown RX wait strategy \"{}\"\n", mode);
+            return 1;
+        }
+    }
+    if (vm.count("spinbudget")) {
+        g_RxSpinBudget = std::chrono::microseconds(vm["spinbudget"].as<unsigned int>());
+    }
+    if (vm.count("busload")) {
+        g_RxBusLoad = std::min(vm["busload"].as<unsigned int>(), 100u);
+    }
+    if (settings.producers * settings.frameTypes.size() > LOOPBACK_MAX_STREAMS) {
+        fmt::print("At most {} producers x frame types\n", LOOPBACK_MAX_STREAMS);
+        return 1;
+    }
+    const auto switching = settings.switchPeriod.count() > 0;
+    const auto initialized = switching || settings.txTimeout > 0;
+    const auto channels = vm.count("channels") ? vm["channels"].as<unsigned int>() : 2u;
+    uint32 rxQueueSize = 0;
+#ifdef LOOPBACK_SIMULATED
+    if (settings.noAckPeriod.count() > 0 && !vm.count("busload")) {
+        // the frames waiting for the acknowledge are confirmed and received together once it comes back,
+        // with room for as many written while the RX thread reads them
+        rxQueueSize = std::bit_ceil(2 * XLSIM_TX_QUEUE_SIZE * channels * XL_CANFD_MAX_EVENT_SIZE);
+    }
+#endif
+    const SwitchConfig switchConfig(channels, rxQueueSize, g_RxBusLoad, settings.txTimeout, settings.txTimeoutActions);
+#ifdef LOOPBACK_SIMULATED
+    xlSimSetChannelCount(vm.count("channels") ? vm["channels"].as<unsigned int>() : XLSIM_DEFAULT_CHANNEL_COUNT);
+    xlSimSetBusTiming(vm.count("unpaced") ? 0 : 1);
+#else
+    if (vm.count("unpaced")) {
+        fmt::print("--unpaced needs the simulated XL driver\n");
+        return 1;
+    }
+#endif
+
+    g_silent = 1;
+    g_AppName = "xlCANloopback";
+    unsigned int txChannel = 0;
+    XLstatus xlStatus = XL_SUCCESS;
+    if (initialized) {
+        // Can_XLdriver_Init opens the port and starts the RX thread, the controllers are started below
+        Can_XLdriver_Init(&switchConfig.config);
+        xlStatus = Can_XLdriver_SetBaudrate(0, 0) == E_OK ? XL_SUCCESS : XL_ERROR;
+    } else {
+        xlStatus = demoInitDriver(xlChanMaskTx, txChannel);
+    }
+    fmt::print("- Init             : {}\n", xlGetErrorString(xlStatus));
+    if (XL_SUCCESS != xlStatus) {
+        return 1;
+    }
+    const auto rxChannels = g_xlChannelMask & ~xlChanMaskTx;
+    const auto channelCount = static_cast<std::size_t>(std::bit_width(static_cast<uint64>(g_xlChannelMask)));
+    if (rxChannels == 0) {
+        fmt::print("- Loopback         : no receiving channel, only the confirmations are measured\n");
+    }
+
+    std::vector<std::vector<LoopbackStream*>> producerStreams(settings.producers);
+    for (unsigned int producer = 0; producer < settings.producers; ++producer) {
+        for (std::size_t type = 0; type < settings.frameTypes.size(); ++type) {
+            const auto index = static_cast<Can_IdType>(producer * settings.frameTypes.size() + type);
+            const auto canId = (LOOPBACK_FIRST_CAN_ID + index) | (static_cast<Can_IdType>(settings.frameTypes[type]) << 30);
+            producerStreams[producer].push_back(&g_LoopbackProbe.addStream(canId, settings.frames, channelCount));
+        }
+    }
+
+    // the mode indications of the started controllers are traced too
+    const auto traceCapacity = static_cast<uint64>(settings.frames) * settings.producers * settings.frameTypes.size() *
+                               (1u + static_cast<unsigned int>(std::popcount(static_cast<uint64>(rxChannels)))) + 2u * channelCount;
+    if (traceCapacity > UINT32_MAX || CanIf_TraceInit(static_cast<uint32>(traceCapacity), LoopbackProbe::now) != E_OK) {
+        fmt::print("- Loopback         : cannot allocate a CanIf trace of {} entries\n", traceCapacity);
+        return 1;
+    }
+
+    if (initialized) {
+        for (uint8 controller = 0; controller < switchConfig.config.ControllerCount && XL_SUCCESS == xlStatus; ++controller) {
+            xlStatus = Can_XLdriver_SetControllerMode(controller, CAN_CS_STARTED) == E_OK ? XL_SUCCESS : XL_ERROR;
+        }
+    } else {
+        xlStatus = demoCreateRxThread();
+        if (XL_SUCCESS == xlStatus) {
+            xlStatus = xlActivateChannel(g_xlPortHandle, g_xlChannelMask, XL_BUS_TYPE_CAN, XL_ACTIVATE_RESET_CLOCK);
+        }
+    }
+    fmt::print("- Start            : {} producers, {} frames each per frame type, TX CM={:#X}, RX CM={:#X}, {}\n",
+               settings.producers, settings.frames, xlChanMaskTx, rxChannels, xlGetErrorString(xlStatus));
+    if (XL_SUCCESS != xlStatus) {
+        demoStopRxThread();
+        return 1;
+    }
+
+    const auto start = LoopbackProbe::Clock::now();
+    const auto startTime = LoopbackProbe::now();
+    std::atomic<bool> producing{true};
+    SwitchResults switchResults;
+    std::thread switcher;
+    if (switching) {
+        switcher = std::thread(switchBaudrates, std::cref(settings), std::cref(producing), std::ref(switchResults));
+    }
+    std::vector<std::thread> producers;
+#ifdef LOOPBACK_SIMULATED
+    if (settings.noAckPeriod.count() > 0) {
+        xlSimSetAcknowledge(0);
+    }
+#endif
+    for (const auto& streams : producerStreams) {
+        producers.emplace_back(produce, std::cref(settings), std::cref(streams), start);
+    }
+#ifdef LOOPBACK_SIMULATED
+    if (settings.noAckPeriod.count() > 0) {
+        // the frames still waiting are transmitted in order, those given up already confirmed late
+        std::this_thread::sleep_until(start + settings.noAckPeriod);
+        xlSimSetAcknowledge(1);
+    }
+#endif
+    for (auto& producer : producers) {
+        producer.join();
+    }
+    const auto writeTime = LoopbackProbe::now() - startTime;
+    producing = false;
+    if (switcher.joinable()) {
+        switcher.join();
+    }
+
+    const auto drainDeadline = LoopbackProbe::Clock::now() + settings.drainTimeout;
+    while (!drained(settings, rxChannels) && LoopbackProbe::Clock::now() < drainDeadline) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+    // read before Can_XLdriver_DeInit, the RX thread stopped: no confirmation comes meanwhile
+    auto txChecked = true;
+    if (settings.txTimeout > 0) {
+        demoStopRxThread();
+        txChecked = checkTxSupervision(settings);
+    }
+    if (initialized) {
+        for (uint8 controller = 0; controller < switchConfig.config.ControllerCount; ++controller) {
+            Can_XLdriver_SetControllerMode(controller, CAN_CS_STOPPED);
+        }
+        Can_XLdriver_DeInit();
+    } else {
+        demoStopRxThread();
+        xlDeactivateChannel(g_xlPortHandle, g_xlChannelMask);
+        xlClosePort(g_xlPortHandle);
+        xlCloseDriver();
+    }
+    g_LoopbackProbe.match();
+
+    auto lastEventAt = startTime;
+    uint64 rejected = 0;
+    uint64 busy = 0;
+    for (const auto& stream : g_LoopbackProbe.streams()) {
+        lastEventAt = std::max(lastEventAt, stream->lastEventAt);
+        rejected += stream->rejected.load(std::memory_order_relaxed);
+        busy += stream->busy.load(std::memory_order_relaxed);
+    }
+    const auto seconds = static_cast<double>(lastEventAt - startTime) / 1e9;
+    fmt::print("- Done             : writes {:.3f}s, last callback {:.3f}s, {} writes rejected, {} busy retries, {} callbacks unmatched, {} dropped by the trace\n",
+               static_cast<double>(writeTime) / 1e9, seconds, rejected, busy, g_LoopbackProbe.unmatched(), CanIf_TraceGetDropped());
+    uint64 overflows = 0;
+    for (const auto& channelOverflows : g_RxQueueStatistics.overflows) {
+        overflows += channelOverflows.load(std::memory_order_relaxed);
+    }
+    fmt::print("- RX queue         : size {}, high water {} events, {} overflows flagged\n",
+               g_RxQueueStatistics.size, g_RxQueueStatistics.highWater.load(std::memory_order_relaxed), overflows);
+    for (unsigned int channel = 0; channel < channelCount; ++channel) {
+        if (g_xlChannelMask & (XLaccess{1} << channel)) {
+            const auto load = g_BusLoad.snapshot(channel);
+            fmt::print("- Bus load         : channel {}, current {:.1f}%, average {:.1f}%, peak {:.1f}%\n",
+                       channel, load.current, load.average, load.peak);
+            g_IdStatistics.forEach(channel, [channel](const IdStatistics& statistics) {
+                fmt::print("- Cycle            : channel {}, ID {:#X}, {} frames, period {:.1f}us, jitter {:.1f}us, min {:.1f}us, max {:.1f}us, {} missed\n",
+                           channel, statistics.id, statistics.count, statistics.meanPeriod / 1000.0, std::sqrt(statistics.periodVariance) / 1000.0,
+                           static_cast<double>(statistics.minPeriod) / 1000.0, static_cast<double>(statistics.maxPeriod) / 1000.0, statistics.missedCycles);
+            });
+        }
+    }
+    if (switching) {
+        auto& durations = switchResults.durations;
+        std::ranges::sort(durations);
+        fmt::print("- Baudrate switch  : {} switches, {} refused, p50 {:.1f}us, p99 {:.1f}us, max {:.1f}us\n",
+                   durations.size(), switchResults.refused, percentile(durations, 0.50), percentile(durations, 0.99),
+                   durations.empty() ? 0.0 : static_cast<double>(durations.back()) / 1000.0);
+    }
+    report(collect(txChannel, rxChannels), seconds);
+    CanIf_TraceDeInit();
+    return txChecked ? 0 : 1;
+}
+
+/**@} */ // END OF addtogroup loopback
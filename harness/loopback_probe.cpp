@@ -0,0 +1,94 @@
+/**
+ * @file loopback_probe.cpp
+ * @author Maxime Verreault
+ * @date 2026-10-19
+ * @copyright COPYRIGHT(c) Maxime Verreault All rights reserved.
+ * @brief Matching of the CanIf trace of the loopback harness to the writes that caused each callback
+ * @ingroup Harness
+ * @addtogroup loopback_probe
+ * @{
+ */
+
+
+/*==================================================================================================
+*                                        INCLUDE FILES
+* 1) system and project includes
+* 2) needed interfaces from external units
+* 3) internal and external interfaces from this unit
+==================================================================================================*/
+#include <algorithm>
+#include <CanIf_Trace.h>
+#include "loopback_probe.h"
+
+
+/*==================================================================================================
+*                                      GLOBAL VARIABLES
+==================================================================================================*/
+LoopbackProbe g_LoopbackProbe;
+
+
+/*==================================================================================================
+*                                       GLOBAL FUNCTIONS
+==================================================================================================*/
+LoopbackStream& LoopbackProbe::addStream(Can_IdType canId, std::size_t frames, std::size_t channels)
+{
+    auto& stream = *allStreams.emplace_back(std::make_unique<LoopbackStream>());
+    stream.canId = canId;
+    stream.sentAt.resize(frames);
+    stream.received.resize(channels);
+    stream.rxLatency.resize(channels);
+    streamOfId[canId & 0x7FF] = &stream;
+    return stream;
+}
+
+LoopbackStream* LoopbackProbe::find(uint32 canId) const
+{
+    /* the driver may report the identifier with the XL extended flag, the stream index is in the low bits */
+    const auto index = canId & 0x7FF;
+    return index < streamOfId.size() ? streamOfId[index] : nullptr;
+}
+
+void LoopbackProbe::match()
+{
+    const auto* entries = CanIf_TraceGetEntries();
+    const auto count = CanIf_TraceGetCount();
+    for(uint32 i = 0; i < count; ++i)
+    {
+        const auto& entry = entries[i];
+        if(entry.Kind == CANIF_TRACE_TX_CONFIRMATION)
+        {
+            auto* stream = find(entry.PduId);
+            if(stream == nullptr || stream->confirmed >= stream->written.load(std::memory_order_acquire))
+            {
+                ++unmatchedCallbacks;
+                continue;
+            }
+            stream->txLatency.push_back(static_cast<sint64>(entry.TimeStamp - stream->sentAt[stream->confirmed++]));
+            stream->lastEventAt = std::max(stream->lastEventAt, entry.TimeStamp);
+        }
+        else if(entry.Kind == CANIF_TRACE_RX_INDICATION)
+        {
+            auto* stream = find(entry.CanId);
+            if(stream == nullptr || entry.Length < LOOPBACK_SEQUENCE_SIZE || entry.ControllerId >= stream->rxLatency.size())
+            {
+                ++unmatchedCallbacks;
+                continue;
+            }
+            uint32 sequence = 0;
+            for(auto b = LOOPBACK_SEQUENCE_SIZE; b > 0; --b)
+            {
+                sequence = (sequence << 8) | entry.Data[b - 1];
+            }
+            if(sequence >= stream->written.load(std::memory_order_acquire))
+            {
+                ++unmatchedCallbacks;
+                continue;
+            }
+            stream->rxLatency[entry.ControllerId].push_back(static_cast<sint64>(entry.TimeStamp - stream->sentAt[sequence]));
+            ++stream->received[entry.ControllerId];
+            stream->lastEventAt = std::max(stream->lastEventAt, entry.TimeStamp);
+        }
+    }
+}
+
+/**@} */ // END OF addtogroup loopback_probe
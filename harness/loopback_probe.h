@@ -0,0 +1,112 @@
+/**
+ * @file loopback_probe.h
+ * @author Maxime Verreault
+ * @date 2026-10-19
+ * @copyright COPYRIGHT(c) Maxime Verreault All rights reserved.
+ * @brief Matching of the CanIf trace of the loopback harness to the writes that caused each callback
+ * @ingroup Harness
+ * @addtogroup loopback_probe
+ * @{
+ */
+
+
+#ifndef LOOPBACK_PROBE_H
+#define LOOPBACK_PROBE_H
+
+/*==================================================================================================
+*                                         INCLUDE FILES
+* 1) system and project includes
+* 2) needed interfaces from external units
+* 3) internal and external interfaces from this unit
+==================================================================================================*/
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <memory>
+#include <vector>
+#include <ComStack_Types.h>
+#include <Can_GeneralTypes.h>
+
+
+/*==================================================================================================
+*                                       DEFINES AND MACROS
+==================================================================================================*/
+#define LOOPBACK_FIRST_CAN_ID      0x100u   // CAN identifier of the first stream, one identifier per stream
+#define LOOPBACK_MAX_STREAMS       0x700u   // streams fit in the standard identifiers above LOOPBACK_FIRST_CAN_ID
+#define LOOPBACK_SEQUENCE_SIZE     4u       // payload bytes carrying the sequence number of a frame
+
+
+/*==================================================================================================
+*                                STRUCTURES AND OTHER TYPEDEFS
+==================================================================================================*/
+/**
+ * @brief Frames of one CAN identifier written by one producer thread
+ * @details The producer stores the write time of a frame at its sequence number before calling
+ *          Can_XLdriver_Write. Confirmations only carry the PDU, the stream index written as PDU
+ *          handle: the n-th confirmation of a stream matches its n-th accepted write, frames of one
+ *          identifier leave the controller in order. Once a confirmation is lost to a receive queue
+ *          overrun the following ones are matched to older writes, latencies are only exact for runs
+ *          without loss. Receptions carry the sequence number in the first payload bytes.
+ */
+struct LoopbackStream
+{
+    Can_IdType canId{0};                                //!< identifier handed to Can_XLdriver_Write, frame type bits included
+    std::vector<uint64> sentAt{};                       //!< write time of each accepted frame (ns), indexed by sequence number
+    std::atomic<uint32> written{0};                     //!< frames accepted by Can_XLdriver_Write
+    std::atomic<uint32> rejected{0};                    //!< frames refused by Can_XLdriver_Write
+    std::atomic<uint32> busy{0};                        //!< writes refused with CAN_BUSY and retried
+    uint32 confirmed{0};                                //!< CanIf_TxConfirmation calls
+    std::vector<sint64> txLatency{};                    //!< write to confirmation latencies (ns)
+    std::vector<uint32> received{};                     //!< CanIf_RxIndication calls per receiving channel
+    std::vector<std::vector<sint64>> rxLatency{};       //!< write to reception latencies (ns) per receiving channel
+    uint64 lastEventAt{0};                              //!< time of the last callback of the stream (ns)
+};
+
+/**
+ * @brief Writes of the harness and their matching with the CanIf trace
+ * @details The CanIf callbacks are recorded by the canif_trace stub, on the clock of the probe,
+ *          and only matched to the writes once the RX thread is stopped: the measured path holds no
+ *          harness code.
+ */
+class LoopbackProbe
+{
+public:
+    using Clock = std::chrono::steady_clock;
+
+    /**
+     * @brief Add a stream and preallocate its storage
+     * @param canId identifier with the frame type bits, the stream index selects its 11 bit value
+     * @param frames maximum number of frames the producer writes
+     * @param channels number of channels the frames can be received on
+     */
+    LoopbackStream& addStream(Can_IdType canId, std::size_t frames, std::size_t channels);
+
+    /** @brief Match the recorded callbacks to the writes, the callbacks must be stopped */
+    void match();
+
+    [[nodiscard]] const std::vector<std::unique_ptr<LoopbackStream>>& streams() const { return allStreams; }
+    [[nodiscard]] uint32 unmatched() const { return unmatchedCallbacks; }
+
+    /** @brief Nanoseconds of the steady clock, the time base of the writes and of the CanIf trace */
+    static uint64 now()
+    {
+        return static_cast<uint64>(std::chrono::duration_cast<std::chrono::nanoseconds>(Clock::now().time_since_epoch()).count());
+    }
+
+private:
+    std::vector<std::unique_ptr<LoopbackStream>> allStreams{};
+    std::array<LoopbackStream*, LOOPBACK_FIRST_CAN_ID + LOOPBACK_MAX_STREAMS> streamOfId{};
+    uint32 unmatchedCallbacks{0};
+
+    [[nodiscard]] LoopbackStream* find(uint32 canId) const;
+};
+
+
+/*==================================================================================================
+*                                GLOBAL VARIABLE DECLARATIONS
+==================================================================================================*/
+extern LoopbackProbe g_LoopbackProbe;
+
+#endif //LOOPBACK_PROBE_H
+
+/**@} */ // END OF addtogroup loopback_probe
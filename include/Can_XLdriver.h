@@ -23,6 +23,7 @@ extern "C" {
 * 2) needed interfaces from external units
 * 3) internal and external interfaces from this unit
 ==================================================================================================*/
+#include <ComStack_Types.h>
 #include <Can_GeneralTypes.h>
 
 /*==================================================================================================
@@ -73,6 +74,11 @@ extern "C" {
 /*==================================================================================================
 *                                       DEFINES AND MACROS
 ==================================================================================================*/
+#define CAN_XLDRIVER_MAX_CONTROLLERS 64u /**<@brief one controller per XL channel, XL_CONFIG_MAX_CHANNELS */
+#define CAN_XLDRIVER_STANDARD_IDS 0x800u /**<@brief entries of Can_XLdriver_ControllerConfigType::StandardIdHrhs */
+#define CAN_XLDRIVER_NO_HRH 0xFFFFu /**<@brief identifier accepted by no HRH, the frame is dropped like a hardware filter does */
+#define CAN_XLDRIVER_TX_TIMEOUT_NOTIFY 0x01u /**<@brief TxTimeoutActions: each frame given up is reported to TxTimeoutNotification */
+#define CAN_XLDRIVER_TX_TIMEOUT_FLUSH 0x02u /**<@brief TxTimeoutActions: a timeout flushes the transmit queue, its frames are given up too */
 
 
 /*==================================================================================================
@@ -83,11 +89,180 @@ extern "C" {
 /*==================================================================================================
 *                                             ENUMS
 ==================================================================================================*/
+/**
+ * @brief How the events of a controller reach CanIf, CanRxProcessing/CanTxProcessing like
+ */
+typedef enum
+{
+    CAN_XLDRIVER_INTERRUPT = 0U,    /**< @brief CanIf is called by the RX thread as soon as the event is received */
+    CAN_XLDRIVER_POLLING            /**< @brief CanIf is called by the matching Can_XLdriver_MainFunction_<...> */
+} Can_XLdriver_ProcessingType;
+
+/**
+ * @brief Identifiers handled by a hardware object, CanIdType like
+ */
+typedef enum
+{
+    CAN_XLDRIVER_ID_STANDARD = 0U,  /**< @brief 11 bit identifiers only */
+    CAN_XLDRIVER_ID_EXTENDED,       /**< @brief 29 bit identifiers only */
+    CAN_XLDRIVER_ID_MIXED           /**< @brief both */
+} Can_XLdriver_IdType;
 
 
 /*==================================================================================================
 *                                STRUCTURES AND OTHER TYPEDEFS
 ==================================================================================================*/
+/** @brief One selectable bitrate of a controller, CanControllerBaudrateConfig like */
+typedef struct
+{
+    uint32 BaudRate;                /**< @brief nominal bitrate (bit/s) */
+    uint32 FdBaudRate;              /**< @brief data bitrate (bit/s) of CAN FD frames, 0 for a classic CAN configuration */
+    uint16 SamplePoint;             /**< @brief nominal sample point (per mille), 0 for the default 875 */
+    uint16 FdSamplePoint;           /**< @brief data phase sample point (per mille), 0 for the default 750 */
+} Can_XLdriver_BaudrateConfigType;
+
+/** @brief One FULL extended HRH, sorted by CanId inside the range of its controller */
+typedef struct
+{
+    Can_IdType CanId;               /**< @brief 29 bit identifier, without the extended flag */
+    Can_HwHandleType Hrh;           /**< @brief HRH receiving the identifier */
+} Can_XLdriver_HrhIdType;
+
+/** @brief Longest time between two receptions of a cyclic identifier, see Can_XLdriver_GetRxDeadlineStatistics */
+typedef struct
+{
+    Can_IdType CanId;               /**< @brief identifier, the most significant bit set for an extended one, the CAN FD flag is ignored */
+    uint32 Timeout;                 /**< @brief us, a multiple of the cycle time */
+} Can_XLdriver_RxDeadlineType;
+
+/** @brief Called with each missed deadline of a controller, from the thread reading the XL receive queue */
+typedef void (*Can_XLdriver_RxTimeoutNotificationType)(uint8 Controller, Can_IdType CanId);
+
+/** @brief Called with each transmitted frame given up without confirmation, from the thread reading the XL receive queue */
+typedef void (*Can_XLdriver_TxTimeoutNotificationType)(uint8 Controller, Can_IdType CanId, PduIdType PduId);
+
+/**
+ * @brief One CAN controller, mapped on one XL channel of the port
+ * @details The HRH of a received identifier is resolved through static tables only: a direct table
+ *          for the standard identifiers, then a binary search of the FULL extended HRHs and the
+ *          filters of the BASIC extended ones. Without StandardIdHrhs every frame is received on HRH 0.
+ */
+typedef struct
+{
+    uint8 ChannelIndex;                                     /**< @brief XL channel index of the controller */
+    const Can_HwHandleType* StandardIdHrhs;                 /**< @brief HRH of each standard identifier, CAN_XLDRIVER_NO_HRH when filtered */
+    const Can_XLdriver_HrhIdType* ExtendedIdHrhs;           /**< @brief FULL extended HRHs, sorted by CanId */
+    const Can_HwHandleType* BasicExtendedHrhs;              /**< @brief BASIC extended HRHs, tried in order after the FULL ones */
+    uint16 ExtendedIdHrhCount;                              /**< @brief number of ExtendedIdHrhs */
+    uint16 BasicExtendedHrhCount;                           /**< @brief number of BasicExtendedHrhs */
+    const Can_XLdriver_BaudrateConfigType* BaudrateConfigs; /**< @brief configurations selected by Can_XLdriver_SetBaudrate */
+    uint16 BaudrateConfigCount;                             /**< @brief number of BaudrateConfigs */
+    uint16 DefaultBaudrateConfigId;                         /**< @brief configuration applied by Can_XLdriver_Init */
+    Can_XLdriver_ProcessingType RxProcessing;               /**< @brief receptions, Can_XLdriver_MainFunction_Read */
+    Can_XLdriver_ProcessingType TxProcessing;               /**< @brief transmit confirmations, Can_XLdriver_MainFunction_Write */
+    Can_XLdriver_ProcessingType BusOffProcessing;           /**< @brief bus-off indications, Can_XLdriver_MainFunction_BusOff */
+    Can_XLdriver_ProcessingType ModeProcessing;             /**< @brief mode indications, Can_XLdriver_MainFunction_Mode */
+    const Can_XLdriver_RxDeadlineType* RxDeadlines;         /**< @brief cyclic identifiers monitored while the controller is started */
+    uint16 RxDeadlineCount;                                 /**< @brief number of RxDeadlines */
+    uint32 TxTimeout;                                       /**< @brief longest wait for a transmit confirmation (us), 0 leaves the frames unsupervised */
+    uint8 TxTimeoutActions;                                 /**< @brief CAN_XLDRIVER_TX_TIMEOUT_NOTIFY, CAN_XLDRIVER_TX_TIMEOUT_FLUSH, the timeouts are always counted */
+} Can_XLdriver_ControllerConfigType;
+
+/**
+ * @brief One hardware transmit object, the Hth of Can_XLdriver_Write
+ * @details The XL flags and the transmission path of each frame kind are selected once by
+ *          Can_XLdriver_Init. On a CAN FD port every frame, classic ones included, is transmitted
+ *          with xlCanTransmitEx.
+ */
+typedef struct
+{
+    uint8 ControllerId;             /**< @brief controller transmitting the frames of the HTH */
+    Can_XLdriver_IdType IdType;     /**< @brief identifiers transmitted, STANDARD and EXTENDED refuse a PDU of the other type */
+    uint8 FdBrs;                    /**< @brief CAN FD frames switch to the data bitrate, 0 keeps the nominal one */
+    uint8 Rtr;                      /**< @brief classic CAN frames are remote frames */
+    uint8 HighPriority;             /**< @brief frames overtake the transmit queue (CAN FD ports only) */
+    uint8 MinimalDlc;               /**< @brief smallest DLC covering the PDU, 0 transmits full-length frames (8 or 64 bytes) */
+    uint8 PaddingValue;             /**< @brief bytes between the PDU and the DLC length, CanFdPaddingValue like */
+} Can_XLdriver_HthConfigType;
+
+/** @brief One hardware receive object, the Hoh given to CanIf_RxIndication */
+typedef struct
+{
+    uint8 ControllerId;             /**< @brief controller receiving the frames of the HRH */
+    Can_XLdriver_IdType IdType;     /**< @brief identifiers received */
+    Can_IdType FilterCode;          /**< @brief identifiers accepted when (CanId & FilterMask) == FilterCode */
+    Can_IdType FilterMask;          /**< @brief all identifier bits for a FULL object */
+} Can_XLdriver_HrhConfigType;
+
+/** @brief Configuration given to Can_XLdriver_Init, it must outlive the driver */
+typedef struct
+{
+    const Can_XLdriver_ControllerConfigType* Controllers;   /**< @brief controllers, indexed by ControllerId */
+    const Can_XLdriver_HthConfigType* Hths;                 /**< @brief HTHs, indexed by Hth */
+    const Can_XLdriver_HrhConfigType* Hrhs;                 /**< @brief HRHs, indexed by Hoh */
+    const char* AppName;                                    /**< @brief application name of the XL port, NULL keeps the default */
+    uint32 RxQueueSize;                                     /**< @brief XL receive queue size given to xlOpenPort, 0 keeps the default */
+    uint8 RxBusLoad;                                        /**< @brief bus load (%) sizing the XL receive queue when RxQueueSize is 0, 0 keeps the default */
+    uint8 ControllerCount;                                  /**< @brief number of Controllers, at most CAN_XLDRIVER_MAX_CONTROLLERS */
+    uint16 HthCount;                                        /**< @brief number of Hths */
+    uint16 HrhCount;                                        /**< @brief number of Hrhs */
+    uint16 PollingQueueSize;                                /**< @brief events kept per polled controller between two main functions */
+    Can_XLdriver_RxTimeoutNotificationType RxTimeoutNotification; /**< @brief missed deadlines, NULL only counts them */
+    Can_XLdriver_TxTimeoutNotificationType TxTimeoutNotification; /**< @brief frames given up, NULL only counts them */
+} Can_XLdriver_ConfigType;
+
+/** @brief Losses on the receive path of one controller, see Can_XLdriver_GetRxStatistics */
+typedef struct
+{
+    uint64 QueueOverflows;      /**< @brief events flagged by the XL driver after it lost events, on the channel of the controller */
+    uint64 PollingQueueDrops;   /**< @brief receptions and confirmations dropped by a full polling queue */
+    uint32 QueueHighWater;      /**< @brief most events seen waiting in the XL receive queue, all channels of the port */
+    uint32 QueueSize;           /**< @brief XL receive queue size, bytes on a CAN FD port, else events */
+} Can_XLdriver_RxStatisticsType;
+
+/** @brief Load of the bus of one controller (%), see Can_XLdriver_GetBusLoad */
+typedef struct
+{
+    float32 Current;            /**< @brief last completed 100 ms */
+    float32 Average;            /**< @brief last completed second */
+    float32 Peak;               /**< @brief busiest completed 100 ms since Can_XLdriver_Init */
+} Can_XLdriver_BusLoadType;
+
+/** @brief Cycle of one identifier on the bus of a controller, see Can_XLdriver_GetIdStatistics */
+typedef struct
+{
+    Can_IdType CanId;           /**< @brief identifier, the most significant bit set for an extended one */
+    uint64 Count;               /**< @brief frames received or confirmed */
+    uint64 LastTimeStamp;       /**< @brief timestamp of the last frame (ns, XL driver clock) */
+    uint64 MinPeriod;           /**< @brief shortest period (ns), 0 before the second frame */
+    uint64 MaxPeriod;           /**< @brief longest period (ns), gaps included */
+    float64 MeanPeriod;         /**< @brief mean period (ns), gaps excluded */
+    float64 PeriodStdDev;       /**< @brief jitter: standard deviation of the period (ns), gaps excluded */
+    uint64 MissedCycles;        /**< @brief cycles missing in the periods longer than 1.5 mean periods */
+} Can_XLdriver_IdStatisticsType;
+
+/** @brief Missed deadlines of one identifier of a controller, see Can_XLdriver_GetRxDeadlineStatistics */
+typedef struct
+{
+    Can_IdType CanId;           /**< @brief identifier, the most significant bit set for an extended one */
+    uint32 Timeout;             /**< @brief configured timeout (us) */
+    uint64 Timeouts;            /**< @brief deadlines missed, one per timeout without a reception */
+    uint64 Recoveries;          /**< @brief receptions after a missed deadline */
+    uint8 TimedOut;             /**< @brief no reception since the last missed deadline */
+} Can_XLdriver_RxDeadlineStatisticsType;
+
+/** @brief Confirmations of the frames transmitted by a controller, see Can_XLdriver_GetTxStatistics */
+typedef struct
+{
+    uint64 Supervised;          /**< @brief frames accepted by the XL driver */
+    uint64 Confirmed;           /**< @brief frames confirmed before their timeout */
+    uint64 Timeouts;            /**< @brief frames given up without confirmation after TxTimeout */
+    uint64 LateConfirmations;   /**< @brief confirmations of a frame given up already */
+    uint64 Flushes;             /**< @brief transmit queue flushes after a timeout */
+    uint64 FlushedFrames;       /**< @brief other frames in flight given up by the flushes */
+    uint64 Busy;                /**< @brief writes refused with CAN_BUSY, too many frames in flight */
+    uint64 InFlight;            /**< @brief frames waiting for their confirmation */
+} Can_XLdriver_TxStatisticsType;
 
 
 /*==================================================================================================
@@ -98,10 +273,106 @@ extern "C" {
 /*==================================================================================================
 *                                     FUNCTION PROTOTYPES
 ==================================================================================================*/
+/**
+ * @brief Open the XL port on the channels of the controllers and apply their default bitrate
+ * @details The controllers are left in CAN_CS_STOPPED. The RX thread is only started when a
+ *          controller processes receptions, confirmations or bus-off events as interrupts: a fully
+ *          polled configuration reads the XL receive queue from the main functions, which must then
+ *          all be called from the same task.
+ */
+void Can_XLdriver_Init(const Can_XLdriver_ConfigType* Config);
+
+/** @brief Stop the RX thread and close the XL port, refused while a controller is started */
+void Can_XLdriver_DeInit(void);
+
+/**
+ * @brief Select one of the bitrate configurations of a controller
+ * @details Beyond AUTOSAR, a started controller is switched in place: its channel is deactivated,
+ *          reconfigured and activated again on the same port, without mode indication. The frames
+ *          on the bus during the switch are lost. Selecting the applied configuration does nothing.
+ * @return E_OK, or E_NOT_OK for an unknown configuration, a sleeping controller or a bitrate refused by the driver
+ */
+Std_ReturnType Can_XLdriver_SetBaudrate(uint8 Controller, uint16 BaudRateConfigID);
+
+/** @brief Transmit confirmations of the polled controllers */
+void Can_XLdriver_MainFunction_Write(void);
+
+/** @brief Receptions of the polled controllers */
+void Can_XLdriver_MainFunction_Read(void);
+
+/** @brief Bus-off indications of the polled controllers */
+void Can_XLdriver_MainFunction_BusOff(void);
+
+/** @brief Wake-up detection, the XL channels report no wake-up event */
+void Can_XLdriver_MainFunction_Wakeup(void);
+
+/** @brief Mode indications of the polled controllers */
+void Can_XLdriver_MainFunction_Mode(void);
+
+void Can_XLdriver_GetVersionInfo(Std_VersionInfoType* versioninfo);
+
 Std_ReturnType Can_XLdriver_GetControllerErrorState(uint8 ControllerId, Can_ErrorStateType* ErrorStatePtr);
 Std_ReturnType Can_XLdriver_GetControllerRxErrorCounter(uint8 ControllerId, uint8* RxErrorCounterPtr);
 Std_ReturnType Can_XLdriver_GetControllerTxErrorCounter(uint8 ControllerId, uint8* TxErrorCounterPtr);
 Std_ReturnType Can_XLdriver_SetControllerMode(uint8 Controller, Can_ControllerStateType Transition);
+Std_ReturnType Can_XLdriver_Write(Can_HwHandleType Hth, const Can_PduType* PduInfo);
+
+/**
+ * @brief Losses and fill level of the receive path of a controller since Can_XLdriver_Init
+ * @details An event flagged by the driver stands for one or more lost events. The high water is
+ *          sampled by the thread reading the XL queue: after each wait, then every few events.
+ * @return E_OK, or E_NOT_OK for an unknown controller
+ */
+Std_ReturnType Can_XLdriver_GetRxStatistics(uint8 Controller, Can_XLdriver_RxStatisticsType* Statistics);
+
+/**
+ * @brief Load of the bus of a controller, from the frames, confirmations and error frames of its channel
+ * @details The bus time of each frame comes from the bit count of the driver when it reports one,
+ *          else from the identifier and payload with their stuff bits. The clock is
+ *          the newest event timestamp of the port: the load of an idle port is not updated.
+ * @return E_OK, or E_NOT_OK for an unknown controller
+ */
+Std_ReturnType Can_XLdriver_GetBusLoad(uint8 Controller, Can_XLdriver_BusLoadType* BusLoad);
+
+/**
+ * @brief Count, cycle time, jitter and gaps of an identifier on the bus of a controller since Can_XLdriver_Init
+ * @details The receptions and transmit confirmations of every identifier of the channel are timed
+ *          by the thread reading the XL queue, the mean and jitter are online and exclude the gaps.
+ *          The CAN FD flag of CanId is ignored.
+ * @return E_OK, or E_NOT_OK for an unknown controller or an identifier without a frame
+ */
+Std_ReturnType Can_XLdriver_GetIdStatistics(uint8 Controller, Can_IdType CanId, Can_XLdriver_IdStatisticsType* Statistics);
+
+/**
+ * @brief Statistics of every identifier seen on the bus of a controller, standard then extended
+ * @param Count in: entries of Statistics, out: entries written
+ * @return E_OK, or E_NOT_OK for an unknown controller or more identifiers than entries, the first ones being written
+ */
+Std_ReturnType Can_XLdriver_GetAllIdStatistics(uint8 Controller, Can_XLdriver_IdStatisticsType* Statistics, uint32* Count);
+
+/**
+ * @brief Missed deadlines of a monitored identifier of a controller since Can_XLdriver_Init
+ * @details Each reception re-arms the deadline of its identifier one timeout later in a timing
+ *          wheel: the cost of a frame does not grow with the number of monitored identifiers. The
+ *          deadlines are armed by the first event of the port and checked, on a silent bus, each time
+ *          the XL receive queue is found empty, at about 1 ms resolution. A missed deadline is
+ *          counted and notified once per timeout while the controller is started, the next reception
+ *          recovers it. The CAN FD flag of CanId is ignored.
+ * @return E_OK, or E_NOT_OK for an unknown controller or an identifier without deadline
+ */
+Std_ReturnType Can_XLdriver_GetRxDeadlineStatistics(uint8 Controller, Can_IdType CanId, Can_XLdriver_RxDeadlineStatisticsType* Statistics);
+
+/**
+ * @brief Transmit confirmations and timeouts of a controller since Can_XLdriver_Init
+ * @details Each frame written on a controller with a TxTimeout is kept in flight, at most 256, with a
+ *          timer of a timing wheel until its confirmation: a further write returns CAN_BUSY. A frame
+ *          unconfirmed after TxTimeout (no node acknowledging it, bus-off) is given up, counted and
+ *          handled by the TxTimeoutActions, at about 1 ms resolution of the host clock. A confirmation
+ *          matches the oldest frame in flight of its identifier, it is only counted once the frame is
+ *          given up: the PDU was reported by TxTimeoutNotification and is not confirmed to CanIf.
+ * @return E_OK, or E_NOT_OK for an unknown controller or a controller without TxTimeout
+ */
+Std_ReturnType Can_XLdriver_GetTxStatistics(uint8 Controller, Can_XLdriver_TxStatisticsType* Statistics);
 
 
 #ifdef __cplusplus
@@ -0,0 +1,1139 @@
+/**
+ * @file Can_XLdriver.cpp
+ * @author Maxime Verreault
+ * @date 2026-10-19
+ * @copyright COPYRIGHT(c) Maxime Verreault All rights reserved.
+ * @brief AUTOSAR Can driver API on top of the XL driver, with interrupt or polling processing per controller
+ * @ingroup xldriver
+ * @addtogroup Can_XLdriver
+ * @{
+ */
+
+
+/*==================================================================================================
+*                                        INCLUDE FILES
+* 1) system and project includes
+* 2) needed interfaces from external units
+* 3) internal and external interfaces from this unit
+==================================================================================================*/
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <bit>
+#include <chrono>
+#include <cmath>
+#include <cstddef>
+#include <cstring>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+#include <fmt/format.h>
+#include <CanIf_Can.h>
+#include "Can_XLdriver.h"
+#include "xlbittiming.h"
+#include "xlframe.h"
+#include "xlring.h"
+#include "xldriver.h"
+
+
+/*==================================================================================================
+*                                       LOCAL MACROS
+==================================================================================================*/
+#define CAN_XLDRIVER_NO_CONTROLLER  0xFFu    // channel without controller, its events are dropped
+#define CAN_XLDRIVER_CHIP_STATE_MS  100u     // longest wait for the chip state event after its request
+
+
+/*==================================================================================================
+*                          LOCAL TYPEDEFS (STRUCTURES, UNIONS, ENUMS)
+==================================================================================================*/
+namespace
+{
+/** @brief Reception kept for Can_XLdriver_MainFunction_Read */
+struct CanRxFrame
+{
+    Can_IdType canId{0};
+    Can_HwHandleType hrh{0};
+    uint8 length{0};
+    std::array<uint8, 64> data{};
+};
+
+/**
+ * @brief Runtime state of one controller
+ * @details The queues are filled by the thread reading the XL receive queue and drained by the main
+ *          functions. A full queue drops the event, PollingQueueSize must cover the events of one
+ *          main function period.
+ */
+struct CanController
+{
+    const Can_XLdriver_ControllerConfigType* config{nullptr};
+    XLaccess channelMask{0};
+    std::atomic<Can_ControllerStateType> state{CAN_CS_UNINIT};
+    std::atomic<bool> busOffPending{false};
+    std::atomic<bool> modeIndicationPending{false};
+    std::unique_ptr<SpscRing<CanRxFrame>> rxQueue{};
+    std::unique_ptr<SpscRing<PduIdType>> txQueue{};
+    std::unique_ptr<XLcanFdConf[]> fdConfigs{};     //!< built once per baudrate configuration by Can_XLdriver_Init
+    uint16 baudrateConfigId{0};                     //!< configuration applied on the channel
+    std::atomic<uint64> queueDrops{0};              //!< events dropped by a full rxQueue or txQueue
+};
+
+
+struct CanTxHth;
+
+/** @brief Transmission of one frame kind, specialized at compile time */
+using CanTxPath = Std_ReturnType (*)(const CanTxHth& hth, const Can_PduType& pdu);
+
+/** @brief XL transmit API of the open port */
+enum class CanTxBackend
+{
+    CanFd,      //!< xlCanTransmitEx, every frame kind
+    Classic     //!< xlCanTransmit, classic CAN frames only
+};
+
+/**
+ * @brief Transmission settings of one HTH, derived once from its configuration
+ * @details The XL events are pre-built with the tag and flags of each frame kind, the hot path of
+ *          Can_XLdriver_Write only patches the identifier, the DLC and the payload of a copy.
+ */
+struct CanTxHth
+{
+    std::array<CanTxPath, 2> paths{};           //!< classic and CAN FD frames, indexed by the CAN FD bit of Can_IdType
+    XLaccess channelMask{0};
+    unsigned int channelIndex{0};               //!< first channel of channelMask, the one of the TX timeouts
+    std::array<XLcanTxEvent, 2> txEvents{};     //!< xlCanTransmitEx events of the classic and CAN FD frames
+    XLevent legacyTxEvent{};                    //!< xlCanTransmit event of the classic CAN frames on a classic CAN port
+    uint8 paddingValue{0x55};
+    bool minimalDlc{true};
+};
+
+
+/*==================================================================================================
+*                                      LOCAL VARIABLES
+==================================================================================================*/
+const Can_XLdriver_ConfigType* g_CanConfig = nullptr;                       //!< configuration of Can_XLdriver_Init, nullptr before
+std::array<CanController, CAN_XLDRIVER_MAX_CONTROLLERS> g_CanControllers;   //!< indexed by ControllerId
+std::array<uint8, XL_CONFIG_MAX_CHANNELS> g_CanControllerOfChannel{};       //!< ControllerId of each XL channel index
+bool g_CanPollDriverQueue = false;                                          //!< no RX thread, the main functions read the XL queue
+std::vector<CanTxHth> g_CanTxHths;                                          //!< indexed by Hth
+CanTxHth g_CanDefaultTxHth;                                                 //!< HTH of Can_XLdriver_Write without a configuration, set by demoInitDriver
+
+
+/*==================================================================================================
+*                                       LOCAL FUNCTIONS
+==================================================================================================*/
+CanController* controllerOfChannel(unsigned int channelIndex)
+{
+    if(channelIndex >= g_CanControllerOfChannel.size() || g_CanControllerOfChannel[channelIndex] == CAN_XLDRIVER_NO_CONTROLLER)
+    {
+        return nullptr;
+    }
+    return &g_CanControllers[g_CanControllerOfChannel[channelIndex]];
+}
+
+uint8 controllerIdOf(const CanController& controller)
+{
+    return static_cast<uint8>(&controller - g_CanControllers.data());
+}
+
+XLaccess channelMaskOf(uint8 controllerId)
+{
+    if(g_CanConfig == nullptr)
+    {
+        return XLaccess{1} << controllerId;
+    }
+    return controllerId < g_CanConfig->ControllerCount ? g_CanControllers[controllerId].channelMask : 0;
+}
+
+/** @brief HRH of a received identifier, as the acceptance filters of the controller would select it */
+Can_HwHandleType hrhOf(const Can_XLdriver_ControllerConfigType& config, Can_IdType canId)
+{
+    if(config.StandardIdHrhs == nullptr)
+    {
+        return 0U;
+    }
+    if(!(canId & XL_CAN_EXT_MSG_ID))
+    {
+        return config.StandardIdHrhs[canId & (CAN_XLDRIVER_STANDARD_IDS - 1)];
+    }
+    const auto id = canId & ~XL_CAN_EXT_MSG_ID;
+    const auto* last = config.ExtendedIdHrhs + config.ExtendedIdHrhCount;
+    const auto* full = std::lower_bound(config.ExtendedIdHrhs, last, id, [](const Can_XLdriver_HrhIdType& hrhId, Can_IdType value) {
+        return hrhId.CanId < value;
+    });
+    if(full != last && full->CanId == id)
+    {
+        return full->Hrh;
+    }
+    for(uint16 i = 0; i < config.BasicExtendedHrhCount; ++i)
+    {
+        const auto& basic = g_CanConfig->Hrhs[config.BasicExtendedHrhs[i]];
+        if((id & basic.FilterMask) == basic.FilterCode)
+        {
+            return config.BasicExtendedHrhs[i];
+        }
+    }
+    return CAN_XLDRIVER_NO_HRH;
+}
+
+void indicateRx(uint8 controllerId, Can_HwHandleType hrh, Can_IdType canId, const uint8* data, uint8 length)
+{
+    Can_HwType mailbox{
+            canId,
+            hrh,
+            controllerId
+    };
+    PduInfoType pduInfo{const_cast<uint8*>(data), nullptr, length};
+    CanIf_RxIndication(&mailbox, &pduInfo);
+}
+
+/** @brief Read the XL receive queue when no RX thread does, every event lands in the queue of its main function */
+void pollDriverQueue()
+{
+    if(g_CanPollDriverQueue)
+    {
+        pollEvents(g_CanConfig->PollingQueueSize);
+    }
+}
+
+bool isPolled(Can_XLdriver_ProcessingType processing)
+{
+    return processing == CAN_XLDRIVER_POLLING;
+}
+
+/** @brief Payload of a PDU in an XL frame, the whole frame beyond the SDU is padded */
+template<bool Fd, std::size_t Capacity>
+uint8 fillPayload(const CanTxHth& hth, const Can_PduType& pdu, unsigned char (&data)[Capacity])
+{
+    constexpr uint8 maxLength = Fd ? XL_CAN_MAX_DATA_LEN : 8;
+    const auto length = std::min(pdu.length, maxLength);
+    copyPadded(data, pdu.sdu, length, hth.paddingValue);
+    return hth.minimalDlc ? CanData::getDLC(length) : static_cast<uint8>(Fd ? 15 : 8);
+}
+
+/** @brief Identifier type of a PDU matches the one of its HTH, a STANDARD HTH also refuses identifiers beyond 11 bits */
+template<Can_XLdriver_IdType IdType>
+constexpr bool isIdTypeOf(Can_IdType id)
+{
+    if constexpr(IdType == CAN_XLDRIVER_ID_STANDARD)
+    {
+        return (id & ~0x40000000u) < CAN_XLDRIVER_STANDARD_IDS;
+    }
+    else if constexpr(IdType == CAN_XLDRIVER_ID_EXTENDED)
+    {
+        return (id & XL_CAN_EXT_MSG_ID) != 0;
+    }
+    else
+    {
+        return true;
+    }
+}
+
+/** @brief XL identifier of a PDU accepted by isIdTypeOf */
+template<Can_XLdriver_IdType IdType>
+constexpr unsigned int xlIdOf(Can_IdType id)
+{
+    if constexpr(IdType == CAN_XLDRIVER_ID_STANDARD)
+    {
+        return id & (CAN_XLDRIVER_STANDARD_IDS - 1);
+    }
+    else if constexpr(IdType == CAN_XLDRIVER_ID_EXTENDED)
+    {
+        return (id & 0x1FFFFFFFu) | XL_CAN_EXT_MSG_ID;
+    }
+    else
+    {
+        // the extended flag of Can_IdType is XL_CAN_EXT_MSG_ID, only the CAN FD flag is dropped
+        return id & ~0x40000000u;
+    }
+}
+
+Std_ReturnType writeResultOf(XLstatus xlStatus)
+{
+    switch(xlStatus)
+    {
+        case XL_SUCCESS:
+            return E_OK;
+        case XL_ERR_QUEUE_IS_FULL:
+            return CAN_BUSY;
+        default:
+            return E_NOT_OK;
+    }
+}
+
+/** @brief XL transmission of one frame kind on one backend, without a branch on the frame kind */
+template<CanTxBackend Backend, Can_XLdriver_IdType IdType, bool Fd>
+Std_ReturnType transmitFrame(const CanTxHth& hth, const Can_PduType& pdu)
+{
+    if constexpr(Backend == CanTxBackend::CanFd)
+    {
+        XLcanTxEvent canTxEvt;
+        unsigned int cntSent;
+
+        // the header of the HTH, the whole data is written by fillPayload
+        std::memcpy(&canTxEvt, &hth.txEvents[Fd], offsetof(XLcanTxEvent, tagData.canMsg.data));
+        canTxEvt.tagData.canMsg.canId = xlIdOf<IdType>(pdu.id);
+        canTxEvt.tagData.canMsg.dlc = fillPayload<Fd>(hth, pdu, canTxEvt.tagData.canMsg.data);
+
+        return writeResultOf(xlCanTransmitEx(g_xlPortHandle, hth.channelMask, 1, &cntSent, &canTxEvt));
+    }
+    else if constexpr(!Fd)
+    {
+        XLevent xlEvent = hth.legacyTxEvent;
+        unsigned int messageCount = 1;
+
+        xlEvent.tagData.msg.id      = xlIdOf<IdType>(pdu.id);
+        xlEvent.tagData.msg.dlc     = fillPayload<false>(hth, pdu, xlEvent.tagData.msg.data);
+
+        return writeResultOf(xlCanTransmit(g_xlPortHandle, hth.channelMask, &messageCount, &xlEvent));
+    }
+    else
+    {
+        // no CAN FD frame on a classic CAN port
+        (void) hth;
+        (void) pdu;
+        return E_NOT_OK;
+    }
+}
+
+/** @brief Can_XLdriver_Write of one frame kind on one backend, in flight until its confirmation on a supervised channel */
+template<CanTxBackend Backend, Can_XLdriver_IdType IdType, bool Fd>
+Std_ReturnType transmit(const CanTxHth& hth, const Can_PduType& pdu)
+{
+    if(!isIdTypeOf<IdType>(pdu.id)) [[unlikely]]
+    {
+        return E_NOT_OK;
+    }
+    const auto position = g_TxSupervisor.onWrite(hth.channelIndex, xlIdOf<IdType>(pdu.id), pdu.swPduHandle);
+    if(position == TxSupervisor::Busy) [[unlikely]]
+    {
+        return CAN_BUSY;
+    }
+    const auto result = transmitFrame<Backend, IdType, Fd>(hth, pdu);
+    if(result != E_OK && position != TxSupervisor::Unsupervised) [[unlikely]]
+    {
+        g_TxSupervisor.onWriteFailed(hth.channelIndex, position);
+    }
+    return result;
+}
+
+template<CanTxBackend Backend, Can_XLdriver_IdType IdType>
+constexpr std::array<CanTxPath, 2> CanTxPathsOf{transmit<Backend, IdType, false>, transmit<Backend, IdType, true>};
+
+/** @brief Transmission paths of each backend and identifier type */
+constexpr std::array<std::array<std::array<CanTxPath, 2>, 3>, 2> CanTxPaths{{
+    {{CanTxPathsOf<CanTxBackend::CanFd, CAN_XLDRIVER_ID_STANDARD>, CanTxPathsOf<CanTxBackend::CanFd, CAN_XLDRIVER_ID_EXTENDED>,
+      CanTxPathsOf<CanTxBackend::CanFd, CAN_XLDRIVER_ID_MIXED>}},
+    {{CanTxPathsOf<CanTxBackend::Classic, CAN_XLDRIVER_ID_STANDARD>, CanTxPathsOf<CanTxBackend::Classic, CAN_XLDRIVER_ID_EXTENDED>,
+      CanTxPathsOf<CanTxBackend::Classic, CAN_XLDRIVER_ID_MIXED>}},
+}};
+
+const std::array<CanTxPath, 2>& txPathsOf(Can_XLdriver_IdType idType)
+{
+    const auto backend = g_canFdSupport ? CanTxBackend::CanFd : CanTxBackend::Classic;
+    return CanTxPaths[static_cast<std::size_t>(backend)][std::min<std::size_t>(idType, CAN_XLDRIVER_ID_MIXED)];
+}
+
+/** @brief XL events of an HTH, everything but the identifier, the DLC and the payload */
+CanTxHth txHthOf(const Can_XLdriver_HthConfigType& hth, XLaccess channelMask)
+{
+    CanTxHth txHth;
+    const unsigned int highPriority = hth.HighPriority ? XL_CAN_TXMSG_FLAG_HIGHPRIO : 0u;
+
+    // the port is open, its backend and the identifier type of the HTH fix the paths
+    txHth.paths = txPathsOf(hth.IdType);
+    txHth.channelMask = channelMask;
+    txHth.channelIndex = static_cast<unsigned int>(std::countr_zero(channelMask));
+    for(auto& txEvent : txHth.txEvents)
+    {
+        initToZero(txEvent);
+        txEvent.tag = XL_CAN_EV_TAG_TX_MSG;
+    }
+    // a remote frame has no CAN FD format, the RTR flag only applies to the classic frames
+    txHth.txEvents[0].tagData.canMsg.msgFlags = (hth.Rtr ? XL_CAN_TXMSG_FLAG_RTR : 0u) | highPriority;
+    txHth.txEvents[1].tagData.canMsg.msgFlags = XL_CAN_TXMSG_FLAG_EDL | (hth.FdBrs ? XL_CAN_TXMSG_FLAG_BRS : 0u) | highPriority;
+    initToZero(txHth.legacyTxEvent);
+    txHth.legacyTxEvent.tag = XL_TRANSMIT_MSG;
+    txHth.legacyTxEvent.tagData.msg.flags = hth.Rtr ? XL_CAN_MSG_FLAG_REMOTE_FRAME : 0u;
+    txHth.paddingValue = hth.PaddingValue;
+    txHth.minimalDlc = hth.MinimalDlc != 0;
+    return txHth;
+}
+
+Std_ReturnType applyBaudrate(CanController& controller, uint16 baudRateConfigId)
+{
+    XLstatus xlStatus;
+
+    if(!(controller.channelMask & g_xlPermissionMask))
+    {
+        return E_NOT_OK;
+    }
+    // the configurations were validated against the channels by Can_XLdriver_Init, only the XL call remains
+    if(g_canFdSupport)
+    {
+        xlStatus = xlCanFdSetConfiguration(g_xlPortHandle, controller.channelMask, &controller.fdConfigs[baudRateConfigId]);
+    }
+    else
+    {
+        xlStatus = xlCanSetChannelBitrate(g_xlPortHandle, controller.channelMask, controller.config->BaudrateConfigs[baudRateConfigId].BaudRate);
+    }
+    if(xlStatus != XL_SUCCESS)
+    {
+        return E_NOT_OK;
+    }
+    controller.baudrateConfigId = baudRateConfigId;
+    const auto& baudrate = controller.config->BaudrateConfigs[baudRateConfigId];
+    setBusLoadBitRates(controller.channelMask, baudrate.BaudRate, g_canFdSupport && baudrate.FdBaudRate != 0 ? baudrate.FdBaudRate : baudrate.BaudRate);
+    return E_OK;
+}
+
+/**
+ * @brief Switch the bitrate of a started controller without reopening the port
+ * @details The channel is only taken off the bus for the reconfiguration: the frames on the bus or
+ *          written meanwhile are lost, the XL queues and the controller state are kept.
+ */
+Std_ReturnType switchBaudrate(CanController& controller, uint16 baudRateConfigId)
+{
+    if(xlDeactivateChannel(g_xlPortHandle, controller.channelMask) != XL_SUCCESS)
+    {
+        return E_NOT_OK;
+    }
+    const auto result = applyBaudrate(controller, baudRateConfigId);
+    // back on the bus even when refused, with the previous configuration
+    if(xlActivateChannel(g_xlPortHandle, controller.channelMask, XL_BUS_TYPE_CAN, XL_ACTIVATE_NONE) != XL_SUCCESS)
+    {
+        controller.state = CAN_CS_STOPPED;
+        return E_NOT_OK;
+    }
+    return result;
+}
+
+/** @brief Check the configuration against the opened port, before any controller is set up */
+bool isConfigValid(const Can_XLdriver_ConfigType& config)
+{
+    XLaccess used = 0;
+    if(config.ControllerCount == 0 || config.ControllerCount > CAN_XLDRIVER_MAX_CONTROLLERS || config.PollingQueueSize == 0 ||
+       !isBitTimingSolvable(config))
+    {
+        return false;
+    }
+    for(uint8 id = 0; id < config.ControllerCount; ++id)
+    {
+        const auto& controller = config.Controllers[id];
+        const auto channelMask = controller.ChannelIndex < XL_CONFIG_MAX_CHANNELS ? XLaccess{1} << controller.ChannelIndex : 0;
+        if(!(channelMask & g_xlChannelMask) || (channelMask & used) ||
+           controller.DefaultBaudrateConfigId >= controller.BaudrateConfigCount)
+        {
+            return false;
+        }
+        // a classic CAN port cannot switch to an FD configuration later on
+        if(!g_canFdSupport && std::any_of(controller.BaudrateConfigs, controller.BaudrateConfigs + controller.BaudrateConfigCount,
+                                          [](const Can_XLdriver_BaudrateConfigType& baudrate) { return baudrate.FdBaudRate != 0; }))
+        {
+            return false;
+        }
+        used |= channelMask;
+    }
+    return std::all_of(config.Hths, config.Hths + config.HthCount, [&config](const Can_XLdriver_HthConfigType& hth) {
+        return hth.ControllerId < config.ControllerCount;
+    }) && std::all_of(config.Hrhs, config.Hrhs + config.HrhCount, [&config](const Can_XLdriver_HrhConfigType& hrh) {
+        return hrh.ControllerId < config.ControllerCount;
+    });
+}
+
+void resetControllers()
+{
+    for(auto& controller : g_CanControllers)
+    {
+        controller.config = nullptr;
+        controller.channelMask = 0;
+        controller.state = CAN_CS_UNINIT;
+        controller.busOffPending = false;
+        controller.modeIndicationPending = false;
+        controller.rxQueue.reset();
+        controller.txQueue.reset();
+        controller.fdConfigs.reset();
+        controller.baudrateConfigId = 0;
+        controller.queueDrops = 0;
+    }
+    g_CanControllerOfChannel.fill(CAN_XLDRIVER_NO_CONTROLLER);
+    g_CanTxHths.clear();
+}
+
+void closeDriver()
+{
+    xlClosePort(g_xlPortHandle);
+    xlCloseDriver();
+    g_xlPortHandle = XL_INVALID_PORTHANDLE;
+}
+
+/**
+ * @brief Request the chip state of a controller and wait for its event
+ * @details Without an RX thread the caller reads the XL queue itself, as the main functions do,
+ *          the other events read meanwhile land in the queues of their main functions.
+ * @return false when the controller is unknown or its chip state did not come in time
+ */
+bool requestChipState(uint8 controllerId, s_xl_chip_state& chipState)
+{
+    const auto channelMask = channelMaskOf(controllerId);
+    if(channelMask == 0)
+    {
+        return false;
+    }
+    const auto channel = static_cast<std::size_t>(std::countr_zero(channelMask));
+    std::unique_lock lock(g_ChipStates.mutex);
+    const auto sequence = g_ChipStates.sequence[channel];
+    lock.unlock();
+    if(xlCanRequestChipState(g_xlPortHandle, channelMask) != XL_SUCCESS)
+    {
+        return false;
+    }
+    const auto received = [&] { return g_ChipStates.sequence[channel] != sequence; };
+    const auto deadline = std::chrono::steady_clock::now() + std::chrono::milliseconds(CAN_XLDRIVER_CHIP_STATE_MS);
+    lock.lock();
+    if(g_CanPollDriverQueue)
+    {
+        while(!received())
+        {
+            lock.unlock();
+            if(std::chrono::steady_clock::now() >= deadline)
+            {
+                return false;
+            }
+            if(pollEvents(g_CanConfig->PollingQueueSize) == 0)
+            {
+                std::this_thread::yield();
+            }
+            lock.lock();
+        }
+    }
+    else if(!g_ChipStates.changed.wait_until(lock, deadline, received))
+    {
+        return false;
+    }
+    if(g_canFdSupport)
+    {
+        const auto& canFd = g_ChipStates.canFd[channel];
+        chipState = s_xl_chip_state{canFd.busStatus, canFd.txErrorCounter, canFd.rxErrorCounter};
+    }
+    else
+    {
+        chipState = g_ChipStates.classic[channel];
+    }
+    return true;
+}
+
+void toIdStatisticsType(const IdStatistics& statistics, Can_XLdriver_IdStatisticsType& result)
+{
+    // the extended flag of Can_IdType is XL_CAN_EXT_MSG_ID
+    result.CanId = statistics.id;
+    result.Count = statistics.count;
+    result.LastTimeStamp = statistics.lastTimeStamp;
+    result.MinPeriod = statistics.minPeriod;
+    result.MaxPeriod = statistics.maxPeriod;
+    result.MeanPeriod = statistics.meanPeriod;
+    result.PeriodStdDev = std::sqrt(statistics.periodVariance);
+    result.MissedCycles = statistics.missedCycles;
+}
+
+/** @brief Missed deadline seen by the thread reading the XL queue, to the notification of the configuration */
+void notifyRxTimeout(unsigned int channelIndex, uint32 id)
+{
+    g_CanConfig->RxTimeoutNotification(g_CanControllerOfChannel[channelIndex], id);
+}
+
+/** @brief Deadlines of every controller, their identifiers as the XL driver reports them */
+std::vector<RxDeadline> rxDeadlinesOf(const Can_XLdriver_ConfigType& config)
+{
+    std::vector<RxDeadline> deadlines;
+    for(uint8 id = 0; id < config.ControllerCount; ++id)
+    {
+        const auto& controller = config.Controllers[id];
+        for(uint16 deadline = 0; deadline < controller.RxDeadlineCount; ++deadline)
+        {
+            const auto& rxDeadline = controller.RxDeadlines[deadline];
+            deadlines.push_back({controller.ChannelIndex, rxDeadline.CanId & ~0x40000000u, uint64{rxDeadline.Timeout} * 1000});
+        }
+    }
+    return deadlines;
+}
+
+/** @brief Transmitted frame given up by the thread reading the XL queue, to the notification of the configuration */
+void notifyTxTimeout(unsigned int channelIndex, uint32 id, PduIdType pduId)
+{
+    g_CanConfig->TxTimeoutNotification(g_CanControllerOfChannel[channelIndex], id, pduId);
+}
+
+/** @brief TX timeout of every supervised controller */
+std::vector<TxSupervision> txSupervisionsOf(const Can_XLdriver_ConfigType& config)
+{
+    static_assert(CAN_XLDRIVER_TX_TIMEOUT_NOTIFY == TX_TIMEOUT_NOTIFY && CAN_XLDRIVER_TX_TIMEOUT_FLUSH == TX_TIMEOUT_FLUSH);
+    std::vector<TxSupervision> supervisions;
+    for(uint8 id = 0; id < config.ControllerCount; ++id)
+    {
+        const auto& controller = config.Controllers[id];
+        if(controller.TxTimeout != 0)
+        {
+            supervisions.push_back({controller.ChannelIndex, uint64{controller.TxTimeout} * 1000, controller.TxTimeoutActions});
+        }
+    }
+    return supervisions;
+}
+}
+
+
+/*==================================================================================================
+*                                       GLOBAL FUNCTIONS
+==================================================================================================*/
+void canRxIndication(unsigned int channelIndex, Can_IdType canId, const uint8* data, uint8 length)
+{
+    if(g_CanConfig == nullptr)
+    {
+        indicateRx(static_cast<uint8>(channelIndex), 0U, canId, data, length);
+        return;
+    }
+    auto* controller = controllerOfChannel(channelIndex);
+    if(controller == nullptr)
+    {
+        return;
+    }
+    const auto hrh = hrhOf(*controller->config, canId);
+    if(hrh == CAN_XLDRIVER_NO_HRH)
+    {
+        return;
+    }
+    if(isPolled(controller->config->RxProcessing))
+    {
+        CanRxFrame frame;
+        frame.canId = canId;
+        frame.hrh = hrh;
+        frame.length = std::min<uint8>(length, static_cast<uint8>(frame.data.size()));
+        std::copy_n(data, frame.length, frame.data.begin());
+        if(!controller->rxQueue->push(frame)) [[unlikely]]
+        {
+            controller->queueDrops.fetch_add(1, std::memory_order_relaxed);
+        }
+        return;
+    }
+    indicateRx(controllerIdOf(*controller), hrh, canId, data, length);
+}
+
+void canOpenDefaultTxHth(XLaccess channelMask)
+{
+    // CAN FD frames switch the bitrate
+    g_CanDefaultTxHth = txHthOf(Can_XLdriver_HthConfigType{0, CAN_XLDRIVER_ID_MIXED, 1, 0, 0, 1, 0x55}, channelMask);
+}
+
+void canTxConfirmation(unsigned int channelIndex, Can_IdType canId)
+{
+    // a frame given up was reported with its PDU already, its identifier would confirm another PDU to CanIf;
+    // the write of an unsupervised frame is not kept, its identifier stands for its PDU
+    const auto supervisedPduId = g_TxSupervisor.onConfirmation(channelIndex, canId);
+    if(!supervisedPduId && g_TxSupervisor.supervises(channelIndex))
+    {
+        return;
+    }
+    const auto pduId = supervisedPduId.value_or(static_cast<PduIdType>(canId));
+    if(g_CanConfig != nullptr)
+    {
+        auto* controller = controllerOfChannel(channelIndex);
+        if(controller == nullptr)
+        {
+            return;
+        }
+        if(isPolled(controller->config->TxProcessing))
+        {
+            if(!controller->txQueue->push(pduId)) [[unlikely]]
+            {
+                controller->queueDrops.fetch_add(1, std::memory_order_relaxed);
+            }
+            return;
+        }
+    }
+    CanIf_TxConfirmation(pduId);
+}
+
+void canBusOff(unsigned int channelIndex)
+{
+    if(g_CanConfig == nullptr)
+    {
+        CanIf_ControllerBusOff(static_cast<uint8>(channelIndex));
+        return;
+    }
+    auto* controller = controllerOfChannel(channelIndex);
+    if(controller == nullptr)
+    {
+        return;
+    }
+    // the controller leaves the bus, CanIf restarts it with Can_XLdriver_SetControllerMode
+    xlDeactivateChannel(g_xlPortHandle, controller->channelMask);
+    controller->state = CAN_CS_STOPPED;
+    g_RxDeadlines.setActive(channelIndex, false);
+    if(isPolled(controller->config->BusOffProcessing))
+    {
+        controller->busOffPending = true;
+        return;
+    }
+    CanIf_ControllerBusOff(controllerIdOf(*controller));
+}
+
+void canBusError(unsigned int channelIndex)
+{
+    if(g_CanConfig != nullptr && controllerOfChannel(channelIndex) == nullptr)
+    {
+        return;
+    }
+    CanIf_ErrorNotification();
+}
+
+void canErrorPassive(unsigned int channelIndex)
+{
+    if(g_CanConfig != nullptr && controllerOfChannel(channelIndex) == nullptr)
+    {
+        return;
+    }
+    CanIf_ControllerErrorStatePassive();
+}
+
+extern "C" void Can_XLdriver_Init(const Can_XLdriver_ConfigType* Config)
+{
+    unsigned int channelIndex = 0;
+    bool rxThread = false;
+
+    if(Config == nullptr || g_CanConfig != nullptr)
+    {
+        return;
+    }
+    if(Config->AppName != nullptr)
+    {
+        g_AppName = Config->AppName;
+    }
+    g_RxQueueSize = Config->RxQueueSize;
+    g_RxBusLoad = Config->RxBusLoad;
+    // the fastest bitrate of the controllers bounds the frame rate on every channel
+    g_RxBusBitRate = 0;
+    for(uint8 id = 0; id < Config->ControllerCount; ++id)
+    {
+        const auto& controller = Config->Controllers[id];
+        for(uint16 baudrate = 0; baudrate < controller.BaudrateConfigCount; ++baudrate)
+        {
+            g_RxBusBitRate = std::max<unsigned int>(g_RxBusBitRate, controller.BaudrateConfigs[baudrate].BaudRate);
+        }
+    }
+    if(demoInitDriver(xlChanMaskTx, channelIndex) != XL_SUCCESS)
+    {
+        return;
+    }
+    if(!isConfigValid(*Config))
+    {
+        fmt::print("ERROR: the Can configuration does not match the available channels!\n\n");
+        closeDriver();
+        return;
+    }
+
+    resetControllers();
+    for(uint8 id = 0; id < Config->ControllerCount; ++id)
+    {
+        auto& controller = g_CanControllers[id];
+        controller.config = &Config->Controllers[id];
+        controller.channelMask = XLaccess{1} << controller.config->ChannelIndex;
+        g_CanControllerOfChannel[controller.config->ChannelIndex] = id;
+        if(isPolled(controller.config->RxProcessing))
+        {
+            controller.rxQueue = std::make_unique<SpscRing<CanRxFrame>>(Config->PollingQueueSize);
+        }
+        if(isPolled(controller.config->TxProcessing))
+        {
+            controller.txQueue = std::make_unique<SpscRing<PduIdType>>(Config->PollingQueueSize);
+        }
+        controller.fdConfigs = std::make_unique<XLcanFdConf[]>(controller.config->BaudrateConfigCount);
+        for(uint16 baudrate = 0; baudrate < controller.config->BaudrateConfigCount; ++baudrate)
+        {
+            initToZero(controller.fdConfigs[baudrate]);
+            toXLcanFdConf(solveBaudrate(controller.config->BaudrateConfigs[baudrate]), controller.fdConfigs[baudrate]);
+        }
+        rxThread |= !isPolled(controller.config->RxProcessing) || !isPolled(controller.config->TxProcessing) ||
+                    !isPolled(controller.config->BusOffProcessing);
+        if(applyBaudrate(controller, controller.config->DefaultBaudrateConfigId) != E_OK)
+        {
+            fmt::print("- SetBaudrate      : controller {} refused its default bitrate\n", id);
+        }
+        controller.state = CAN_CS_STOPPED;
+    }
+
+    // the controllers are stopped, their deadlines are not counted until they start
+    g_RxDeadlines.configure(rxDeadlinesOf(*Config), Config->RxTimeoutNotification != nullptr ? notifyRxTimeout : nullptr);
+    g_TxSupervisor.configure(txSupervisionsOf(*Config), g_xlPortHandle, Config->TxTimeoutNotification != nullptr ? notifyTxTimeout : nullptr);
+
+    g_CanTxHths.clear();
+    for(uint16 hth = 0; hth < Config->HthCount; ++hth)
+    {
+        g_CanTxHths.push_back(txHthOf(Config->Hths[hth], g_CanControllers[Config->Hths[hth].ControllerId].channelMask));
+    }
+
+    // the RX thread reads g_CanConfig, publish it before the thread starts
+    g_CanConfig = Config;
+    g_CanPollDriverQueue = !rxThread;
+    if(rxThread && demoCreateRxThread() != XL_SUCCESS)
+    {
+        g_CanConfig = nullptr;
+        resetControllers();
+        closeDriver();
+    }
+}
+
+extern "C" void Can_XLdriver_DeInit(void)
+{
+    if(g_CanConfig == nullptr)
+    {
+        return;
+    }
+    for(uint8 id = 0; id < g_CanConfig->ControllerCount; ++id)
+    {
+        if(g_CanControllers[id].state == CAN_CS_STARTED)
+        {
+            return;
+        }
+    }
+    demoStopRxThread();
+    g_RxDeadlines.configure({}, nullptr);
+    g_TxSupervisor.configure({}, XL_INVALID_PORTHANDLE, nullptr);
+    xlDeactivateChannel(g_xlPortHandle, g_xlChannelMask);
+    closeDriver();
+    g_CanConfig = nullptr;
+    g_CanPollDriverQueue = false;
+    resetControllers();
+}
+
+extern "C" Std_ReturnType Can_XLdriver_SetBaudrate(uint8 Controller, uint16 BaudRateConfigID)
+{
+    if(g_CanConfig == nullptr || Controller >= g_CanConfig->ControllerCount)
+    {
+        return E_NOT_OK;
+    }
+    auto& controller = g_CanControllers[Controller];
+    if(BaudRateConfigID >= controller.config->BaudrateConfigCount)
+    {
+        return E_NOT_OK;
+    }
+    switch(controller.state)
+    {
+        case CAN_CS_STOPPED:
+            return applyBaudrate(controller, BaudRateConfigID);
+        case CAN_CS_STARTED:
+            return BaudRateConfigID == controller.baudrateConfigId ? E_OK : switchBaudrate(controller, BaudRateConfigID);
+        default:
+            return E_NOT_OK;
+    }
+}
+
+extern "C" void Can_XLdriver_MainFunction_Write(void)
+{
+    if(g_CanConfig == nullptr)
+    {
+        return;
+    }
+    pollDriverQueue();
+    for(uint8 id = 0; id < g_CanConfig->ControllerCount; ++id)
+    {
+        auto& controller = g_CanControllers[id];
+        PduIdType pduId;
+        while(controller.txQueue && controller.txQueue->pop(pduId))
+        {
+            CanIf_TxConfirmation(pduId);
+        }
+    }
+}
+
+extern "C" void Can_XLdriver_MainFunction_Read(void)
+{
+    if(g_CanConfig == nullptr)
+    {
+        return;
+    }
+    pollDriverQueue();
+    for(uint8 id = 0; id < g_CanConfig->ControllerCount; ++id)
+    {
+        auto& controller = g_CanControllers[id];
+        CanRxFrame frame;
+        while(controller.rxQueue && controller.rxQueue->pop(frame))
+        {
+            indicateRx(id, frame.hrh, frame.canId, frame.data.data(), frame.length);
+        }
+    }
+}
+
+extern "C" void Can_XLdriver_MainFunction_BusOff(void)
+{
+    if(g_CanConfig == nullptr)
+    {
+        return;
+    }
+    pollDriverQueue();
+    for(uint8 id = 0; id < g_CanConfig->ControllerCount; ++id)
+    {
+        if(g_CanControllers[id].busOffPending.exchange(false))
+        {
+            CanIf_ControllerBusOff(id);
+        }
+    }
+}
+
+extern "C" void Can_XLdriver_MainFunction_Wakeup(void)
+{
+    // the XL channels have no sleep mode: a controller in CAN_CS_SLEEP is only woken up by CanIf
+}
+
+extern "C" void Can_XLdriver_MainFunction_Mode(void)
+{
+    if(g_CanConfig == nullptr)
+    {
+        return;
+    }
+    for(uint8 id = 0; id < g_CanConfig->ControllerCount; ++id)
+    {
+        auto& controller = g_CanControllers[id];
+        if(controller.modeIndicationPending.exchange(false))
+        {
+            CanIf_ControllerModeIndication(id, controller.state);
+        }
+    }
+}
+
+extern "C" void Can_XLdriver_GetVersionInfo(Std_VersionInfoType* versioninfo)
+{
+    if(versioninfo == nullptr)
+    {
+        return;
+    }
+    versioninfo->vendorID = CAN_XLDRIVER_VENDOR_ID;
+    versioninfo->moduleID = CAN_XLDRIVER_MODULE_ID;
+    versioninfo->sw_major_version = CAN_XLDRIVER_SW_MAJOR_VERSION;
+    versioninfo->sw_minor_version = CAN_XLDRIVER_SW_MINOR_VERSION;
+    versioninfo->sw_patch_version = CAN_XLDRIVER_SW_PATCH_VERSION;
+}
+
+extern "C" Std_ReturnType Can_XLdriver_GetControllerErrorState(uint8 ControllerId, Can_ErrorStateType* ErrorStatePtr)
+{
+    s_xl_chip_state chipState{};
+    if(ErrorStatePtr == nullptr || !requestChipState(ControllerId, chipState))
+    {
+        return E_NOT_OK;
+    }
+    switch(chipState.busStatus)
+    {
+        case XL_CHIPSTAT_BUSOFF:
+            *ErrorStatePtr = CAN_ERRORSTATE_BUSOFF;
+            break;
+        case XL_CHIPSTAT_ERROR_PASSIVE:
+            *ErrorStatePtr = CAN_ERRORSTATE_PASSIVE;
+            break;
+        case XL_CHIPSTAT_ERROR_WARNING:
+        case XL_CHIPSTAT_ERROR_ACTIVE:
+            *ErrorStatePtr = CAN_ERRORSTATE_ACTIVE;
+            break;
+        default:
+            return E_NOT_OK;
+    }
+    return E_OK;
+}
+
+extern "C" Std_ReturnType Can_XLdriver_GetControllerRxErrorCounter(uint8 ControllerId, uint8* RxErrorCounterPtr)
+{
+    s_xl_chip_state chipState{};
+    if(RxErrorCounterPtr == nullptr || !requestChipState(ControllerId, chipState))
+    {
+        return E_NOT_OK;
+    }
+    *RxErrorCounterPtr = chipState.rxErrorCounter;
+    return E_OK;
+}
+
+extern "C" Std_ReturnType Can_XLdriver_GetControllerTxErrorCounter(uint8 ControllerId, uint8* TxErrorCounterPtr)
+{
+    s_xl_chip_state chipState{};
+    if(TxErrorCounterPtr == nullptr || !requestChipState(ControllerId, chipState))
+    {
+        return E_NOT_OK;
+    }
+    *TxErrorCounterPtr = chipState.txErrorCounter;
+    return E_OK;
+}
+
+extern "C" Std_ReturnType Can_XLdriver_SetControllerMode(uint8 Controller, Can_ControllerStateType Transition)
+{
+    if(g_CanConfig == nullptr || Controller >= g_CanConfig->ControllerCount)
+    {
+        return E_NOT_OK;
+    }
+    auto& controller = g_CanControllers[Controller];
+    const Can_ControllerStateType current = controller.state;
+    XLstatus xlStatus = XL_SUCCESS;
+
+    if(Transition != current)
+    {
+        switch(Transition)
+        {
+            case CAN_CS_STARTED:
+                if(current != CAN_CS_STOPPED)
+                {
+                    return E_NOT_OK;
+                }
+                xlStatus = xlActivateChannel(g_xlPortHandle, controller.channelMask, XL_BUS_TYPE_CAN, XL_ACTIVATE_NONE);
+                break;
+            case CAN_CS_STOPPED:
+                if(current == CAN_CS_STARTED)
+                {
+                    xlStatus = xlDeactivateChannel(g_xlPortHandle, controller.channelMask);
+                }
+                break;
+            case CAN_CS_SLEEP:
+                // no sleep mode on the XL channels, the stopped channel stays offline
+                if(current != CAN_CS_STOPPED)
+                {
+                    return E_NOT_OK;
+                }
+                break;
+            default:
+                return E_NOT_OK;
+        }
+        if(xlStatus != XL_SUCCESS)
+        {
+            return E_NOT_OK;
+        }
+        controller.state = Transition;
+        g_RxDeadlines.setActive(controller.config->ChannelIndex, Transition == CAN_CS_STARTED);
+    }
+
+    if(isPolled(controller.config->ModeProcessing))
+    {
+        controller.modeIndicationPending = true;
+    }
+    else
+    {
+        CanIf_ControllerModeIndication(Controller, Transition);
+    }
+    return E_OK;
+}
+
+extern "C" Std_ReturnType Can_XLdriver_Write(Can_HwHandleType Hth, const Can_PduType* PduInfo)
+{
+    if(PduInfo == nullptr)
+    {
+        return E_NOT_OK;
+    }
+    // the CAN FD bit of Can_IdType selects the path, the rest is fixed by the HTH
+    const auto fd = (PduInfo->id >> 30) & 1u;
+
+    if(g_CanConfig == nullptr)
+    {
+        // built by demoInitDriver before any writer starts, only read here
+        const auto& defaultHth = g_CanDefaultTxHth;
+        if(defaultHth.channelMask == 0)
+        {
+            return E_NOT_OK;
+        }
+        return defaultHth.paths[fd](defaultHth, *PduInfo);
+    }
+    if(Hth >= g_CanTxHths.size())
+    {
+        return E_NOT_OK;
+    }
+    const auto& hth = g_CanTxHths[Hth];
+    return hth.paths[fd](hth, *PduInfo);
+}
+
+extern "C" Std_ReturnType Can_XLdriver_GetRxStatistics(uint8 Controller, Can_XLdriver_RxStatisticsType* Statistics)
+{
+    if(g_CanConfig == nullptr || Controller >= g_CanConfig->ControllerCount || Statistics == nullptr)
+    {
+        return E_NOT_OK;
+    }
+    const auto& controller = g_CanControllers[Controller];
+    Statistics->QueueOverflows = g_RxQueueStatistics.overflows[controller.config->ChannelIndex].load(std::memory_order_relaxed);
+    Statistics->PollingQueueDrops = controller.queueDrops.load(std::memory_order_relaxed);
+    Statistics->QueueHighWater = g_RxQueueStatistics.highWater.load(std::memory_order_relaxed);
+    Statistics->QueueSize = g_RxQueueStatistics.size;
+    return E_OK;
+}
+
+extern "C" Std_ReturnType Can_XLdriver_GetBusLoad(uint8 Controller, Can_XLdriver_BusLoadType* BusLoad)
+{
+    if(g_CanConfig == nullptr || Controller >= g_CanConfig->ControllerCount || BusLoad == nullptr)
+    {
+        return E_NOT_OK;
+    }
+    const auto load = g_BusLoad.snapshot(g_CanControllers[Controller].config->ChannelIndex);
+    BusLoad->Current = load.current;
+    BusLoad->Average = load.average;
+    BusLoad->Peak = load.peak;
+    return E_OK;
+}
+
+extern "C" Std_ReturnType Can_XLdriver_GetIdStatistics(uint8 Controller, Can_IdType CanId, Can_XLdriver_IdStatisticsType* Statistics)
+{
+    IdStatistics statistics{};
+    if(g_CanConfig == nullptr || Controller >= g_CanConfig->ControllerCount || Statistics == nullptr ||
+       !g_IdStatistics.snapshot(g_CanControllers[Controller].config->ChannelIndex, CanId & ~0x40000000u, statistics))
+    {
+        return E_NOT_OK;
+    }
+    toIdStatisticsType(statistics, *Statistics);
+    return E_OK;
+}
+
+extern "C" Std_ReturnType Can_XLdriver_GetAllIdStatistics(uint8 Controller, Can_XLdriver_IdStatisticsType* Statistics, uint32* Count)
+{
+    if(g_CanConfig == nullptr || Controller >= g_CanConfig->ControllerCount || Statistics == nullptr || Count == nullptr)
+    {
+        return E_NOT_OK;
+    }
+    const auto capacity = *Count;
+    uint32 seen = 0;
+    g_IdStatistics.forEach(g_CanControllers[Controller].config->ChannelIndex, [&](const IdStatistics& statistics) {
+        if(seen < capacity)
+        {
+            toIdStatisticsType(statistics, Statistics[seen]);
+        }
+        ++seen;
+    });
+    *Count = std::min(seen, capacity);
+    return seen <= capacity ? E_OK : E_NOT_OK;
+}
+
+extern "C" Std_ReturnType Can_XLdriver_GetRxDeadlineStatistics(uint8 Controller, Can_IdType CanId, Can_XLdriver_RxDeadlineStatisticsType* Statistics)
+{
+    RxDeadlineStatistics statistics{};
+    if(g_CanConfig == nullptr || Controller >= g_CanConfig->ControllerCount || Statistics == nullptr ||
+       !g_RxDeadlines.snapshot(g_CanControllers[Controller].config->ChannelIndex, CanId & ~0x40000000u, statistics))
+    {
+        return E_NOT_OK;
+    }
+    Statistics->CanId = statistics.id;
+    Statistics->Timeout = static_cast<uint32>(statistics.timeout / 1000);
+    Statistics->Timeouts = statistics.timeouts;
+    Statistics->Recoveries = statistics.recoveries;
+    Statistics->TimedOut = statistics.timedOut ? 1 : 0;
+    return E_OK;
+}
+
+extern "C" Std_ReturnType Can_XLdriver_GetTxStatistics(uint8 Controller, Can_XLdriver_TxStatisticsType* Statistics)
+{
+    TxSupervisionStatistics statistics{};
+    if(g_CanConfig == nullptr || Controller >= g_CanConfig->ControllerCount || Statistics == nullptr ||
+       !g_TxSupervisor.snapshot(g_CanControllers[Controller].config->ChannelIndex, statistics))
+    {
+        return E_NOT_OK;
+    }
+    Statistics->Supervised = statistics.supervised;
+    Statistics->Confirmed = statistics.confirmed;
+    Statistics->Timeouts = statistics.timeouts;
+    Statistics->LateConfirmations = statistics.lateConfirmations;
+    Statistics->Flushes = statistics.flushes;
+    Statistics->FlushedFrames = statistics.flushedFrames;
+    Statistics->Busy = statistics.busy;
+    Statistics->InFlight = statistics.inFlight;
+    return E_OK;
+}
+
+/**@} */ // END OF addtogroup Can_XLdriver
@@ -0,0 +1,33 @@
+/**
+ * @file Can_XLdriver_CfgCheck.cpp
+ * @author Maxime Verreault
+ * @date 2026-10-19
+ * @copyright COPYRIGHT(c) Maxime Verreault All rights reserved.
+ * @brief Build time checks of a generated Can configuration, compiled once per generated Can_XLdriver_Cfg.h
+ * @details The generator validates the description, this unit what only the compiler knows: the
+ *          tables fit their types and each baudrate has a bit timing on the XL clock.
+ * @ingroup Can_XLdriver
+ * @addtogroup Can_XLdriver_CfgCheck
+ * @{
+ */
+
+
+/*==================================================================================================
+*                                        INCLUDE FILES
+* 1) system and project includes
+* 2) needed interfaces from external units
+* 3) internal and external interfaces from this unit
+==================================================================================================*/
+#include "Can_XLdriver_Cfg.h"
+#include "xlbittiming.h"
+
+
+/*==================================================================================================
+*                                       LOCAL FUNCTIONS
+==================================================================================================*/
+// a baudrate without a bit timing on the XL clock fails the build instead of Can_XLdriver_Init
+static_assert(isBitTimingSolvable(Can_XLdriver_Config), "a baudrate of the Can configuration has no bit timing on the XL clock");
+static_assert(Can_XLdriver_Config.ControllerCount == CAN_XLDRIVER_CFG_CONTROLLER_COUNT && Can_XLdriver_Config.HthCount == CAN_XLDRIVER_CFG_HTH_COUNT,
+              "the counts of the Can configuration disagree with its tables");
+
+/**@} */ // END OF addtogroup Can_XLdriver_CfgCheck
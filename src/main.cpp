@@ -0,0 +1,244 @@
+/**
+ * @file main.cpp
+ * @author Maxime Verreault
+ * @date 2026-10-19
+ * @copyright COPYRIGHT(c) Maxime Verreault All rights reserved.
+ * @brief Command line demo application of the XL driver adapter
+ * @ingroup xldriver
+ * @addtogroup xlmain
+ * @{
+ */
+
+
+/*==================================================================================================
+*                                        INCLUDE FILES
+* 1) system and project includes
+* 2) needed interfaces from external units
+* 3) internal and external interfaces from this unit
+==================================================================================================*/
+#include <array>
+#include <memory>
+#include <sstream>
+#include <thread>
+#include <boost/program_options.hpp>
+#include <fmt/format.h>
+#include "Can_XLdriver.h"
+#include "xldriver.h"
+#include "xlasc.h"
+#include "xlblf.h"
+#include "xlpcapng.h"
+#ifdef CAN_XLDRIVER_GENERATED_CFG
+#include "Can_XLdriver_Cfg.h"
+#endif
+
+
+namespace po = boost::program_options;
+
+
+/*==================================================================================================
+*                                       GLOBAL FUNCTIONS
+==================================================================================================*/
+int main(int argc, char *argv[])
+{
+    XLstatus      xlStatus;
+
+
+    unsigned int  xlChanIndex = 0;
+    unsigned int  txID = 0x01;
+
+    fmt::print(
+            "┌{0:─^{3}}┐\n"
+            "│{1: ^{3}}│\n"
+            "│{2: ^{3}}│\n"
+#ifdef WIN64
+            "│{4: ^{3}}│\n"
+#endif
+            "└{0:─^{3}}┘\n", "", "xlCANdemo - Test Application for XL Family Driver API", fmt::format("Vector Informatik GmbH, {}", __DATE__), 58, "- 64bit Version -");
+
+    po::options_description desc("Allowed options");
+    desc.add_options()
+            ("help", "produce help message")
+            ("baudrate", po::value<unsigned int>(), "set baudrate (kbps)")
+            ("databaudrate", po::value<unsigned int>(), "set the CAN FD data phase baudrate (kbps, default 2000)")
+            ("appname", po::value<std::string>(), "Name of the application to be read (e.g. \"xlCANcontrol\").\nApplication names are listed in the Vector Hardware Configuration tool.")
+            ("txid", po::value<unsigned int>(), "set ID for sending data")
+            ("rxwait", po::value<std::string>(), "RX thread wait strategy on an empty queue: spin, block or adaptive (default)")
+            ("spinbudget", po::value<unsigned int>(), "maximum spin time after the last received event (us), auto-tuned below it in adaptive mode")
+            ("busload", po::value<unsigned int>(), "size the XL receive queue for this bus load (%) on every channel, the default size otherwise")
+            ("record", po::value<std::string>(), "record all events into <path>_<index>.xlrec segment files")
+            ("record-segment-mb", po::value<unsigned int>(), "size of one record segment file (MB, default 64)")
+            ("record-budget-mb", po::value<unsigned int>(), "disk space kept for the recording, oldest segments are deleted beyond it (MB, default 1024)")
+            ("asc", po::value<std::string>(), "export the frames and error frames into an ASC log file")
+            ("blf", po::value<std::string>(), "export the frames and error frames into a BLF log file")
+            ("pcapng", po::value<std::string>(), "export the frames and error frames into a PCAP-NG (SocketCAN) capture file")
+            ("replay", po::value<std::string>(), "replay a recording (record base path) or an .asc file, then exit")
+            ("replay-mode", po::value<std::string>(), "replay pacing: original (default) or fast")
+            ("replay-speed", po::value<double>(), "replay speed factor for the original pacing (default 1.0)")
+            ("replay-target", po::value<std::string>(), "canif (default) to indicate frames to CanIf, bus to transmit them")
+            ("replay-tx", "also replay the frames transmitted by the recording node")
+            ;
+#ifdef CAN_XLDRIVER_GENERATED_CFG
+    desc.add_options()
+            ("can-init", "open the controllers of the generated configuration with Can_XLdriver_Init and run the main functions")
+            ;
+#endif
+
+    po::variables_map vm;
+    po::store(po::parse_command_line(argc, argv, desc), vm);
+    po::notify(vm);
+
+    if (vm.count("help")) {
+        std::stringstream str{};
+        str << desc;
+        fmt::print("{}\n", str.str());
+        return 1;
+    }
+
+    if (vm.count("baudrate")) {
+        g_BaudRate = vm["baudrate"].as<unsigned int>() * 1000;
+        fmt::print("Baudrate = {}kbps\n", vm["baudrate"].as<unsigned int>());
+    } else {
+        fmt::print("Baudrate was not set. Default Baudrate selected ({}kbps)\n", g_BaudRate/1000);
+    }
+
+    if (vm.count("databaudrate")) {
+        g_DataBitRate = vm["databaudrate"].as<unsigned int>() * 1000;
+        fmt::print("Data baudrate = {}kbps\n", vm["databaudrate"].as<unsigned int>());
+    }
+
+    if (vm.count("appname")) {
+        g_AppName = vm["appname"].as<std::string>();
+        fmt::print("AppName = {}\n", vm["appname"].as<std::string>());
+    } else {
+        fmt::print("AppName was not set. Default AppName selected (\"{}\")\n", g_AppName);
+    }
+
+    if (vm.count("txid")) {
+        txID = vm["txid"].as<unsigned int>();
+        fmt::print("TX ID = {:#X}\n", vm["txid"].as<unsigned int>());
+    } else {
+        fmt::print("TX ID was not set. Default TX ID selected ({})\n", txID);
+    }
+
+    if (vm.count("rxwait")) {
+        const auto& mode = vm["rxwait"].as<std::string>();
+        if (mode == "spin") {
+            g_RxWaitMode = RxWaitMode::Spin;
+        } else if (mode == "block") {
+            g_RxWaitMode = RxWaitMode::Block;
+        } else if (mode != "adaptive") {
+            fmt::print("Unknown RX wait strategy \"{}\"\n", mode);
+            return 1;
+        }
+        fmt::print("RX wait = {}\n", mode);
+    }
+
+    if (vm.count("spinbudget")) {
+        g_RxSpinBudget = std::chrono::microseconds(vm["spinbudget"].as<unsigned int>());
+        fmt::print("Spin budget = {}us\n", g_RxSpinBudget.count());
+    }
+
+    if (vm.count("busload")) {
+        g_RxBusLoad = std::min(vm["busload"].as<unsigned int>(), 100u);
+        fmt::print("Bus load = {}%\n", g_RxBusLoad);
+    }
+
+    if (vm.count("record")) {
+        Recorder::Settings recordSettings{vm["record"].as<std::string>()};
+        if (vm.count("record-segment-mb")) {
+            recordSettings.segmentBytes = vm["record-segment-mb"].as<unsigned int>() * 1024ull * 1024ull;
+        }
+        if (vm.count("record-budget-mb")) {
+            recordSettings.diskBudgetBytes = vm["record-budget-mb"].as<unsigned int>() * 1024ull * 1024ull;
+        }
+        const auto opened = g_Recorder.open(recordSettings);
+        fmt::print("- Record           : {}, {}\n", recordSettings.basePath, opened ? "OK" : "FAILED");
+    }
+
+    if (vm.count("asc")) {
+        auto writer = std::make_unique<AscWriter>(vm["asc"].as<std::string>());
+        fmt::print("- ASC export       : {}, {}\n", vm["asc"].as<std::string>(), writer->isOpen() ? "OK" : "FAILED");
+        if (writer->isOpen()) {
+            g_Export.addWriter(std::move(writer));
+        }
+    }
+    if (vm.count("blf")) {
+        auto writer = std::make_unique<BlfWriter>(vm["blf"].as<std::string>());
+        fmt::print("- BLF export       : {}, {}\n", vm["blf"].as<std::string>(), writer->isOpen() ? "OK" : "FAILED");
+        if (writer->isOpen()) {
+            g_Export.addWriter(std::move(writer));
+        }
+    }
+    if (vm.count("pcapng")) {
+        auto writer = std::make_unique<PcapngWriter>(vm["pcapng"].as<std::string>());
+        fmt::print("- PCAP-NG export   : {}, {}\n", vm["pcapng"].as<std::string>(), writer->isOpen() ? "OK" : "FAILED");
+        if (writer->isOpen()) {
+            g_Export.addWriter(std::move(writer));
+        }
+    }
+    g_Export.start();
+
+#ifdef CAN_XLDRIVER_GENERATED_CFG
+    if (vm.count("can-init")) {
+        Can_XLdriver_Init(&Can_XLdriver_Config);
+        for (uint8 controller = 0; controller < CAN_XLDRIVER_CFG_CONTROLLER_COUNT; ++controller) {
+            const auto result = Can_XLdriver_SetControllerMode(controller, CAN_CS_STARTED);
+            fmt::print("- Start controller : {}, {}\n", controller, result == E_OK ? "OK" : "FAILED");
+        }
+        std::array<uint8, 8> data{69, 21, 87, 34, 0, 1, 2, 4};
+        const Can_PduType pduinfo{txID, 0, data.size(), data.data()};
+        Can_XLdriver_Write(0, &pduinfo);
+        while (true) {
+            // one 1 ms task slice of the BSW scheduler
+            Can_XLdriver_MainFunction_Write();
+            Can_XLdriver_MainFunction_Read();
+            Can_XLdriver_MainFunction_BusOff();
+            Can_XLdriver_MainFunction_Wakeup();
+            Can_XLdriver_MainFunction_Mode();
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        }
+    }
+#endif
+
+    xlStatus = demoInitDriver(xlChanMaskTx, xlChanIndex);
+    fmt::print("- Init             : {}\n",  xlGetErrorString(xlStatus));
+
+    if(XL_SUCCESS == xlStatus) {
+        xlStatus = demoCreateRxThread();
+        fmt::print("- Create RX thread : {}\n",  xlGetErrorString(xlStatus));
+    }
+
+    if(XL_SUCCESS == xlStatus) {
+        xlStatus = xlActivateChannel(g_xlPortHandle, g_xlChannelMask, XL_BUS_TYPE_CAN, XL_ACTIVATE_RESET_CLOCK);
+        fmt::print("- ActivateChannel  : CM={:#X}, {}\n", g_xlChannelMask, xlGetErrorString(xlStatus));
+    }
+    if(XL_SUCCESS == xlStatus && vm.count("replay")) {
+        ReplaySettings replaySettings;
+        if (vm.count("replay-mode") && vm["replay-mode"].as<std::string>() == "fast") {
+            replaySettings.timing = ReplayTiming::AsFastAsPossible;
+        }
+        if (vm.count("replay-speed") && vm["replay-speed"].as<double>() > 0.0) {
+            replaySettings.speed = vm["replay-speed"].as<double>();
+        }
+        replaySettings.includeTx = vm.count("replay-tx") > 0;
+        const auto toBus = vm.count("replay-target") && vm["replay-target"].as<std::string>() == "bus";
+        xlStatus = demoReplay(vm["replay"].as<std::string>(), replaySettings, toBus);
+        fmt::print("- Replay done      : {}\n", xlGetErrorString(xlStatus));
+        demoStopRxThread();
+        g_Export.stop();
+        return xlStatus;
+    }
+
+    Can_ErrorStateType res;
+    Can_XLdriver_GetControllerErrorState(0, &res);
+    std::array<uint8, 8> data{69, 21, 87, 34, 0, 1, 2, 4};
+    const Can_PduType pduinfo{
+            0x69 | 0x40000000, 0, data.size(), data.data()
+    };
+    Can_XLdriver_Write(0, &pduinfo);
+    while(true);
+    xlStatus = demoTransmit(txID);
+    return xlStatus;
+}
+
+/**@} */ // END OF addtogroup xlmain
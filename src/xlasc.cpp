@@ -0,0 +1,336 @@
+/**
+ * @file xlasc.cpp
+ * @author Maxime Verreault
+ * @date 2026-10-19
+ * @copyright COPYRIGHT(c) Maxime Verreault All rights reserved.
+ * @brief Vector ASC (ASCII log) support
+ * @ingroup xldriver
+ * @addtogroup xlasc
+ * @{
+ */
+
+
+/*==================================================================================================
+*                                        INCLUDE FILES
+* 1) system and project includes
+* 2) needed interfaces from external units
+* 3) internal and external interfaces from this unit
+==================================================================================================*/
+#include "xlasc.h"
+#include <algorithm>
+#include <array>
+#include <cctype>
+#include <charconv>
+#include <cmath>
+#include <cstdlib>
+#include <ctime>
+#include <iterator>
+#include <fmt/chrono.h>
+
+
+/*==================================================================================================
+*                                       LOCAL FUNCTIONS
+==================================================================================================*/
+namespace
+{
+constexpr std::size_t MaxTokens = 90;   // CANFD line with 64 data bytes and the trailing bit timing fields
+
+/** @brief Split a line on blanks into at most MaxTokens views, returns the token count */
+std::size_t tokenize(std::string_view line, std::array<std::string_view, MaxTokens>& tokens)
+{
+    std::size_t count = 0;
+    std::size_t position = 0;
+    while(count < tokens.size())
+    {
+        position = line.find_first_not_of(" \t\r", position);
+        if(position == std::string_view::npos)
+        {
+            break;
+        }
+        const auto end = std::min(line.find_first_of(" \t\r", position), line.size());
+        tokens[count++] = line.substr(position, end - position);
+        position = end;
+    }
+    return count;
+}
+
+template<typename T>
+bool parseNumber(std::string_view token, T& value, int base)
+{
+    const auto result = std::from_chars(token.data(), token.data() + token.size(), value, base);
+    return result.ec == std::errc() && result.ptr == token.data() + token.size();
+}
+
+bool parseTimeStamp(std::string_view token, XLuint64& timeStamp)
+{
+    /* from_chars for double is not available on every toolchain we build with */
+    const std::string text(token);
+    char* end = nullptr;
+    const double seconds = std::strtod(text.c_str(), &end);
+    if(end != text.c_str() + text.size() || seconds < 0.0)
+    {
+        return false;
+    }
+    timeStamp = static_cast<XLuint64>(std::llround(seconds * 1e9));
+    return true;
+}
+
+bool parseIdentifier(std::string_view token, int base, uint32& canId)
+{
+    bool extended = false;
+    if(!token.empty() && (token.back() == 'x' || token.back() == 'X'))
+    {
+        extended = true;
+        token.remove_suffix(1);
+    }
+    if(!parseNumber(token, canId, base))
+    {
+        return false;
+    }
+    if(extended)
+    {
+        canId |= XL_CAN_EXT_MSG_ID;
+    }
+    return true;
+}
+
+bool parseData(const std::array<std::string_view, MaxTokens>& tokens, std::size_t first, std::size_t count,
+               std::size_t length, int base, RecordEntry& entry)
+{
+    if(length > RECORD_MAX_DATA_LEN || first + length > count)
+    {
+        return false;
+    }
+    for(std::size_t i = 0; i < length; ++i)
+    {
+        if(!parseNumber(tokens[first + i], entry.data[i], base))
+        {
+            return false;
+        }
+    }
+    entry.length = static_cast<uint8>(length);
+    return true;
+}
+
+bool isFlag(std::string_view token)
+{
+    return token == "0" || token == "1";
+}
+}
+
+
+/*==================================================================================================
+*                                       GLOBAL FUNCTIONS
+==================================================================================================*/
+bool AscReader::open(const std::string& path)
+{
+    stream.close();
+    stream.clear();
+    stream.open(path);
+    numberBase = 16;
+    relativeTimeStamps = false;
+    lastTimeStamp = 0;
+    return stream.is_open();
+}
+
+bool AscReader::next(RecordEntry& entry)
+{
+    std::string line;
+    while(std::getline(stream, line))
+    {
+        if(parseLine(line, entry))
+        {
+            return true;
+        }
+    }
+    return false;
+}
+
+bool AscReader::parseLine(std::string_view line, RecordEntry& entry)
+{
+    std::array<std::string_view, MaxTokens> tokens{};
+    const auto count = tokenize(line, tokens);
+    if(count < 2)
+    {
+        return false;
+    }
+    if(tokens[0] == "base" && count >= 4)
+    {
+        numberBase = tokens[1] == "dec" ? 10 : 16;
+        relativeTimeStamps = tokens[3] == "relative";
+        return false;
+    }
+
+    entry = RecordEntry{};
+    if(!parseTimeStamp(tokens[0], entry.timeStamp))
+    {
+        return false;
+    }
+    if(relativeTimeStamps)
+    {
+        entry.timeStamp += lastTimeStamp;
+    }
+
+    bool parsed = false;
+    if(tokens[1] == "CANFD" && count >= 9)
+    {
+        /* ts CANFD ch dir id [symbolic name] brs esi dlc length data... */
+        unsigned channel = 0;
+        auto field = std::size_t{5};
+        if(!isFlag(tokens[field]))
+        {
+            ++field;
+        }
+        uint8 brs = 0;
+        uint8 esi = 0;
+        unsigned length = 0;
+        parsed = parseNumber(tokens[2], channel, 10) && channel > 0 &&
+                 parseIdentifier(tokens[4], numberBase, entry.canId) &&
+                 field + 3 < count &&
+                 parseNumber(tokens[field], brs, 10) && parseNumber(tokens[field + 1], esi, 10) &&
+                 parseNumber(tokens[field + 2], entry.dlc, 16) && parseNumber(tokens[field + 3], length, 10) &&
+                 parseData(tokens, field + 4, count, length, numberBase, entry);
+        entry.channel = static_cast<uint16>(channel - 1);
+        entry.kind = tokens[3] == "Tx" ? RecordKind::TxOk : RecordKind::Rx;
+        entry.msgFlags = XL_CAN_RXMSG_FLAG_EDL | (brs ? XL_CAN_RXMSG_FLAG_BRS : 0u) | (esi ? XL_CAN_RXMSG_FLAG_ESI : 0u);
+    }
+    else if(count >= 5 && (tokens[3] == "Rx" || tokens[3] == "Tx"))
+    {
+        /* ts ch id dir d|r dlc data... */
+        unsigned channel = 0;
+        parsed = parseNumber(tokens[1], channel, 10) && channel > 0 &&
+                 parseIdentifier(tokens[2], numberBase, entry.canId) &&
+                 count >= 6 && parseNumber(tokens[5], entry.dlc, 16);
+        entry.channel = static_cast<uint16>(channel - 1);
+        entry.kind = tokens[3] == "Tx" ? RecordKind::TxOk : RecordKind::Rx;
+        if(parsed && tokens[4] == "r")
+        {
+            entry.msgFlags = XL_CAN_RXMSG_FLAG_RTR;
+        }
+        else if(parsed)
+        {
+            parsed = tokens[4] == "d" && parseData(tokens, 6, count, std::min<uint8>(entry.dlc, 8), numberBase, entry);
+        }
+    }
+
+    if(parsed)
+    {
+        lastTimeStamp = entry.timeStamp;
+    }
+    return parsed;
+}
+
+AscWriter::AscWriter(const std::string& path): file(std::fopen(path.c_str(), "wb"))
+{
+    if(file == nullptr)
+    {
+        return;
+    }
+    const auto now = std::chrono::system_clock::now();
+    const auto milliseconds = std::chrono::duration_cast<std::chrono::milliseconds>(now.time_since_epoch()).count() % 1000;
+    const auto local = fmt::localtime(std::chrono::system_clock::to_time_t(now));
+    auto date = fmt::format("{:%a %b %d %I:%M:%S}.{:03} {:%p %Y}", local, milliseconds, local);
+    /* CANoe writes the meridiem in lower case */
+    for(auto& character : date)
+    {
+        character = static_cast<char>(std::tolower(static_cast<unsigned char>(character)));
+    }
+    date[0] = static_cast<char>(std::toupper(static_cast<unsigned char>(date[0])));
+    date[4] = static_cast<char>(std::toupper(static_cast<unsigned char>(date[4])));
+
+    fmt::format_to(std::back_inserter(buffer),
+                   "date {0}\n"
+                   "base hex  timestamps absolute\n"
+                   "internal events logged\n"
+                   "// version 13.0.0\n"
+                   "Begin Triggerblock {0}\n"
+                   "   0.000000 Start of measurement\n", date);
+}
+
+AscWriter::~AscWriter()
+{
+    close();
+}
+
+void AscWriter::write(const RecordEntry& entry)
+{
+    if(file == nullptr)
+    {
+        return;
+    }
+    const auto isFrame = entry.kind == RecordKind::Rx || entry.kind == RecordKind::TxOk;
+    const auto isError = entry.kind == RecordKind::RxError || entry.kind == RecordKind::TxError || entry.kind == RecordKind::ErrorFrame;
+    if(!isFrame && !isError)
+    {
+        return;
+    }
+    if(!firstTimeStamp)
+    {
+        firstTimeStamp = entry.timeStamp;
+    }
+    const auto seconds = static_cast<double>(entry.timeStamp - std::min(entry.timeStamp, *firstTimeStamp)) / 1e9;
+    const auto channel = entry.channel + 1u;
+    auto out = std::back_inserter(buffer);
+
+    if(isError)
+    {
+        fmt::format_to(out, "{: 11.6f} {}  ErrorFrame\n", seconds, channel);
+    }
+    else
+    {
+        const auto id = entry.canId & ~XL_CAN_EXT_MSG_ID;
+        const auto extended = (entry.canId & XL_CAN_EXT_MSG_ID) != 0;
+        const auto direction = entry.kind == RecordKind::TxOk ? "Tx" : "Rx";
+        if(entry.msgFlags & XL_CAN_RXMSG_FLAG_EDL)
+        {
+            const auto brs = (entry.msgFlags & XL_CAN_RXMSG_FLAG_BRS) ? 1 : 0;
+            const auto esi = (entry.msgFlags & XL_CAN_RXMSG_FLAG_ESI) ? 1 : 0;
+            const auto flags = (1u << 12) | (static_cast<unsigned>(brs) << 13) | (static_cast<unsigned>(esi) << 14);
+            fmt::format_to(out, "{: 11.6f} CANFD {:>3} {:<4} {:>8}  {:>32} {} {} {:x} {:>2}",
+                           seconds, channel, direction, fmt::format("{:X}{}", id, extended ? "x" : ""), "",
+                           brs, esi, entry.dlc, entry.length);
+            for(uint8 i = 0; i < entry.length; ++i)
+            {
+                fmt::format_to(out, " {:02X}", entry.data[i]);
+            }
+            fmt::format_to(out, " {:>8} {:>4} {:>8X} {:>8} {:>8} {:>8} {:>8} {:>8}\n", 0, 0, flags, 0, 0, 0, 0, 0);
+        }
+        else
+        {
+            const auto remote = (entry.msgFlags & XL_CAN_RXMSG_FLAG_RTR) != 0;
+            fmt::format_to(out, "{: 11.6f} {}  {:<15} {:<4} {} {:x}",
+                           seconds, channel, fmt::format("{:X}{}", id, extended ? "x" : ""), direction,
+                           remote ? 'r' : 'd', entry.dlc);
+            for(uint8 i = 0; i < entry.length && !remote; ++i)
+            {
+                fmt::format_to(out, " {:02X}", entry.data[i]);
+            }
+            fmt::format_to(out, "\n");
+        }
+    }
+
+    if(buffer.size() >= ASC_WRITE_BUFFER_SIZE)
+    {
+        flushBuffer();
+    }
+}
+
+void AscWriter::close()
+{
+    if(file == nullptr)
+    {
+        return;
+    }
+    fmt::format_to(std::back_inserter(buffer), "End TriggerBlock\n");
+    flushBuffer();
+    std::fclose(file);
+    file = nullptr;
+}
+
+void AscWriter::flushBuffer()
+{
+    written += std::fwrite(buffer.data(), 1, buffer.size(), file);
+    buffer.clear();
+}
+
+/**@} */ // END OF addtogroup xlasc
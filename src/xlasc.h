@@ -0,0 +1,91 @@
+/**
+ * @file xlasc.h
+ * @author Maxime Verreault
+ * @date 2026-10-19
+ * @copyright COPYRIGHT(c) Maxime Verreault All rights reserved.
+ * @brief Vector ASC (ASCII log) support
+ * @ingroup xldriver
+ * @addtogroup xlasc
+ * @{
+ */
+
+
+#ifndef XLASC_H
+#define XLASC_H
+
+/*==================================================================================================
+*                                         INCLUDE FILES
+* 1) system and project includes
+* 2) needed interfaces from external units
+* 3) internal and external interfaces from this unit
+==================================================================================================*/
+#include <cstdio>
+#include <fstream>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <fmt/format.h>
+#include "xlrecorder.h"
+#include "xlexport.h"
+
+
+/*==================================================================================================
+*                                       DEFINES AND MACROS
+==================================================================================================*/
+#define ASC_WRITE_BUFFER_SIZE   (256u * 1024u)  // formatted text kept in memory before one fwrite
+
+
+/*==================================================================================================
+*                                STRUCTURES AND OTHER TYPEDEFS
+==================================================================================================*/
+/**
+ * @brief Streams the CAN and CAN FD frames of an ASC file as records
+ * @details Understands the "base hex|dec" and "timestamps absolute|relative" header lines, classic
+ *          frame lines and CANFD lines. Channels are 1-based in ASC and 0-based in the records.
+ *          Error frames, statistics and other events are skipped.
+ */
+class AscReader
+{
+public:
+    bool open(const std::string& path);
+    bool next(RecordEntry& entry);
+
+private:
+    std::ifstream stream{};
+    int numberBase{16};
+    bool relativeTimeStamps{false};
+    XLuint64 lastTimeStamp{0};
+
+    bool parseLine(std::string_view line, RecordEntry& entry);
+};
+
+/**
+ * @brief Writes frames and error frames as an ASC file readable by CANoe/CANalyzer
+ * @details Timestamps are relative to the first written event. Frames with EDL use the CANFD line
+ *          format, all other frames the classic one. Chip states and TX requests are not logged.
+ */
+class AscWriter : public LogWriter
+{
+public:
+    explicit AscWriter(const std::string& path);
+    AscWriter(const AscWriter&) = delete;
+    AscWriter& operator=(const AscWriter&) = delete;
+    ~AscWriter() override;
+
+    [[nodiscard]] bool isOpen() const { return file != nullptr; }
+    void write(const RecordEntry& entry) override;
+    void close() override;
+    [[nodiscard]] uint64 bytesWritten() const override { return written + buffer.size(); }
+
+private:
+    std::FILE* file{nullptr};
+    fmt::memory_buffer buffer{};
+    std::optional<XLuint64> firstTimeStamp{};
+    uint64 written{0};
+
+    void flushBuffer();
+};
+
+#endif //XLASC_H
+
+/**@} */ // END OF addtogroup xlasc
@@ -0,0 +1,479 @@
+/**
+ * @file xlbitstream.h
+ * @author Maxime Verreault
+ * @date 2026-10-19
+ * @copyright COPYRIGHT(c) Maxime Verreault All rights reserved.
+ * @brief Bit streams of CAN and CAN FD frames: CRC and stuffed length, usable in constant expressions
+ * @details The stuffing and the CRC advance one byte of the frame per table lookup. A bit-by-bit
+ *          reference builds the same frames, the benchmarks check both agree before measuring.
+ * @ingroup xldriver
+ * @addtogroup xlbitstream
+ * @{
+ */
+
+
+#ifndef XLBITSTREAM_H
+#define XLBITSTREAM_H
+
+/*==================================================================================================
+*                                         INCLUDE FILES
+* 1) system and project includes
+* 2) needed interfaces from external units
+* 3) internal and external interfaces from this unit
+==================================================================================================*/
+#include "vxlapi.h"
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <string_view>
+#include <utility>
+#include <Can_GeneralTypes.h>
+#include "xlframe.h"
+
+
+/*==================================================================================================
+*                                       DEFINES AND MACROS
+==================================================================================================*/
+#define CAN_CRC15_POLYNOMIAL       0x4599u          // x^15 + x^14 + x^10 + x^8 + x^7 + x^4 + x^3 + 1
+#define CAN_CRC17_POLYNOMIAL       0x1685Bu         // x^17 + x^16 + x^14 + x^13 + x^11 + x^6 + x^4 + x^3 + x + 1
+#define CAN_CRC21_POLYNOMIAL       0x102899u        // x^21 + x^20 + x^13 + x^11 + x^7 + x^4 + x^3 + 1
+#define CANFD_CRC17_MAX_LEN        16u              // longest CAN FD payload protected by the CRC-17
+
+
+/*==================================================================================================
+*                                STRUCTURES AND OTHER TYPEDEFS
+==================================================================================================*/
+/** @brief Frame as sent on the bus */
+struct StuffedFrame
+{
+    FrameBits bits;     //!< bits from SOF to the end of the intermission, stuff bits included
+    uint32 crc;         //!< CRC sequence: 15 bits (classic), 17 or 21 bits (CAN FD)
+    uint32 stuffBits;   //!< dynamic stuff bits, from SOF to the CRC sequence (classic) or to the data field (CAN FD)
+};
+
+
+/*==================================================================================================
+*                                       GLOBAL CONSTANTS
+==================================================================================================*/
+/**
+ * @brief Bit stuffing state after a bit: its level times 5 plus the length of its run minus 1
+ * @details A stuff bit of the opposite level follows 5 equal bits and starts the next run.
+ */
+constexpr uint8 stuffBit(uint8 state, uint32 bit, uint32& stuffBits)
+{
+    const uint32 level = state / 5;
+    const uint32 run = state % 5 + 1;
+    if(bit != level)
+    {
+        return static_cast<uint8>(bit * 5);
+    }
+    if(run + 1 == 5)
+    {
+        ++stuffBits;
+        return static_cast<uint8>((1 - level) * 5);
+    }
+    return static_cast<uint8>(level * 5 + run);
+}
+
+/** @brief Stuffing state before SOF: the recessive idle bus, SOF starts a run */
+inline constexpr uint8 StuffStateIdle = 5;
+
+/**
+ * @brief Stuffing of 8 bits from each state
+ * @details An entry holds the bits sent, stuff bits included (8 to 10 bits), from bit 6, the stuff
+ *          bits (0 to 2) from bit 4 and the next state in the low 4 bits.
+ */
+inline constexpr auto StuffTable = []() {
+    std::array<std::array<uint16, 256>, 10> table{};
+    for(uint8 state = 0; state < table.size(); ++state)
+    {
+        for(uint32 byte = 0; byte < 256; ++byte)
+        {
+            uint32 stuffBits = 0;
+            uint32 sent = 0;
+            uint8 next = state;
+            for(int bit = 7; bit >= 0; --bit)
+            {
+                const auto value = (byte >> bit) & 1u;
+                const auto stuffed = stuffBits;
+                next = stuffBit(next, value, stuffBits);
+                sent = sent << 1 | value;
+                if(stuffBits != stuffed)
+                {
+                    sent = sent << 1 | (1u - value);
+                }
+            }
+            table[state][byte] = static_cast<uint16>(sent << 6 | stuffBits << 4 | next);
+        }
+    }
+    return table;
+}();
+
+/** @brief CRC register of Width bits after one more bit */
+template<uint32 Width, uint32 Polynomial>
+constexpr uint32 crcBit(uint32 crc, uint32 bit)
+{
+    const auto feedback = ((crc >> (Width - 1)) ^ bit) & 1u;
+    crc = (crc << 1) & ((1u << Width) - 1);
+    return feedback != 0 ? crc ^ Polynomial : crc;
+}
+
+/**
+ * @brief CRC of each value of Bits bits from a cleared register
+ * @details Leading zeros leave a cleared register unchanged: the entry of a value below 2^n is
+ *          also its CRC as n bits, one table serves any count of bits up to Bits.
+ */
+template<uint32 Width, uint32 Polynomial, uint32 Bits>
+constexpr std::array<uint32, 1u << Bits> crcTable()
+{
+    std::array<uint32, 1u << Bits> table{};
+    for(uint32 value = 0; value < table.size(); ++value)
+    {
+        uint32 crc = 0;
+        for(int bit = Bits - 1; bit >= 0; --bit)
+        {
+            crc = crcBit<Width, Polynomial>(crc, (value >> bit) & 1u);
+        }
+        table[value] = crc;
+    }
+    return table;
+}
+
+inline constexpr auto Crc15Table = crcTable<15, CAN_CRC15_POLYNOMIAL, 8>();
+// 10 bits, the most a stuffed byte sends
+inline constexpr auto Crc17Table = crcTable<17, CAN_CRC17_POLYNOMIAL, 10>();
+inline constexpr auto Crc21Table = crcTable<21, CAN_CRC21_POLYNOMIAL, 10>();
+
+
+/*==================================================================================================
+*                                       GLOBAL FUNCTIONS
+==================================================================================================*/
+/** @brief CRC register of Width bits after count more bits (at most the bits of the table), MSB first */
+template<uint32 Width, std::size_t Size>
+constexpr uint32 crcBits(uint32 crc, uint32 value, uint32 count, const std::array<uint32, Size>& table)
+{
+    return ((crc << count) & ((1u << Width) - 1)) ^ table[(crc >> (Width - count)) ^ value];
+}
+
+/**
+ * @brief Classic frame as sent on the bus
+ * @details The stuff bits of SOF to the CRC sequence depend on the identifier, the payload and their
+ *          CRC, both advanced one byte per lookup. The header is aligned on bytes by leading bits:
+ *          zeros leave the CRC of a cleared register unchanged, alternating bits ending recessive
+ *          never stuff and leave SOF starting a run. A DLC above 8 carries 8 bytes, remote frames none.
+ * @param id identifier without the XL extended flag
+ */
+constexpr StuffedFrame classicFrame(bool extended, bool remote, uint32 id, uint8 dlc, const uint8* data)
+{
+    const uint32 length = remote ? 0u : std::min<uint32>(dlc & 0xFu, MAX_MSG_LEN);
+    // SOF (dominant, the leading 0), identifier, RTR or SRR and IDE, the extended identifier and RTR, r1/r0 and DLC
+    const uint64 header = extended ? (static_cast<uint64>((id >> 18) & 0x7FF) << 27) | (3ull << 25) |
+                                     (static_cast<uint64>(id & 0x3FFFF) << 7) | (static_cast<uint64>(remote) << 6) | (dlc & 0xFu)
+                                   : (static_cast<uint64>(id & 0x7FF) << 7) | (static_cast<uint64>(remote) << 6) | (dlc & 0xFu);
+    const uint32 headerBits = extended ? 39 : 19;
+    const uint32 headerBytes = (headerBits + 7) / 8;
+    const uint64 stuffedHeader = header | ((0x55ull & ((1u << (8 * headerBytes - headerBits)) - 1)) << headerBits);
+    uint32 crc = 0;
+    uint32 state = StuffStateIdle;
+    uint32 stuffBits = 0;
+    const auto stuffByte = [&state, &stuffBits](uint32 byte) {
+        const uint32 entry = StuffTable[state][byte & 0xFF];
+        stuffBits += (entry >> 4) & 3u;
+        state = entry & 0xFu;
+    };
+
+    for(uint32 byte = headerBytes; byte-- > 0;)
+    {
+        crc = crcBits<15>(crc, static_cast<uint32>(header >> (8 * byte)) & 0xFF, 8, Crc15Table);
+        stuffByte(static_cast<uint32>(stuffedHeader >> (8 * byte)));
+    }
+    for(uint32 byte = 0; byte < length; ++byte)
+    {
+        crc = crcBits<15>(crc, data[byte], 8, Crc15Table);
+        stuffByte(data[byte]);
+    }
+    // the CRC sequence then the opposite of its last bit, which ends a run without stuffing
+    const uint32 sequence = crc << 1 | (~crc & 1u);
+    stuffByte(sequence >> 8);
+    stuffByte(sequence);
+    // CRC, CRC delimiter, ACK slot and delimiter, EOF, intermission
+    return StuffedFrame{FrameBits{headerBits + 8 * length + 15 + 1 + 2 + 7 + 3 + stuffBits, 0}, crc, stuffBits};
+}
+
+/**
+ * @brief CAN FD frame as sent on the bus, with the CRC of Width bits
+ * @details ISO 11898-1:2015: the CRC covers SOF to the data field with its dynamic stuff bits, then
+ *          the stuff count, from a register holding a leading 1. The stuffed bits of each byte come
+ *          from the stuffing table and advance the CRC by 8 to 10 bits. The arbitration field is
+ *          aligned on bytes by leading bits sent neither to the CRC nor on the bus; the 5 bits of
+ *          ESI and DLC shift the data field, whose last 5 bits are sent followed by 3 alternating
+ *          bits that never stuff. A stuff bit after BRS counts at the nominal bitrate.
+ */
+template<uint32 Width>
+constexpr StuffedFrame fdFrameWithCrc(bool extended, bool brs, bool esi, uint32 id, uint8 dlc, const uint8* data)
+{
+    constexpr const auto& table = Width == 17 ? Crc17Table : Crc21Table;
+    const uint32 length = CanData::getPayloadSize(dlc & 0xFu);
+    // SOF, identifier, RRS (dominant) or SRR and IDE, the extended identifier and RRS, FDF (recessive), res and BRS
+    const uint64 arbitration = extended ? (static_cast<uint64>((id >> 18) & 0x7FF) << 24) | (3ull << 22) |
+                                          (static_cast<uint64>(id & 0x3FFFF) << 4) | (1u << 2) | static_cast<uint64>(brs)
+                                        : (static_cast<uint64>(id & 0x7FF) << 5) | (1u << 2) | static_cast<uint64>(brs);
+    const uint32 arbitrationBits = extended ? 36 : 17;
+    const uint32 arbitrationBytes = (arbitrationBits + 7) / 8;
+    const uint32 alignment = 8 * arbitrationBytes - arbitrationBits;
+    const uint64 aligned = arbitration | ((0x55ull & ((1u << alignment) - 1)) << arbitrationBits);
+    uint32 crc = 1u << (Width - 1);
+    uint32 state = StuffStateIdle;
+    // the bits sent for a byte, without its leading and trailing bits which are not part of the frame
+    const auto send = [&state, &crc](uint32 byte, uint32 leading, uint32 trailing) {
+        const uint32 entry = StuffTable[state][byte & 0xFF];
+        const uint32 stuffed = (entry >> 4) & 3u;
+        const uint32 count = 8 + stuffed - leading - trailing;
+        crc = crcBits<Width>(crc, ((entry >> 6) >> trailing) & ((1u << count) - 1), count, table);
+        state = entry & 0xFu;
+        return stuffed;
+    };
+
+    uint32 arbitrationStuffBits = 0;
+    for(uint32 byte = arbitrationBytes; byte-- > 0;)
+    {
+        arbitrationStuffBits += send(static_cast<uint32>(aligned >> (8 * byte)), byte + 1 == arbitrationBytes ? alignment : 0, 0);
+    }
+    uint32 dataStuffBits = 0;
+    uint32 previous = (esi ? 0x10u : 0u) | (dlc & 0xFu);
+    for(uint32 byte = 0; byte < length; ++byte)
+    {
+        dataStuffBits += send((previous << 3) | (data[byte] >> 5), 0, 0);
+        previous = data[byte];
+    }
+    dataStuffBits += send(((previous & 0x1Fu) << 3) | ((previous & 1u) != 0 ? 0x2u : 0x5u), 0, 3);
+    // stuff count: the dynamic stuff bits modulo 8 in Gray code, then an even parity bit
+    const uint32 stuffBits = arbitrationStuffBits + dataStuffBits;
+    const uint32 gray = (stuffBits % 8) ^ ((stuffBits % 8) >> 1);
+    crc = crcBits<Width>(crc, gray << 1 | (std::popcount(gray) & 1u), 4, table);
+
+    // ESI, DLC, data, stuff count, CRC, a fixed stuff bit before the stuff count and after every 4 bits, CRC delimiter
+    const uint32 dataPhase = 1 + 4 + 8 * length + dataStuffBits + 4 + Width + (4 + Width + 3) / 4 + 1;
+    // ACK slot and delimiter, EOF, intermission
+    const uint32 nominal = arbitrationBits + arbitrationStuffBits + 2 + 7 + 3;
+    return StuffedFrame{brs ? FrameBits{nominal, dataPhase} : FrameBits{nominal + dataPhase, 0}, crc, stuffBits};
+}
+
+/** @brief CAN FD frame as sent on the bus, CRC-17 up to 16 bytes of payload, CRC-21 beyond */
+constexpr StuffedFrame fdFrame(bool extended, bool brs, bool esi, uint32 id, uint8 dlc, const uint8* data)
+{
+    return CanData::getPayloadSize(dlc & 0xFu) <= CANFD_CRC17_MAX_LEN ? fdFrameWithCrc<17>(extended, brs, esi, id, dlc, data)
+                                                                       : fdFrameWithCrc<21>(extended, brs, esi, id, dlc, data);
+}
+
+/** @brief Bits of a classic frame from SOF to the end of the intermission, stuff bits included */
+constexpr FrameBits classicFrameBits(bool extended, bool remote, uint32 id, uint8 dlc, const uint8* data)
+{
+    return classicFrame(extended, remote, id, dlc, data).bits;
+}
+
+/** @brief Bits of a CAN FD frame from SOF to the end of the intermission, stuff bits included */
+constexpr FrameBits fdFrameBits(bool extended, bool brs, bool esi, uint32 id, uint8 dlc, const uint8* data)
+{
+    return fdFrame(extended, brs, esi, id, dlc, data).bits;
+}
+
+/**
+ * @brief Frame a PDU is sent as by Can_XLdriver_Write: the smallest DLC holding its SDU, padded
+ * @details The frame type is read from the identifier, the CAN FD frames longer than 64 bytes
+ *          and the classic ones longer than 8 bytes are truncated.
+ * @param brs bitrate switch of the HTH, ignored for classic frames
+ */
+inline StuffedFrame stuffedFrameOf(const Can_PduType& pdu, bool brs, uint8 paddingValue)
+{
+    const FrameType frameType(pdu.id);
+    const bool fd = frameType == FrameType::StandardCanFd || frameType == FrameType::ExtendedCanFd;
+    const bool extended = frameType == FrameType::ExtendedCan || frameType == FrameType::ExtendedCanFd;
+    const uint32 id = pdu.id & (extended ? 0x1FFFFFFFu : 0x7FFu);
+
+    if(!fd)
+    {
+        return classicFrame(extended, false, id, std::min<uint8>(pdu.length, MAX_MSG_LEN), pdu.sdu);
+    }
+    unsigned char payload[XL_CAN_MAX_DATA_LEN];
+    const auto length = std::min<uint8>(pdu.length, XL_CAN_MAX_DATA_LEN);
+    copyPadded(payload, pdu.sdu, length, paddingValue);
+    return fdFrame(extended, brs, false, id, CanData::getDLC(length), payload);
+}
+
+/**
+ * @brief Reference of classicFrame and fdFrame: the frame built bit by bit, stuffed by counting runs
+ * @param remote remote frame, classic frames only
+ * @param brs bitrate switch, CAN FD frames only
+ * @param esi error state indicator, CAN FD frames only
+ */
+constexpr StuffedFrame stuffedFrameReference(bool extended, bool fd, bool remote, bool brs, bool esi, uint32 id, uint8 dlc, const uint8* data)
+{
+    std::array<uint8, 640> bits{};
+    uint32 size = 0;
+    const auto put = [&bits, &size](uint64 value, uint32 count) {
+        for(uint32 bit = count; bit-- > 0;)
+        {
+            bits[size++] = static_cast<uint8>((value >> bit) & 1u);
+        }
+    };
+    const uint32 length = fd ? CanData::getPayloadSize(dlc & 0xFu) : remote ? 0u : std::min<uint32>(dlc & 0xFu, MAX_MSG_LEN);
+
+    put(0, 1);
+    if(extended)
+    {
+        put(id >> 18, 11);
+        put(3, 2);
+        put(id, 18);
+        put(!fd && remote, 1);
+    }
+    else
+    {
+        put(id, 11);
+        put(!fd && remote, 1);
+        put(0, 1);
+    }
+    if(fd)
+    {
+        put(1, 1);
+        put(0, 1);
+        put(brs, 1);
+    }
+    const uint32 arbitrationEnd = size;
+    if(fd)
+    {
+        put(esi, 1);
+    }
+    else
+    {
+        put(0, extended ? 2 : 1);
+    }
+    put(dlc & 0xFu, 4);
+    for(uint32 byte = 0; byte < length; ++byte)
+    {
+        put(data[byte], 8);
+    }
+
+    uint32 crc = 0;
+    if(!fd)
+    {
+        for(uint32 bit = 0; bit < size; ++bit)
+        {
+            crc = crcBit<15, CAN_CRC15_POLYNOMIAL>(crc, bits[bit]);
+        }
+        put(crc, 15);
+    }
+    // dynamic stuffing of SOF to the CRC sequence (classic) or to the data field (CAN FD)
+    std::array<uint8, 800> sent{};
+    uint32 sentSize = 0;
+    uint32 stuffBits = 0;
+    uint32 arbitrationStuffBits = 0;
+    uint32 level = 2;
+    uint32 run = 0;
+    for(uint32 bit = 0; bit < size; ++bit)
+    {
+        sent[sentSize++] = bits[bit];
+        run = bits[bit] == level ? run + 1 : 1;
+        level = bits[bit];
+        if(run == 5)
+        {
+            level = 1u - level;
+            sent[sentSize++] = static_cast<uint8>(level);
+            run = 1;
+            ++stuffBits;
+        }
+        if(bit + 1 == arbitrationEnd)
+        {
+            arbitrationStuffBits = stuffBits;
+        }
+    }
+    if(!fd)
+    {
+        return StuffedFrame{FrameBits{sentSize + 1 + 2 + 7 + 3, 0}, crc, stuffBits};
+    }
+
+    const uint32 width = length <= CANFD_CRC17_MAX_LEN ? 17 : 21;
+    crc = 1u << (width - 1);
+    const uint32 count = stuffBits % 8;
+    const uint32 stuffCount = (count ^ (count >> 1)) << 1 | (std::popcount(count ^ (count >> 1)) & 1u);
+    for(uint32 bit = 0; bit < sentSize + 4; ++bit)
+    {
+        const uint32 value = bit < sentSize ? sent[bit] : (stuffCount >> (sentSize + 3 - bit)) & 1u;
+        crc = width == 17 ? crcBit<17, CAN_CRC17_POLYNOMIAL>(crc, value) : crcBit<21, CAN_CRC21_POLYNOMIAL>(crc, value);
+    }
+    // the CRC field: a fixed stuff bit, then one after every 4 bits of the stuff count and the CRC
+    uint32 crcField = 0;
+    for(uint32 bit = 0; bit < 4 + width; ++bit)
+    {
+        crcField += bit % 4 == 0 ? 2 : 1;
+    }
+    const uint32 nominal = arbitrationEnd + arbitrationStuffBits + 2 + 7 + 3;
+    const uint32 dataPhase = sentSize - arbitrationEnd - arbitrationStuffBits + crcField + 1;
+    return StuffedFrame{brs ? FrameBits{nominal, dataPhase} : FrameBits{nominal + dataPhase, 0}, crc, stuffBits};
+}
+
+/** @brief Same frame from the tables and from the reference */
+constexpr bool isStuffedFrameEquivalent(bool extended, bool fd, bool brs, uint32 id, uint8 dlc, const uint8* data)
+{
+    const auto frame = fd ? fdFrame(extended, brs, false, id, dlc, data) : classicFrame(extended, false, id, dlc, data);
+    const auto reference = stuffedFrameReference(extended, fd, false, brs, false, id, dlc, data);
+    return frame.bits.nominal == reference.bits.nominal && frame.bits.data == reference.bits.data &&
+           frame.crc == reference.crc && frame.stuffBits == reference.stuffBits;
+}
+
+/** @brief Every DLC of every frame type, with an identifier and a payload stuffing the most, the least and in between */
+constexpr bool isStuffedFrameEquivalent()
+{
+    std::array<uint8, XL_CAN_MAX_DATA_LEN> zeros{};
+    std::array<uint8, XL_CAN_MAX_DATA_LEN> ones{};
+    std::array<uint8, XL_CAN_MAX_DATA_LEN> counting{};
+    for(uint32 byte = 0; byte < XL_CAN_MAX_DATA_LEN; ++byte)
+    {
+        ones[byte] = 0xFF;
+        counting[byte] = static_cast<uint8>(byte * 37 + 1);
+    }
+    for(uint8 dlc = 0; dlc < 16; ++dlc)
+    {
+        for(const auto& [id, data] : {std::pair{0u, zeros.data()}, std::pair{0x1FFFFFFFu, ones.data()}, std::pair{0x0AAAAAAAu, counting.data()}})
+        {
+            for(const bool extended : {false, true})
+            {
+                if(!isStuffedFrameEquivalent(extended, false, false, id, dlc, data) ||
+                   !isStuffedFrameEquivalent(extended, true, (dlc & 1) != 0, id, dlc, data))
+                {
+                    return false;
+                }
+            }
+        }
+    }
+    return true;
+}
+
+/** @brief CRC of "123456789" sent most significant bit first from a cleared register, the check value of the CRC catalogues */
+template<uint32 Width, uint32 Polynomial>
+constexpr uint32 crcCheck()
+{
+    uint32 crc = 0;
+    for(const char byte : std::string_view{"123456789"})
+    {
+        for(int bit = 7; bit >= 0; --bit)
+        {
+            crc = crcBit<Width, Polynomial>(crc, (static_cast<uint32>(byte) >> bit) & 1u);
+        }
+    }
+    return crc;
+}
+
+// CRC-15/CAN, CRC-17/CAN-FD and CRC-21/CAN-FD of the catalogues
+static_assert(crcCheck<15, CAN_CRC15_POLYNOMIAL>() == 0x059E);
+static_assert(crcCheck<17, CAN_CRC17_POLYNOMIAL>() == 0x04F03);
+static_assert(crcCheck<21, CAN_CRC21_POLYNOMIAL>() == 0x0ED841);
+// 34 dominant bits from SOF to the CRC sequence, a stuff bit after every 5
+static_assert(classicFrameBits(false, false, 0, 0, nullptr).nominal == ShortestFrameBits + 6);
+static_assert(fdFrameBits(false, false, false, 0, 0, nullptr).nominal >= frameBits(false, true, false, false, 0).nominal);
+static_assert(isStuffedFrameEquivalent());
+
+
+#endif //XLBITSTREAM_H
+
+/**@} */ // END OF addtogroup xlbitstream
@@ -0,0 +1,216 @@
+/**
+ * @file xlbittiming.h
+ * @author Maxime Verreault
+ * @date 2026-10-19
+ * @copyright COPYRIGHT(c) Maxime Verreault All rights reserved.
+ * @brief CAN and CAN FD bit timing solver, usable in constant expressions
+ * @ingroup xldriver
+ * @addtogroup xlbittiming
+ * @{
+ */
+
+
+#ifndef XLBITTIMING_H
+#define XLBITTIMING_H
+
+/*==================================================================================================
+*                                         INCLUDE FILES
+* 1) system and project includes
+* 2) needed interfaces from external units
+* 3) internal and external interfaces from this unit
+==================================================================================================*/
+#include "vxlapi.h"
+#include <algorithm>
+#include <Can_GeneralTypes.h>
+#include "Can_XLdriver.h"
+
+
+/*==================================================================================================
+*                                       DEFINES AND MACROS
+==================================================================================================*/
+#define XL_CANFD_CLOCK                  80000000u   //!< Protocol clock of the XL CAN FD controllers (Hz)
+#define XL_DEFAULT_SAMPLE_POINT         875u        //!< Nominal sample point (per mille), CiA 601-3 recommendation
+#define XL_DEFAULT_FD_SAMPLE_POINT      750u        //!< Data phase sample point (per mille), CiA 601-3 recommendation
+
+
+/*==================================================================================================
+*                                STRUCTURES AND OTHER TYPEDEFS
+==================================================================================================*/
+/** @brief Register ranges of one phase of the controller, in time quanta */
+struct BitTimingLimits
+{
+    uint32 tseg1Min;
+    uint32 tseg1Max;
+    uint32 tseg2Min;
+    uint32 tseg2Max;
+    uint32 sjwMax;
+    uint32 prescalerMax;
+};
+
+/** @brief Arbitration phase ranges, tseg1 includes the propagation segment */
+inline constexpr BitTimingLimits NominalBitTimingLimits{2, 256, 2, 128, 128, 512};
+/** @brief Data phase ranges */
+inline constexpr BitTimingLimits DataBitTimingLimits{1, 32, 1, 16, 16, 32};
+
+/** @brief Timing of one phase, the bit is 1 (sync) + tseg1 + tseg2 quanta of prescaler clock periods */
+struct BitTiming
+{
+    uint32 bitRate = 0;
+    uint32 prescaler = 0;
+    uint32 tseg1 = 0;
+    uint32 tseg2 = 0;
+    uint32 sjw = 0;
+    uint32 samplePoint = 0;     //!< reached sample point (per mille)
+
+    [[nodiscard]] constexpr bool valid() const
+    {
+        return prescaler != 0;
+    }
+
+    [[nodiscard]] constexpr uint32 quanta() const
+    {
+        return 1 + tseg1 + tseg2;
+    }
+};
+
+/** @brief Arbitration and data phase timings of a CAN FD controller */
+struct FdBitTiming
+{
+    BitTiming nominal;
+    BitTiming data;
+
+    [[nodiscard]] constexpr bool valid() const
+    {
+        return nominal.valid() && data.valid();
+    }
+};
+
+
+/*==================================================================================================
+*                                       GLOBAL FUNCTIONS
+==================================================================================================*/
+/**
+ * @brief Best timing of one phase for an exact bitrate
+ * @details Every prescaler dividing the clock into a whole number of quanta per bit is tried. The
+ *          segments are placed as close as possible to the target sample point, then the timing
+ *          with the most quanta (finest resynchronization) wins among the equally close ones.
+ *          The SJW is the whole phase segment 2, as large as the controller allows.
+ * @param prescaler 0 to try every prescaler, else the only one accepted
+ * @return an invalid timing (prescaler 0) when the bitrate cannot be reached exactly
+ */
+constexpr BitTiming solveBitTiming(uint32 clock, uint32 bitRate, uint32 samplePoint, const BitTimingLimits& limits, uint32 prescaler = 0)
+{
+    BitTiming best{};
+    uint32 bestError = 0;
+
+    if(bitRate == 0)
+    {
+        return best;
+    }
+    for(uint32 candidate = prescaler != 0 ? prescaler : 1; candidate <= (prescaler != 0 ? prescaler : limits.prescalerMax); ++candidate)
+    {
+        const auto divider = static_cast<unsigned long long>(candidate) * bitRate;
+        if(clock % divider != 0)
+        {
+            continue;
+        }
+        const auto quanta = static_cast<uint32>(clock / divider);
+        if(quanta < 1 + limits.tseg1Min + limits.tseg2Min || quanta > 1 + limits.tseg1Max + limits.tseg2Max)
+        {
+            continue;
+        }
+        // quanta before the sample point, the sync segment included
+        const uint32 sampled = (quanta * samplePoint + 500) / 1000;
+        const uint32 tseg2 = std::clamp(quanta - std::max<uint32>(sampled, 1), limits.tseg2Min, limits.tseg2Max);
+        const uint32 tseg1 = quanta - 1 - tseg2;
+        if(tseg1 < limits.tseg1Min || tseg1 > limits.tseg1Max)
+        {
+            continue;
+        }
+        const uint32 reached = (1 + tseg1) * 1000 / quanta;
+        const uint32 error = reached > samplePoint ? reached - samplePoint : samplePoint - reached;
+        if(!best.valid() || error < bestError || (error == bestError && quanta > best.quanta()))
+        {
+            best = BitTiming{bitRate, candidate, tseg1, tseg2, std::min(tseg2, limits.sjwMax), reached};
+            bestError = error;
+        }
+    }
+    return best;
+}
+
+/**
+ * @brief Best timings of both phases of a CAN FD controller
+ * @details The data phase keeps the prescaler of the arbitration phase when it can, as ISO 11898-1
+ *          recommends for the transmitter delay compensation, else it picks its own.
+ */
+constexpr FdBitTiming solveFdBitTiming(uint32 clock, uint32 bitRate, uint32 samplePoint, uint32 dataBitRate, uint32 dataSamplePoint)
+{
+    FdBitTiming timing{solveBitTiming(clock, bitRate, samplePoint, NominalBitTimingLimits), {}};
+
+    if(timing.nominal.valid())
+    {
+        timing.data = solveBitTiming(clock, dataBitRate, dataSamplePoint, DataBitTimingLimits, timing.nominal.prescaler);
+        if(!timing.data.valid())
+        {
+            timing.data = solveBitTiming(clock, dataBitRate, dataSamplePoint, DataBitTimingLimits);
+        }
+    }
+    return timing;
+}
+
+/**
+ * @brief Timings of a baudrate configuration
+ * @details A classic CAN configuration keeps the nominal timing in the data phase of an FD channel.
+ */
+constexpr FdBitTiming solveBaudrate(const Can_XLdriver_BaudrateConfigType& baudrate, uint32 clock = XL_CANFD_CLOCK)
+{
+    const uint32 samplePoint = baudrate.SamplePoint != 0 ? baudrate.SamplePoint : XL_DEFAULT_SAMPLE_POINT;
+    const uint32 dataSamplePoint = baudrate.FdSamplePoint != 0 ? baudrate.FdSamplePoint : XL_DEFAULT_FD_SAMPLE_POINT;
+
+    if(baudrate.FdBaudRate == 0)
+    {
+        const auto nominal = solveBitTiming(clock, baudrate.BaudRate, samplePoint, NominalBitTimingLimits);
+        return FdBitTiming{nominal, nominal};
+    }
+    return solveFdBitTiming(clock, baudrate.BaudRate, samplePoint, baudrate.FdBaudRate, dataSamplePoint);
+}
+
+/** @brief Every baudrate of the configuration has a timing, usable in a static_assert on generated tables */
+constexpr bool isBitTimingSolvable(const Can_XLdriver_ConfigType& config, uint32 clock = XL_CANFD_CLOCK)
+{
+    for(uint8 id = 0; id < config.ControllerCount; ++id)
+    {
+        const auto& controller = config.Controllers[id];
+        for(uint16 baudrate = 0; baudrate < controller.BaudrateConfigCount; ++baudrate)
+        {
+            if(!solveBaudrate(controller.BaudrateConfigs[baudrate], clock).valid())
+            {
+                return false;
+            }
+        }
+    }
+    return true;
+}
+
+/** @brief XL configuration of a solved timing, the driver derives the prescalers from the bitrates and quanta */
+inline void toXLcanFdConf(const FdBitTiming& timing, XLcanFdConf& fdParams)
+{
+    fdParams.arbitrationBitRate = timing.nominal.bitRate;
+    fdParams.tseg1Abr           = timing.nominal.tseg1;
+    fdParams.tseg2Abr           = timing.nominal.tseg2;
+    fdParams.sjwAbr             = timing.nominal.sjw;
+    fdParams.dataBitRate        = timing.data.bitRate;
+    fdParams.tseg1Dbr           = timing.data.tseg1;
+    fdParams.tseg2Dbr           = timing.data.tseg2;
+    fdParams.sjwDbr             = timing.data.sjw;
+}
+
+// the rates of our networks, checked at compile time against the XL clock
+static_assert(solveFdBitTiming(XL_CANFD_CLOCK, 500000, XL_DEFAULT_SAMPLE_POINT, 2000000, XL_DEFAULT_FD_SAMPLE_POINT).valid());
+static_assert(solveFdBitTiming(XL_CANFD_CLOCK, 500000, XL_DEFAULT_SAMPLE_POINT, 5000000, XL_DEFAULT_FD_SAMPLE_POINT).valid());
+static_assert(solveBitTiming(XL_CANFD_CLOCK, 500000, XL_DEFAULT_SAMPLE_POINT, NominalBitTimingLimits).tseg1 == 139);
+
+
+#endif //XLBITTIMING_H
+
+/**@} */ // END OF addtogroup xlbittiming
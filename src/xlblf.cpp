@@ -0,0 +1,303 @@
+/**
+ * @file xlblf.cpp
+ * @author Maxime Verreault
+ * @date 2026-10-19
+ * @copyright COPYRIGHT(c) Maxime Verreault All rights reserved.
+ * @brief Vector BLF (binary logging format) writer
+ * @ingroup xldriver
+ * @addtogroup xlblf
+ * @{
+ */
+
+
+/*==================================================================================================
+*                                        INCLUDE FILES
+* 1) system and project includes
+* 2) needed interfaces from external units
+* 3) internal and external interfaces from this unit
+==================================================================================================*/
+#include "xlblf.h"
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <cstring>
+#include <ctime>
+#include <utility>
+#include <zlib.h>
+
+
+/*==================================================================================================
+*                                       LOCAL FUNCTIONS
+==================================================================================================*/
+namespace
+{
+static_assert(std::endian::native == std::endian::little, "BLF is little endian, values are copied as is");
+
+constexpr uint32 ObjectSignature = 0x4A424F4C;     // "LOBJ"
+constexpr uint32 FileSignature = 0x47474F4C;       // "LOGG"
+constexpr uint16 ObjectHeaderBaseSize = 16;
+constexpr uint16 ObjectHeaderV1Size = 16;
+constexpr uint32 ObjectTimeOneNanos = 0x00000002;
+constexpr uint32 ObjectTypeCanMessage = 1;
+constexpr uint32 ObjectTypeLogContainer = 10;
+constexpr uint32 ObjectTypeCanErrorExt = 73;
+constexpr uint32 ObjectTypeCanFdMessage = 100;
+constexpr uint16 CompressionZlib = 2;
+constexpr uint32 CanMessageExtendedId = 0x80000000;
+constexpr uint8 CanMessageTx = 0x01;
+constexpr uint8 CanMessageRemote = 0x80;
+constexpr uint8 CanFdEdl = 0x01;
+constexpr uint8 CanFdBrs = 0x02;
+constexpr uint8 CanFdEsi = 0x04;
+
+template<typename T>
+void put(std::vector<uint8>& buffer, T value)
+{
+    const auto offset = buffer.size();
+    buffer.resize(offset + sizeof(T));
+    std::memcpy(buffer.data() + offset, &value, sizeof(T));
+}
+
+template<typename T>
+void put(uint8* buffer, std::size_t offset, T value)
+{
+    std::memcpy(buffer + offset, &value, sizeof(T));
+}
+
+/** @brief Windows SYSTEMTIME layout of a point in time, as stored in the file header */
+void putSystemTime(std::vector<uint8>& buffer, std::chrono::system_clock::time_point time)
+{
+    const auto seconds = std::chrono::system_clock::to_time_t(time);
+    const auto milliseconds = std::chrono::duration_cast<std::chrono::milliseconds>(time.time_since_epoch()).count() % 1000;
+    std::tm local{};
+#ifdef _WIN32
+    localtime_s(&local, &seconds);
+#else
+    localtime_r(&seconds, &local);
+#endif
+    put<uint16>(buffer, static_cast<uint16>(local.tm_year + 1900));
+    put<uint16>(buffer, static_cast<uint16>(local.tm_mon + 1));
+    put<uint16>(buffer, static_cast<uint16>(local.tm_wday));
+    put<uint16>(buffer, static_cast<uint16>(local.tm_mday));
+    put<uint16>(buffer, static_cast<uint16>(local.tm_hour));
+    put<uint16>(buffer, static_cast<uint16>(local.tm_min));
+    put<uint16>(buffer, static_cast<uint16>(local.tm_sec));
+    put<uint16>(buffer, static_cast<uint16>(milliseconds));
+}
+}
+
+
+/*==================================================================================================
+*                                       GLOBAL FUNCTIONS
+==================================================================================================*/
+BlfWriter::BlfWriter(const std::string& path, int compressionLevel):
+    file(std::fopen(path.c_str(), "wb")),
+    level(compressionLevel)
+{
+    if(file == nullptr)
+    {
+        return;
+    }
+    container.reserve(BLF_CONTAINER_SIZE + 128);
+    startTime = stopTime = std::chrono::system_clock::now();
+    writeHeader();
+    compressor = std::thread(&BlfWriter::compressLoop, this);
+}
+
+BlfWriter::~BlfWriter()
+{
+    close();
+}
+
+void BlfWriter::write(const RecordEntry& entry)
+{
+    if(file == nullptr)
+    {
+        return;
+    }
+    const auto isFrame = entry.kind == RecordKind::Rx || entry.kind == RecordKind::TxOk;
+    const auto isError = entry.kind == RecordKind::RxError || entry.kind == RecordKind::TxError || entry.kind == RecordKind::ErrorFrame;
+    if(!isFrame && !isError)
+    {
+        return;
+    }
+    if(!firstTimeStamp)
+    {
+        firstTimeStamp = entry.timeStamp;
+        startTime = std::chrono::system_clock::now();
+    }
+    const auto timeStamp = entry.timeStamp - std::min(entry.timeStamp, *firstTimeStamp);
+    stopTime = startTime + std::chrono::duration_cast<std::chrono::system_clock::duration>(std::chrono::nanoseconds(timeStamp));
+    const auto channel = static_cast<uint16>(entry.channel + 1u);
+    const auto id = (entry.canId & XL_CAN_EXT_MSG_ID) ? ((entry.canId & ~XL_CAN_EXT_MSG_ID) | CanMessageExtendedId) : entry.canId;
+
+    if(isError)
+    {
+        /* CAN_ERROR_EXT: channel, length, flags (4), ecc, position, dlc, reserved, frame length, id, extended flags, reserved (2), data */
+        std::array<uint8, 32> object{};
+        put<uint16>(object.data(), 0, channel);
+        put<uint16>(object.data(), 2, static_cast<uint16>(entry.length));
+        put<uint8>(object.data(), 10, entry.dlc);
+        put<uint32>(object.data(), 16, id);
+        std::memcpy(object.data() + 24, entry.data, std::min<std::size_t>(entry.length, 8));
+        addObject(ObjectTypeCanErrorExt, timeStamp, object.data(), object.size());
+    }
+    else if(entry.msgFlags & XL_CAN_RXMSG_FLAG_EDL)
+    {
+        /* CAN_FD_MESSAGE: channel, flags, dlc, id, frame length (4), bit count, FD flags, valid bytes, reserved (5), data */
+        std::array<uint8, 84> object{};
+        uint8 fdFlags = CanFdEdl;
+        fdFlags |= (entry.msgFlags & XL_CAN_RXMSG_FLAG_BRS) ? CanFdBrs : 0;
+        fdFlags |= (entry.msgFlags & XL_CAN_RXMSG_FLAG_ESI) ? CanFdEsi : 0;
+        put<uint16>(object.data(), 0, channel);
+        put<uint8>(object.data(), 2, entry.kind == RecordKind::TxOk ? CanMessageTx : 0);
+        put<uint8>(object.data(), 3, entry.dlc);
+        put<uint32>(object.data(), 4, id);
+        put<uint8>(object.data(), 13, fdFlags);
+        put<uint8>(object.data(), 14, entry.length);
+        std::memcpy(object.data() + 20, entry.data, std::min<std::size_t>(entry.length, RECORD_MAX_DATA_LEN));
+        addObject(ObjectTypeCanFdMessage, timeStamp, object.data(), object.size());
+    }
+    else
+    {
+        /* CAN_MESSAGE: channel, flags, dlc, id, data */
+        std::array<uint8, 16> object{};
+        uint8 flags = entry.kind == RecordKind::TxOk ? CanMessageTx : 0;
+        flags |= (entry.msgFlags & XL_CAN_RXMSG_FLAG_RTR) ? CanMessageRemote : 0;
+        put<uint16>(object.data(), 0, channel);
+        put<uint8>(object.data(), 2, flags);
+        put<uint8>(object.data(), 3, entry.dlc);
+        put<uint32>(object.data(), 4, id);
+        std::memcpy(object.data() + 8, entry.data, std::min<std::size_t>(entry.length, 8));
+        addObject(ObjectTypeCanMessage, timeStamp, object.data(), object.size());
+    }
+}
+
+void BlfWriter::close()
+{
+    if(file == nullptr)
+    {
+        return;
+    }
+    submitContainer();
+    {
+        std::lock_guard lock(mutex);
+        stopping = true;
+    }
+    pendingChanged.notify_all();
+    compressor.join();
+    std::fseek(file, 0, SEEK_SET);
+    writeHeader();
+    std::fclose(file);
+    file = nullptr;
+}
+
+uint64 BlfWriter::bytesWritten() const
+{
+    std::lock_guard lock(mutex);
+    return fileSize;
+}
+
+void BlfWriter::addObject(uint32 objectType, XLuint64 timeStamp, const uint8* data, std::size_t length)
+{
+    const auto headerSize = static_cast<uint16>(ObjectHeaderBaseSize + ObjectHeaderV1Size);
+    put<uint32>(container, ObjectSignature);
+    put<uint16>(container, headerSize);
+    put<uint16>(container, 1);
+    put<uint32>(container, static_cast<uint32>(headerSize + length));
+    put<uint32>(container, objectType);
+    put<uint32>(container, ObjectTimeOneNanos);
+    put<uint16>(container, 0);
+    put<uint16>(container, 0);
+    put<uint64>(container, timeStamp);
+    container.insert(container.end(), data, data + length);
+    container.resize(container.size() + length % 4);
+    ++objectCount;
+
+    if(container.size() >= BLF_CONTAINER_SIZE)
+    {
+        submitContainer();
+    }
+}
+
+void BlfWriter::submitContainer()
+{
+    if(container.empty())
+    {
+        return;
+    }
+    uncompressedSize += ObjectHeaderBaseSize + 16u + container.size();
+    std::unique_lock lock(mutex);
+    pendingChanged.wait(lock, [this]() { return pending.size() < BLF_MAX_PENDING_CONTAINERS; });
+    pending.push_back(std::exchange(container, {}));
+    lock.unlock();
+    pendingChanged.notify_all();
+    container.reserve(BLF_CONTAINER_SIZE + 128);
+}
+
+void BlfWriter::compressLoop()
+{
+    std::vector<uint8> compressed{};
+    std::vector<uint8> object{};
+    while(true)
+    {
+        std::vector<uint8> uncompressed{};
+        {
+            std::unique_lock lock(mutex);
+            pendingChanged.wait(lock, [this]() { return stopping || !pending.empty(); });
+            if(pending.empty())
+            {
+                return;
+            }
+            uncompressed = std::move(pending.front());
+            pending.pop_front();
+        }
+        pendingChanged.notify_all();
+
+        auto compressedLength = compressBound(static_cast<uLong>(uncompressed.size()));
+        compressed.resize(compressedLength);
+        compress2(compressed.data(), &compressedLength, uncompressed.data(), static_cast<uLong>(uncompressed.size()), level);
+
+        /* LOG_CONTAINER: base header only, then method, reserved, uncompressed size, reserved */
+        const auto objectSize = static_cast<uint32>(ObjectHeaderBaseSize + 16u + compressedLength);
+        object.clear();
+        put<uint32>(object, ObjectSignature);
+        put<uint16>(object, ObjectHeaderBaseSize);
+        put<uint16>(object, 1);
+        put<uint32>(object, objectSize);
+        put<uint32>(object, ObjectTypeLogContainer);
+        put<uint16>(object, CompressionZlib);
+        object.resize(object.size() + 6);
+        put<uint32>(object, static_cast<uint32>(uncompressed.size()));
+        object.resize(object.size() + 4);
+        object.insert(object.end(), compressed.begin(), compressed.begin() + static_cast<std::ptrdiff_t>(compressedLength));
+        object.resize(object.size() + objectSize % 4);
+        std::fwrite(object.data(), 1, object.size(), file);
+
+        std::lock_guard lock(mutex);
+        fileSize += object.size();
+    }
+}
+
+void BlfWriter::writeHeader()
+{
+    std::vector<uint8> header{};
+    header.reserve(BLF_FILE_HEADER_SIZE);
+    put<uint32>(header, FileSignature);
+    put<uint32>(header, BLF_FILE_HEADER_SIZE);
+    /* application id, application version, binary log version */
+    for(const uint8 value : {uint8{5}, uint8{0}, uint8{0}, uint8{0}, uint8{2}, uint8{6}, uint8{8}, uint8{1}})
+    {
+        put<uint8>(header, value);
+    }
+    put<uint64>(header, fileSize);
+    put<uint64>(header, uncompressedSize);
+    put<uint32>(header, objectCount);
+    put<uint32>(header, 0);
+    putSystemTime(header, startTime);
+    putSystemTime(header, stopTime);
+    header.resize(BLF_FILE_HEADER_SIZE);
+    std::fwrite(header.data(), 1, header.size(), file);
+}
+
+/**@} */ // END OF addtogroup xlblf
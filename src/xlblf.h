@@ -0,0 +1,90 @@
+/**
+ * @file xlblf.h
+ * @author Maxime Verreault
+ * @date 2026-10-19
+ * @copyright COPYRIGHT(c) Maxime Verreault All rights reserved.
+ * @brief Vector BLF (binary logging format) writer
+ * @ingroup xldriver
+ * @addtogroup xlblf
+ * @{
+ */
+
+
+#ifndef XLBLF_H
+#define XLBLF_H
+
+/*==================================================================================================
+*                                         INCLUDE FILES
+* 1) system and project includes
+* 2) needed interfaces from external units
+* 3) internal and external interfaces from this unit
+==================================================================================================*/
+#include <chrono>
+#include <condition_variable>
+#include <cstdio>
+#include <deque>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <thread>
+#include <vector>
+#include "xlexport.h"
+
+
+/*==================================================================================================
+*                                       DEFINES AND MACROS
+==================================================================================================*/
+#define BLF_FILE_HEADER_SIZE        144u
+#define BLF_CONTAINER_SIZE          (128u * 1024u)  // uncompressed bytes per log container
+#define BLF_MAX_PENDING_CONTAINERS  16u             // containers waiting for compression before write() blocks
+#define BLF_COMPRESSION_LEVEL       6               // zlib level, 1 is faster, 9 is smaller
+
+
+/*==================================================================================================
+*                                STRUCTURES AND OTHER TYPEDEFS
+==================================================================================================*/
+/**
+ * @brief Writes frames and error frames as a BLF file readable by CANoe/CANalyzer
+ * @details Objects are serialized on the calling (export) thread into 128 KiB containers, which a
+ *          dedicated thread deflates and appends to the file. The file header, holding the object
+ *          count and the file sizes, is rewritten on close.
+ */
+class BlfWriter : public LogWriter
+{
+public:
+    explicit BlfWriter(const std::string& path, int compressionLevel = BLF_COMPRESSION_LEVEL);
+    BlfWriter(const BlfWriter&) = delete;
+    BlfWriter& operator=(const BlfWriter&) = delete;
+    ~BlfWriter() override;
+
+    [[nodiscard]] bool isOpen() const { return file != nullptr; }
+    void write(const RecordEntry& entry) override;
+    void close() override;
+    [[nodiscard]] uint64 bytesWritten() const override;
+
+private:
+    std::FILE* file{nullptr};
+    const int level;
+    std::vector<uint8> container{};
+    std::optional<XLuint64> firstTimeStamp{};
+    std::chrono::system_clock::time_point startTime{};
+    std::chrono::system_clock::time_point stopTime{};
+    uint32 objectCount{0};
+    uint64 uncompressedSize{BLF_FILE_HEADER_SIZE};
+
+    mutable std::mutex mutex{};
+    std::condition_variable pendingChanged{};
+    std::deque<std::vector<uint8>> pending{};
+    bool stopping{false};
+    uint64 fileSize{BLF_FILE_HEADER_SIZE};
+    std::thread compressor{};
+
+    void addObject(uint32 objectType, XLuint64 timeStamp, const uint8* data, std::size_t length);
+    void submitContainer();
+    void compressLoop();
+    void writeHeader();
+};
+
+#endif //XLBLF_H
+
+/**@} */ // END OF addtogroup xlblf
@@ -0,0 +1,181 @@
+/**
+ * @file xlbusload.h
+ * @author Maxime Verreault
+ * @date 2026-10-19
+ * @copyright COPYRIGHT(c) Maxime Verreault All rights reserved.
+ * @brief Bus load of each channel, from the bus time of the frames seen by the RX path
+ * @ingroup xldriver
+ * @addtogroup xlbusload
+ * @{
+ */
+
+
+#ifndef XLBUSLOAD_H
+#define XLBUSLOAD_H
+
+/*==================================================================================================
+*                                         INCLUDE FILES
+* 1) system and project includes
+* 2) needed interfaces from external units
+* 3) internal and external interfaces from this unit
+==================================================================================================*/
+#include "vxlapi.h"
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <Platform_Types.h>
+#include "xlframe.h"
+
+
+/*==================================================================================================
+*                                       DEFINES AND MACROS
+==================================================================================================*/
+#define BUS_LOAD_BUCKET_NS         100000000ull     // bus time summed per bucket of the sliding window (100 ms)
+#define BUS_LOAD_WINDOW_BUCKETS    10u              // completed buckets averaged (1 s)
+
+
+/*==================================================================================================
+*                                STRUCTURES AND OTHER TYPEDEFS
+==================================================================================================*/
+/** @brief Load of one channel (%) */
+struct BusLoad
+{
+    float32 current;    //!< last completed bucket
+    float32 average;    //!< completed buckets of the sliding window
+    float32 peak;       //!< highest completed bucket since the port was opened
+};
+
+/**
+ * @brief Bus time of the frames of each channel, summed in buckets of a sliding window
+ * @details The thread reading the XL queue adds the frames with their driver timestamp, which is
+ *          also the clock of the window: the newest timestamp of the port completes the buckets of
+ *          every channel, an idle channel drops to 0 % as soon as another one receives. The bucket
+ *          being filled is never reported. A snapshot is a few relaxed loads, from any thread, and
+ *          may mix two consecutive buckets when it races with the RX thread.
+ */
+class BusLoadMeter
+{
+public:
+    /** @brief Bitrates of the frames added from now on, set when the channel is configured */
+    void setBitRates(unsigned int channelIndex, uint32 bitRate, uint32 dataBitRate)
+    {
+        auto& channel = channels[channelIndex % channels.size()];
+        channel.psPerBit.store(bitRate != 0 ? 1000000000000ull / bitRate : 0, std::memory_order_relaxed);
+        channel.psPerDataBit.store(dataBitRate != 0 ? 1000000000000ull / dataBitRate : 0, std::memory_order_relaxed);
+    }
+
+    /** @brief Add a frame seen on the bus of a channel, from the thread reading the XL queue only */
+    void addFrame(unsigned int channelIndex, XLuint64 timeStamp, const FrameBits& bits)
+    {
+        auto& channel = channels[channelIndex % channels.size()];
+        const auto busTime = bits.nominal * channel.psPerBit.load(std::memory_order_relaxed) +
+                             bits.data * channel.psPerDataBit.load(std::memory_order_relaxed);
+        // the events of the port are almost in timestamp order, a late one goes to the bucket being filled
+        const auto bucket = std::max<uint64>(timeStamp / BUS_LOAD_BUCKET_NS, channel.bucket.load(std::memory_order_relaxed));
+
+        if(firstBucket.load(std::memory_order_relaxed) == NoBucket)
+        {
+            firstBucket.store(bucket, std::memory_order_relaxed);
+        }
+        if(bucket > latestBucket.load(std::memory_order_relaxed))
+        {
+            latestBucket.store(bucket, std::memory_order_relaxed);
+        }
+        advance(channel, bucket);
+        auto& slot = channel.buckets[bucket % channel.buckets.size()];
+        slot.store(slot.load(std::memory_order_relaxed) + busTime, std::memory_order_relaxed);
+    }
+
+    /** @brief Load of a channel up to the newest timestamp of the port */
+    [[nodiscard]] BusLoad snapshot(unsigned int channelIndex) const
+    {
+        const auto& channel = channels[channelIndex % channels.size()];
+        const auto newest = channel.bucket.load(std::memory_order_relaxed);
+        const auto now = std::max(latestBucket.load(std::memory_order_relaxed), newest);
+        const auto start = firstBucket.load(std::memory_order_relaxed);
+        BusLoad load{0.0f, 0.0f, toPercent(channel.peak.load(std::memory_order_relaxed))};
+
+        if(start == NoBucket || now == start)
+        {
+            return load;
+        }
+        // the completed buckets of the window, those after the newest one of the channel were idle
+        const auto completed = std::min<uint64>(now - start, BUS_LOAD_WINDOW_BUCKETS);
+        uint64 busTime = 0;
+        for(uint64 bucket = now - completed; bucket < now; ++bucket)
+        {
+            const auto value = bucket <= newest ? channel.buckets[bucket % channel.buckets.size()].load(std::memory_order_relaxed) : 0;
+            busTime += value;
+            if(bucket + 1 == now)
+            {
+                load.current = toPercent(value);
+            }
+        }
+        load.average = toPercent(busTime) / static_cast<float32>(completed);
+        load.peak = std::max(load.peak, load.current);
+        return load;
+    }
+
+    /** @brief Forget every frame, when the port is opened */
+    void reset()
+    {
+        for(auto& channel : channels)
+        {
+            for(auto& bucket : channel.buckets)
+            {
+                bucket.store(0, std::memory_order_relaxed);
+            }
+            channel.bucket.store(0, std::memory_order_relaxed);
+            channel.peak.store(0, std::memory_order_relaxed);
+        }
+        firstBucket.store(NoBucket, std::memory_order_relaxed);
+        latestBucket.store(0, std::memory_order_relaxed);
+    }
+
+private:
+    static constexpr uint64 NoBucket = ~uint64{0};
+
+    struct Channel
+    {
+        std::atomic<uint64> psPerBit{0};
+        std::atomic<uint64> psPerDataBit{0};
+        std::array<std::atomic<uint64>, BUS_LOAD_WINDOW_BUCKETS + 1> buckets{};     //!< bus time (ps), the window and the bucket being filled
+        std::atomic<uint64> bucket{0};                                              //!< bucket being filled
+        std::atomic<uint64> peak{0};                                                //!< bus time (ps) of the busiest completed bucket
+    };
+
+    static float32 toPercent(uint64 busTimePs)
+    {
+        return static_cast<float32>(static_cast<double>(busTimePs) / (BUS_LOAD_BUCKET_NS * 10.0));
+    }
+
+    /** @brief Complete the buckets of a channel up to the one of a new frame, the skipped ones were idle */
+    static void advance(Channel& channel, uint64 bucket)
+    {
+        const auto current = channel.bucket.load(std::memory_order_relaxed);
+        if(bucket == current)
+        {
+            return;
+        }
+        const auto completed = channel.buckets[current % channel.buckets.size()].load(std::memory_order_relaxed);
+        if(completed > channel.peak.load(std::memory_order_relaxed))
+        {
+            channel.peak.store(completed, std::memory_order_relaxed);
+        }
+        const auto cleared = std::min<uint64>(bucket - current, channel.buckets.size());
+        for(uint64 skipped = 1; skipped <= cleared; ++skipped)
+        {
+            channel.buckets[(bucket + channel.buckets.size() - skipped + 1) % channel.buckets.size()].store(0, std::memory_order_relaxed);
+        }
+        channel.bucket.store(bucket, std::memory_order_relaxed);
+    }
+
+    std::array<Channel, XL_CONFIG_MAX_CHANNELS> channels{};
+    std::atomic<uint64> firstBucket{NoBucket};          //!< bucket of the first frame since the port was opened
+    std::atomic<uint64> latestBucket{0};                //!< newest bucket of the port, the clock of the window
+};
+
+
+#endif //XLBUSLOAD_H
+
+/**@} */ // END OF addtogroup xlbusload
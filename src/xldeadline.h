@@ -0,0 +1,324 @@
+/**
+ * @file xldeadline.h
+ * @author Maxime Verreault
+ * @date 2026-10-19
+ * @copyright COPYRIGHT(c) Maxime Verreault All rights reserved.
+ * @brief Deadlines of the cyclic identifiers received by the RX path, late and missing frames
+ * @ingroup xldriver
+ * @addtogroup xldeadline
+ * @{
+ */
+
+
+#ifndef XLDEADLINE_H
+#define XLDEADLINE_H
+
+/*==================================================================================================
+*                                         INCLUDE FILES
+* 1) system and project includes
+* 2) needed interfaces from external units
+* 3) internal and external interfaces from this unit
+==================================================================================================*/
+#include "vxlapi.h"
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <bit>
+#include <chrono>
+#include <memory>
+#include <optional>
+#include <vector>
+#include <Platform_Types.h>
+#include "xltimerwheel.h"
+
+
+/*==================================================================================================
+*                                       DEFINES AND MACROS
+==================================================================================================*/
+#define RX_DEADLINE_TICK_SHIFT      20u     // ticks of the wheel: 2^20 ns of the driver clock, about 1 ms
+
+
+/*==================================================================================================
+*                                STRUCTURES AND OTHER TYPEDEFS
+==================================================================================================*/
+/** @brief Longest time between two frames of an identifier of a channel */
+struct RxDeadline
+{
+    unsigned int channelIndex;
+    uint32 id;                  //!< identifier, XL_CAN_EXT_MSG_ID set for an extended one
+    uint64 timeout;             //!< ns
+};
+
+/** @brief Timeouts of one monitored identifier of a channel */
+struct RxDeadlineStatistics
+{
+    uint32 id;                  //!< identifier, XL_CAN_EXT_MSG_ID set for an extended one
+    uint64 timeout;             //!< ns
+    uint64 timeouts;            //!< deadlines missed, one per timeout without a frame
+    uint64 recoveries;          //!< frames received after a missed deadline
+    bool timedOut;              //!< no frame since the last missed deadline
+};
+
+/**
+ * @brief Deadline of each monitored identifier of the channels, in a timing wheel
+ * @details Each frame of a monitored identifier re-arms its deadline one timeout later: a lookup in
+ *          a flat array for the standard identifiers or an open addressing table for the extended
+ *          ones, then an O(1) move in the wheel, whatever the number of identifiers. Only the
+ *          deadlines due are visited when the wheel advances, on the driver timestamp of each event
+ *          and, while the queue is empty, on the host time elapsed since the last one. A missed
+ *          deadline is counted, reported to the handler and re-armed one timeout later, the
+ *          timeouts of a long silence are counted at once. The deadlines are armed by the first
+ *          event of the port, each identifier then has its timeout to show up; those of an
+ *          inactive channel are re-armed without being counted.
+ *          Updated by the thread reading the XL queue only, the statistics are read from any thread.
+ */
+class DeadlineMonitor
+{
+public:
+    using Clock = std::chrono::steady_clock;
+    /** @brief Called by the thread reading the XL queue with each missed deadline */
+    using TimeoutHandler = void (*)(unsigned int channelIndex, uint32 id);
+
+    /**
+     * @brief Replace the monitored identifiers, while no thread reads the XL queue
+     * @details The tables are allocated here, the deadlines without timeout and the second
+     *          deadline of an identifier are ignored. Every channel is left inactive.
+     */
+    void configure(const std::vector<RxDeadline>& rxDeadlines, TimeoutHandler timeoutHandler)
+    {
+        for(auto& channel : channels)
+        {
+            channel.reset();
+        }
+        for(auto& channel : active)
+        {
+            channel.store(false, std::memory_order_relaxed);
+        }
+        std::array<uint32, XL_CONFIG_MAX_CHANNELS> extendedCounts{};
+        for(const auto& deadline : rxDeadlines)
+        {
+            extendedCounts[deadline.channelIndex % extendedCounts.size()] += (deadline.id & XL_CAN_EXT_MSG_ID) ? 1 : 0;
+        }
+
+        deadlines = std::make_unique<Deadline[]>(rxDeadlines.size());
+        count = 0;
+        for(const auto& deadline : rxDeadlines)
+        {
+            const auto channelIndex = deadline.channelIndex % channels.size();
+            auto& channel = channels[channelIndex];
+            if(!channel)
+            {
+                channel = std::make_unique<Channel>();
+                channel->standard.fill(NoDeadline);
+                channel->extended.assign(extendedCounts[channelIndex] != 0 ? std::bit_ceil(2 * extendedCounts[channelIndex]) : 0, NoDeadline);
+            }
+            auto* slot = Channel::slotOf(*channel, deadline.id, deadlines.get());
+            if(deadline.timeout == 0 || slot == nullptr || *slot != NoDeadline)
+            {
+                continue;
+            }
+            *slot = count;
+            auto& added = deadlines[count++];
+            added.id = deadline.id;
+            added.channelIndex = static_cast<uint8>(channelIndex);
+            added.timeout = deadline.timeout;
+        }
+        handler = timeoutHandler;
+        started = false;
+        idleSince.reset();
+        lastTimeStamp = 0;
+        wheel.resize(0);
+    }
+
+    /** @brief Count and report the missed deadlines of a channel from now on, from any thread */
+    void setActive(unsigned int channelIndex, bool isActive)
+    {
+        active[channelIndex % active.size()].store(isActive, std::memory_order_relaxed);
+    }
+
+    /** @brief Expire the deadlines up to a frame and re-arm the one of its identifier */
+    void onFrame(unsigned int channelIndex, uint32 id, XLuint64 timeStamp)
+    {
+        if(count == 0)
+        {
+            return;
+        }
+        advance(timeStamp);
+        const auto index = find(channelIndex, id);
+        if(index == NoDeadline)
+        {
+            return;
+        }
+        auto& deadline = deadlines[index];
+        if(deadline.timedOut.load(std::memory_order_relaxed))
+        {
+            deadline.timedOut.store(false, std::memory_order_relaxed);
+            deadline.recoveries.store(deadline.recoveries.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+        }
+        deadline.due = timeStamp + deadline.timeout;
+        wheel.schedule(index, tickAfter(deadline.due));
+    }
+
+    /**
+     * @brief Expire the deadlines up to the estimated driver time, each time the XL queue is found empty
+     * @return the longest wait of the RX thread before the next deadline (ms), at most maxWaitMs
+     */
+    unsigned int onIdle(unsigned int maxWaitMs)
+    {
+        if(!started)
+        {
+            return maxWaitMs;
+        }
+        const auto host = Clock::now();
+        if(!idleSince)
+        {
+            idleSince = host;
+        }
+        const auto now = lastTimeStamp + static_cast<uint64>(std::chrono::duration_cast<std::chrono::nanoseconds>(host - *idleSince).count());
+        expireUpTo(now);
+
+        const auto next = wheel.nextTick();
+        if(next == TimingWheel::NoTick)
+        {
+            return maxWaitMs;
+        }
+        const auto wait = ((next << RX_DEADLINE_TICK_SHIFT) - std::min(now, next << RX_DEADLINE_TICK_SHIFT) + 999999) / 1000000;
+        return static_cast<unsigned int>(std::clamp<uint64>(wait, 1, maxWaitMs));
+    }
+
+    /** @brief Timeouts of a monitored identifier of a channel, false when it is not monitored */
+    bool snapshot(unsigned int channelIndex, uint32 id, RxDeadlineStatistics& statistics) const
+    {
+        const auto index = find(channelIndex, id);
+        if(index == NoDeadline)
+        {
+            return false;
+        }
+        const auto& deadline = deadlines[index];
+        statistics.id = deadline.id;
+        statistics.timeout = deadline.timeout;
+        statistics.timeouts = deadline.timeouts.load(std::memory_order_relaxed);
+        statistics.recoveries = deadline.recoveries.load(std::memory_order_relaxed);
+        statistics.timedOut = deadline.timedOut.load(std::memory_order_relaxed);
+        return true;
+    }
+
+    /** @brief Monitored identifiers of every channel */
+    [[nodiscard]] uint32 size() const
+    {
+        return count;
+    }
+
+private:
+    static constexpr uint32 NoDeadline = ~uint32{0};
+
+    struct Deadline
+    {
+        uint32 id{0};
+        uint8 channelIndex{0};
+        uint64 timeout{0};                      //!< ns
+        uint64 due{0};                          //!< driver time of the armed deadline
+        std::atomic<uint64> timeouts{0};
+        std::atomic<uint64> recoveries{0};
+        std::atomic<bool> timedOut{false};
+    };
+
+    struct Channel
+    {
+        std::array<uint32, 2048> standard{};    //!< deadline of each standard identifier
+        std::vector<uint32> extended{};         //!< open addressing table of the extended identifiers, a power of 2
+
+        /** @brief Slot of an identifier, free or its own, nullptr when the channel monitors no extended one */
+        template<typename Self>
+        static auto slotOf(Self& channel, uint32 id, const Deadline* deadlines) -> decltype(channel.extended.data())
+        {
+            if(!(id & XL_CAN_EXT_MSG_ID))
+            {
+                return &channel.standard[id & (channel.standard.size() - 1)];
+            }
+            if(channel.extended.empty())
+            {
+                return nullptr;
+            }
+            // Fibonacci hashing, the identifiers of a network often differ in their low bits only
+            const auto mask = channel.extended.size() - 1;
+            auto slot = static_cast<std::size_t>((id * 0x9E3779B1u) >> (32 - std::countr_zero(channel.extended.size())));
+            while(channel.extended[slot] != NoDeadline && deadlines[channel.extended[slot]].id != id)
+            {
+                slot = (slot + 1) & mask;
+            }
+            return &channel.extended[slot];
+        }
+    };
+
+    static uint64 tickAfter(uint64 timeStamp)
+    {
+        return (timeStamp + (uint64{1} << RX_DEADLINE_TICK_SHIFT) - 1) >> RX_DEADLINE_TICK_SHIFT;
+    }
+
+    [[nodiscard]] uint32 find(unsigned int channelIndex, uint32 id) const
+    {
+        const auto& channel = channels[channelIndex % channels.size()];
+        // the table always keeps a free slot, the probe ends on it
+        const auto* slot = channel ? Channel::slotOf(*channel, id, deadlines.get()) : nullptr;
+        return slot != nullptr ? *slot : NoDeadline;
+    }
+
+    void advance(XLuint64 timeStamp)
+    {
+        idleSince.reset();
+        if(!started)
+        {
+            // the first event gives the driver time, every identifier has its timeout to show up
+            started = true;
+            wheel.resize(count, timeStamp >> RX_DEADLINE_TICK_SHIFT);
+            for(uint32 index = 0; index < count; ++index)
+            {
+                deadlines[index].due = timeStamp + deadlines[index].timeout;
+                wheel.schedule(index, tickAfter(deadlines[index].due));
+            }
+        }
+        // the events of the port are almost in timestamp order, the clock never goes back
+        lastTimeStamp = std::max<uint64>(lastTimeStamp, timeStamp);
+        expireUpTo(lastTimeStamp);
+    }
+
+    void expireUpTo(uint64 now)
+    {
+        if((now >> RX_DEADLINE_TICK_SHIFT) <= wheel.now())
+        {
+            return;
+        }
+        wheel.advance(now >> RX_DEADLINE_TICK_SHIFT, [this, now](uint32 index) {
+            auto& deadline = deadlines[index];
+            const auto missed = 1 + (now > deadline.due ? (now - deadline.due) / deadline.timeout : 0);
+            deadline.due += missed * deadline.timeout;
+            wheel.schedule(index, tickAfter(deadline.due));
+            if(!active[deadline.channelIndex].load(std::memory_order_relaxed))
+            {
+                return;
+            }
+            deadline.timeouts.store(deadline.timeouts.load(std::memory_order_relaxed) + missed, std::memory_order_relaxed);
+            deadline.timedOut.store(true, std::memory_order_relaxed);
+            if(handler != nullptr)
+            {
+                handler(deadline.channelIndex, deadline.id);
+            }
+        });
+    }
+
+    std::unique_ptr<Deadline[]> deadlines{};
+    uint32 count{0};
+    std::array<std::unique_ptr<Channel>, XL_CONFIG_MAX_CHANNELS> channels{};
+    std::array<std::atomic<bool>, XL_CONFIG_MAX_CHANNELS> active{};
+    TimeoutHandler handler{nullptr};
+    TimingWheel wheel{};
+    bool started{false};
+    uint64 lastTimeStamp{0};                        //!< newest driver timestamp of the port
+    std::optional<Clock::time_point> idleSince{};   //!< host time the queue was found empty, after lastTimeStamp
+};
+
+
+#endif //XLDEADLINE_H
+
+/**@} */ // END OF addtogroup xldeadline
@@ -16,7 +16,11 @@
 #define RECEIVE_EVENT_SIZE         1        // DO NOT EDIT! Currently 1 is supported only
 #define RX_QUEUE_SIZE              4096     // internal driver queue size in CAN events
 #define RX_QUEUE_SIZE_FD           16384    // driver queue size for CAN-FD Rx events
+#define RX_QUEUE_SIZE_MAX          32768    // largest classic CAN driver queue accepted by xlOpenPort, in events
+#define RX_QUEUE_LEVEL_PERIOD      64       // events received between two samples of the receive queue level
 #define ENABLE_CAN_FD_MODE_NO_ISO  0        // switch to activate no iso mode on a CAN FD channel
+#define CANIF_IGNORED_RXMSG_FLAGS  (XL_CAN_RXMSG_FLAG_RTR | XL_CAN_RXMSG_FLAG_EF)  // receptions not reported to CanIf, every TX_OK is
+#define CANIF_IGNORED_MSG_FLAGS    (XL_CAN_MSG_FLAG_ERROR_FRAME | XL_CAN_MSG_FLAG_REMOTE_FRAME | XL_CAN_MSG_FLAG_TX_REQUEST)  // classic port receptions not reported to CanIf
 
 /*==================================================================================================
 *                                        INCLUDE FILES
@@ -31,45 +35,33 @@
 #include <minwindef.h>
 #include <winerror.h>
 #include <synchapi.h>
+#include <algorithm>
 #include <array>
+#include <bit>
 #include <numeric>
 #include <atomic>
 #include <thread>
-#include <boost/program_options.hpp>
 #include <fmt/format.h>
 #include <condition_variable>
 #include <CanIf_Can.h>
 #include "Can_XLdriver.h"
+#include "xlwait.h"
+#include "xlrecorder.h"
+#include "xlreplay.h"
+#include "xlasc.h"
+#include "xlblf.h"
+#include "xlexport.h"
+#include "xlpcapng.h"
+#include "xlbittiming.h"
+#include "xlframe.h"
+#include "xlbitstream.h"
+#include "xlbusload.h"
+#include "xldriver.h"
 
 
-namespace po = boost::program_options;
-
 /*==================================================================================================
 *                          LOCAL TYPEDEFS (STRUCTURES, UNIONS, ENUMS)
 ==================================================================================================*/
-struct FrameType
-{
-    static constexpr uint8 StandardCan = 0;
-    static constexpr uint8 StandardCanFd = 1;
-    static constexpr uint8 ExtendedCan = 2;
-    static constexpr uint8 ExtendedCanFd = 3;
-    static constexpr uint32 mask = 0xC0000000;
-    const uint8 selected;
-
-    constexpr explicit FrameType(const Can_IdType id): selected((id & mask) >> 30)
-    {
-    }
-
-    bool operator ==(uint8& other) const
-    {
-        return selected == other;
-    }
-
-    bool operator ==(const uint8& other) const
-    {
-        return selected == other;
-    }
-};
 
 /*==================================================================================================
 *                                       LOCAL MACROS
@@ -90,13 +82,28 @@ XLdriverConfig  g_xlDrvConfig;                                            //!< C
 XLaccess        g_xlChannelMask             = 0;                          //!< Global channelmask (includes all founded channels)
 XLaccess        g_xlPermissionMask          = 0;                          //!< Global permissionmask (includes all founded channels)
 unsigned int    g_BaudRate                  = 500000;                     //!< Default baudrate
+unsigned int    g_DataBitRate               = 2000000;                    //!< Default CAN FD data phase bitrate
+unsigned int    g_RxQueueSize               = 0;                          //!< Receive queue size given to xlOpenPort, 0 selects RX_QUEUE_SIZE(_FD)
+unsigned int    g_RxBusLoad                 = 0;                          //!< Bus load (%) sizing the receive queue when g_RxQueueSize is 0, 0 keeps the default
+unsigned int    g_RxBusBitRate              = 0;                          //!< Bitrate of the channels at g_RxBusLoad, 0 selects g_BaudRate
 int             g_silent                    = 0;                          //!< flag to visualize the message events (on/off)
 unsigned int    g_TimerRate                 = 0;                          //!< Global timerrate (to toggel)
 unsigned int    g_canFdSupport              = 0;                          //!< Global CAN FD support flag
 unsigned int    g_canFdModeNoIso            = ENABLE_CAN_FD_MODE_NO_ISO;  //!< Global CAN FD ISO (default) / no ISO mode flag
 XLaccess      xlChanMaskTx = 0;
+XLhandle        g_xlNotificationHandle      = nullptr;                    //!< Event signaled by the driver when the receive queue is not empty
+RxWaitMode      g_RxWaitMode                = RxWaitMode::Adaptive;       //!< How the RX thread waits on an empty receive queue
+std::chrono::microseconds g_RxSpinBudget{50};                             //!< Maximum time the RX thread spins after the last event
+Recorder        g_Recorder;                                               //!< Capture-to-disk of the events seen by the RX thread
+ExportPipeline  g_Export;                                                 //!< ASC/BLF export of the events seen by the RX thread
 
 std::atomic<bool> consumerThreadRun{true};                                        //!< flag to start/stop the RX thread
+std::thread     g_RxThread;                                               //!< RX thread started by demoCreateRxThread
+RxQueueStatistics g_RxQueueStatistics;                                    //!< losses and fill level of the receive queue of the port
+BusLoadMeter    g_BusLoad;                                                //!< bus load of the channels of the port
+IdStatisticsTable g_IdStatistics;                                         //!< count, cycle time and gaps of each identifier of the channels
+DeadlineMonitor g_RxDeadlines;                                            //!< deadlines of the cyclic identifiers received on the channels
+TxSupervisor    g_TxSupervisor;                                           //!< timeouts of the frames transmitted on the channels
 
 /*==================================================================================================
 *                                      GLOBAL CONSTANTS
@@ -112,212 +119,455 @@ std::atomic<bool> consumerThreadRun{true};
 *                                       LOCAL FUNCTIONS
 ==================================================================================================*/
 
-template<typename T>
-constexpr void initToZero(T& source)
-{
-    (void) source;
-}
 
-template<>
-constexpr void initToZero(XLcanTxEvent& source)
+ChipStates g_ChipStates;                                                  //!< written by the thread reading the queue
+
+/**
+ * @brief Hand an event to the recorder and the log export, converting it only once
+ */
+template<typename Event>
+void captureEvent(const Event& event)
 {
-    source.channelIndex = 0;
-    source.tag = 0;
-    source.transId = 0;
-    for(unsigned char & i : source.reserved)
+    if (!g_Recorder.isOpen() && !g_Export.isRunning())
     {
-        i = 0;
+        return;
     }
-    source.tagData.canMsg.canId = 0;
-    source.tagData.canMsg.dlc = 0;
-    source.tagData.canMsg.msgFlags = 0;
-    for(unsigned char & i : source.tagData.canMsg.data)
+    RecordEntry entry;
+    if (Recorder::toRecord(event, entry))
     {
-        i = 0;
+        if (g_Recorder.isOpen())
+        {
+            g_Recorder.record(entry);
+        }
+        if (g_Export.isRunning())
+        {
+            g_Export.push(entry);
+        }
     }
-    for(unsigned char & i : source.tagData.canMsg.reserved)
+}
+
+/** @brief Count an event flagged after the driver lost events, on the channel of the flagged event */
+void countRxQueueOverflow(unsigned int channelIndex)
+{
+    g_RxQueueStatistics.overflows[channelIndex % XL_CONFIG_MAX_CHANNELS].fetch_add(1, std::memory_order_relaxed);
+}
+
+/** @brief Keep the highest fill level of the receive queue, only the thread reading the queue samples it */
+void sampleRxQueueLevel()
+{
+    int level = 0;
+    if (xlGetReceiveQueueLevel(g_xlPortHandle, &level) == XL_SUCCESS &&
+        static_cast<unsigned int>(level) > g_RxQueueStatistics.highWater.load(std::memory_order_relaxed))
     {
-        i = 0;
+        g_RxQueueStatistics.highWater.store(static_cast<unsigned int>(level), std::memory_order_relaxed);
     }
 }
 
-template<>
-constexpr void initToZero(XLevent & source)
+/** @brief Clear the statistics of the receive queue of a port opened with size */
+void resetRxQueueStatistics(unsigned int size)
 {
-    source.tag = 0;
-    source.chanIndex = 0;
-    source.transId = 0;
-    source.portHandle = 0;
-    source.flags = 0;
-    source.reserved = 0;
-    source.timeStamp = 0;
-    source.tagData.msg.dlc = 0;
-    source.tagData.msg.flags = 0;
-    source.tagData.msg.id = 0;
-    source.tagData.msg.res1 = 0;
-    source.tagData.msg.res2 = 0;
-    for(unsigned char & i: source.tagData.msg.data)
+    for (auto& overflows : g_RxQueueStatistics.overflows)
     {
-        i = 0;
+        overflows.store(0, std::memory_order_relaxed);
     }
+    g_RxQueueStatistics.highWater.store(0, std::memory_order_relaxed);
+    g_RxQueueStatistics.size = size;
 }
 
-template<>
-constexpr void initToZero(XLcanFdConf& source)
+/**
+ * @brief Bits on the bus of a frame received or transmitted on a CAN FD port
+ * @details The driver counts the bits of the frame, stuff bits included, in totalBitCnt: the
+ *          intermission is added. A frame switching its bitrate is split between both phases by
+ *          fdFrameBits, as are the frames the driver did not count.
+ */
+FrameBits busBitsOf(const XL_CAN_EV_RX_MSG& msg)
 {
-    source.arbitrationBitRate = 0;
-    source.sjwAbr = 0;
-    source.tseg1Abr = 0;
-    source.tseg2Abr = 0;
-    source.dataBitRate = 0;
-    source.sjwDbr = 0;
-    source.tseg1Dbr = 0;
-    source.tseg2Dbr = 0;
-    source.reserved = 0;
-    source.options = 0;
-    for(auto & data: source.reserved1)
+    const bool extended = (msg.canId & XL_CAN_EXT_MSG_ID) != 0;
+    const auto id = msg.canId & ~XL_CAN_EXT_MSG_ID;
+
+    if (msg.msgFlags & XL_CAN_RXMSG_FLAG_BRS)
     {
-        data = 0;
+        return fdFrameBits(extended, true, (msg.msgFlags & XL_CAN_RXMSG_FLAG_ESI) != 0, id, msg.dlc, msg.data);
     }
-    source.reserved2 = 0;
+    if (msg.totalBitCnt != 0)
+    {
+        return FrameBits{msg.totalBitCnt + 3u, 0};
+    }
+    if (msg.msgFlags & XL_CAN_RXMSG_FLAG_EDL)
+    {
+        return fdFrameBits(extended, false, (msg.msgFlags & XL_CAN_RXMSG_FLAG_ESI) != 0, id, msg.dlc, msg.data);
+    }
+    return classicFrameBits(extended, (msg.msgFlags & XL_CAN_RXMSG_FLAG_RTR) != 0, id, msg.dlc, msg.data);
 }
 
-struct CanData
+/** @brief Handler of the event tag sharing a slot, the other tags of the slot are unsupported */
+template<typename Handler>
+struct EventSlot
+{
+    unsigned short tag;
+    Handler handler;
+};
+
+constexpr unsigned short NoEventTag = 0xFFFF;                           //!< tag of the slots without a handler
+constexpr std::size_t CanEventSlots = 16;                               //!< classic CAN tags, slot of tag % 16
+constexpr std::size_t CanFdEventSlots = 32;                             //!< CAN FD tags, slot of tag % 32
+// the overflow flag of a CAN FD event selects the second half of the table, without a branch
+static_assert(XL_CAN_QUEUE_OVERFLOW >> 3 == CanFdEventSlots);
+
+void onIgnoredEvent(XLevent&)
 {
-    std::vector<uint8> data{};
-    const uint8 dlc;
-    const uint8 frameSize;
+}
 
-    CanData(const uint8* rawData, uint8 length): dlc(getDLC(length)), frameSize(getPayloadSize(dlc))
+void onUnsupportedEvent(XLevent& xlEvent)
+{
+    if (!g_silent)
     {
-        data.resize(frameSize);
-        for(auto i = 0; i < length; ++i)
+        fmt::print("{} event parsing currently unsupported\n", xlGetEventString(&xlEvent));
+    }
+}
+
+void onReceiveMsg(XLevent& xlEvent)
+{
+    const auto& msg = xlEvent.tagData.msg;
+    const auto flags = msg.flags;
+    // the frames on the bus: receptions, transmit confirmations and error frames
+    if (!(flags & XL_CAN_MSG_FLAG_TX_REQUEST))
+    {
+        g_BusLoad.addFrame(xlEvent.chanIndex, xlEvent.timeStamp, flags & XL_CAN_MSG_FLAG_ERROR_FRAME ? FrameBits{ErrorFrameBits, 0} :
+            classicFrameBits((msg.id & XL_CAN_EXT_MSG_ID) != 0, (flags & XL_CAN_MSG_FLAG_REMOTE_FRAME) != 0,
+                             msg.id & ~XL_CAN_EXT_MSG_ID, static_cast<uint8>(msg.dlc), msg.data));
+        if (!(flags & XL_CAN_MSG_FLAG_ERROR_FRAME))
+        {
+            g_IdStatistics.addFrame(xlEvent.chanIndex, msg.id, xlEvent.timeStamp);
+        }
+        // the receptions only re-arm the deadlines
+        if (!(flags & (XL_CAN_MSG_FLAG_ERROR_FRAME | XL_CAN_MSG_FLAG_TX_COMPLETED)))
         {
-            data[i] = rawData[i];
+            g_RxDeadlines.onFrame(xlEvent.chanIndex, msg.id, xlEvent.timeStamp);
         }
-        pad(0x55, length);
     }
+    // the controller overrun, a driver queue overrun is flagged in the event itself and counted by handleEvent
+    if ((flags & XL_CAN_MSG_FLAG_OVERRUN) && !(xlEvent.flags & XL_EVENT_FLAG_OVERRUN)) [[unlikely]]
+    {
+        countRxQueueOverflow(xlEvent.chanIndex);
+    }
+    // a remote frame written by the stack is confirmed too
+    if ((flags & (XL_CAN_MSG_FLAG_TX_COMPLETED | XL_CAN_MSG_FLAG_ERROR_FRAME | XL_CAN_MSG_FLAG_TX_REQUEST)) == XL_CAN_MSG_FLAG_TX_COMPLETED)
+    {
+        canTxConfirmation(xlEvent.chanIndex, xlEvent.tagData.msg.id);
+    }
+    else if (flags & XL_CAN_MSG_FLAG_ERROR_FRAME)
+    {
+        canBusError(xlEvent.chanIndex);
+    }
+    else if (!(flags & CANIF_IGNORED_MSG_FLAGS))
+    {
+        canRxIndication(xlEvent.chanIndex, xlEvent.tagData.msg.id, xlEvent.tagData.msg.data,
+                        static_cast<uint8>(std::min<unsigned short>(xlEvent.tagData.msg.dlc, MAX_MSG_LEN)));
+    }
+}
+
+void onChipState(XLevent& xlEvent)
+{
+    {
+        std::lock_guard lock(g_ChipStates.mutex);
+        const auto channel = xlEvent.chanIndex % XL_CONFIG_MAX_CHANNELS;
+        g_ChipStates.classic[channel] = xlEvent.tagData.chipState;
+        ++g_ChipStates.sequence[channel];
+    }
+    g_ChipStates.changed.notify_all();
+    if (xlEvent.tagData.chipState.busStatus == XL_CHIPSTAT_BUSOFF)
+    {
+        canBusOff(xlEvent.chanIndex);
+    }
+    else if (xlEvent.tagData.chipState.busStatus == XL_CHIPSTAT_ERROR_PASSIVE)
+    {
+        canErrorPassive(xlEvent.chanIndex);
+    }
+}
 
-    static constexpr uint8 getDLC(uint8 length)
+void onIgnoredCanFdEvent(XLcanRxEvent&)
+{
+}
+
+void onUnsupportedCanFdEvent(XLcanRxEvent& xlEvent)
+{
+    if (xlEvent.flagsChip & XL_CAN_QUEUE_OVERFLOW)
     {
-        if(length <= 8)         return length;
-        else if(length <= 12)   return 9;
-        else if(length <= 16)   return 10;
-        else if(length <= 20)   return 11;
-        else if(length <= 24)   return 12;
-        else if(length <= 32)   return 13;
-        else if(length <= 48)   return 14;
-        else                    return 15;
+        countRxQueueOverflow(xlEvent.channelIndex);
     }
+    if (!g_silent)
+    {
+        fmt::print("{} event parsing currently unsupported\n", xlCanGetEventString(&xlEvent));
+    }
+}
 
-    static constexpr uint8 getPayloadSize(uint8 dlc)
+void onCanFdRxOk(XLcanRxEvent& xlEvent)
+{
+    g_BusLoad.addFrame(xlEvent.channelIndex, xlEvent.timeStampSync, busBitsOf(xlEvent.tagData.canRxOkMsg));
+    g_IdStatistics.addFrame(xlEvent.channelIndex, xlEvent.tagData.canRxOkMsg.canId, xlEvent.timeStampSync);
+    g_RxDeadlines.onFrame(xlEvent.channelIndex, xlEvent.tagData.canRxOkMsg.canId, xlEvent.timeStampSync);
+    if (!(xlEvent.tagData.canRxOkMsg.msgFlags & CANIF_IGNORED_RXMSG_FLAGS))
     {
-        if(dlc <= 8)            return dlc;
-        else if(dlc == 9)       return 12;
-        else if(dlc == 10)      return 16;
-        else if(dlc == 11)      return 20;
-        else if(dlc == 12)      return 24;
-        else if(dlc == 13)      return 32;
-        else if(dlc == 14)      return 48;
-        else if(dlc == 15)      return 64;
-        else                    return 0;
+        canRxIndication(xlEvent.channelIndex, xlEvent.tagData.canRxOkMsg.canId, xlEvent.tagData.canRxOkMsg.data,
+                        CanData::getPayloadSize(xlEvent.tagData.canRxOkMsg.dlc));
     }
-private:
-    void pad(uint8 value, uint8 length)
+}
+
+void onCanFdTxOk(XLcanRxEvent& xlEvent)
+{
+    g_BusLoad.addFrame(xlEvent.channelIndex, xlEvent.timeStampSync, busBitsOf(xlEvent.tagData.canTxOkMsg));
+    g_IdStatistics.addFrame(xlEvent.channelIndex, xlEvent.tagData.canTxOkMsg.canId, xlEvent.timeStampSync);
+    canTxConfirmation(xlEvent.channelIndex, xlEvent.tagData.canTxOkMsg.canId);
+}
+
+void onCanFdError(XLcanRxEvent& xlEvent)
+{
+    g_BusLoad.addFrame(xlEvent.channelIndex, xlEvent.timeStampSync, FrameBits{ErrorFrameBits, 0});
+    canBusError(xlEvent.channelIndex);
+}
+
+void onCanFdChipState(XLcanRxEvent& xlEvent)
+{
     {
-        for(auto i = length; i < frameSize; ++i)
-        {
-            data[i] = value;
-        }
+        std::lock_guard lock(g_ChipStates.mutex);
+        const auto channel = xlEvent.channelIndex % XL_CONFIG_MAX_CHANNELS;
+        g_ChipStates.canFd[channel] = xlEvent.tagData.canChipState;
+        ++g_ChipStates.sequence[channel];
     }
-};
+    g_ChipStates.changed.notify_all();
+    if (xlEvent.tagData.canChipState.busStatus == XL_CHIPSTAT_BUSOFF)
+    {
+        canBusOff(xlEvent.channelIndex);
+    }
+    else if (xlEvent.tagData.canChipState.busStatus == XL_CHIPSTAT_ERROR_PASSIVE)
+    {
+        canErrorPassive(xlEvent.channelIndex);
+    }
+}
+
+void onCanFdOverflow(XLcanRxEvent& xlEvent);
+
+/** @brief Built-in handlers of the classic CAN events */
+constexpr std::array<EventSlot<CanEventHandler>, CanEventSlots> canEventSlots()
+{
+    std::array<EventSlot<CanEventHandler>, CanEventSlots> slots{};
+    slots.fill({NoEventTag, onUnsupportedEvent});
+    const auto add = [&slots](unsigned short tag, CanEventHandler handler) {
+        slots[tag % CanEventSlots] = {tag, handler};
+    };
+    add(XL_RECEIVE_MSG, onReceiveMsg);
+    add(XL_CHIP_STATE, onChipState);
+    add(XL_TRANSCEIVER, onIgnoredEvent);
+    add(XL_TIMER, onIgnoredEvent);
+    add(XL_SYNC_PULSE, onIgnoredEvent);
+    add(XL_APPLICATION_NOTIFICATION, onIgnoredEvent);
+    return slots;
+}
+
+/** @brief Built-in handlers of the CAN FD events, then the same tags flagged with a queue overflow */
+constexpr std::array<EventSlot<CanFdEventHandler>, 2 * CanFdEventSlots> canFdEventSlots()
+{
+    std::array<EventSlot<CanFdEventHandler>, 2 * CanFdEventSlots> slots{};
+    slots.fill({NoEventTag, onUnsupportedCanFdEvent});
+    const auto add = [&slots](unsigned short tag, CanFdEventHandler handler) {
+        slots[tag % CanFdEventSlots] = {tag, handler};
+        slots[CanFdEventSlots + tag % CanFdEventSlots] = {tag, onCanFdOverflow};
+    };
+    add(XL_CAN_EV_TAG_RX_OK, onCanFdRxOk);
+    add(XL_CAN_EV_TAG_RX_ERROR, onCanFdError);
+    add(XL_CAN_EV_TAG_TX_ERROR, onCanFdError);
+    add(XL_CAN_EV_TAG_TX_REQUEST, onIgnoredCanFdEvent);
+    add(XL_CAN_EV_TAG_TX_OK, onCanFdTxOk);
+    add(XL_CAN_EV_TAG_CHIP_STATE, onCanFdChipState);
+    add(XL_SYNC_PULSE, onIgnoredCanFdEvent);
+    return slots;
+}
+
+constexpr auto DefaultCanEventSlots = canEventSlots();
+constexpr auto DefaultCanFdEventSlots = canFdEventSlots();
+constinit auto g_CanEventSlots = DefaultCanEventSlots;                  //!< handlers of the RX thread, indexed by tag % CanEventSlots
+constinit auto g_CanFdEventSlots = DefaultCanFdEventSlots;              //!< handlers of the RX thread, indexed by tag % CanFdEventSlots and overflow
+
+/** @brief Event delivered after the driver queue lost events: counted, then handled as usual */
+void onCanFdOverflow(XLcanRxEvent& xlEvent)
+{
+    countRxQueueOverflow(xlEvent.channelIndex);
+    g_CanFdEventSlots[xlEvent.tag % CanFdEventSlots].handler(xlEvent);
+}
+
+/** @brief Replace the handler of the slot of a tag, nullptr restores the built-in one */
+template<typename Handler, std::size_t Size>
+Handler setEventHandler(std::array<EventSlot<Handler>, Size>& slots, const std::array<EventSlot<Handler>, Size>& defaults,
+                        std::size_t slotCount, unsigned short tag, Handler handler)
+{
+    auto& slot = slots[tag % slotCount];
+    if (slot.tag != tag && slot.tag != NoEventTag)
+    {
+        return nullptr;
+    }
+    const auto previous = slot.handler;
+    slot.tag = handler != nullptr ? tag : defaults[tag % slotCount].tag;
+    slot.handler = handler != nullptr ? handler : defaults[tag % slotCount].handler;
+    return previous;
+}
+
+void handleEvent(XLevent& xlEvent)
+{
+    captureEvent(xlEvent);
+    if (!g_silent)
+    {
+        fmt::print("{}\n", xlGetEventString(&xlEvent));
+    }
+    if (xlEvent.flags & XL_EVENT_FLAG_OVERRUN) [[unlikely]]
+    {
+        countRxQueueOverflow(xlEvent.chanIndex);
+    }
+    const auto& slot = g_CanEventSlots[xlEvent.tag % CanEventSlots];
+    (slot.tag == xlEvent.tag ? slot.handler : onUnsupportedEvent)(xlEvent);
+}
+
+void handleCanFdEvent(XLcanRxEvent& xlEvent)
+{
+    captureEvent(xlEvent);
+    if (!g_silent)
+    {
+        fmt::print("{}\n", xlCanGetEventString(&xlEvent));
+    }
+    const auto& slot = g_CanFdEventSlots[xlEvent.tag % CanFdEventSlots | (xlEvent.flagsChip & XL_CAN_QUEUE_OVERFLOW) >> 3];
+    (slot.tag == xlEvent.tag ? slot.handler : onUnsupportedCanFdEvent)(xlEvent);
+}
+
+CanEventHandler setCanEventHandler(unsigned char tag, CanEventHandler handler)
+{
+    return setEventHandler(g_CanEventSlots, DefaultCanEventSlots, CanEventSlots, tag, handler);
+}
 
-std::condition_variable chipStateCV;
-s_xl_chip_state g_ChipState{1, 0, 0};
-XL_CAN_EV_CHIP_STATE g_CanFdChipState{1, 0, 0, 0, 0};
+CanFdEventHandler setCanFdEventHandler(unsigned short tag, CanFdEventHandler handler)
+{
+    const auto previous = setEventHandler(g_CanFdEventSlots, DefaultCanFdEventSlots, CanFdEventSlots, tag, handler);
+    const auto& slot = g_CanFdEventSlots[tag % CanFdEventSlots];
+    // the overflow slot counts, then calls the handler of the tag
+    g_CanFdEventSlots[CanFdEventSlots + tag % CanFdEventSlots] = {slot.tag, slot.tag != NoEventTag ? onCanFdOverflow : onUnsupportedCanFdEvent};
+    return previous;
+}
 
-[[noreturn]] void eventConsumer()
+void eventConsumer()
 {
     unsigned int rcvSize = 1;
+    unsigned int received = 0;
     XLevent xlEvent;
-    while(true)
+    RxWaitStrategy rxWait(g_RxWaitMode, g_RxSpinBudget, g_xlNotificationHandle);
+    while(consumerThreadRun.load(std::memory_order_relaxed))
     {
         rcvSize = 1;
         auto xlStatus = xlReceive(g_xlPortHandle, &rcvSize, &xlEvent);
-        if (xlStatus != XL_ERR_QUEUE_IS_EMPTY && rcvSize > 0)
+        if (xlStatus == XL_ERR_QUEUE_IS_EMPTY || rcvSize == 0)
         {
-            if (!g_silent)
-            {
-                fmt::print("{}\n", xlGetEventString(&xlEvent));
-            }
-            switch (xlEvent.tag)
+            // a blocked thread wakes up for the next deadline
+            rxWait.onIdle(g_TxSupervisor.onIdle(g_RxDeadlines.onIdle(RX_WAIT_BLOCK_TIMEOUT_MS)));
+            received = 0;
+        }
+        else
+        {
+            // the queue is the fullest when the thread catches up: right after a wait, then periodically,
+            // the TX timeouts of a queue never empty expire there too
+            if (received++ % RX_QUEUE_LEVEL_PERIOD == 0)
             {
-                case XL_RECEIVE_MSG:
-                    if (xlEvent.tagData.msg.flags == XL_CAN_MSG_FLAG_TX_COMPLETED)
-                    {
-                        CanIf_TxConfirmation(xlEvent.tagData.msg.id);
-                    }
-                    break;
-                case XL_CHIP_STATE:
-                    g_ChipState = xlEvent.tagData.chipState;
-                    chipStateCV.notify_all();
-                    break;
-                default:
-                    fmt::print("{} event parsing currently unsupported", xlGetEventString(&xlEvent));
-                    break;
+                sampleRxQueueLevel();
+                g_TxSupervisor.expire();
             }
+            rxWait.onEvent(xlEvent.timeStamp);
+            handleEvent(xlEvent);
         }
     }
 }
 
-[[noreturn]] void eventCanFdConsumer()
+void eventCanFdConsumer()
 {
+    unsigned int received = 0;
     XLcanRxEvent xlEvent;
-    while(true)
+    RxWaitStrategy rxWait(g_RxWaitMode, g_RxSpinBudget, g_xlNotificationHandle);
+    while(consumerThreadRun.load(std::memory_order_relaxed))
     {
         auto xlStatus = xlCanReceive(g_xlPortHandle, &xlEvent);
-        if (xlStatus != XL_ERR_QUEUE_IS_EMPTY)
+        if (xlStatus == XL_ERR_QUEUE_IS_EMPTY)
         {
-            if (!g_silent)
-            {
-                fmt::print("{}\n", xlCanGetEventString(&xlEvent));
-            }
-            switch (xlEvent.tag)
+            rxWait.onIdle(g_TxSupervisor.onIdle(g_RxDeadlines.onIdle(RX_WAIT_BLOCK_TIMEOUT_MS)));
+            received = 0;
+        }
+        else
+        {
+            if (received++ % RX_QUEUE_LEVEL_PERIOD == 0)
             {
-                case XL_CAN_EV_TAG_RX_OK:
-                    if (xlEvent.tagData.canRxOkMsg.msgFlags == 0)
-                    {
-                        Can_HwType mailbox{
-                                xlEvent.tagData.canRxOkMsg.canId,
-                                0U, /* TODO: Set real HRH based on config and CanId */
-                                static_cast<uint8>(xlEvent.channelIndex)
-                        };
-                        PduInfoType pduInfo{
-                            xlEvent.tagData.canRxOkMsg.data,
-                            nullptr,
-                            CanData::getPayloadSize(xlEvent.tagData.canRxOkMsg.dlc)
-                        };
-                        CanIf_RxIndication(&mailbox, &pduInfo);
-                    }
-                    break;
-                case XL_CAN_EV_TAG_TX_OK:
-                    if (xlEvent.tagData.canRxOkMsg.msgFlags == 0)
-                    {
-                        CanIf_TxConfirmation(xlEvent.tagData.canRxOkMsg.canId);
-                    }
-                    break;
-                case XL_CAN_EV_TAG_CHIP_STATE:
-                    g_CanFdChipState = xlEvent.tagData.canChipState;
-                    chipStateCV.notify_all();
-                    break;
-                default:
-                    fmt::print("{} event parsing currently unsupported", xlCanGetEventString(&xlEvent));
-                    break;
+                sampleRxQueueLevel();
+                g_TxSupervisor.expire();
             }
+            rxWait.onEvent(xlEvent.timeStampSync);
+            handleCanFdEvent(xlEvent);
         }
     }
 }
 
+unsigned int pollEvents(unsigned int maxEvents)
+{
+    unsigned int handled = 0;
+    // the events accumulated since the last main function
+    sampleRxQueueLevel();
+    if (g_canFdSupport)
+    {
+        XLcanRxEvent xlEvent;
+        while (handled < maxEvents && xlCanReceive(g_xlPortHandle, &xlEvent) == XL_SUCCESS)
+        {
+            handleCanFdEvent(xlEvent);
+            ++handled;
+        }
+    }
+    else
+    {
+        XLevent xlEvent;
+        unsigned int rcvSize = 1;
+        while (handled < maxEvents && xlReceive(g_xlPortHandle, &rcvSize, &xlEvent) == XL_SUCCESS && rcvSize != 0)
+        {
+            handleEvent(xlEvent);
+            ++handled;
+            rcvSize = 1;
+        }
+    }
+    // a drained queue, the deadlines of a silent bus expire on the host time
+    if (handled < maxEvents)
+    {
+        (void) g_RxDeadlines.onIdle(RX_WAIT_BLOCK_TIMEOUT_MS);
+    }
+    // the TX timeouts run on the host clock, drained queue or not
+    g_TxSupervisor.expire();
+    return handled;
+}
+
+void setBusLoadBitRates(XLaccess channelMask, unsigned int bitRate, unsigned int dataBitRate)
+{
+    for (unsigned int channel = 0; channel < XL_CONFIG_MAX_CHANNELS; ++channel)
+    {
+        if (channelMask & (XLaccess{1} << channel))
+        {
+            g_BusLoad.setBitRates(channel, bitRate, dataBitRate);
+        }
+    }
+}
+
+unsigned int rxQueueSizeFor(unsigned int channels, unsigned int bitRate, unsigned int busLoad, bool canFd)
+{
+    // every channel of the port queues each frame of its bus, as a reception or a transmit confirmation
+    const auto events = std::max<uint64>(channels * busFrameRate(bitRate, busLoad) * RX_QUEUE_STALL_MS / 1000, 1);
+    if (canFd)
+    {
+        // XL_CANFD_MAX_EVENT_SIZE per event leaves room for payloads longer than the shortest frames
+        return static_cast<unsigned int>(std::clamp<uint64>(std::bit_ceil(events * XL_CANFD_MAX_EVENT_SIZE),
+                                                            RX_QUEUE_SIZE_FD, RX_FIFO_CANFD_QUEUE_SIZE_MAX));
+    }
+    return static_cast<unsigned int>(std::clamp<uint64>(std::bit_ceil(events), RX_QUEUE_SIZE, RX_QUEUE_SIZE_MAX));
+}
+
 void demoPrintConfig() {
 
     fmt::print("{0:─^58}\n", ""); /* have 58 minus character centered */
@@ -417,13 +667,25 @@ XLstatus demoInitDriver(XLaccess &pxlChannelMaskTx, unsigned int &pxlChannelInde
     // ------------------------------------
     if(XL_SUCCESS == xlStatus) {
 
+        auto rxQueueSize = g_RxQueueSize != 0 ? g_RxQueueSize : g_canFdSupport ? RX_QUEUE_SIZE_FD : RX_QUEUE_SIZE;
+        if (g_RxQueueSize == 0 && g_RxBusLoad != 0) {
+            const auto channels = static_cast<unsigned int>(std::popcount(static_cast<uint64>(g_xlChannelMask)));
+            const auto bitRate = g_RxBusBitRate != 0 ? g_RxBusBitRate : g_BaudRate;
+            rxQueueSize = rxQueueSizeFor(channels, bitRate, g_RxBusLoad, g_canFdSupport != 0);
+            fmt::print("- RxQueueSize      : {} {} for {} channels at {} % of {} bit/s\n", rxQueueSize, g_canFdSupport ? "bytes" : "events",
+                       channels, g_RxBusLoad, bitRate);
+        }
+        resetRxQueueStatistics(rxQueueSize);
+        g_BusLoad.reset();
+        g_IdStatistics.reset(g_xlChannelMask);
+
         // check if we can use CAN FD
         if (g_canFdSupport) {
-            xlStatus = xlOpenPort(&g_xlPortHandle, g_AppName.data(), g_xlChannelMask, &g_xlPermissionMask, RX_QUEUE_SIZE_FD, XL_INTERFACE_VERSION_V4, XL_BUS_TYPE_CAN);
+            xlStatus = xlOpenPort(&g_xlPortHandle, g_AppName.data(), g_xlChannelMask, &g_xlPermissionMask, rxQueueSize, XL_INTERFACE_VERSION_V4, XL_BUS_TYPE_CAN);
         }
             // if not, we make 'normal' CAN
         else {
-            xlStatus = xlOpenPort(&g_xlPortHandle, g_AppName.data(), g_xlChannelMask, &g_xlPermissionMask, RX_QUEUE_SIZE, XL_INTERFACE_VERSION, XL_BUS_TYPE_CAN);
+            xlStatus = xlOpenPort(&g_xlPortHandle, g_AppName.data(), g_xlChannelMask, &g_xlPermissionMask, rxQueueSize, XL_INTERFACE_VERSION, XL_BUS_TYPE_CAN);
 
         }
         fmt::print("- OpenPort         : CM={:#X}, PH={:#X}, PM={:#X}, {}\n", g_xlChannelMask, g_xlPortHandle, g_xlPermissionMask, xlGetErrorString(xlStatus));
@@ -441,33 +703,35 @@ XLstatus demoInitDriver(XLaccess &pxlChannelMaskTx, unsigned int &pxlChannelInde
                 XLcanFdConf fdParams;
                 initToZero(fdParams);
 
-                // arbitration bitrate
-                fdParams.arbitrationBitRate = 1000000;
-                fdParams.tseg1Abr           = 6;
-                fdParams.tseg2Abr           = 3;
-                fdParams.sjwAbr             = 2;
-
-                // data bitrate
-                fdParams.dataBitRate = fdParams.arbitrationBitRate*2;
-                fdParams.tseg1Dbr    = 6;
-                fdParams.tseg2Dbr    = 3;
-                fdParams.sjwDbr      = 2;
+                // the segments follow the requested bitrates instead of fixed quanta
+                const auto timing = solveFdBitTiming(XL_CANFD_CLOCK, g_BaudRate, XL_DEFAULT_SAMPLE_POINT, g_DataBitRate, XL_DEFAULT_FD_SAMPLE_POINT);
+                toXLcanFdConf(timing, fdParams);
 
                 if (g_canFdModeNoIso) {
                     fdParams.options = CANFD_CONFOPT_NO_ISO;
                 }
 
-                xlStatus = xlCanFdSetConfiguration(g_xlPortHandle, g_xlChannelMask, &fdParams);
-                fmt::print("- SetFdConfig.     : ABaudr.={}, DBaudr.={}, {}\n", fdParams.arbitrationBitRate, fdParams.dataBitRate, xlGetErrorString(xlStatus));
+                if (timing.valid()) {
+                    xlStatus = xlCanFdSetConfiguration(g_xlPortHandle, g_xlChannelMask, &fdParams);
+                    setBusLoadBitRates(g_xlChannelMask, g_BaudRate, g_DataBitRate);
+                }
+                else {
+                    xlStatus = XL_ERR_WRONG_PARAMETER;
+                }
+                fmt::print("- SetFdConfig.     : ABaudr.={} ({}/{}/{}), DBaudr.={} ({}/{}/{}), {}\n",
+                           fdParams.arbitrationBitRate, fdParams.tseg1Abr, fdParams.tseg2Abr, fdParams.sjwAbr,
+                           fdParams.dataBitRate, fdParams.tseg1Dbr, fdParams.tseg2Dbr, fdParams.sjwDbr, xlGetErrorString(xlStatus));
             }
             else {
                 xlStatus = xlCanSetChannelBitrate(g_xlPortHandle, g_xlChannelMask, g_BaudRate);
+                setBusLoadBitRates(g_xlChannelMask, g_BaudRate, g_BaudRate);
                 fmt::print("- SetChannelBitrate: baudr.={}, {}\n", g_BaudRate, xlGetErrorString(xlStatus));
             }
         }
         else {
             fmt::print("-                  : we have NO init access!\n");
         }
+        canOpenDefaultTxHth(pxlChannelMaskTx);
     }
     else {
 
@@ -484,22 +748,42 @@ XLstatus demoCreateRxThread() {
 
     if (g_xlPortHandle != XL_INVALID_PORTHANDLE)
     {
+        if(g_RxWaitMode != RxWaitMode::Spin)
+        {
+            // the event is set once the queue holds one event, the consumer drains it before waiting again
+            xlStatus = xlSetNotification(g_xlPortHandle, &g_xlNotificationHandle, 1);
+            fmt::print("- SetNotification  : {}\n", xlGetErrorString(xlStatus));
+            if(XL_SUCCESS != xlStatus)
+            {
+                g_xlNotificationHandle = nullptr;
+            }
+        }
+
+        consumerThreadRun = true;
         if(g_canFdSupport)
         {
-            std::thread consumerThread(eventCanFdConsumer);
-            consumerThread.detach();
+            g_RxThread = std::thread(eventCanFdConsumer);
             xlStatus = XL_SUCCESS;
         }
         else
         {
-            std::thread consumerThread(eventConsumer);
-            consumerThread.detach();
+            g_RxThread = std::thread(eventConsumer);
             xlStatus = XL_SUCCESS;
         }
     }
     return xlStatus;
 }
 
+void demoStopRxThread()
+{
+    // a blocked consumer wakes up at the latest after RX_WAIT_BLOCK_TIMEOUT_MS
+    consumerThreadRun = false;
+    if(g_RxThread.joinable())
+    {
+        g_RxThread.join();
+    }
+}
+
 
 XLstatus demoTransmit(unsigned int txID)
 {
@@ -552,182 +836,85 @@ XLstatus demoTransmit(unsigned int txID)
     return xlStatus;
 }
 
-extern "C" Std_ReturnType Can_XLdriver_GetControllerErrorState(uint8 ControllerId, Can_ErrorStateType* ErrorStatePtr)
+bool replayTransmit(const RecordEntry& entry)
 {
-    std::mutex mtx;
-    std::unique_lock<std::mutex> lk(mtx);
-    xlCanRequestChipState(g_xlPortHandle, 1 << ControllerId);
-    chipStateCV.wait(lk);
-    switch(g_ChipState.busStatus)
-    {
-        case XL_CHIPSTAT_BUSOFF:
-            *ErrorStatePtr = CAN_ERRORSTATE_BUSOFF;
-            break;
-        case XL_CHIPSTAT_ERROR_PASSIVE:
-            *ErrorStatePtr = CAN_ERRORSTATE_PASSIVE;
-            break;
-        case XL_CHIPSTAT_ERROR_WARNING:
-        case XL_CHIPSTAT_ERROR_ACTIVE:
-            *ErrorStatePtr = CAN_ERRORSTATE_ACTIVE;
-            break;
-        default:
-            break;
+    XLaccess channelMask = XLaccess{1} << entry.channel;
+    if (!(channelMask & g_xlPermissionMask)) {
+        channelMask = xlChanMaskTx;
     }
-    return 0;
-}
-
-extern "C" Std_ReturnType Can_XLdriver_GetControllerRxErrorCounter(uint8 ControllerId, uint8* RxErrorCounterPtr)
-{
-    std::mutex mtx;
-    std::unique_lock<std::mutex> lk(mtx);
-    xlCanRequestChipState(g_xlPortHandle, 1 << ControllerId);
-    chipStateCV.wait(lk);
-    *RxErrorCounterPtr = g_ChipState.rxErrorCounter;
-    return 0;
-}
-
-extern "C" Std_ReturnType Can_XLdriver_GetControllerTxErrorCounter(uint8 ControllerId, uint8* TxErrorCounterPtr)
-{
-    std::mutex mtx;
-    std::unique_lock<std::mutex> lk(mtx);
-    xlCanRequestChipState(g_xlPortHandle, 1 << ControllerId);
-    chipStateCV.wait(lk);
-    *TxErrorCounterPtr = g_ChipState.txErrorCounter;
-    return 0;
-}
-
-extern "C" Std_ReturnType Can_XLdriver_SetControllerMode(uint8 Controller, Can_ControllerStateType Transition)
-{
-    (void) Controller;
-    (void) Transition;
-    return 0;
-}
-
-extern "C" Std_ReturnType Can_XLdriver_Write(Can_HwHandleType Hth, const Can_PduType* PduInfo)
-{
-    (void) Hth;
-    const auto frametype = FrameType(PduInfo->id);
-    const auto id = PduInfo->id & 0x3FFFFFFF;
-    XLstatus xlStatus = XL_ERROR;
-
-    if(frametype == FrameType::StandardCan || frametype == FrameType::ExtendedCan)
-    {
-        static XLevent       xlEvent;
-        unsigned int messageCount = 1;
-
-        initToZero(xlEvent);
-        xlEvent.tag                 = XL_TRANSMIT_MSG;
-        xlEvent.tagData.msg.id      = id;
-        auto canFrame = CanData(PduInfo->sdu, PduInfo->length);
-        xlEvent.tagData.msg.dlc     = canFrame.dlc;
-        xlEvent.tagData.msg.flags   = 0;
-        std::ranges::copy_n(canFrame.data.begin(), canFrame.frameSize, std::begin(xlEvent.tagData.msg.data));
+    XLstatus xlStatus;
+    const auto queueFullDeadline = std::chrono::steady_clock::now() + std::chrono::milliseconds(REPLAY_QUEUE_FULL_MS);
 
-        xlStatus = xlCanTransmit(g_xlPortHandle, xlChanMaskTx, &messageCount, &xlEvent);
+    for (;;) {
+        if (g_canFdSupport) {
+            XLcanTxEvent canTxEvt;
+            unsigned int cntSent;
+
+            initToZero(canTxEvt);
+            canTxEvt.tag = XL_CAN_EV_TAG_TX_MSG;
+            canTxEvt.tagData.canMsg.canId    = entry.canId;
+            canTxEvt.tagData.canMsg.msgFlags = ((entry.msgFlags & XL_CAN_RXMSG_FLAG_EDL) ? XL_CAN_TXMSG_FLAG_EDL : 0u) |
+                                               ((entry.msgFlags & XL_CAN_RXMSG_FLAG_BRS) ? XL_CAN_TXMSG_FLAG_BRS : 0u) |
+                                               ((entry.msgFlags & XL_CAN_RXMSG_FLAG_RTR) ? XL_CAN_TXMSG_FLAG_RTR : 0u);
+            canTxEvt.tagData.canMsg.dlc      = entry.dlc;
+            std::ranges::copy_n(entry.data, entry.length, std::begin(canTxEvt.tagData.canMsg.data));
+            xlStatus = xlCanTransmitEx(g_xlPortHandle, channelMask, 1, &cntSent, &canTxEvt);
+        }
+        else {
+            XLevent xlEvent;
+            unsigned int messageCount = 1;
+
+            initToZero(xlEvent);
+            xlEvent.tag                 = XL_TRANSMIT_MSG;
+            xlEvent.tagData.msg.id      = entry.canId;
+            xlEvent.tagData.msg.dlc     = entry.dlc;
+            xlEvent.tagData.msg.flags   = (entry.msgFlags & XL_CAN_RXMSG_FLAG_RTR) ? XL_CAN_MSG_FLAG_REMOTE_FRAME : 0;
+            std::ranges::copy_n(entry.data, std::min<uint8>(entry.length, MAX_MSG_LEN), std::begin(xlEvent.tagData.msg.data));
+            xlStatus = xlCanTransmit(g_xlPortHandle, channelMask, &messageCount, &xlEvent);
+        }
+        // the transmit queue drains at bus speed, retry rather than lose the frame unless the bus is gone or the replay stopped
+        if (xlStatus != XL_ERR_QUEUE_IS_FULL || !consumerThreadRun.load(std::memory_order_relaxed) ||
+            std::chrono::steady_clock::now() >= queueFullDeadline) {
+            break;
+        }
+        std::this_thread::yield();
     }
-    else if(frametype == FrameType::StandardCanFd || frametype == FrameType::ExtendedCanFd)
-    {
-        XLcanTxEvent canTxEvt;
-        unsigned int cntSent;
 
-        initToZero(canTxEvt);
-        canTxEvt.tag = XL_CAN_EV_TAG_TX_MSG;
-
-        canTxEvt.tagData.canMsg.canId     = id;
-        canTxEvt.tagData.canMsg.msgFlags  = XL_CAN_TXMSG_FLAG_EDL | XL_CAN_TXMSG_FLAG_BRS;
-        auto canFrame = CanData(PduInfo->sdu, PduInfo->length);
-        canTxEvt.tagData.canMsg.dlc = canFrame.dlc;
-        std::ranges::copy_n(canFrame.data.begin(), canFrame.frameSize, std::begin(canTxEvt.tagData.canMsg.data));
-
-        xlStatus = xlCanTransmitEx(g_xlPortHandle, xlChanMaskTx, 1, &cntSent, &canTxEvt);
-    }
-    return xlStatus;
+    return xlStatus == XL_SUCCESS;
 }
 
-/*==================================================================================================
-*                                       GLOBAL FUNCTIONS
-==================================================================================================*/
-int main(int argc, char *argv[])
+XLstatus demoReplay(const std::string& path, const ReplaySettings& settings, bool toBus)
 {
-    XLstatus      xlStatus;
-
-
-    unsigned int  xlChanIndex = 0;
-    unsigned int  txID = 0x01;
-
-    fmt::print(
-            "┌{0:─^{3}}┐\n"
-            "│{1: ^{3}}│\n"
-            "│{2: ^{3}}│\n"
-#ifdef WIN64
-            "│{4: ^{3}}│\n"
-#endif
-            "└{0:─^{3}}┘\n", "", "xlCANdemo - Test Application for XL Family Driver API", fmt::format("Vector Informatik GmbH, {}", __DATE__), 58, "- 64bit Version -");
-
-    po::options_description desc("Allowed options");
-    desc.add_options()
-            ("help", "produce help message")
-            ("baudrate", po::value<unsigned int>(), "set baudrate (kbps)")
-            ("appname", po::value<std::string>(), "Name of the application to be read (e.g. \"xlCANcontrol\").\nApplication names are listed in the Vector Hardware Configuration tool.")
-            ("txid", po::value<unsigned int>(), "set ID for sending data")
-            ;
-
-    po::variables_map vm;
-    po::store(po::parse_command_line(argc, argv, desc), vm);
-    po::notify(vm);
-
-    if (vm.count("help")) {
-        std::stringstream str{};
-        str << desc;
-        fmt::print("{}\n", str.str());
-        return 1;
-    }
+    RecordReader recordReader;
+    AscReader ascReader;
+    ReplaySource source;
 
-    if (vm.count("baudrate")) {
-        g_BaudRate = vm["baudrate"].as<unsigned int>() * 1000;
-        fmt::print("Baudrate = {}kbps\n", vm["baudrate"].as<unsigned int>());
-    } else {
-        fmt::print("Baudrate was not set. Default Baudrate selected ({}kbps)\n", g_BaudRate/1000);
-    }
-
-    if (vm.count("appname")) {
-        g_AppName = vm["appname"].as<std::string>();
-        fmt::print("AppName = {}\n", vm["appname"].as<std::string>());
-    } else {
-        fmt::print("AppName was not set. Default AppName selected (\"{}\")\n", g_AppName);
+    if (path.ends_with(".asc")) {
+        if (!ascReader.open(path)) {
+            return XL_ERROR;
+        }
+        source = [&ascReader](RecordEntry& entry) { return ascReader.next(entry); };
     }
-
-    if (vm.count("txid")) {
-        txID = vm["txid"].as<unsigned int>();
-        fmt::print("TX ID = {:#X}\n", vm["txid"].as<unsigned int>());
-    } else {
-        fmt::print("TX ID was not set. Default TX ID selected ({})\n", txID);
+    else {
+        if (!recordReader.open(path)) {
+            return XL_ERROR;
+        }
+        source = [&recordReader](RecordEntry& entry) { return recordReader.next(entry); };
     }
 
-    xlStatus = demoInitDriver(xlChanMaskTx, xlChanIndex);
-    fmt::print("- Init             : {}\n",  xlGetErrorString(xlStatus));
+    const auto report = Replayer(settings).run(source, toBus ? ReplaySink(replayTransmit) : ReplaySink(Replayer::indicateToCanIf), consumerThreadRun);
 
-    if(XL_SUCCESS == xlStatus) {
-        xlStatus = demoCreateRxThread();
-        fmt::print("- Create RX thread : {}\n",  xlGetErrorString(xlStatus));
+    fmt::print("- Replay           : {} frames, {} failed, {} skipped, {:.0f} frames/s\n",
+               report.frames, report.failed, report.skipped, report.framesPerSecond());
+    if (settings.timing == ReplayTiming::Original && report.frames > 0) {
+        fmt::print("- Timing error     : mean {}ns, max {}ns\n", report.totalError.count() / static_cast<sint64>(report.frames), report.maxError.count());
+        for (std::size_t i = 0; i < report.errorHistogram.size(); ++i) {
+            if (report.errorHistogram[i] > 0) {
+                fmt::print("  {:>9} us : {}\n", i == 0 ? std::string("< 1") : fmt::format("< {}", 1u << i), report.errorHistogram[i]);
+            }
+        }
     }
-
-    if(XL_SUCCESS == xlStatus) {
-        xlStatus = xlActivateChannel(g_xlPortHandle, g_xlChannelMask, XL_BUS_TYPE_CAN, XL_ACTIVATE_RESET_CLOCK);
-        fmt::print("- ActivateChannel  : CM={:#X}, {}\n", g_xlChannelMask, xlGetErrorString(xlStatus));
-    }
-    Can_ErrorStateType res;
-    Can_XLdriver_GetControllerErrorState(0, &res);
-    std::array<uint8, 8> data{69, 21, 87, 34, 0, 1, 2, 4};
-    const Can_PduType pduinfo{
-            0x69 | 0x40000000, 0, data.size(), data.data()
-    };
-    Can_XLdriver_Write(0, &pduinfo);
-    while(true);
-    xlStatus = demoTransmit(txID);
-    return xlStatus;
+    return report.failed == 0 ? XL_SUCCESS : XL_ERROR;
 }
 
-
-
 /**@} */ // END OF addtogroup <>
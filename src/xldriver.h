@@ -0,0 +1,177 @@
+/**
+ * @file xldriver.h
+ * @author Maxime Verreault
+ * @date 2026-10-19
+ * @copyright COPYRIGHT(c) Maxime Verreault All rights reserved.
+ * @brief Driver state and entry points shared between the adapter, the demo application and the benchmarks
+ * @ingroup xldriver
+ * @addtogroup xldriver
+ * @{
+ */
+
+
+#ifndef XLDRIVER_H
+#define XLDRIVER_H
+
+/*==================================================================================================
+*                                         INCLUDE FILES
+* 1) system and project includes
+* 2) needed interfaces from external units
+* 3) internal and external interfaces from this unit
+==================================================================================================*/
+#include "vxlapi.h"
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <mutex>
+#include <string>
+#include <Can_GeneralTypes.h>
+#include "xlwait.h"
+#include "xlrecorder.h"
+#include "xlreplay.h"
+#include "xlexport.h"
+#include "xlbusload.h"
+#include "xlidstats.h"
+#include "xldeadline.h"
+#include "xltxtimeout.h"
+
+
+/*==================================================================================================
+*                                       DEFINES AND MACROS
+==================================================================================================*/
+#define RX_QUEUE_STALL_MS          50       // RX thread stall absorbed by a receive queue sized from the bus load
+
+
+/*==================================================================================================
+*                                STRUCTURES AND OTHER TYPEDEFS
+==================================================================================================*/
+/** @brief Handler of one event tag of a classic CAN port */
+using CanEventHandler = void (*)(XLevent& xlEvent);
+
+/** @brief Handler of one event tag of a CAN FD port */
+using CanFdEventHandler = void (*)(XLcanRxEvent& xlEvent);
+
+/** @brief Losses and fill level of the XL receive queue, written by the thread reading the queue */
+struct RxQueueStatistics
+{
+    std::array<std::atomic<uint64>, XL_CONFIG_MAX_CHANNELS> overflows{};    //!< events flagged after a loss, by channel of the flagged event
+    std::atomic<unsigned int> highWater{0};                                 //!< most events seen waiting in the queue
+    unsigned int size{0};                                                   //!< size given to xlOpenPort, bytes on a CAN FD port, else events
+};
+
+/** @brief Last chip state of each channel, the classic and CAN FD events are kept apart */
+struct ChipStates
+{
+    std::mutex mutex;                                                       //!< guards the states and the sequences
+    std::condition_variable changed;                                        //!< notified on every chip state event
+    std::array<s_xl_chip_state, XL_CONFIG_MAX_CHANNELS> classic{};          //!< last XL_CHIP_STATE of each channel
+    std::array<XL_CAN_EV_CHIP_STATE, XL_CONFIG_MAX_CHANNELS> canFd{};       //!< last XL_CAN_EV_TAG_CHIP_STATE of each channel
+    std::array<uint32, XL_CONFIG_MAX_CHANNELS> sequence{};                  //!< chip state events received on each channel
+};
+
+
+/*==================================================================================================
+*                                GLOBAL VARIABLE DECLARATIONS
+==================================================================================================*/
+extern std::string      g_AppName;
+extern XLportHandle     g_xlPortHandle;
+extern XLaccess         g_xlChannelMask;
+extern XLaccess         g_xlPermissionMask;
+extern unsigned int     g_BaudRate;
+extern unsigned int     g_DataBitRate;
+extern unsigned int     g_RxQueueSize;
+extern unsigned int     g_RxBusLoad;
+extern unsigned int     g_RxBusBitRate;
+extern int              g_silent;
+extern unsigned int     g_canFdSupport;
+extern XLaccess         xlChanMaskTx;
+extern RxWaitMode       g_RxWaitMode;
+extern std::chrono::microseconds g_RxSpinBudget;
+extern Recorder         g_Recorder;
+extern ExportPipeline   g_Export;
+extern std::atomic<bool> consumerThreadRun;
+extern ChipStates       g_ChipStates;
+extern RxQueueStatistics g_RxQueueStatistics;
+extern BusLoadMeter     g_BusLoad;
+extern IdStatisticsTable g_IdStatistics;
+extern DeadlineMonitor  g_RxDeadlines;
+extern TxSupervisor     g_TxSupervisor;
+
+
+/*==================================================================================================
+*                                     FUNCTION PROTOTYPES
+==================================================================================================*/
+XLstatus demoInitDriver(XLaccess &pxlChannelMaskTx, unsigned int &pxlChannelIndex);
+XLstatus demoCreateRxThread();
+/** @brief Stop and join the RX thread, the replay also stops as it shares consumerThreadRun */
+void demoStopRxThread();
+XLstatus demoTransmit(unsigned int txID);
+XLstatus demoReplay(const std::string& path, const ReplaySettings& settings, bool toBus);
+bool replayTransmit(const RecordEntry& entry);
+
+/**
+ * @brief Record, print and dispatch one event of a classic CAN port, as the RX thread does
+ * @details The handler comes from a table indexed by the event tag, built at compile time.
+ */
+void handleEvent(XLevent& xlEvent);
+
+/**
+ * @brief Record, print and dispatch one event of a CAN FD port, as the RX thread does
+ * @details The handler comes from a table indexed by the event tag and the queue overflow flag,
+ *          built at compile time, the flagged events are counted in g_RxQueueStatistics first.
+ */
+void handleCanFdEvent(XLcanRxEvent& xlEvent);
+
+/**
+ * @brief Replace the handler of a classic CAN event tag, before the RX thread starts
+ * @param handler nullptr restores the built-in handler
+ * @return the replaced handler, for the new one to chain to it, nullptr when another tag owns the slot
+ */
+CanEventHandler setCanEventHandler(unsigned char tag, CanEventHandler handler);
+
+/**
+ * @brief Replace the handler of a CAN FD event tag, before the RX thread starts
+ * @param handler nullptr restores the built-in handler
+ * @return the replaced handler, for the new one to chain to it, nullptr when another tag owns the slot
+ */
+CanFdEventHandler setCanFdEventHandler(unsigned short tag, CanFdEventHandler handler);
+
+/** @brief Receive and dispatch at most maxEvents events from the calling thread, in place of the RX thread */
+unsigned int pollEvents(unsigned int maxEvents);
+
+/**
+ * @brief Receive queue size holding the events of RX_QUEUE_STALL_MS of traffic on the channels
+ * @details Every channel is loaded at busLoad (%) with the shortest frames. The size is rounded up
+ *          to a power of two, kept within the limits of xlOpenPort and never below the default.
+ * @return bytes for a CAN FD port, else events
+ */
+unsigned int rxQueueSizeFor(unsigned int channels, unsigned int bitRate, unsigned int busLoad, bool canFd);
+
+/** @brief Bitrates of the frames counted in g_BusLoad for the channels of a mask, once they are applied */
+void setBusLoadBitRates(XLaccess channelMask, unsigned int bitRate, unsigned int dataBitRate);
+
+/**
+ * @brief Hand a received frame of an XL channel to CanIf, now or from Can_XLdriver_MainFunction_Read
+ * @details Before Can_XLdriver_Init every channel is reported at once, with its index as ControllerId.
+ */
+void canRxIndication(unsigned int channelIndex, Can_IdType canId, const uint8* data, uint8 length);
+
+/** @brief HTH of Can_XLdriver_Write without a configuration for the channels of the port just opened, before any writer starts */
+void canOpenDefaultTxHth(XLaccess channelMask);
+
+/** @brief Hand a transmit confirmation of an XL channel to CanIf, now or from Can_XLdriver_MainFunction_Write */
+void canTxConfirmation(unsigned int channelIndex, Can_IdType canId);
+
+/** @brief Stop the controller of an XL channel gone bus-off and report it, now or from Can_XLdriver_MainFunction_BusOff */
+void canBusOff(unsigned int channelIndex);
+
+/** @brief Report an error frame seen or caused by an XL channel to CanIf */
+void canBusError(unsigned int channelIndex);
+
+/** @brief Report an XL channel gone error passive to CanIf */
+void canErrorPassive(unsigned int channelIndex);
+
+#endif //XLDRIVER_H
+
+/**@} */ // END OF addtogroup xldriver
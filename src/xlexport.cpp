@@ -0,0 +1,80 @@
+/**
+ * @file xlexport.cpp
+ * @author Maxime Verreault
+ * @date 2026-10-19
+ * @copyright COPYRIGHT(c) Maxime Verreault All rights reserved.
+ * @brief Streaming export of the driver events into log files, off the RX hot path
+ * @ingroup xldriver
+ * @addtogroup xlexport
+ * @{
+ */
+
+
+/*==================================================================================================
+*                                        INCLUDE FILES
+* 1) system and project includes
+* 2) needed interfaces from external units
+* 3) internal and external interfaces from this unit
+==================================================================================================*/
+#include "xlexport.h"
+#include <chrono>
+
+
+/*==================================================================================================
+*                                       GLOBAL FUNCTIONS
+==================================================================================================*/
+ExportPipeline::~ExportPipeline()
+{
+    stop();
+}
+
+void ExportPipeline::addWriter(std::unique_ptr<LogWriter> writer)
+{
+    writers.push_back(std::move(writer));
+}
+
+void ExportPipeline::start()
+{
+    if(writers.empty() || running.exchange(true))
+    {
+        return;
+    }
+    worker = std::thread([this]() {
+        while(running.load(std::memory_order_relaxed))
+        {
+            drain();
+            std::this_thread::sleep_for(std::chrono::milliseconds(EXPORT_IDLE_SLEEP_MS));
+        }
+        drain();
+    });
+}
+
+void ExportPipeline::stop()
+{
+    if(!running.exchange(false))
+    {
+        return;
+    }
+    worker.join();
+    for(auto& writer : writers)
+    {
+        writer->close();
+    }
+}
+
+void ExportPipeline::drain()
+{
+    RecordEntry entry;
+    uint64 count = 0;
+    while(queue.pop(entry))
+    {
+        for(auto& writer : writers)
+        {
+            writer->write(entry);
+        }
+        ++count;
+    }
+    exportedCount.fetch_add(count, std::memory_order_relaxed);
+}
+
+/**@} */ // END OF addtogroup xlexport
@@ -0,0 +1,100 @@
+/**
+ * @file xlexport.h
+ * @author Maxime Verreault
+ * @date 2026-10-19
+ * @copyright COPYRIGHT(c) Maxime Verreault All rights reserved.
+ * @brief Streaming export of the driver events into log files, off the RX hot path
+ * @ingroup xldriver
+ * @addtogroup xlexport
+ * @{
+ */
+
+
+#ifndef XLEXPORT_H
+#define XLEXPORT_H
+
+/*==================================================================================================
+*                                         INCLUDE FILES
+* 1) system and project includes
+* 2) needed interfaces from external units
+* 3) internal and external interfaces from this unit
+==================================================================================================*/
+#include <atomic>
+#include <memory>
+#include <thread>
+#include <vector>
+#include "xlrecorder.h"
+#include "xlring.h"
+
+
+/*==================================================================================================
+*                                       DEFINES AND MACROS
+==================================================================================================*/
+#define EXPORT_QUEUE_CAPACITY       65536   // events buffered between the RX thread and the export thread
+#define EXPORT_IDLE_SLEEP_MS        1       // export thread sleep when the queue is empty
+
+
+/*==================================================================================================
+*                                STRUCTURES AND OTHER TYPEDEFS
+==================================================================================================*/
+/**
+ * @brief Log file format fed with recorded events by the export thread
+ */
+class LogWriter
+{
+public:
+    virtual ~LogWriter() = default;
+    virtual void write(const RecordEntry& entry) = 0;
+    virtual void close() = 0;
+    [[nodiscard]] virtual uint64 bytesWritten() const = 0;
+};
+
+/**
+ * @brief Moves events from the RX thread to the log writers
+ * @details push() only copies the record into a lock-free ring, formatting and file output run on
+ *          the export thread. Events are dropped, and counted, when the ring is full.
+ */
+class ExportPipeline
+{
+public:
+    explicit ExportPipeline(std::size_t queueCapacity = EXPORT_QUEUE_CAPACITY): queue(queueCapacity)
+    {
+    }
+    ExportPipeline(const ExportPipeline&) = delete;
+    ExportPipeline& operator=(const ExportPipeline&) = delete;
+    ~ExportPipeline();
+
+    /** @brief Register a writer, only before start() */
+    void addWriter(std::unique_ptr<LogWriter> writer);
+    void start();
+    /** @brief Drain the queue, close the writers and join the export thread */
+    void stop();
+    [[nodiscard]] bool isRunning() const { return running.load(std::memory_order_relaxed); }
+
+    bool push(const RecordEntry& entry)
+    {
+        if(queue.push(entry))
+        {
+            return true;
+        }
+        droppedCount.fetch_add(1, std::memory_order_relaxed);
+        return false;
+    }
+
+    [[nodiscard]] uint64 dropped() const { return droppedCount.load(std::memory_order_relaxed); }
+    [[nodiscard]] uint64 exported() const { return exportedCount.load(std::memory_order_relaxed); }
+
+private:
+    SpscRing<RecordEntry> queue;
+    std::vector<std::unique_ptr<LogWriter>> writers{};
+    std::thread worker{};
+    std::atomic<bool> running{false};
+    std::atomic<uint64> droppedCount{0};
+    std::atomic<uint64> exportedCount{0};
+
+    void drain();
+};
+
+#endif //XLEXPORT_H
+
+/**@} */ // END OF addtogroup xlexport
@@ -0,0 +1,366 @@
+/**
+ * @file xlframe.h
+ * @author Maxime Verreault
+ * @date 2026-10-19
+ * @copyright COPYRIGHT(c) Maxime Verreault All rights reserved.
+ * @brief Frame classification, DLC conversion and XL event initialization helpers
+ * @ingroup xldriver
+ * @addtogroup xlframe
+ * @{
+ */
+
+
+#ifndef XLFRAME_H
+#define XLFRAME_H
+
+/*==================================================================================================
+*                                         INCLUDE FILES
+* 1) system and project includes
+* 2) needed interfaces from external units
+* 3) internal and external interfaces from this unit
+==================================================================================================*/
+#include "vxlapi.h"
+#include <algorithm>
+#include <array>
+#include <cstring>
+#include <vector>
+#include <Can_GeneralTypes.h>
+#if defined(__AVX2__)
+#include <immintrin.h>
+#define XL_FRAME_AVX2
+#elif defined(__SSE2__) || defined(_M_X64)
+#include <emmintrin.h>
+#define XL_FRAME_SSE2
+#endif
+
+
+/*==================================================================================================
+*                                       GLOBAL CONSTANTS
+==================================================================================================*/
+/** @brief Payload size of each DLC, ISO 11898-1 */
+inline constexpr std::array<uint8, 16> PayloadSizeOfDlc{0, 1, 2, 3, 4, 5, 6, 7, 8, 12, 16, 20, 24, 32, 48, 64};
+
+/** @brief Smallest DLC whose payload holds each SDU length up to 64 bytes */
+inline constexpr auto DlcOfLength = []() {
+    std::array<uint8, XL_CAN_MAX_DATA_LEN + 1> dlcs{};
+    uint8 dlc = 0;
+    for(uint8 length = 0; length < dlcs.size(); ++length)
+    {
+        while(PayloadSizeOfDlc[dlc] < length)
+        {
+            ++dlc;
+        }
+        dlcs[length] = dlc;
+    }
+    return dlcs;
+}();
+
+
+/*==================================================================================================
+*                                STRUCTURES AND OTHER TYPEDEFS
+==================================================================================================*/
+struct FrameType
+{
+    static constexpr uint8 StandardCan = 0;
+    static constexpr uint8 StandardCanFd = 1;
+    static constexpr uint8 ExtendedCan = 2;
+    static constexpr uint8 ExtendedCanFd = 3;
+    static constexpr uint32 mask = 0xC0000000;
+    const uint8 selected;
+
+    constexpr explicit FrameType(const Can_IdType id): selected((id & mask) >> 30)
+    {
+    }
+
+    bool operator ==(uint8& other) const
+    {
+        return selected == other;
+    }
+
+    bool operator ==(const uint8& other) const
+    {
+        return selected == other;
+    }
+};
+
+template<typename T>
+constexpr void initToZero(T& source)
+{
+    (void) source;
+}
+
+template<>
+constexpr void initToZero(XLcanTxEvent& source)
+{
+    source.channelIndex = 0;
+    source.tag = 0;
+    source.transId = 0;
+    for(unsigned char & i : source.reserved)
+    {
+        i = 0;
+    }
+    source.tagData.canMsg.canId = 0;
+    source.tagData.canMsg.dlc = 0;
+    source.tagData.canMsg.msgFlags = 0;
+    for(unsigned char & i : source.tagData.canMsg.data)
+    {
+        i = 0;
+    }
+    for(unsigned char & i : source.tagData.canMsg.reserved)
+    {
+        i = 0;
+    }
+}
+
+template<>
+constexpr void initToZero(XLevent & source)
+{
+    source.tag = 0;
+    source.chanIndex = 0;
+    source.transId = 0;
+    source.portHandle = 0;
+    source.flags = 0;
+    source.reserved = 0;
+    source.timeStamp = 0;
+    source.tagData.msg.dlc = 0;
+    source.tagData.msg.flags = 0;
+    source.tagData.msg.id = 0;
+    source.tagData.msg.res1 = 0;
+    source.tagData.msg.res2 = 0;
+    for(unsigned char & i: source.tagData.msg.data)
+    {
+        i = 0;
+    }
+}
+
+template<>
+constexpr void initToZero(XLcanFdConf& source)
+{
+    source.arbitrationBitRate = 0;
+    source.sjwAbr = 0;
+    source.tseg1Abr = 0;
+    source.tseg2Abr = 0;
+    source.dataBitRate = 0;
+    source.sjwDbr = 0;
+    source.tseg1Dbr = 0;
+    source.tseg2Dbr = 0;
+    source.reserved = 0;
+    source.options = 0;
+    for(auto & data: source.reserved1)
+    {
+        data = 0;
+    }
+    source.reserved2 = 0;
+}
+
+struct CanData
+{
+    std::vector<uint8> data{};
+    const uint8 dlc;
+    const uint8 frameSize;
+
+    CanData(const uint8* rawData, uint8 length): dlc(getDLC(length)), frameSize(getPayloadSize(dlc))
+    {
+        const auto copied = std::min(length, frameSize);
+        data.resize(frameSize);
+        std::copy_n(rawData, copied, data.begin());
+        std::fill(data.begin() + copied, data.end(), 0x55);
+    }
+
+    /** @brief DLC of an SDU length, the longer SDUs are truncated to DLC 15 */
+    static constexpr uint8 getDLC(uint8 length)
+    {
+        return DlcOfLength[std::min<uint8>(length, XL_CAN_MAX_DATA_LEN)];
+    }
+
+    /** @brief Payload size of a DLC, 0 for the values a 4-bit DLC cannot take */
+    static constexpr uint8 getPayloadSize(uint8 dlc)
+    {
+        return dlc < PayloadSizeOfDlc.size() ? PayloadSizeOfDlc[dlc] : 0;
+    }
+};
+
+/** @brief Every SDU length gets the smallest DLC holding it, DLC 15 beyond 64 bytes, and no DLC beyond 15 has a payload */
+constexpr bool isDlcConversionExhaustive()
+{
+    for(unsigned length = 0; length <= 0xFF; ++length)
+    {
+        const auto dlc = CanData::getDLC(static_cast<uint8>(length));
+        const auto size = CanData::getPayloadSize(dlc);
+        if(length > XL_CAN_MAX_DATA_LEN ? dlc != 15 : size < length || (dlc > 0 && CanData::getPayloadSize(dlc - 1) >= length) || (length <= 8 && dlc != length))
+        {
+            return false;
+        }
+    }
+    for(unsigned dlc = 16; dlc <= 0xFF; ++dlc)
+    {
+        if(CanData::getPayloadSize(static_cast<uint8>(dlc)) != 0)
+        {
+            return false;
+        }
+    }
+    return true;
+}
+
+static_assert(isDlcConversionExhaustive());
+static_assert(CanData::getDLC(13) == 10 && CanData::getDLC(49) == 15 && CanData::getPayloadSize(13) == 32);
+
+/**
+ * @brief Reference of copyPadded: the SDU then the padding up to the capacity of the frame
+ * @param length bytes of the SDU, at most Capacity
+ */
+template<std::size_t Capacity>
+inline void copyPaddedScalar(unsigned char (&frame)[Capacity], const uint8* sdu, uint8 length, uint8 padding)
+{
+    std::copy_n(sdu, length, frame);
+    std::fill(frame + length, frame + Capacity, padding);
+}
+
+/** @brief Copy of 0 to 16 bytes by two overlapping moves at most, never reading past the SDU */
+inline void copyShort(unsigned char* frame, const uint8* sdu, uint8 length)
+{
+    if(length >= 8)
+    {
+        std::memcpy(frame, sdu, 8);
+        std::memcpy(frame + length - 8, sdu + length - 8, 8);
+    }
+    else if(length >= 4)
+    {
+        std::memcpy(frame, sdu, 4);
+        std::memcpy(frame + length - 4, sdu + length - 4, 4);
+    }
+    else if(length > 0)
+    {
+        // 1 to 3 bytes: first, middle and last
+        frame[0] = sdu[0];
+        frame[length / 2] = sdu[length / 2];
+        frame[length - 1] = sdu[length - 1];
+    }
+}
+
+/**
+ * @brief SDU copied into an XL frame, the rest of the frame filled with the padding
+ * @details A CAN FD frame is padded by whole vector stores, then the SDU is copied by overlapping
+ *          vector moves, so any length takes a few instructions and no loop over the bytes. The
+ *          SDU is never read past its length. A classic CAN frame is padded by a single word, other
+ *          capacities, and targets without SSE2, take copyPaddedScalar.
+ * @param length bytes of the SDU, at most Capacity
+ */
+template<std::size_t Capacity>
+inline void copyPadded(unsigned char (&frame)[Capacity], const uint8* sdu, uint8 length, uint8 padding)
+{
+    if constexpr(Capacity == MAX_MSG_LEN)
+    {
+        // a classic CAN frame is padded by one 64-bit store
+        const uint64 pad = 0x0101010101010101ull * padding;
+        std::memcpy(frame, &pad, sizeof(pad));
+        copyShort(frame, sdu, length);
+        return;
+    }
+#if defined(XL_FRAME_AVX2)
+    if constexpr(Capacity == XL_CAN_MAX_DATA_LEN)
+    {
+        const __m256i pad = _mm256_set1_epi8(static_cast<char>(padding));
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(frame), pad);
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(frame + 32), pad);
+        if(length >= 32)
+        {
+            const __m256i head = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(sdu));
+            const __m256i tail = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(sdu + length - 32));
+            _mm256_storeu_si256(reinterpret_cast<__m256i*>(frame), head);
+            _mm256_storeu_si256(reinterpret_cast<__m256i*>(frame + length - 32), tail);
+        }
+        else if(length >= 16)
+        {
+            const __m128i head = _mm_loadu_si128(reinterpret_cast<const __m128i*>(sdu));
+            const __m128i tail = _mm_loadu_si128(reinterpret_cast<const __m128i*>(sdu + length - 16));
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(frame), head);
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(frame + length - 16), tail);
+        }
+        else
+        {
+            copyShort(frame, sdu, length);
+        }
+        return;
+    }
+#elif defined(XL_FRAME_SSE2)
+    if constexpr(Capacity == XL_CAN_MAX_DATA_LEN)
+    {
+        const __m128i pad = _mm_set1_epi8(static_cast<char>(padding));
+        for(std::size_t offset = 0; offset < Capacity; offset += 16)
+        {
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(frame + offset), pad);
+        }
+        if(length >= 16)
+        {
+            // whole blocks, then the last 16 bytes overlapping the previous block
+            for(std::size_t offset = 0; offset + 16 < length; offset += 16)
+            {
+                _mm_storeu_si128(reinterpret_cast<__m128i*>(frame + offset), _mm_loadu_si128(reinterpret_cast<const __m128i*>(sdu + offset)));
+            }
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(frame + length - 16), _mm_loadu_si128(reinterpret_cast<const __m128i*>(sdu + length - 16)));
+        }
+        else
+        {
+            copyShort(frame, sdu, length);
+        }
+        return;
+    }
+#endif
+    copyPaddedScalar(frame, sdu, length, padding);
+}
+
+/** @brief Bits of a frame on the bus, per bitrate phase */
+struct FrameBits
+{
+    uint32 nominal;     //!< bits at the nominal bitrate, the whole frame without bitrate switch
+    uint32 data;        //!< bits at the data bitrate, from ESI to the CRC delimiter with bitrate switch
+
+    /** @brief Duration of the frame (ns) */
+    [[nodiscard]] constexpr uint64 durationNs(uint32 bitRate, uint32 dataBitRate) const
+    {
+        return nominal * 1000000000ull / bitRate + (data != 0 ? data * 1000000000ull / dataBitRate : 0);
+    }
+};
+
+/**
+ * @brief Bits of a frame from SOF to the end of the intermission, without the dynamic stuff bits
+ * @details The fixed stuff bits of the CAN FD CRC field are counted. Remote frames carry no data.
+ */
+constexpr FrameBits frameBits(bool extended, bool fd, bool brs, bool remote, uint8 dlc)
+{
+    // ACK slot and delimiter, EOF, intermission
+    constexpr uint32 trailer = 2 + 7 + 3;
+    const uint32 payload = remote ? 0u : 8u * CanData::getPayloadSize(dlc);
+
+    if(!fd)
+    {
+        // SOF, identifier, RTR/SRR, IDE, r0/r1, DLC, data, CRC, CRC delimiter
+        return FrameBits{(extended ? 1 + 11 + 1 + 1 + 18 + 1 + 1 + 1 : 1 + 11 + 1 + 1 + 1) + 4 + payload + 15 + 1 + trailer, 0};
+    }
+    // SOF, identifier, RRS, IDE, FDF, res, BRS
+    const uint32 arbitration = extended ? 1 + 11 + 1 + 1 + 18 + 1 + 1 + 1 + 1 : 1 + 11 + 1 + 1 + 1 + 1 + 1;
+    // ESI, DLC, data, stuff count, CRC 17 or 21 with its fixed stuff bits, CRC delimiter
+    const uint32 dataPhase = 1 + 4 + payload + 4 + (payload <= 8 * 16 ? 17 + 6 : 21 + 7) + 1;
+    return brs ? FrameBits{arbitration + trailer, dataPhase} : FrameBits{arbitration + dataPhase + trailer, 0};
+}
+
+static_assert(frameBits(false, false, false, false, 8).nominal == 111);
+static_assert(frameBits(true, false, false, false, 8).nominal == 131);
+
+/** @brief Shortest frame of a bus, classic with a standard identifier and no payload: it bounds the frame rate */
+inline constexpr uint32 ShortestFrameBits = frameBits(false, false, false, false, 0).nominal;
+static_assert(ShortestFrameBits == 47);
+
+/** @brief Most frames per second of a bus loaded at busLoad (%), all of them the shortest one */
+constexpr uint64 busFrameRate(uint32 bitRate, uint32 busLoad)
+{
+    return static_cast<uint64>(bitRate) * busLoad / (100u * ShortestFrameBits);
+}
+
+/** @brief Bits of an error frame: error flag, superposed flags of the other nodes, delimiter and intermission */
+inline constexpr uint32 ErrorFrameBits = 6 + 6 + 8 + 3;
+
+#endif //XLFRAME_H
+
+/**@} */ // END OF addtogroup xlframe
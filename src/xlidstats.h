@@ -0,0 +1,275 @@
+/**
+ * @file xlidstats.h
+ * @author Maxime Verreault
+ * @date 2026-10-19
+ * @copyright COPYRIGHT(c) Maxime Verreault All rights reserved.
+ * @brief Count, cycle time, jitter and gaps of each CAN identifier seen by the RX path
+ * @ingroup xldriver
+ * @addtogroup xlidstats
+ * @{
+ */
+
+
+#ifndef XLIDSTATS_H
+#define XLIDSTATS_H
+
+/*==================================================================================================
+*                                         INCLUDE FILES
+* 1) system and project includes
+* 2) needed interfaces from external units
+* 3) internal and external interfaces from this unit
+==================================================================================================*/
+#include "vxlapi.h"
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <bit>
+#include <cmath>
+#include <memory>
+#include <Platform_Types.h>
+
+
+/*==================================================================================================
+*                                       DEFINES AND MACROS
+==================================================================================================*/
+#define ID_STATISTICS_EXTENDED_SLOTS    1024u       // extended identifiers tracked per channel, a power of 2
+#define ID_STATISTICS_GAP_RATIO         1.5         // a period beyond this ratio of the mean cycle misses cycles
+#define ID_STATISTICS_MIN_PERIODS       4u          // periods averaged before the gaps are detected
+
+
+/*==================================================================================================
+*                                STRUCTURES AND OTHER TYPEDEFS
+==================================================================================================*/
+/** @brief Statistics of one identifier of a channel, the times in ns of the driver clock */
+struct IdStatistics
+{
+    uint32 id;                  //!< identifier, XL_CAN_EXT_MSG_ID set for an extended one
+    uint64 count;               //!< frames
+    uint64 lastTimeStamp;       //!< timestamp of the last frame
+    uint64 minPeriod;           //!< shortest period, 0 before the second frame
+    uint64 maxPeriod;           //!< longest period, gaps included
+    float64 meanPeriod;         //!< mean of the periods without a gap
+    float64 periodVariance;     //!< sample variance of the periods without a gap, the jitter is its square root
+    uint64 periods;             //!< periods of the mean and variance
+    uint64 missedCycles;        //!< cycles missing in the gaps, a gap is a period beyond ID_STATISTICS_GAP_RATIO of the mean
+};
+
+/**
+ * @brief Statistics of the identifiers of each channel, updated by the thread reading the XL queue
+ * @details The 2048 standard identifiers of a channel are a flat array, the extended ones an open
+ *          addressing table of ID_STATISTICS_EXTENDED_SLOTS slots, never emptied until the next
+ *          reset: the frames of the identifiers beyond it are only counted. An update is O(1) and
+ *          allocates nothing, the tables are allocated by reset for the channels of the port. Each
+ *          identifier is a seqlock: a snapshot, from any thread, retries while the RX thread
+ *          updates the same identifier and never blocks it.
+ */
+class IdStatisticsTable
+{
+public:
+    /** @brief Add a frame of a channel, from the thread reading the XL queue only */
+    void addFrame(unsigned int channelIndex, uint32 id, XLuint64 timeStamp)
+    {
+        auto* table = channels[channelIndex % channels.size()].get();
+        if(table == nullptr)
+        {
+            return;
+        }
+        auto* entry = (id & XL_CAN_EXT_MSG_ID) ? table->insert(id) : &table->standard[id & (table->standard.size() - 1)];
+        if(entry == nullptr) [[unlikely]]
+        {
+            table->untracked.store(table->untracked.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+            return;
+        }
+        update(*entry, timeStamp);
+    }
+
+    /**
+     * @brief Statistics of an identifier of a channel
+     * @return false when no frame of the identifier was seen
+     */
+    bool snapshot(unsigned int channelIndex, uint32 id, IdStatistics& statistics) const
+    {
+        const auto* table = channels[channelIndex % channels.size()].get();
+        if(table == nullptr)
+        {
+            return false;
+        }
+        const auto* entry = (id & XL_CAN_EXT_MSG_ID) ? table->find(id) : &table->standard[id & (table->standard.size() - 1)];
+        return entry != nullptr && read(*entry, (id & XL_CAN_EXT_MSG_ID) ? id : id & (table->standard.size() - 1), statistics);
+    }
+
+    /** @brief Statistics of every identifier seen on a channel, the standard ones in order, then the extended ones */
+    template<typename Function>
+    void forEach(unsigned int channelIndex, Function function) const
+    {
+        const auto* table = channels[channelIndex % channels.size()].get();
+        if(table == nullptr)
+        {
+            return;
+        }
+        IdStatistics statistics{};
+        for(uint32 id = 0; id < table->standard.size(); ++id)
+        {
+            if(read(table->standard[id], id, statistics))
+            {
+                function(statistics);
+            }
+        }
+        for(const auto& entry : table->extended)
+        {
+            const auto id = entry.id.load(std::memory_order_acquire);
+            if(id != NoId && read(entry, id, statistics))
+            {
+                function(statistics);
+            }
+        }
+    }
+
+    /** @brief Frames of the extended identifiers found no slot on a channel */
+    [[nodiscard]] uint64 untracked(unsigned int channelIndex) const
+    {
+        const auto* table = channels[channelIndex % channels.size()].get();
+        return table != nullptr ? table->untracked.load(std::memory_order_relaxed) : 0;
+    }
+
+    /** @brief Forget every frame and allocate the tables of the channels of a mask, when the port is opened */
+    void reset(XLaccess channelMask)
+    {
+        for(unsigned int channel = 0; channel < channels.size(); ++channel)
+        {
+            channels[channel] = (channelMask >> channel) & 1u ? std::make_unique<Table>() : nullptr;
+        }
+    }
+
+private:
+    static constexpr uint32 NoId = 0;       //!< free extended slot, 0 has no XL_CAN_EXT_MSG_ID
+
+    struct Entry
+    {
+        std::atomic<uint32> sequence{0};            //!< odd while the RX thread updates the entry
+        std::atomic<uint32> id{NoId};               //!< extended identifier of a slot
+        std::atomic<uint64> count{0};
+        std::atomic<uint64> lastTimeStamp{0};
+        std::atomic<uint64> minPeriod{0};
+        std::atomic<uint64> maxPeriod{0};
+        std::atomic<uint64> periods{0};
+        std::atomic<uint64> missedCycles{0};
+        std::atomic<float64> meanPeriod{0.0};
+        std::atomic<float64> squaredDeviations{0.0};    //!< sum of the squared deviations from the mean (Welford)
+    };
+
+    struct Table
+    {
+        std::array<Entry, 2048> standard{};
+        std::array<Entry, ID_STATISTICS_EXTENDED_SLOTS> extended{};
+        std::atomic<uint64> untracked{0};
+
+        static std::size_t slotOf(uint32 id)
+        {
+            // Fibonacci hashing, the identifiers of a network often differ in their low bits only
+            return (id * 0x9E3779B1u) >> (32 - std::countr_zero(ID_STATISTICS_EXTENDED_SLOTS));
+        }
+
+        /** @brief Slot of an extended identifier, taken on its first frame, nullptr when the table is full */
+        Entry* insert(uint32 id)
+        {
+            for(std::size_t probe = 0, slot = slotOf(id); probe < extended.size(); ++probe, slot = (slot + 1) & (extended.size() - 1))
+            {
+                const auto current = extended[slot].id.load(std::memory_order_relaxed);
+                if(current == id)
+                {
+                    return &extended[slot];
+                }
+                if(current == NoId)
+                {
+                    extended[slot].id.store(id, std::memory_order_release);
+                    return &extended[slot];
+                }
+            }
+            return nullptr;
+        }
+
+        [[nodiscard]] const Entry* find(uint32 id) const
+        {
+            for(std::size_t probe = 0, slot = slotOf(id); probe < extended.size(); ++probe, slot = (slot + 1) & (extended.size() - 1))
+            {
+                const auto current = extended[slot].id.load(std::memory_order_acquire);
+                if(current == id)
+                {
+                    return &extended[slot];
+                }
+                if(current == NoId)
+                {
+                    return nullptr;
+                }
+            }
+            return nullptr;
+        }
+    };
+
+    static void update(Entry& entry, XLuint64 timeStamp)
+    {
+        const auto sequence = entry.sequence.load(std::memory_order_relaxed);
+        entry.sequence.store(sequence + 1, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_release);
+
+        const auto count = entry.count.load(std::memory_order_relaxed);
+        if(count != 0)
+        {
+            const auto last = entry.lastTimeStamp.load(std::memory_order_relaxed);
+            const uint64 period = timeStamp > last ? timeStamp - last : 0;
+            const auto periods = entry.periods.load(std::memory_order_relaxed);
+            const auto mean = entry.meanPeriod.load(std::memory_order_relaxed);
+            entry.minPeriod.store(count == 1 ? period : std::min<uint64>(entry.minPeriod.load(std::memory_order_relaxed), period), std::memory_order_relaxed);
+            entry.maxPeriod.store(std::max<uint64>(entry.maxPeriod.load(std::memory_order_relaxed), period), std::memory_order_relaxed);
+            if(periods >= ID_STATISTICS_MIN_PERIODS && static_cast<float64>(period) > ID_STATISTICS_GAP_RATIO * mean)
+            {
+                const auto missed = static_cast<uint64>(std::llround(static_cast<float64>(period) / mean)) - 1;
+                entry.missedCycles.store(entry.missedCycles.load(std::memory_order_relaxed) + missed, std::memory_order_relaxed);
+            }
+            else
+            {
+                const auto delta = static_cast<float64>(period) - mean;
+                const auto updated = mean + delta / static_cast<float64>(periods + 1);
+                entry.meanPeriod.store(updated, std::memory_order_relaxed);
+                entry.squaredDeviations.store(entry.squaredDeviations.load(std::memory_order_relaxed) + delta * (static_cast<float64>(period) - updated),
+                                              std::memory_order_relaxed);
+                entry.periods.store(periods + 1, std::memory_order_relaxed);
+            }
+        }
+        entry.lastTimeStamp.store(timeStamp, std::memory_order_relaxed);
+        entry.count.store(count + 1, std::memory_order_relaxed);
+
+        entry.sequence.store(sequence + 2, std::memory_order_release);
+    }
+
+    /** @brief Consistent copy of an entry, false when it has no frame */
+    static bool read(const Entry& entry, uint32 id, IdStatistics& statistics)
+    {
+        uint32 sequence = 0;
+        do
+        {
+            sequence = entry.sequence.load(std::memory_order_acquire);
+            statistics.count = entry.count.load(std::memory_order_relaxed);
+            statistics.lastTimeStamp = entry.lastTimeStamp.load(std::memory_order_relaxed);
+            statistics.minPeriod = entry.minPeriod.load(std::memory_order_relaxed);
+            statistics.maxPeriod = entry.maxPeriod.load(std::memory_order_relaxed);
+            statistics.periods = entry.periods.load(std::memory_order_relaxed);
+            statistics.missedCycles = entry.missedCycles.load(std::memory_order_relaxed);
+            statistics.meanPeriod = entry.meanPeriod.load(std::memory_order_relaxed);
+            statistics.periodVariance = entry.squaredDeviations.load(std::memory_order_relaxed);
+            std::atomic_thread_fence(std::memory_order_acquire);
+        } while((sequence & 1u) != 0 || sequence != entry.sequence.load(std::memory_order_relaxed));
+
+        statistics.id = id;
+        statistics.periodVariance = statistics.periods > 1 ? statistics.periodVariance / static_cast<float64>(statistics.periods - 1) : 0.0;
+        return statistics.count != 0;
+    }
+
+    std::array<std::unique_ptr<Table>, XL_CONFIG_MAX_CHANNELS> channels{};
+};
+
+
+#endif //XLIDSTATS_H
+
+/**@} */ // END OF addtogroup xlidstats
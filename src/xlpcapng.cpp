@@ -0,0 +1,226 @@
+/**
+ * @file xlpcapng.cpp
+ * @author Maxime Verreault
+ * @date 2026-10-19
+ * @copyright COPYRIGHT(c) Maxime Verreault All rights reserved.
+ * @brief PCAP-NG writer with the SocketCAN link type, for Wireshark
+ * @ingroup xldriver
+ * @addtogroup xlpcapng
+ * @{
+ */
+
+
+/*==================================================================================================
+*                                        INCLUDE FILES
+* 1) system and project includes
+* 2) needed interfaces from external units
+* 3) internal and external interfaces from this unit
+==================================================================================================*/
+#include "xlpcapng.h"
+#include <algorithm>
+#include <bit>
+#include <chrono>
+#include <cstring>
+#include <fmt/format.h>
+
+
+/*==================================================================================================
+*                                       LOCAL FUNCTIONS
+==================================================================================================*/
+namespace
+{
+static_assert(std::endian::native == std::endian::little, "blocks are written in host order with a little endian magic");
+
+constexpr uint32 BlockSectionHeader = 0x0A0D0D0A;
+constexpr uint32 BlockInterfaceDescription = 0x00000001;
+constexpr uint32 BlockEnhancedPacket = 0x00000006;
+constexpr uint32 ByteOrderMagic = 0x1A2B3C4D;
+constexpr uint16 OptionEnd = 0;
+constexpr uint16 OptionInterfaceName = 2;
+constexpr uint16 OptionTimeStampResolution = 9;
+constexpr uint8 TimeStampNanoseconds = 9;
+
+/* struct can_frame / struct canfd_frame, can_id in network byte order for LINKTYPE_CAN_SOCKETCAN */
+constexpr uint32 SocketCanExtendedFlag = 0x80000000;
+constexpr uint32 SocketCanRemoteFlag = 0x40000000;
+constexpr uint32 SocketCanErrorFlag = 0x20000000;
+constexpr uint32 SocketCanErrorBus = 0x00000080;
+constexpr uint8 SocketCanFdBrs = 0x01;
+constexpr uint8 SocketCanFdEsi = 0x02;
+constexpr uint8 SocketCanFdFrame = 0x04;
+constexpr std::size_t SocketCanFrameSize = 16;
+constexpr std::size_t SocketCanFdFrameSize = 72;
+
+template<typename T>
+void put(std::vector<uint8>& buffer, T value)
+{
+    const auto offset = buffer.size();
+    buffer.resize(offset + sizeof(T));
+    std::memcpy(buffer.data() + offset, &value, sizeof(T));
+}
+
+void putPadded(std::vector<uint8>& buffer, const uint8* data, std::size_t length)
+{
+    buffer.insert(buffer.end(), data, data + length);
+    buffer.resize(buffer.size() + (4 - length % 4) % 4);
+}
+
+void putOption(std::vector<uint8>& buffer, uint16 code, const void* value, uint16 length)
+{
+    put<uint16>(buffer, code);
+    put<uint16>(buffer, length);
+    putPadded(buffer, static_cast<const uint8*>(value), length);
+}
+
+/** @brief Patch the total length at both ends of the block starting at offset */
+void closeBlock(std::vector<uint8>& buffer, std::size_t offset)
+{
+    const auto length = static_cast<uint32>(buffer.size() - offset + sizeof(uint32));
+    put<uint32>(buffer, length);
+    std::memcpy(buffer.data() + offset + sizeof(uint32), &length, sizeof(length));
+}
+
+std::size_t openBlock(std::vector<uint8>& buffer, uint32 type)
+{
+    const auto offset = buffer.size();
+    put<uint32>(buffer, type);
+    put<uint32>(buffer, 0);
+    return offset;
+}
+}
+
+
+/*==================================================================================================
+*                                       GLOBAL FUNCTIONS
+==================================================================================================*/
+PcapngWriter::PcapngWriter(const std::string& path): file(std::fopen(path.c_str(), "wb"))
+{
+    if(file == nullptr)
+    {
+        return;
+    }
+    buffer.reserve(PCAPNG_WRITE_BUFFER_SIZE + 128);
+    const auto block = openBlock(buffer, BlockSectionHeader);
+    put<uint32>(buffer, ByteOrderMagic);
+    put<uint16>(buffer, 1);
+    put<uint16>(buffer, 0);
+    put<sint64>(buffer, -1);    // section length not specified
+    closeBlock(buffer, block);
+}
+
+PcapngWriter::PcapngWriter(const std::string& path, sint64 timeStampOffset): PcapngWriter(path)
+{
+    epochOffset = timeStampOffset;
+}
+
+PcapngWriter::~PcapngWriter()
+{
+    close();
+}
+
+void PcapngWriter::write(const RecordEntry& entry)
+{
+    if(file == nullptr)
+    {
+        return;
+    }
+    const auto isFrame = entry.kind == RecordKind::Rx || entry.kind == RecordKind::TxOk;
+    const auto isError = entry.kind == RecordKind::RxError || entry.kind == RecordKind::TxError || entry.kind == RecordKind::ErrorFrame;
+    if(!isFrame && !isError)
+    {
+        return;
+    }
+    if(!epochOffset)
+    {
+        const auto now = std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::system_clock::now().time_since_epoch());
+        epochOffset = static_cast<sint64>(now.count()) - static_cast<sint64>(entry.timeStamp);
+    }
+    const auto interfaceId = interfaceOf(entry.channel);
+    const auto timeStamp = static_cast<uint64>(static_cast<sint64>(entry.timeStamp) + *epochOffset);
+
+    std::array<uint8, SocketCanFdFrameSize> frame{};
+    std::size_t frameSize = SocketCanFrameSize;
+    uint32 canId = 0;
+    if(isError)
+    {
+        canId = SocketCanErrorFlag | SocketCanErrorBus;
+        frame[4] = 8;
+    }
+    else
+    {
+        const auto extended = (entry.canId & XL_CAN_EXT_MSG_ID) != 0;
+        canId = extended ? ((entry.canId & ~XL_CAN_EXT_MSG_ID) | SocketCanExtendedFlag) : entry.canId;
+        canId |= (entry.msgFlags & XL_CAN_RXMSG_FLAG_RTR) ? SocketCanRemoteFlag : 0;
+        frame[4] = entry.length;
+        if(entry.msgFlags & XL_CAN_RXMSG_FLAG_EDL)
+        {
+            frameSize = SocketCanFdFrameSize;
+            frame[5] = SocketCanFdFrame;
+            frame[5] |= (entry.msgFlags & XL_CAN_RXMSG_FLAG_BRS) ? SocketCanFdBrs : 0;
+            frame[5] |= (entry.msgFlags & XL_CAN_RXMSG_FLAG_ESI) ? SocketCanFdEsi : 0;
+        }
+        else if(entry.dlc > 8)
+        {
+            frame[7] = entry.dlc;   // len8_dlc
+        }
+        std::memcpy(frame.data() + 8, entry.data, std::min<std::size_t>(entry.length, frameSize - 8));
+    }
+    for(std::size_t i = 0; i < sizeof(canId); ++i)
+    {
+        frame[i] = static_cast<uint8>(canId >> (8 * (sizeof(canId) - 1 - i)));
+    }
+
+    const auto block = openBlock(buffer, BlockEnhancedPacket);
+    put<uint32>(buffer, interfaceId);
+    put<uint32>(buffer, static_cast<uint32>(timeStamp >> 32));
+    put<uint32>(buffer, static_cast<uint32>(timeStamp));
+    put<uint32>(buffer, static_cast<uint32>(frameSize));
+    put<uint32>(buffer, static_cast<uint32>(frameSize));
+    putPadded(buffer, frame.data(), frameSize);
+    closeBlock(buffer, block);
+
+    if(buffer.size() >= PCAPNG_WRITE_BUFFER_SIZE)
+    {
+        flushBuffer();
+    }
+}
+
+void PcapngWriter::close()
+{
+    if(file == nullptr)
+    {
+        return;
+    }
+    flushBuffer();
+    std::fclose(file);
+    file = nullptr;
+}
+
+uint32 PcapngWriter::interfaceOf(uint16 channel)
+{
+    auto& interfaceId = interfaceIds[channel % interfaceIds.size()];
+    if(interfaceId)
+    {
+        return *interfaceId;
+    }
+    interfaceId = interfaceCount++;
+
+    const auto name = fmt::format("xlcan{}", channel + 1u);
+    const auto block = openBlock(buffer, BlockInterfaceDescription);
+    put<uint16>(buffer, PCAPNG_LINKTYPE_CAN_SOCKETCAN);
+    put<uint16>(buffer, 0);
+    put<uint32>(buffer, static_cast<uint32>(SocketCanFdFrameSize));
+    putOption(buffer, OptionInterfaceName, name.data(), static_cast<uint16>(name.size()));
+    putOption(buffer, OptionTimeStampResolution, &TimeStampNanoseconds, sizeof(TimeStampNanoseconds));
+    putOption(buffer, OptionEnd, nullptr, 0);
+    closeBlock(buffer, block);
+    return *interfaceId;
+}
+
+void PcapngWriter::flushBuffer()
+{
+    written += std::fwrite(buffer.data(), 1, buffer.size(), file);
+    buffer.clear();
+}
+
+/**@} */ // END OF addtogroup xlpcapng
@@ -0,0 +1,76 @@
+/**
+ * @file xlpcapng.h
+ * @author Maxime Verreault
+ * @date 2026-10-19
+ * @copyright COPYRIGHT(c) Maxime Verreault All rights reserved.
+ * @brief PCAP-NG writer with the SocketCAN link type, for Wireshark
+ * @ingroup xldriver
+ * @addtogroup xlpcapng
+ * @{
+ */
+
+
+#ifndef XLPCAPNG_H
+#define XLPCAPNG_H
+
+/*==================================================================================================
+*                                         INCLUDE FILES
+* 1) system and project includes
+* 2) needed interfaces from external units
+* 3) internal and external interfaces from this unit
+==================================================================================================*/
+#include <array>
+#include <cstdio>
+#include <optional>
+#include <string>
+#include <vector>
+#include "xlexport.h"
+
+
+/*==================================================================================================
+*                                       DEFINES AND MACROS
+==================================================================================================*/
+#define PCAPNG_LINKTYPE_CAN_SOCKETCAN   227u
+#define PCAPNG_WRITE_BUFFER_SIZE        (256u * 1024u)  // blocks kept in memory before one fwrite
+
+
+/*==================================================================================================
+*                                STRUCTURES AND OTHER TYPEDEFS
+==================================================================================================*/
+/**
+ * @brief Writes frames and error frames as a PCAP-NG capture of SocketCAN frames
+ * @details Each XL channel gets its own interface description block, written before its first
+ *          packet, with nanosecond timestamp resolution. Packet timestamps are the driver timestamps
+ *          (timeStampSync for CAN FD channels) shifted to the wall clock time of the first event.
+ */
+class PcapngWriter : public LogWriter
+{
+public:
+    explicit PcapngWriter(const std::string& path);
+
+    /** @brief Packet timestamps shifted by a fixed offset (ns) rather than the wall clock, for a reproducible capture */
+    PcapngWriter(const std::string& path, sint64 timeStampOffset);
+    PcapngWriter(const PcapngWriter&) = delete;
+    PcapngWriter& operator=(const PcapngWriter&) = delete;
+    ~PcapngWriter() override;
+
+    [[nodiscard]] bool isOpen() const { return file != nullptr; }
+    void write(const RecordEntry& entry) override;
+    void close() override;
+    [[nodiscard]] uint64 bytesWritten() const override { return written + buffer.size(); }
+
+private:
+    std::FILE* file{nullptr};
+    std::vector<uint8> buffer{};
+    std::array<std::optional<uint32>, XL_CONFIG_MAX_CHANNELS> interfaceIds{};
+    uint32 interfaceCount{0};
+    std::optional<sint64> epochOffset{};
+    uint64 written{0};
+
+    uint32 interfaceOf(uint16 channel);
+    void flushBuffer();
+};
+
+#endif //XLPCAPNG_H
+
+/**@} */ // END OF addtogroup xlpcapng
@@ -0,0 +1,503 @@
+/**
+ * @file xlrecorder.cpp
+ * @author Maxime Verreault
+ * @date 2026-10-19
+ * @copyright COPYRIGHT(c) Maxime Verreault All rights reserved.
+ * @brief Capture-to-disk recorder writing the driver events into memory-mapped segment files
+ * @ingroup xldriver
+ * @addtogroup xlrecorder
+ * @{
+ */
+
+
+/*==================================================================================================
+*                                        INCLUDE FILES
+* 1) system and project includes
+* 2) needed interfaces from external units
+* 3) internal and external interfaces from this unit
+==================================================================================================*/
+#include "xlrecorder.h"
+#include <algorithm>
+#include <chrono>
+#include <cstddef>
+#include <cstring>
+#include <filesystem>
+#include <utility>
+#include <fmt/format.h>
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <unistd.h>
+#endif
+
+
+/*==================================================================================================
+*                                       LOCAL FUNCTIONS
+==================================================================================================*/
+namespace
+{
+uint64 wallClockNs()
+{
+    return static_cast<uint64>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+            std::chrono::system_clock::now().time_since_epoch()).count());
+}
+
+void copyPayload(RecordEntry& entry, const unsigned char* data, uint8 length)
+{
+    entry.length = std::min<uint8>(length, RECORD_MAX_DATA_LEN);
+    std::memcpy(entry.data, data, entry.length);
+}
+}
+
+
+/*==================================================================================================
+*                                       GLOBAL FUNCTIONS
+==================================================================================================*/
+MappedFile::~MappedFile()
+{
+    close();
+}
+
+#ifdef _WIN32
+bool MappedFile::create(const std::string& path, uint64 size)
+{
+    close();
+    fileHandle = CreateFileA(path.c_str(), GENERIC_READ | GENERIC_WRITE, FILE_SHARE_READ, nullptr,
+                             CREATE_ALWAYS, FILE_ATTRIBUTE_NORMAL, nullptr);
+    if(fileHandle == INVALID_HANDLE_VALUE)
+    {
+        fileHandle = nullptr;
+        return false;
+    }
+    /* the mapping extends the file to its final size, no separate pre-allocation needed */
+    mappingHandle = CreateFileMappingA(fileHandle, nullptr, PAGE_READWRITE,
+                                       static_cast<DWORD>(size >> 32), static_cast<DWORD>(size & 0xFFFFFFFF), nullptr);
+    if(mappingHandle != nullptr)
+    {
+        view = static_cast<uint8*>(MapViewOfFile(mappingHandle, FILE_MAP_WRITE, 0, 0, size));
+    }
+    if(view == nullptr)
+    {
+        close();
+        return false;
+    }
+    mappedSize = size;
+    return true;
+}
+
+void MappedFile::flush(bool synchronous) const
+{
+    if(view != nullptr)
+    {
+        FlushViewOfFile(view, mappedSize);
+        if(synchronous)
+        {
+            FlushFileBuffers(fileHandle);
+        }
+    }
+}
+
+void MappedFile::close()
+{
+    if(view != nullptr)
+    {
+        UnmapViewOfFile(view);
+        view = nullptr;
+    }
+    if(mappingHandle != nullptr)
+    {
+        CloseHandle(mappingHandle);
+        mappingHandle = nullptr;
+    }
+    if(fileHandle != nullptr)
+    {
+        CloseHandle(fileHandle);
+        fileHandle = nullptr;
+    }
+    mappedSize = 0;
+}
+#else
+bool MappedFile::create(const std::string& path, uint64 size)
+{
+    close();
+    fd = ::open(path.c_str(), O_RDWR | O_CREAT | O_TRUNC, 0644);
+    if(fd < 0)
+    {
+        return false;
+    }
+    if(::ftruncate(fd, static_cast<off_t>(size)) == 0)
+    {
+        void* mapped = ::mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+        if(mapped != MAP_FAILED)
+        {
+            view = static_cast<uint8*>(mapped);
+        }
+    }
+    if(view == nullptr)
+    {
+        close();
+        return false;
+    }
+    mappedSize = size;
+    return true;
+}
+
+void MappedFile::flush(bool synchronous) const
+{
+    if(view != nullptr)
+    {
+        ::msync(view, mappedSize, synchronous ? MS_SYNC : MS_ASYNC);
+    }
+}
+
+void MappedFile::close()
+{
+    if(view != nullptr)
+    {
+        ::munmap(view, mappedSize);
+        view = nullptr;
+    }
+    if(fd >= 0)
+    {
+        ::close(fd);
+        fd = -1;
+    }
+    mappedSize = 0;
+}
+#endif
+
+Recorder::~Recorder()
+{
+    close();
+}
+
+std::string Recorder::segmentPath(const std::string& basePath, uint64 index)
+{
+    return fmt::format("{}_{:06}{}", basePath, index, RECORD_FILE_EXTENSION);
+}
+
+bool Recorder::open(const Settings& recorderSettings)
+{
+    close();
+    settings = recorderSettings;
+    if(settings.segmentBytes < RECORD_HEADER_SIZE + sizeof(RecordEntry))
+    {
+        return false;
+    }
+    capacity = (settings.segmentBytes - RECORD_HEADER_SIZE) / sizeof(RecordEntry);
+    writeIndex = 0;
+    segmentsOnDisk.clear();
+
+    current = createSegment(0);
+    if(!current)
+    {
+        return false;
+    }
+    launchSpare(nullptr, 1);
+    return true;
+}
+
+void Recorder::close()
+{
+    if(!current)
+    {
+        return;
+    }
+    auto unused = spare.get();
+    if(unused)
+    {
+        /* the spare never received a record, do not leave an empty segment behind */
+        const auto path = unused->path;
+        unused.reset();
+        std::error_code ec;
+        std::filesystem::remove(path, ec);
+    }
+    retire(std::move(current), writeIndex);
+}
+
+bool Recorder::record(const XLcanRxEvent& event)
+{
+    RecordEntry entry;
+    return toRecord(event, entry) && record(entry);
+}
+
+bool Recorder::record(const XLevent& event)
+{
+    RecordEntry entry;
+    return toRecord(event, entry) && record(entry);
+}
+
+bool Recorder::record(const RecordEntry& entry)
+{
+    if(!current || (writeIndex == capacity && !rotate()))
+    {
+        droppedCount.fetch_add(1, std::memory_order_relaxed);
+        return false;
+    }
+
+    RecordEntry& slot = current->records[writeIndex];
+    std::memcpy(&slot, &entry, offsetof(RecordEntry, kind));
+    std::memcpy(&slot.dlc, &entry.dlc, sizeof(RecordEntry) - offsetof(RecordEntry, dlc));
+    std::atomic_ref<RecordKind>(slot.kind).store(entry.kind, std::memory_order_release);
+
+    ++writeIndex;
+    if(writeIndex % RECORD_COMMIT_INTERVAL == 0)
+    {
+        std::atomic_ref<uint64>(current->header->committed).store(writeIndex, std::memory_order_release);
+    }
+    recordCount.fetch_add(1, std::memory_order_relaxed);
+    return true;
+}
+
+Recorder::Statistics Recorder::statistics() const
+{
+    return {
+        recordCount.load(std::memory_order_relaxed),
+        droppedCount.load(std::memory_order_relaxed),
+        segmentCount.load(std::memory_order_relaxed),
+        deletedCount.load(std::memory_order_relaxed)
+    };
+}
+
+std::unique_ptr<RecordSegment> Recorder::createSegment(uint64 index)
+{
+    /* keep room for the segment being written and the one prepared ahead */
+    const auto maxSegments = std::max<uint64>(2, settings.diskBudgetBytes / settings.segmentBytes);
+    while(segmentsOnDisk.size() + 1 > maxSegments)
+    {
+        std::error_code ec;
+        std::filesystem::remove(segmentsOnDisk.front(), ec);
+        segmentsOnDisk.pop_front();
+        deletedCount.fetch_add(1, std::memory_order_relaxed);
+    }
+
+    auto segment = std::make_unique<RecordSegment>();
+    segment->path = segmentPath(settings.basePath, index);
+    if(!segment->file.create(segment->path, RECORD_HEADER_SIZE + capacity * sizeof(RecordEntry)))
+    {
+        return nullptr;
+    }
+    segment->header = reinterpret_cast<RecordSegmentHeader*>(segment->file.data());
+    segment->records = reinterpret_cast<RecordEntry*>(segment->file.data() + RECORD_HEADER_SIZE);
+
+    std::memcpy(segment->header->magic, RECORD_FILE_MAGIC, sizeof(segment->header->magic));
+    segment->header->version = RECORD_FILE_VERSION;
+    segment->header->recordSize = sizeof(RecordEntry);
+    segment->header->segmentIndex = index;
+    segment->header->capacity = capacity;
+    segment->header->committed = 0;
+    segment->header->createdAt = wallClockNs();
+    segment->header->state = RecordSegmentState::Open;
+    segment->file.flush(false);
+
+    segmentsOnDisk.push_back(segment->path);
+    segmentCount.fetch_add(1, std::memory_order_relaxed);
+    return segment;
+}
+
+void Recorder::launchSpare(std::unique_ptr<RecordSegment> retired, uint64 index)
+{
+    const auto retiredCommitted = capacity;
+    spare = std::async(std::launch::async, [this, index, retiredCommitted](std::unique_ptr<RecordSegment> previous) {
+        if(previous)
+        {
+            retire(std::move(previous), retiredCommitted);
+        }
+        return createSegment(index);
+    }, std::move(retired));
+}
+
+bool Recorder::rotate()
+{
+    auto next = spare.get();
+    if(!next)
+    {
+        /* retry creating the segment next time, the current one stays full until then */
+        launchSpare(nullptr, current->header->segmentIndex + 1);
+        return false;
+    }
+    const auto nextIndex = next->header->segmentIndex + 1;
+    launchSpare(std::exchange(current, std::move(next)), nextIndex);
+    writeIndex = 0;
+    return true;
+}
+
+void Recorder::retire(std::unique_ptr<RecordSegment> segment, uint64 committed)
+{
+    std::atomic_ref<uint64>(segment->header->committed).store(committed, std::memory_order_release);
+    segment->header->state = RecordSegmentState::Closed;
+    segment->file.flush(true);
+    segment->file.close();
+}
+
+bool Recorder::toRecord(const XLcanRxEvent& event, RecordEntry& entry)
+{
+    entry = RecordEntry{};
+    entry.timeStamp = event.timeStampSync;
+    entry.channel = event.channelIndex;
+    entry.flagsChip = event.flagsChip;
+    switch(event.tag)
+    {
+        case XL_CAN_EV_TAG_RX_OK:
+        case XL_CAN_EV_TAG_TX_OK:
+            entry.kind = event.tag == XL_CAN_EV_TAG_RX_OK ? RecordKind::Rx : RecordKind::TxOk;
+            entry.canId = event.tagData.canRxOkMsg.canId;
+            entry.msgFlags = event.tagData.canRxOkMsg.msgFlags;
+            entry.dlc = event.tagData.canRxOkMsg.dlc;
+            copyPayload(entry, event.tagData.canRxOkMsg.data,
+                        CANFD_GET_NUM_DATABYTES(entry.dlc, entry.msgFlags & XL_CAN_RXMSG_FLAG_EDL, entry.msgFlags & XL_CAN_RXMSG_FLAG_RTR));
+            return true;
+        case XL_CAN_EV_TAG_TX_REQUEST:
+            entry.kind = RecordKind::TxRequest;
+            entry.canId = event.tagData.canTxRequest.canId;
+            entry.msgFlags = event.tagData.canTxRequest.msgFlags;
+            entry.dlc = event.tagData.canTxRequest.dlc;
+            copyPayload(entry, event.tagData.canTxRequest.data,
+                        CANFD_GET_NUM_DATABYTES(entry.dlc, entry.msgFlags & XL_CAN_RXMSG_FLAG_EDL, entry.msgFlags & XL_CAN_RXMSG_FLAG_RTR));
+            return true;
+        case XL_CAN_EV_TAG_RX_ERROR:
+        case XL_CAN_EV_TAG_TX_ERROR:
+            entry.kind = event.tag == XL_CAN_EV_TAG_RX_ERROR ? RecordKind::RxError : RecordKind::TxError;
+            entry.errorCode = event.tagData.canError.errorCode;
+            return true;
+        case XL_CAN_EV_TAG_CHIP_STATE:
+            entry.kind = RecordKind::ChipState;
+            entry.data[0] = event.tagData.canChipState.busStatus;
+            entry.data[1] = event.tagData.canChipState.txErrorCounter;
+            entry.data[2] = event.tagData.canChipState.rxErrorCounter;
+            entry.length = 3;
+            return true;
+        default:
+            return false;
+    }
+}
+
+bool Recorder::toRecord(const XLevent& event, RecordEntry& entry)
+{
+    entry = RecordEntry{};
+    entry.timeStamp = event.timeStamp;
+    entry.channel = event.chanIndex;
+    entry.flagsChip = (event.flags & XL_EVENT_FLAG_OVERRUN) ? XL_CAN_QUEUE_OVERFLOW : 0;
+    switch(event.tag)
+    {
+        case XL_RECEIVE_MSG:
+        {
+            const auto flags = event.tagData.msg.flags;
+            entry.canId = event.tagData.msg.id;
+            entry.dlc = static_cast<uint8>(event.tagData.msg.dlc);
+            if(flags & XL_CAN_MSG_FLAG_ERROR_FRAME)
+            {
+                entry.kind = RecordKind::ErrorFrame;
+                return true;
+            }
+            if(flags & XL_CAN_MSG_FLAG_TX_COMPLETED)
+            {
+                entry.kind = RecordKind::TxOk;
+            }
+            else if(flags & XL_CAN_MSG_FLAG_TX_REQUEST)
+            {
+                entry.kind = RecordKind::TxRequest;
+            }
+            else
+            {
+                entry.kind = RecordKind::Rx;
+            }
+            if(flags & XL_CAN_MSG_FLAG_REMOTE_FRAME)
+            {
+                entry.msgFlags = XL_CAN_RXMSG_FLAG_RTR;
+            }
+            else
+            {
+                copyPayload(entry, event.tagData.msg.data, std::min<uint8>(entry.dlc, MAX_MSG_LEN));
+            }
+            return true;
+        }
+        case XL_CHIP_STATE:
+            entry.kind = RecordKind::ChipState;
+            entry.data[0] = event.tagData.chipState.busStatus;
+            entry.data[1] = event.tagData.chipState.txErrorCounter;
+            entry.data[2] = event.tagData.chipState.rxErrorCounter;
+            entry.length = 3;
+            return true;
+        default:
+            return false;
+    }
+}
+
+bool RecordReader::open(const std::string& basePath)
+{
+    namespace fs = std::filesystem;
+    segmentPaths.clear();
+    nextSegment = 0;
+    remaining = 0;
+    recovered = 0;
+    stream.close();
+
+    const fs::path base(basePath);
+    const auto directory = base.has_parent_path() ? base.parent_path() : fs::path(".");
+    const auto prefix = base.filename().string() + "_";
+    std::error_code ec;
+    for(const auto& file : fs::directory_iterator(directory, ec))
+    {
+        const auto name = file.path().filename().string();
+        if(file.path().extension() == RECORD_FILE_EXTENSION && name.starts_with(prefix))
+        {
+            segmentPaths.push_back(file.path().string());
+        }
+    }
+    /* zero padded indexes sort in recording order */
+    std::ranges::sort(segmentPaths);
+    return !segmentPaths.empty();
+}
+
+bool RecordReader::next(RecordEntry& entry)
+{
+    while(true)
+    {
+        if(remaining > 0 && stream.read(reinterpret_cast<char*>(&entry), sizeof(entry)))
+        {
+            --remaining;
+            if(entry.kind != RecordKind::None)
+            {
+                return true;
+            }
+            /* first slot never written: end of a segment left open by a crash */
+            remaining = 0;
+        }
+        if(!openNextSegment())
+        {
+            return false;
+        }
+    }
+}
+
+bool RecordReader::openNextSegment()
+{
+    while(nextSegment < segmentPaths.size())
+    {
+        stream.close();
+        stream.clear();
+        stream.open(segmentPaths[nextSegment++], std::ios::binary);
+
+        RecordSegmentHeader header{};
+        if(!stream.read(reinterpret_cast<char*>(&header), sizeof(header)) ||
+           std::memcmp(header.magic, RECORD_FILE_MAGIC, sizeof(header.magic)) != 0 ||
+           header.version != RECORD_FILE_VERSION || header.recordSize != sizeof(RecordEntry))
+        {
+            continue;
+        }
+        stream.seekg(RECORD_HEADER_SIZE);
+        const auto scanning = header.state != RecordSegmentState::Closed;
+        remaining = scanning ? header.capacity : header.committed;
+        if(scanning)
+        {
+            ++recovered;
+        }
+        return true;
+    }
+    return false;
+}
+
+/**@} */ // END OF addtogroup xlrecorder
@@ -0,0 +1,232 @@
+/**
+ * @file xlrecorder.h
+ * @author Maxime Verreault
+ * @date 2026-10-19
+ * @copyright COPYRIGHT(c) Maxime Verreault All rights reserved.
+ * @brief Capture-to-disk recorder writing the driver events into memory-mapped segment files
+ * @ingroup xldriver
+ * @addtogroup xlrecorder
+ * @{
+ */
+
+
+#ifndef XLRECORDER_H
+#define XLRECORDER_H
+
+/*==================================================================================================
+*                                         INCLUDE FILES
+* 1) system and project includes
+* 2) needed interfaces from external units
+* 3) internal and external interfaces from this unit
+==================================================================================================*/
+#include "vxlapi.h"
+#include <atomic>
+#include <deque>
+#include <fstream>
+#include <future>
+#include <memory>
+#include <string>
+#include <vector>
+#include <Platform_Types.h>
+
+
+/*==================================================================================================
+*                                       DEFINES AND MACROS
+==================================================================================================*/
+#define RECORD_FILE_MAGIC           "XLREC\r\n"     // 8 bytes including the terminating zero
+#define RECORD_FILE_VERSION         1u
+#define RECORD_FILE_EXTENSION       ".xlrec"
+#define RECORD_HEADER_SIZE          4096u           // one page, records start page aligned
+#define RECORD_COMMIT_INTERVAL      1024u           // records between two updates of the header commit count
+#define RECORD_MAX_DATA_LEN         64u
+
+
+/*==================================================================================================
+*                                             ENUMS
+==================================================================================================*/
+/**
+ * @brief Kind of a recorded event, zero marks a slot that was never written
+ */
+enum class RecordKind : uint8
+{
+    None = 0,
+    Rx,             //!< frame received from the bus
+    TxOk,           //!< own frame transmitted successfully
+    TxRequest,      //!< own frame handed to the controller
+    RxError,        //!< error detected while receiving (errorCode is valid)
+    TxError,        //!< error detected while transmitting (errorCode is valid)
+    ErrorFrame,     //!< error frame seen on a classic CAN channel
+    ChipState       //!< bus status, data holds busStatus, txErrorCounter, rxErrorCounter
+};
+
+/**
+ * @brief Lifecycle of a segment file as stored in its header
+ */
+enum class RecordSegmentState : uint32
+{
+    Open = 1,       //!< being written, or the writer crashed: scan past the commit count
+    Closed = 2      //!< complete, the commit count is exact
+};
+
+
+/*==================================================================================================
+*                                STRUCTURES AND OTHER TYPEDEFS
+==================================================================================================*/
+/**
+ * @brief Fixed-size record of one driver event, as stored on disk
+ * @details The kind is written last so a reader never sees a partially filled record as valid.
+ */
+struct RecordEntry
+{
+    XLuint64 timeStamp;             //!< driver timestamp in nanoseconds
+    uint32 canId;                   //!< identifier including XL_CAN_EXT_MSG_ID for extended frames
+    uint32 msgFlags;                //!< XL_CAN_RXMSG_FLAG_*, also for events of a classic port
+    uint16 channel;                 //!< driver channel index
+    RecordKind kind;
+    uint8 dlc;
+    uint8 length;                   //!< number of valid bytes in data
+    uint8 errorCode;                //!< XL_CAN_ERRC_* for RxError and TxError
+    uint16 flagsChip;               //!< XLcanRxEvent::flagsChip, carries XL_CAN_QUEUE_OVERFLOW
+    uint8 data[RECORD_MAX_DATA_LEN];
+};
+static_assert(sizeof(RecordEntry) == 88, "record layout is part of the file format");
+
+/**
+ * @brief Header at the start of every segment file
+ */
+struct RecordSegmentHeader
+{
+    char magic[8];
+    uint32 version;
+    uint32 recordSize;
+    uint64 segmentIndex;
+    uint64 capacity;                //!< number of record slots in the file
+    uint64 committed;               //!< records known to be complete
+    uint64 createdAt;               //!< wall clock at creation, nanoseconds since epoch
+    RecordSegmentState state;
+    uint32 reserved;
+};
+
+/**
+ * @brief Pre-sized file mapped in memory
+ */
+class MappedFile
+{
+public:
+    MappedFile() = default;
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+    ~MappedFile();
+
+    bool create(const std::string& path, uint64 size);
+    void flush(bool synchronous) const;
+    void close();
+    [[nodiscard]] uint8* data() const { return view; }
+
+private:
+    uint8* view{nullptr};
+    uint64 mappedSize{0};
+#ifdef _WIN32
+    void* fileHandle{nullptr};
+    void* mappingHandle{nullptr};
+#else
+    int fd{-1};
+#endif
+};
+
+/**
+ * @brief One mapped segment of a recording
+ */
+struct RecordSegment
+{
+    MappedFile file;
+    std::string path;
+    RecordSegmentHeader* header{nullptr};
+    RecordEntry* records{nullptr};
+};
+
+/**
+ * @brief Writes driver events into a rotating set of memory-mapped segment files
+ * @details Files are named <basePath>_<index>.xlrec and pre-sized at creation. While a segment is
+ *          being filled the next one is created, and the previous one unmapped, by a background
+ *          task so the consumer thread only copies records. Once the disk budget is reached the
+ *          oldest segments are deleted. record() must always be called from the same thread.
+ */
+class Recorder
+{
+public:
+    struct Settings
+    {
+        std::string basePath;
+        uint64 segmentBytes{64ull * 1024 * 1024};
+        uint64 diskBudgetBytes{1024ull * 1024 * 1024};
+    };
+
+    struct Statistics
+    {
+        uint64 records;
+        uint64 dropped;
+        uint64 segments;
+        uint64 deletedSegments;
+    };
+
+    Recorder() = default;
+    Recorder(const Recorder&) = delete;
+    Recorder& operator=(const Recorder&) = delete;
+    ~Recorder();
+
+    bool open(const Settings& recorderSettings);
+    void close();
+    [[nodiscard]] bool isOpen() const { return current != nullptr; }
+
+    bool record(const XLcanRxEvent& event);
+    bool record(const XLevent& event);
+    bool record(const RecordEntry& entry);
+
+    [[nodiscard]] Statistics statistics() const;
+
+    static std::string segmentPath(const std::string& basePath, uint64 index);
+    static bool toRecord(const XLcanRxEvent& event, RecordEntry& entry);
+    static bool toRecord(const XLevent& event, RecordEntry& entry);
+
+private:
+    Settings settings{};
+    uint64 capacity{0};
+    uint64 writeIndex{0};
+    std::unique_ptr<RecordSegment> current{};
+    std::future<std::unique_ptr<RecordSegment>> spare{};
+    std::deque<std::string> segmentsOnDisk{};         //!< only touched by the serialized prepare tasks
+    std::atomic<uint64> recordCount{0};
+    std::atomic<uint64> droppedCount{0};
+    std::atomic<uint64> segmentCount{0};
+    std::atomic<uint64> deletedCount{0};
+
+    std::unique_ptr<RecordSegment> createSegment(uint64 index);
+    void launchSpare(std::unique_ptr<RecordSegment> retired, uint64 index);
+    bool rotate();
+    static void retire(std::unique_ptr<RecordSegment> segment, uint64 committed);
+};
+
+/**
+ * @brief Reads back a recording segment by segment, recovering segments left open by a crash
+ */
+class RecordReader
+{
+public:
+    bool open(const std::string& basePath);
+    bool next(RecordEntry& entry);
+    [[nodiscard]] uint64 recoveredSegments() const { return recovered; }
+
+private:
+    std::vector<std::string> segmentPaths{};
+    std::size_t nextSegment{0};
+    std::ifstream stream{};
+    uint64 remaining{0};
+    uint64 recovered{0};
+
+    bool openNextSegment();
+};
+
+#endif //XLRECORDER_H
+
+/**@} */ // END OF addtogroup xlrecorder
@@ -0,0 +1,101 @@
+/**
+ * @file xlreplay.cpp
+ * @author Maxime Verreault
+ * @date 2026-10-19
+ * @copyright COPYRIGHT(c) Maxime Verreault All rights reserved.
+ * @brief Replay of recorded traffic into CanIf or onto the bus
+ * @ingroup xldriver
+ * @addtogroup xlreplay
+ * @{
+ */
+
+
+/*==================================================================================================
+*                                        INCLUDE FILES
+* 1) system and project includes
+* 2) needed interfaces from external units
+* 3) internal and external interfaces from this unit
+==================================================================================================*/
+#include "xlreplay.h"
+#include <algorithm>
+#include <bit>
+#include <thread>
+#include "xldriver.h"
+
+
+/*==================================================================================================
+*                                       GLOBAL FUNCTIONS
+==================================================================================================*/
+ReplayReport Replayer::run(const ReplaySource& source, const ReplaySink& sink, const std::atomic<bool>& keepRunning) const
+{
+    using Clock = std::chrono::steady_clock;
+    ReplayReport report;
+    RecordEntry entry;
+    bool first = true;
+    XLuint64 firstTimeStamp = 0;
+    const auto start = Clock::now();
+
+    while(keepRunning.load(std::memory_order_relaxed) && source(entry))
+    {
+        if(!isReplayed(entry))
+        {
+            ++report.skipped;
+            continue;
+        }
+        if(first)
+        {
+            firstTimeStamp = entry.timeStamp;
+            first = false;
+        }
+
+        if(settings.timing == ReplayTiming::Original)
+        {
+            const auto offset = static_cast<double>(entry.timeStamp - std::min(entry.timeStamp, firstTimeStamp)) / settings.speed;
+            const auto deadline = start + std::chrono::nanoseconds(static_cast<sint64>(offset));
+            waitUntil(deadline);
+            const auto error = std::chrono::duration_cast<std::chrono::nanoseconds>(Clock::now() - deadline);
+            const auto errorUs = static_cast<uint64>(error.count()) / 1000;
+            const auto bucket = std::min<std::size_t>(std::bit_width(errorUs), REPLAY_HISTOGRAM_BUCKETS - 1);
+            ++report.errorHistogram[bucket];
+            report.maxError = std::max(report.maxError, error);
+            report.totalError += error;
+        }
+
+        ++report.frames;
+        if(!sink(entry))
+        {
+            ++report.failed;
+        }
+    }
+    report.duration = std::chrono::duration_cast<std::chrono::nanoseconds>(Clock::now() - start);
+    return report;
+}
+
+bool Replayer::indicateToCanIf(const RecordEntry& entry)
+{
+    if(!(entry.msgFlags & (XL_CAN_RXMSG_FLAG_RTR | XL_CAN_RXMSG_FLAG_EF)))
+    {
+        canRxIndication(entry.channel, entry.canId, entry.data, entry.length);
+    }
+    return true;
+}
+
+bool Replayer::isReplayed(const RecordEntry& entry) const
+{
+    return entry.kind == RecordKind::Rx || (settings.includeTx && entry.kind == RecordKind::TxOk);
+}
+
+void Replayer::waitUntil(std::chrono::steady_clock::time_point deadline) const
+{
+    auto remaining = deadline - std::chrono::steady_clock::now();
+    if(remaining > settings.spinThreshold)
+    {
+        std::this_thread::sleep_for(remaining - settings.spinThreshold);
+    }
+    while(std::chrono::steady_clock::now() < deadline)
+    {
+        /* spin: the OS sleep granularity is far above the accuracy we need */
+    }
+}
+
+/**@} */ // END OF addtogroup xlreplay
@@ -0,0 +1,113 @@
+/**
+ * @file xlreplay.h
+ * @author Maxime Verreault
+ * @date 2026-10-19
+ * @copyright COPYRIGHT(c) Maxime Verreault All rights reserved.
+ * @brief Replay of recorded traffic into CanIf or onto the bus
+ * @ingroup xldriver
+ * @addtogroup xlreplay
+ * @{
+ */
+
+
+#ifndef XLREPLAY_H
+#define XLREPLAY_H
+
+/*==================================================================================================
+*                                         INCLUDE FILES
+* 1) system and project includes
+* 2) needed interfaces from external units
+* 3) internal and external interfaces from this unit
+==================================================================================================*/
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <functional>
+#include <Can_GeneralTypes.h>
+#include "xlrecorder.h"
+
+
+/*==================================================================================================
+*                                       DEFINES AND MACROS
+==================================================================================================*/
+#define REPLAY_SPIN_THRESHOLD_US    2000    // sleep until this close to the deadline, spin the rest (OS timer granularity)
+#define REPLAY_HISTOGRAM_BUCKETS    20      // bucket 0 below 1 us, bucket i in [2^(i-1), 2^i) us, last bucket open ended
+#define REPLAY_QUEUE_FULL_MS        1000    // longest wait for room in the transmit queue, then the replayed frame fails
+
+
+/*==================================================================================================
+*                                             ENUMS
+==================================================================================================*/
+/**
+ * @brief Pacing of the replayed frames
+ */
+enum class ReplayTiming : uint8
+{
+    Original,           //!< keep the recorded inter-frame times, divided by the speed factor
+    AsFastAsPossible    //!< no pacing, measures the achievable frame rate
+};
+
+
+/*==================================================================================================
+*                                STRUCTURES AND OTHER TYPEDEFS
+==================================================================================================*/
+struct ReplaySettings
+{
+    ReplayTiming timing{ReplayTiming::Original};
+    double speed{1.0};                  //!< 2.0 replays twice as fast as recorded
+    bool includeTx{false};              //!< replay the frames the recording node sent itself
+    std::chrono::nanoseconds spinThreshold{std::chrono::microseconds(REPLAY_SPIN_THRESHOLD_US)};
+};
+
+struct ReplayReport
+{
+    uint64 frames{0};                   //!< frames handed to the sink
+    uint64 failed{0};                   //!< frames the sink rejected
+    uint64 skipped{0};                  //!< records that are not replayable frames
+    std::chrono::nanoseconds duration{0};
+    std::chrono::nanoseconds maxError{0};
+    std::chrono::nanoseconds totalError{0};
+    std::array<uint64, REPLAY_HISTOGRAM_BUCKETS> errorHistogram{};     //!< lateness against the scheduled time
+
+    [[nodiscard]] double framesPerSecond() const
+    {
+        return duration.count() > 0 ? static_cast<double>(frames) * 1e9 / static_cast<double>(duration.count()) : 0.0;
+    }
+};
+
+using ReplaySource = std::function<bool(RecordEntry&)>;
+using ReplaySink = std::function<bool(const RecordEntry&)>;
+
+/**
+ * @brief Feeds records from a source to a sink with the recorded timing
+ * @details Each frame is scheduled at its recorded offset from the first frame, scaled by the speed
+ *          factor. The replayer sleeps until the spin threshold before the deadline and busy-waits
+ *          the remainder, which keeps the lateness well below 100 us where a sleep alone would be
+ *          off by a full OS timer period.
+ */
+class Replayer
+{
+public:
+    explicit Replayer(const ReplaySettings& replaySettings): settings(replaySettings)
+    {
+    }
+
+    ReplayReport run(const ReplaySource& source, const ReplaySink& sink, const std::atomic<bool>& keepRunning) const;
+
+    /**
+     * @brief Sink indicating the frame to CanIf as if it was received by the controller
+     * @details The frame takes the path of a live reception: acceptance filters, HRH and polling queue
+     *          of the controller of its channel. Remote and error frames are not indicated, as live.
+     */
+    static bool indicateToCanIf(const RecordEntry& entry);
+
+private:
+    ReplaySettings settings;
+
+    bool isReplayed(const RecordEntry& entry) const;
+    void waitUntil(std::chrono::steady_clock::time_point deadline) const;
+};
+
+#endif //XLREPLAY_H
+
+/**@} */ // END OF addtogroup xlreplay
@@ -0,0 +1,110 @@
+/**
+ * @file xlring.h
+ * @author Maxime Verreault
+ * @date 2026-10-19
+ * @copyright COPYRIGHT(c) Maxime Verreault All rights reserved.
+ * @brief Bounded single-producer single-consumer ring buffer
+ * @ingroup xldriver
+ * @addtogroup xlring
+ * @{
+ */
+
+
+#ifndef XLRING_H
+#define XLRING_H
+
+/*==================================================================================================
+*                                         INCLUDE FILES
+* 1) system and project includes
+* 2) needed interfaces from external units
+* 3) internal and external interfaces from this unit
+==================================================================================================*/
+#include <algorithm>
+#include <atomic>
+#include <bit>
+#include <cstddef>
+#include <memory>
+
+
+/*==================================================================================================
+*                                       DEFINES AND MACROS
+==================================================================================================*/
+#define XL_CACHE_LINE_SIZE 64
+
+
+/*==================================================================================================
+*                                STRUCTURES AND OTHER TYPEDEFS
+==================================================================================================*/
+/**
+ * @brief Lock-free ring between exactly one producer thread and one consumer thread
+ * @details The capacity is rounded up to a power of two. Each side caches the other side's index
+ *          so the shared cache lines are only read when the ring looks full or empty.
+ */
+template<typename T>
+class SpscRing
+{
+public:
+    explicit SpscRing(std::size_t minimumCapacity):
+        mask(std::bit_ceil(std::max<std::size_t>(minimumCapacity, 2)) - 1),
+        slots(std::make_unique<T[]>(mask + 1))
+    {
+    }
+
+    bool push(const T& value)
+    {
+        const auto head = producer.index.load(std::memory_order_relaxed);
+        if(head - producer.cachedOther > mask)
+        {
+            producer.cachedOther = consumer.index.load(std::memory_order_acquire);
+            if(head - producer.cachedOther > mask)
+            {
+                return false;
+            }
+        }
+        slots[head & mask] = value;
+        producer.index.store(head + 1, std::memory_order_release);
+        return true;
+    }
+
+    bool pop(T& value)
+    {
+        const auto tail = consumer.index.load(std::memory_order_relaxed);
+        if(tail == consumer.cachedOther)
+        {
+            consumer.cachedOther = producer.index.load(std::memory_order_acquire);
+            if(tail == consumer.cachedOther)
+            {
+                return false;
+            }
+        }
+        value = slots[tail & mask];
+        consumer.index.store(tail + 1, std::memory_order_release);
+        return true;
+    }
+
+    [[nodiscard]] std::size_t size() const
+    {
+        return producer.index.load(std::memory_order_acquire) - consumer.index.load(std::memory_order_acquire);
+    }
+
+    [[nodiscard]] std::size_t capacity() const
+    {
+        return mask + 1;
+    }
+
+private:
+    struct alignas(XL_CACHE_LINE_SIZE) Side
+    {
+        std::atomic<std::size_t> index{0};
+        std::size_t cachedOther{0};
+    };
+
+    const std::size_t mask;
+    std::unique_ptr<T[]> slots;
+    Side producer{};
+    Side consumer{};
+};
+
+#endif //XLRING_H
+
+/**@} */ // END OF addtogroup xlring
@@ -0,0 +1,226 @@
+/**
+ * @file xltimerwheel.h
+ * @author Maxime Verreault
+ * @date 2026-10-19
+ * @copyright COPYRIGHT(c) Maxime Verreault All rights reserved.
+ * @brief Hierarchical timing wheel of preallocated timers, the deadlines of the RX path
+ * @ingroup xldriver
+ * @addtogroup xltimerwheel
+ * @{
+ */
+
+
+#ifndef XLTIMERWHEEL_H
+#define XLTIMERWHEEL_H
+
+/*==================================================================================================
+*                                         INCLUDE FILES
+* 1) system and project includes
+* 2) needed interfaces from external units
+* 3) internal and external interfaces from this unit
+==================================================================================================*/
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <vector>
+#include <Platform_Types.h>
+
+
+/*==================================================================================================
+*                                       DEFINES AND MACROS
+==================================================================================================*/
+#define TIMER_WHEEL_SLOT_BITS   6u      // 64 slots per level, the occupancy of a level is one word
+#define TIMER_WHEEL_LEVELS      8u      // levels of the wheel, the ticks stay below 2^48
+
+
+/*==================================================================================================
+*                                STRUCTURES AND OTHER TYPEDEFS
+==================================================================================================*/
+/**
+ * @brief Timers indexed 0..size-1, each one armed at most once, expired in tick order
+ * @details Level L holds the timers whose expiry first differs from the current tick in its digit
+ *          L (6 bits), in the slot of that digit: the timers of a slot are moved one level down
+ *          when the current tick reaches it, and a timer moves at most once per level. Each slot is
+ *          an intrusive doubly linked list through the timer array, arming and cancelling a timer
+ *          is O(1) and allocates nothing. The occupancy words let advance() jump straight to the
+ *          next tick with something to do, however long the wheel was left alone.
+ *          Not thread safe, the thread reading the XL queue owns the wheel.
+ */
+class TimingWheel
+{
+public:
+    static constexpr uint32 NoTimer = ~uint32{0};
+    static constexpr uint64 NoTick = ~uint64{0};
+
+    TimingWheel()
+    {
+        heads.fill(NoTimer);
+    }
+
+    /** @brief Allocate the timers, all disarmed, and start at a tick */
+    void resize(uint32 timers, uint64 tick = 0)
+    {
+        nodes.assign(timers, Node{});
+        heads.fill(NoTimer);
+        occupied.fill(0);
+        current = std::min(tick, TickLimit);
+    }
+
+    [[nodiscard]] uint32 size() const
+    {
+        return static_cast<uint32>(nodes.size());
+    }
+
+    /** @brief Last tick processed by advance() */
+    [[nodiscard]] uint64 now() const
+    {
+        return current;
+    }
+
+    [[nodiscard]] bool armed(uint32 timer) const
+    {
+        return nodes[timer].slot != NoSlot;
+    }
+
+    /** @brief Arm or re-arm a timer, an expiry not after the current tick expires on the next one */
+    void schedule(uint32 timer, uint64 expiry)
+    {
+        cancel(timer);
+        nodes[timer].expiry = std::clamp(expiry, current + 1, TickLimit);
+        insert(timer);
+    }
+
+    void cancel(uint32 timer)
+    {
+        auto& node = nodes[timer];
+        if(node.slot == NoSlot)
+        {
+            return;
+        }
+        if(node.prev != NoTimer)
+        {
+            nodes[node.prev].next = node.next;
+        }
+        else
+        {
+            heads[node.slot] = node.next;
+            if(node.next == NoTimer)
+            {
+                occupied[node.slot >> TIMER_WHEEL_SLOT_BITS] &= ~(uint64{1} << (node.slot & SlotMask));
+            }
+        }
+        if(node.next != NoTimer)
+        {
+            nodes[node.next].prev = node.prev;
+        }
+        node.slot = NoSlot;
+    }
+
+    /** @brief Next tick where a timer expires or moves down a level, NoTick without an armed timer */
+    [[nodiscard]] uint64 nextTick() const
+    {
+        auto next = NoTick;
+        for(unsigned int level = 0; level < TIMER_WHEEL_LEVELS; ++level)
+        {
+            // the slots of a level are all ahead of the digit of the current tick
+            const auto shift = level * TIMER_WHEEL_SLOT_BITS;
+            const auto digit = (current >> shift) & SlotMask;
+            const auto ahead = digit == SlotMask ? 0 : occupied[level] & (~uint64{0} << (digit + 1));
+            if(ahead != 0)
+            {
+                const auto base = current >> (shift + TIMER_WHEEL_SLOT_BITS) << (shift + TIMER_WHEEL_SLOT_BITS);
+                next = std::min(next, base + (static_cast<uint64>(std::countr_zero(ahead)) << shift));
+            }
+        }
+        return next;
+    }
+
+    /**
+     * @brief Process the ticks up to a new current tick, the expired timers are disarmed first
+     * @param expire called with each expired timer, it may arm any timer again
+     */
+    template<typename Function>
+    void advance(uint64 tick, Function expire)
+    {
+        tick = std::min(tick, TickLimit);
+        while(current < tick)
+        {
+            const auto next = nextTick();
+            if(next > tick)
+            {
+                current = tick;
+                return;
+            }
+            current = next;
+            cascade();
+            const auto slot = static_cast<uint32>(current & SlotMask);
+            while(heads[slot] != NoTimer)
+            {
+                const auto timer = heads[slot];
+                cancel(timer);
+                expire(timer);
+            }
+        }
+    }
+
+private:
+    static constexpr uint64 SlotMask = (uint64{1} << TIMER_WHEEL_SLOT_BITS) - 1;
+    static constexpr uint64 TickLimit = (uint64{1} << (TIMER_WHEEL_SLOT_BITS * TIMER_WHEEL_LEVELS)) - 1;
+    static constexpr uint16 NoSlot = 0xFFFF;
+
+    struct Node
+    {
+        uint64 expiry{0};
+        uint32 next{NoTimer};
+        uint32 prev{NoTimer};
+        uint16 slot{NoSlot};        //!< level * 64 + slot, NoSlot while disarmed
+    };
+
+    /** @brief Link an expiry not before the current tick in its slot */
+    void insert(uint32 timer)
+    {
+        auto& node = nodes[timer];
+        const auto differing = node.expiry ^ current;
+        const auto level = differing == 0 ? 0u : static_cast<unsigned int>(std::bit_width(differing) - 1) / TIMER_WHEEL_SLOT_BITS;
+        const auto digit = (node.expiry >> (level * TIMER_WHEEL_SLOT_BITS)) & SlotMask;
+        node.slot = static_cast<uint16>((level << TIMER_WHEEL_SLOT_BITS) | digit);
+        node.prev = NoTimer;
+        node.next = heads[node.slot];
+        if(node.next != NoTimer)
+        {
+            nodes[node.next].prev = timer;
+        }
+        heads[node.slot] = timer;
+        occupied[level] |= uint64{1} << digit;
+    }
+
+    /** @brief Move down the timers of the slots the current tick starts, from the highest level */
+    void cascade()
+    {
+        for(unsigned int level = TIMER_WHEEL_LEVELS - 1; level > 0; --level)
+        {
+            const auto shift = level * TIMER_WHEEL_SLOT_BITS;
+            if((current & ((uint64{1} << shift) - 1)) != 0)
+            {
+                continue;
+            }
+            const auto slot = static_cast<uint32>((level << TIMER_WHEEL_SLOT_BITS) | ((current >> shift) & SlotMask));
+            while(heads[slot] != NoTimer)
+            {
+                const auto timer = heads[slot];
+                cancel(timer);
+                insert(timer);
+            }
+        }
+    }
+
+    std::vector<Node> nodes{};
+    std::array<uint32, TIMER_WHEEL_LEVELS << TIMER_WHEEL_SLOT_BITS> heads{};
+    std::array<uint64, TIMER_WHEEL_LEVELS> occupied{};      //!< non-empty slots of each level
+    uint64 current{0};
+};
+
+
+#endif //XLTIMERWHEEL_H
+
+/**@} */ // END OF addtogroup xltimerwheel
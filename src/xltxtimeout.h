@@ -0,0 +1,432 @@
+/**
+ * @file xltxtimeout.h
+ * @author Maxime Verreault
+ * @date 2026-10-19
+ * @copyright COPYRIGHT(c) Maxime Verreault All rights reserved.
+ * @brief Timeouts of the transmitted frames never confirmed: no node acknowledging them, bus-off
+ * @ingroup xldriver
+ * @addtogroup xltxtimeout
+ * @{
+ */
+
+
+#ifndef XLTXTIMEOUT_H
+#define XLTXTIMEOUT_H
+
+/*==================================================================================================
+*                                         INCLUDE FILES
+* 1) system and project includes
+* 2) needed interfaces from external units
+* 3) internal and external interfaces from this unit
+==================================================================================================*/
+#include "vxlapi.h"
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <memory>
+#include <optional>
+#include <vector>
+#include <ComStack_Types.h>
+#include <Platform_Types.h>
+#include "xltimerwheel.h"
+
+
+/*==================================================================================================
+*                                       DEFINES AND MACROS
+==================================================================================================*/
+#define TX_TIMEOUT_TICK_SHIFT       20u     // ticks of the wheel: 2^20 ns of the host clock, about 1 ms
+#define TX_TIMEOUT_SLOTS            256u    // frames in flight per supervised channel, a power of 2
+#define TX_TIMEOUT_NOTIFY           0x01u   // action: report each frame given up to the handler
+#define TX_TIMEOUT_FLUSH            0x02u   // action: flush the transmit queue of the channel, its frames are given up
+
+
+/*==================================================================================================
+*                                STRUCTURES AND OTHER TYPEDEFS
+==================================================================================================*/
+/** @brief Longest wait for the confirmation of a frame transmitted on a channel */
+struct TxSupervision
+{
+    unsigned int channelIndex;
+    uint64 timeout;             //!< ns
+    uint8 actions;              //!< TX_TIMEOUT_NOTIFY, TX_TIMEOUT_FLUSH
+};
+
+/** @brief Frames supervised on one channel */
+struct TxSupervisionStatistics
+{
+    uint64 supervised;          //!< frames accepted by the XL driver
+    uint64 confirmed;           //!< confirmations of a frame in flight
+    uint64 timeouts;            //!< frames given up without confirmation after the timeout
+    uint64 lateConfirmations;   //!< confirmations of no frame in flight, a frame given up already
+    uint64 flushes;             //!< transmit queue flushes after a timeout
+    uint64 flushedFrames;       //!< other frames in flight given up by the flushes
+    uint64 busy;                //!< writes refused, every slot in flight
+    uint64 inFlight;            //!< frames waiting for their confirmation
+};
+
+/**
+ * @brief Frames in flight on the supervised channels, each one with a timer of a timing wheel
+ * @details A channel keeps TX_TIMEOUT_SLOTS frames in flight in a ring of slots. The writers claim
+ *          the next position with a CAS, a slot is published before the frame is handed to the XL
+ *          driver and is free again when its confirmation, its timeout or a flush gives it up: a
+ *          write finding its slot still in flight is refused, like a full transmit queue. The thread
+ *          reading the XL queue arms the timer of each published frame on its write time, matches
+ *          each confirmation with the oldest frame in flight of the same identifier, and expires the
+ *          timers on the host clock: each time the queue is found empty and every
+ *          RX_QUEUE_LEVEL_PERIOD events. The host clock measures what the stack waits for, the
+ *          frames never confirmed get no driver timestamp anyway.
+ *          Nothing is allocated after configure, the statistics are read from any thread.
+ */
+class TxSupervisor
+{
+public:
+    using Clock = std::chrono::steady_clock;
+    /** @brief Called by the thread reading the XL queue with each frame given up */
+    using TimeoutHandler = void (*)(unsigned int channelIndex, uint32 id, PduIdType pduId);
+
+    static constexpr uint64 Unsupervised = ~uint64{0};      //!< onWrite: no timeout on the channel
+    static constexpr uint64 Busy = ~uint64{0} - 1;          //!< onWrite: every slot of the channel in flight
+
+    /**
+     * @brief Replace the supervised channels, while no thread writes nor reads the XL queue
+     * @details The slots are allocated here, the channels without timeout and the second
+     *          supervision of a channel are ignored.
+     */
+    void configure(const std::vector<TxSupervision>& supervisions, XLportHandle xlPortHandle, TimeoutHandler timeoutHandler)
+    {
+        channelOf.fill(nullptr);
+        channels.clear();
+        minTimeout = ~uint64{0};
+        for(const auto& supervision : supervisions)
+        {
+            const auto channelIndex = supervision.channelIndex % channelOf.size();
+            if(supervision.timeout == 0 || channelOf[channelIndex] != nullptr)
+            {
+                continue;
+            }
+            auto& channel = channels.emplace_back(std::make_unique<Channel>());
+            for(uint32 slot = 0; slot < TX_TIMEOUT_SLOTS; ++slot)
+            {
+                channel->slots[slot].sequence.store(slot, std::memory_order_relaxed);
+            }
+            channel->channelIndex = channelIndex;
+            channel->firstTimer = static_cast<uint32>(channels.size() - 1) * TX_TIMEOUT_SLOTS;
+            channel->timeout = supervision.timeout;
+            channel->actions = supervision.actions;
+            channelOf[channelIndex] = channel.get();
+            minTimeout = std::min(minTimeout, supervision.timeout);
+        }
+        portHandle = xlPortHandle;
+        handler = timeoutHandler;
+        wheel.resize(static_cast<uint32>(channels.size()) * TX_TIMEOUT_SLOTS, hostTime() >> TX_TIMEOUT_TICK_SHIFT);
+    }
+
+    /**
+     * @brief Take the slot of a frame about to be transmitted, from any thread
+     * @return position of the frame, Unsupervised or Busy
+     */
+    uint64 onWrite(unsigned int channelIndex, uint32 id, PduIdType pduId)
+    {
+        auto* channel = channelOf[channelIndex % channelOf.size()];
+        if(channel == nullptr)
+        {
+            return Unsupervised;
+        }
+        auto position = channel->writePosition.load(std::memory_order_relaxed);
+        for(;;)
+        {
+            const auto sequence = channel->slots[position & SlotMask].sequence.load(std::memory_order_acquire);
+            if(sequence == position)
+            {
+                if(channel->writePosition.compare_exchange_weak(position, position + 1, std::memory_order_relaxed))
+                {
+                    break;
+                }
+            }
+            else if(sequence < position)
+            {
+                // the frame of the previous round is still in flight
+                channel->busy.fetch_add(1, std::memory_order_relaxed);
+                return Busy;
+            }
+            else
+            {
+                position = channel->writePosition.load(std::memory_order_relaxed);
+            }
+        }
+        auto& slot = channel->slots[position & SlotMask];
+        slot.id.store(id, std::memory_order_relaxed);
+        slot.pduId.store(pduId, std::memory_order_relaxed);
+        slot.hostTime.store(hostTime(), std::memory_order_relaxed);
+        // published before the XL driver has it, its confirmation always finds it
+        slot.sequence.store(position + 1, std::memory_order_release);
+        channel->supervised.fetch_add(1, std::memory_order_relaxed);
+        return position;
+    }
+
+    /** @brief Free the slot of a frame the XL driver refused, from the thread of onWrite */
+    void onWriteFailed(unsigned int channelIndex, uint64 position)
+    {
+        auto* channel = channelOf[channelIndex % channelOf.size()];
+        auto expected = position + 1;
+        // an armed timer of the slot finds it free and is ignored
+        if(channel != nullptr && channel->slots[position & SlotMask].sequence.compare_exchange_strong(expected, position + TX_TIMEOUT_SLOTS, std::memory_order_acq_rel))
+        {
+            channel->supervised.fetch_sub(1, std::memory_order_relaxed);
+        }
+    }
+
+    /**
+     * @brief Give up the timer of the oldest frame in flight of an identifier, from the thread reading the XL queue
+     * @return PDU of the confirmed frame, none when the channel is unsupervised or the frame was given up
+     */
+    std::optional<PduIdType> onConfirmation(unsigned int channelIndex, uint32 id)
+    {
+        auto* channel = channelOf[channelIndex % channelOf.size()];
+        if(channel == nullptr)
+        {
+            return std::nullopt;
+        }
+        // the frames of an identifier are transmitted in order, the others may overtake them by priority
+        const auto end = channel->writePosition.load(std::memory_order_acquire);
+        for(auto position = channel->oldestPosition; position != end; ++position)
+        {
+            const auto& slot = channel->slots[position & SlotMask];
+            if(slot.sequence.load(std::memory_order_acquire) == position + 1 && slot.id.load(std::memory_order_relaxed) == id)
+            {
+                // read before the release, a writer may claim the slot right after
+                const auto pduId = slot.pduId.load(std::memory_order_relaxed);
+                if(release(*channel, position))
+                {
+                    increment(channel->confirmed);
+                    return pduId;
+                }
+            }
+        }
+        increment(channel->lateConfirmations);
+        return std::nullopt;
+    }
+
+    /** @brief Arm the frames written since the last call and expire the timers up to the host time */
+    void expire()
+    {
+        if(!channels.empty())
+        {
+            expireUpTo(hostTime());
+        }
+    }
+
+    /**
+     * @brief expire(), each time the XL queue is found empty
+     * @return the longest wait of the RX thread before the next timeout (ms), at most maxWaitMs
+     */
+    unsigned int onIdle(unsigned int maxWaitMs)
+    {
+        if(channels.empty())
+        {
+            return maxWaitMs;
+        }
+        const auto now = hostTime();
+        expireUpTo(now);
+
+        // the frames written during the wait are only armed when the thread wakes up
+        const auto longest = std::clamp<uint64>(minTimeout / 1000000, 1, maxWaitMs);
+        const auto next = wheel.nextTick();
+        if(next == TimingWheel::NoTick)
+        {
+            return static_cast<unsigned int>(longest);
+        }
+        const auto wait = ((next << TX_TIMEOUT_TICK_SHIFT) - std::min(now, next << TX_TIMEOUT_TICK_SHIFT) + 999999) / 1000000;
+        return static_cast<unsigned int>(std::clamp<uint64>(wait, 1, longest));
+    }
+
+    /** @brief The channel has a timeout, its confirmations go through onConfirmation */
+    [[nodiscard]] bool supervises(unsigned int channelIndex) const
+    {
+        return channelOf[channelIndex % channelOf.size()] != nullptr;
+    }
+
+    /** @brief Frames supervised on a channel, false when it has no timeout */
+    bool snapshot(unsigned int channelIndex, TxSupervisionStatistics& statistics) const
+    {
+        const auto* channel = channelOf[channelIndex % channelOf.size()];
+        if(channel == nullptr)
+        {
+            return false;
+        }
+        statistics.supervised = channel->supervised.load(std::memory_order_relaxed);
+        statistics.confirmed = channel->confirmed.load(std::memory_order_relaxed);
+        statistics.timeouts = channel->timeouts.load(std::memory_order_relaxed);
+        statistics.lateConfirmations = channel->lateConfirmations.load(std::memory_order_relaxed);
+        statistics.flushes = channel->flushes.load(std::memory_order_relaxed);
+        statistics.flushedFrames = channel->flushedFrames.load(std::memory_order_relaxed);
+        statistics.busy = channel->busy.load(std::memory_order_relaxed);
+        // the counters are read one by one, a frame confirmed meanwhile may be missing from supervised
+        const auto completed = statistics.confirmed + statistics.timeouts + statistics.flushedFrames;
+        statistics.inFlight = statistics.supervised > completed ? statistics.supervised - completed : 0;
+        return true;
+    }
+
+private:
+    static constexpr uint64 SlotMask = TX_TIMEOUT_SLOTS - 1;
+
+    /** @brief One frame in flight, position p: sequence p while free, p + 1 once published, p + TX_TIMEOUT_SLOTS once given up */
+    struct Slot
+    {
+        std::atomic<uint64> sequence{0};
+        std::atomic<uint32> id{0};              //!< identifier, XL_CAN_EXT_MSG_ID set for an extended one
+        std::atomic<PduIdType> pduId{0};
+        std::atomic<uint64> hostTime{0};        //!< ns, written
+    };
+
+    struct Channel
+    {
+        std::array<Slot, TX_TIMEOUT_SLOTS> slots{};
+        alignas(64) std::atomic<uint64> writePosition{0};
+        std::atomic<uint64> supervised{0};
+        std::atomic<uint64> busy{0};
+        // owned by the thread reading the XL queue
+        alignas(64) uint64 armPosition{0};                  //!< next frame to arm
+        uint64 oldestPosition{0};                           //!< oldest frame maybe in flight
+        std::array<uint64, TX_TIMEOUT_SLOTS> armed{};       //!< position of the timer of each slot
+        unsigned int channelIndex{0};
+        uint32 firstTimer{0};                               //!< timer of slot 0
+        uint64 timeout{0};                                  //!< ns
+        uint8 actions{0};
+        std::atomic<uint64> confirmed{0};
+        std::atomic<uint64> timeouts{0};
+        std::atomic<uint64> lateConfirmations{0};
+        std::atomic<uint64> flushes{0};
+        std::atomic<uint64> flushedFrames{0};
+    };
+
+    static uint64 hostTime()
+    {
+        return static_cast<uint64>(std::chrono::duration_cast<std::chrono::nanoseconds>(Clock::now().time_since_epoch()).count());
+    }
+
+    static uint64 tickAfter(uint64 time)
+    {
+        return (time + (uint64{1} << TX_TIMEOUT_TICK_SHIFT) - 1) >> TX_TIMEOUT_TICK_SHIFT;
+    }
+
+    /** @brief Counter of the thread reading the XL queue, a plain increment */
+    static void increment(std::atomic<uint64>& counter, uint64 count = 1)
+    {
+        counter.store(counter.load(std::memory_order_relaxed) + count, std::memory_order_relaxed);
+    }
+
+    /** @brief Give up a published frame and its timer, false when it was given up already */
+    bool release(Channel& channel, uint64 position)
+    {
+        const auto slot = static_cast<uint32>(position & SlotMask);
+        auto expected = position + 1;
+        if(!channel.slots[slot].sequence.compare_exchange_strong(expected, position + TX_TIMEOUT_SLOTS, std::memory_order_acq_rel))
+        {
+            return false;
+        }
+        if(channel.armed[slot] == position)
+        {
+            wheel.cancel(channel.firstTimer + slot);
+        }
+        // a free position is given up, a later one claimed or free
+        while(channel.slots[channel.oldestPosition & SlotMask].sequence.load(std::memory_order_acquire) >= channel.oldestPosition + TX_TIMEOUT_SLOTS)
+        {
+            ++channel.oldestPosition;
+        }
+        return true;
+    }
+
+    /** @brief Arm the timers of the frames published since the last call, in order */
+    void arm(Channel& channel)
+    {
+        const auto end = channel.writePosition.load(std::memory_order_acquire);
+        for(; channel.armPosition != end; ++channel.armPosition)
+        {
+            const auto position = channel.armPosition;
+            const auto slot = static_cast<uint32>(position & SlotMask);
+            const auto sequence = channel.slots[slot].sequence.load(std::memory_order_acquire);
+            if(sequence == position)
+            {
+                // claimed, its writer has not published it yet
+                return;
+            }
+            if(sequence == position + 1)
+            {
+                channel.armed[slot] = position;
+                wheel.schedule(channel.firstTimer + slot, tickAfter(channel.slots[slot].hostTime.load(std::memory_order_relaxed) + channel.timeout));
+            }
+        }
+    }
+
+    /** @brief Give up the frames in flight of a channel once its transmit queue is flushed */
+    void flush(Channel& channel)
+    {
+        // the frames written during the flush may still be transmitted, their confirmation is late
+        const auto end = channel.writePosition.load(std::memory_order_acquire);
+        xlCanFlushTransmitQueue(portHandle, XLaccess{1} << channel.channelIndex);
+        increment(channel.flushes);
+        for(auto position = channel.oldestPosition; position < end; ++position)
+        {
+            const auto& slot = channel.slots[position & SlotMask];
+            const auto id = slot.id.load(std::memory_order_relaxed);
+            const auto pduId = slot.pduId.load(std::memory_order_relaxed);
+            if(slot.sequence.load(std::memory_order_acquire) != position + 1 || !release(channel, position))
+            {
+                continue;
+            }
+            increment(channel.flushedFrames);
+            if((channel.actions & TX_TIMEOUT_NOTIFY) && handler != nullptr)
+            {
+                handler(channel.channelIndex, id, pduId);
+            }
+        }
+    }
+
+    void expireUpTo(uint64 now)
+    {
+        for(auto& channel : channels)
+        {
+            arm(*channel);
+        }
+        if((now >> TX_TIMEOUT_TICK_SHIFT) <= wheel.now())
+        {
+            return;
+        }
+        wheel.advance(now >> TX_TIMEOUT_TICK_SHIFT, [this](uint32 timer) {
+            auto& channel = *channels[timer / TX_TIMEOUT_SLOTS];
+            const auto slot = timer & static_cast<uint32>(SlotMask);
+            const auto position = channel.armed[slot];
+            // read before the release, the slot is claimed again right after it
+            const auto id = channel.slots[slot].id.load(std::memory_order_relaxed);
+            const auto pduId = channel.slots[slot].pduId.load(std::memory_order_relaxed);
+            if(!release(channel, position))
+            {
+                // refused by the XL driver in the meantime
+                return;
+            }
+            increment(channel.timeouts);
+            if((channel.actions & TX_TIMEOUT_NOTIFY) && handler != nullptr)
+            {
+                handler(channel.channelIndex, id, pduId);
+            }
+            if(channel.actions & TX_TIMEOUT_FLUSH)
+            {
+                flush(channel);
+            }
+        });
+    }
+
+    std::vector<std::unique_ptr<Channel>> channels{};
+    std::array<Channel*, XL_CONFIG_MAX_CHANNELS> channelOf{};
+    XLportHandle portHandle{XL_INVALID_PORTHANDLE};
+    TimeoutHandler handler{nullptr};
+    TimingWheel wheel{};
+    uint64 minTimeout{~uint64{0}};                  //!< ns, shortest timeout of the channels
+};
+
+
+#endif //XLTXTIMEOUT_H
+
+/**@} */ // END OF addtogroup xltxtimeout
@@ -0,0 +1,174 @@
+/**
+ * @file xlwait.h
+ * @author Maxime Verreault
+ * @date 2026-10-19
+ * @copyright COPYRIGHT(c) Maxime Verreault All rights reserved.
+ * @brief Wait strategy used by the RX consumer loops when the port receive queue is empty
+ * @ingroup xldriver
+ * @addtogroup xlwait
+ * @{
+ */
+
+
+#ifndef XLWAIT_H
+#define XLWAIT_H
+
+/*==================================================================================================
+*                                         INCLUDE FILES
+* 1) system and project includes
+* 2) needed interfaces from external units
+* 3) internal and external interfaces from this unit
+==================================================================================================*/
+#include "vxlapi.h"
+#include <windows.h>
+#include <synchapi.h>
+#include <algorithm>
+#include <chrono>
+#include <optional>
+#include <thread>
+#if defined(__x86_64__) || defined(__i386__) || defined(_M_X64) || defined(_M_IX86)
+#include <immintrin.h>
+#endif
+#include <Platform_Types.h>
+
+
+/*==================================================================================================
+*                                       DEFINES AND MACROS
+==================================================================================================*/
+#define RX_WAIT_BLOCK_TIMEOUT_MS   100      // upper bound of one blocking wait, guards against a missed notification
+#define RX_WAIT_MIN_SPIN_BUDGET_NS 2000     // lower bound of the auto-tuned spin budget
+#define RX_WAIT_GAP_EWMA_SHIFT     3        // weight 1/8 of a new inter-arrival sample in the running average
+
+
+/*==================================================================================================
+*                                             ENUMS
+==================================================================================================*/
+/**
+ * @brief How a consumer thread waits for the next event once the receive queue is drained
+ */
+enum class RxWaitMode : uint8
+{
+    Spin,       //!< never leave the CPU, lowest latency
+    Block,      //!< block on the port notification handle right away, lowest CPU usage
+    Adaptive    //!< spin for an auto-tuned budget, then yield, then block
+};
+
+
+/*==================================================================================================
+*                                STRUCTURES AND OTHER TYPEDEFS
+==================================================================================================*/
+/**
+ * @brief Hybrid spin-then-block waiter for one consumer loop
+ * @details After the last received event the waiter spins for the spin budget, yields its time
+ *          slice for the same duration and finally blocks on the handle returned by
+ *          xlSetNotification(). In adaptive mode the spin budget follows twice the average
+ *          inter-arrival time measured on the driver timestamps, bounded by the configured budget:
+ *          a bus with dense traffic keeps the thread spinning, an idle bus puts it to sleep early.
+ *          Not thread safe, each consumer thread owns its instance.
+ */
+class RxWaitStrategy
+{
+public:
+    using Clock = std::chrono::steady_clock;
+
+    RxWaitStrategy(RxWaitMode waitMode, std::chrono::nanoseconds budget, XLhandle notificationHandle):
+        mode(notificationHandle == nullptr ? RxWaitMode::Spin : waitMode),
+        maxSpinBudget(budget),
+        spinBudget(budget),
+        notification(notificationHandle)
+    {
+    }
+
+    /**
+     * @brief Record the arrival of an event
+     * @param timeStamp driver timestamp of the event in nanoseconds
+     */
+    void onEvent(XLuint64 timeStamp)
+    {
+        idleSince.reset();
+        if(mode != RxWaitMode::Adaptive)
+        {
+            return;
+        }
+        if(lastTimeStamp != 0 && timeStamp > lastTimeStamp)
+        {
+            /* gaps longer than the budget bound carry no information beyond "too long to spin" */
+            const auto gap = static_cast<sint64>(std::min<XLuint64>(timeStamp - lastTimeStamp, 2 * maxSpinBudget.count()));
+            averageGap += (gap - averageGap) >> RX_WAIT_GAP_EWMA_SHIFT;
+            /* a budget below the minimum is kept as is, --spinbudget 0 never spins */
+            spinBudget = std::clamp(std::chrono::nanoseconds(2 * averageGap),
+                                    std::min(std::chrono::nanoseconds(RX_WAIT_MIN_SPIN_BUDGET_NS), maxSpinBudget),
+                                    maxSpinBudget);
+        }
+        lastTimeStamp = timeStamp;
+    }
+
+    /**
+     * @brief Wait a little for the next event, called each time the receive queue was found empty
+     * @param blockTimeoutMs longest blocking wait, shorter to wake up for a deadline
+     */
+    void onIdle(unsigned int blockTimeoutMs = RX_WAIT_BLOCK_TIMEOUT_MS)
+    {
+        if(mode == RxWaitMode::Spin)
+        {
+            relax();
+            return;
+        }
+        if(mode == RxWaitMode::Block)
+        {
+            block(blockTimeoutMs);
+            return;
+        }
+
+        const auto now = Clock::now();
+        if(!idleSince)
+        {
+            idleSince = now;
+        }
+        const auto idleTime = now - *idleSince;
+        if(idleTime < spinBudget)
+        {
+            relax();
+        }
+        else if(idleTime < 2 * spinBudget)
+        {
+            std::this_thread::yield();
+        }
+        else
+        {
+            block(blockTimeoutMs);
+        }
+    }
+
+    [[nodiscard]] std::chrono::nanoseconds currentSpinBudget() const
+    {
+        return spinBudget;
+    }
+
+private:
+    const RxWaitMode mode;
+    const std::chrono::nanoseconds maxSpinBudget;
+    std::chrono::nanoseconds spinBudget;
+    const XLhandle notification;
+    std::optional<Clock::time_point> idleSince{};
+    XLuint64 lastTimeStamp{0};
+    sint64 averageGap{0};
+
+    static void relax()
+    {
+#if defined(__x86_64__) || defined(__i386__) || defined(_M_X64) || defined(_M_IX86)
+        _mm_pause();
+#else
+        std::this_thread::yield();
+#endif
+    }
+
+    void block(unsigned int timeoutMs) const
+    {
+        (void) WaitForSingleObject(notification, timeoutMs);
+    }
+};
+
+#endif //XLWAIT_H
+
+/**@} */ // END OF addtogroup xlwait
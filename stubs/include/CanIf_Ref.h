@@ -0,0 +1,125 @@
+/**
+ * @file CanIf_Ref.h
+ * @author Maxime Verreault
+ * @date 2026-10-19
+ * @copyright COPYRIGHT(c) Maxime Verreault All rights reserved.
+ * @brief STUB FILE ONLY, reference CanIf routing frames to the upper layers through generated tables
+ * @details Alternative to CanIf.c for benchmarks of the adapter and CanIf path: link the canif_ref
+ *          library instead. The reception path does what a production CanIf does per frame:
+ *          HRH range check, software filtering of the identifier against the sorted RX PDUs of the
+ *          HRH, DLC check and indication to the upper layer owning the PDU. The tables are
+ *          generated at build time by tools/canif_ref_cfg.py into CanIf_Ref_Cfg.c.
+ * @ingroup Stubs
+ * @addtogroup CanIf_Ref
+ * @{
+ */
+
+
+#ifndef CANIF_REF_H
+#define CANIF_REF_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*==================================================================================================
+*                                         INCLUDE FILES
+* 1) system and project includes
+* 2) needed interfaces from external units
+* 3) internal and external interfaces from this unit
+==================================================================================================*/
+#include <Can_GeneralTypes.h>
+#include "ComStack_Types.h"
+
+
+/*==================================================================================================
+*                                       DEFINES AND MACROS
+==================================================================================================*/
+#define CANIF_REF_CAN_ID_MASK       0xBFFFFFFFu /**<@brief identifier bits compared, the CAN FD bit is ignored */
+#define CANIF_REF_MAX_USERS         8u          /**<@brief upper layers a PDU can be routed to */
+
+
+/*==================================================================================================
+*                                STRUCTURES AND OTHER TYPEDEFS
+==================================================================================================*/
+/** @brief Reception callback of an upper layer, PduR_CanIfRxIndication like */
+typedef void (*CanIf_RefRxIndicationFctType)(PduIdType RxPduId, const PduInfoType* PduInfoPtr);
+
+/** @brief Transmission confirmation callback of an upper layer, PduR_CanIfTxConfirmation like */
+typedef void (*CanIf_RefTxConfirmationFctType)(PduIdType TxPduId, Std_ReturnType result);
+
+/** @brief One RX PDU, sorted by CanId inside the range of its HRH */
+typedef struct
+{
+    Can_IdType CanId;           /**< @brief identifier, bit 31 set for an extended one */
+    PduLengthType Length;       /**< @brief minimum length accepted by the DLC check */
+    PduIdType UpperPduId;       /**< @brief PDU handle of the upper layer */
+    uint8 User;                 /**< @brief upper layer receiving the PDU */
+} CanIf_RefRxPduCfgType;
+
+/** @brief One hardware receive object and its range of RX PDUs */
+typedef struct
+{
+    Can_IdType FilterCode;      /**< @brief identifiers accepted when (CanId & FilterMask) == FilterCode */
+    Can_IdType FilterMask;      /**< @brief zero accepts everything before the PDU search */
+    uint16 FirstRxPdu;          /**< @brief index of the first RX PDU of the HRH */
+    uint16 RxPduCount;          /**< @brief number of RX PDUs of the HRH */
+} CanIf_RefHrhCfgType;
+
+/** @brief One TX PDU, indexed by the handle passed to CanIf_TxConfirmation */
+typedef struct
+{
+    PduIdType UpperPduId;       /**< @brief PDU handle of the upper layer */
+    uint8 User;                 /**< @brief upper layer confirmed */
+} CanIf_RefTxPduCfgType;
+
+/** @brief Generated configuration */
+typedef struct
+{
+    const CanIf_RefHrhCfgType* Hrhs;
+    const CanIf_RefRxPduCfgType* RxPdus;
+    const CanIf_RefTxPduCfgType* TxPdus;
+    uint16 HrhCount;
+    uint16 RxPduCount;
+    uint16 TxPduCount;
+} CanIf_RefConfigType;
+
+/** @brief Counters of the frames handled since the last CanIf_RefInit */
+typedef struct
+{
+    uint32 RxIndicated;         /**< @brief frames indicated to an upper layer */
+    uint32 RxFiltered;          /**< @brief frames of an identifier without RX PDU */
+    uint32 RxDlcFailed;         /**< @brief frames shorter than their RX PDU */
+    uint32 RxInvalidHrh;        /**< @brief frames of an unknown HRH */
+    uint32 TxConfirmed;         /**< @brief confirmations forwarded to an upper layer */
+    uint32 TxInvalidPdu;        /**< @brief confirmations of an unknown TX PDU */
+} CanIf_RefStatisticsType;
+
+
+/*==================================================================================================
+*                                     FUNCTION PROTOTYPES
+==================================================================================================*/
+/**
+ * @brief Select the tables and clear the counters, the callbacks are ignored before the first call
+ * @param ConfigPtr generated configuration, &CanIf_RefConfig of CanIf_Ref_Cfg.h
+ */
+void CanIf_RefInit(const CanIf_RefConfigType* ConfigPtr);
+
+/**
+ * @brief Install the callbacks of one upper layer, NULL ones drop the PDUs of the user
+ * @return E_OK, or E_NOT_OK for a user beyond CANIF_REF_MAX_USERS
+ */
+Std_ReturnType CanIf_RefSetUser(uint8 User, CanIf_RefRxIndicationFctType RxIndication, CanIf_RefTxConfirmationFctType TxConfirmation);
+
+/** @brief Copy of the counters, not synchronized with the RX thread */
+void CanIf_RefGetStatistics(CanIf_RefStatisticsType* Statistics);
+
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* CANIF_REF_H */
+
+
+/**@} */ /* END OF addtogroup CanIf_Ref */
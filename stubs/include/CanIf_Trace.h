@@ -0,0 +1,130 @@
+/**
+ * @file CanIf_Trace.h
+ * @author Maxime Verreault
+ * @date 2026-10-19
+ * @copyright COPYRIGHT(c) Maxime Verreault All rights reserved.
+ * @brief STUB FILE ONLY, CanIf recording every callback into a preallocated lock-free trace
+ * @details Alternative to CanIf.c for tests and measurements: link the canif_trace library instead.
+ *          The callbacks never block nor print, each one claims the next trace entry with a single
+ *          atomic increment and copies its arguments into it. Entries are read back with the query
+ *          functions below, while the callbacks keep running.
+ * @ingroup Stubs
+ * @addtogroup CanIf_Trace
+ * @{
+ */
+
+
+#ifndef CANIF_TRACE_H
+#define CANIF_TRACE_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*==================================================================================================
+*                                         INCLUDE FILES
+* 1) system and project includes
+* 2) needed interfaces from external units
+* 3) internal and external interfaces from this unit
+==================================================================================================*/
+#include <Can_GeneralTypes.h>
+#include "ComStack_Types.h"
+
+
+/*==================================================================================================
+*                                       DEFINES AND MACROS
+==================================================================================================*/
+#define CANIF_TRACE_MAX_DATA_LENGTH     64u     /**<@brief payload bytes copied from a CanIf_RxIndication */
+
+
+/*==================================================================================================
+*                                             ENUMS
+==================================================================================================*/
+/** @brief Callback recorded by one trace entry */
+typedef enum
+{
+    CANIF_TRACE_RX_INDICATION = 0,
+    CANIF_TRACE_TX_CONFIRMATION,
+    CANIF_TRACE_CONTROLLER_BUS_OFF,
+    CANIF_TRACE_CONTROLLER_MODE_INDICATION,
+    CANIF_TRACE_CONTROLLER_ERROR_STATE_PASSIVE,
+    CANIF_TRACE_ERROR_NOTIFICATION,
+    CANIF_TRACE_KIND_COUNT
+} CanIf_TraceKindType;
+
+
+/*==================================================================================================
+*                                STRUCTURES AND OTHER TYPEDEFS
+==================================================================================================*/
+/** @brief One recorded callback, the fields not carried by the callback are zero, Data only holds Length bytes */
+typedef struct
+{
+    uint64 TimeStamp;                           /**< @brief nanoseconds of the trace clock when the callback ran */
+    CanIf_TraceKindType Kind;                   /**< @brief recorded callback */
+    Can_IdType CanId;                           /**< @brief CanIf_RxIndication mailbox identifier */
+    Can_HwHandleType Hoh;                       /**< @brief CanIf_RxIndication mailbox hardware object */
+    PduIdType PduId;                            /**< @brief CanIf_TxConfirmation PDU */
+    uint8 ControllerId;                         /**< @brief controller of the mailbox, bus-off or mode indication */
+    Can_ControllerStateType ControllerMode;     /**< @brief CanIf_ControllerModeIndication state */
+    PduLengthType Length;                       /**< @brief SDU length received, Data holds at most CANIF_TRACE_MAX_DATA_LENGTH bytes */
+    uint8 Data[CANIF_TRACE_MAX_DATA_LENGTH];    /**< @brief copy of the received SDU */
+} CanIf_TraceEntryType;
+
+/** @brief Monotonic time source of the trace, in nanoseconds */
+typedef uint64 (*CanIf_TraceClockType)(void);
+
+
+/*==================================================================================================
+*                                     FUNCTION PROTOTYPES
+==================================================================================================*/
+/**
+ * @brief Allocate the trace and start recording
+ * @param Capacity number of entries, callbacks beyond it are counted as dropped
+ * @param Clock time source of the entries, NULL for the monotonic clock of the system
+ * @return E_OK, or E_NOT_OK when the allocation fails
+ * @note Not thread safe with the callbacks, call it before the driver starts reporting.
+ */
+Std_ReturnType CanIf_TraceInit(uint32 Capacity, CanIf_TraceClockType Clock);
+
+/** @brief Free the trace, the callbacks are dropped until the next CanIf_TraceInit */
+void CanIf_TraceDeInit(void);
+
+/** @brief Forget all the entries and the counters, not thread safe with the callbacks */
+void CanIf_TraceReset(void);
+
+/** @brief Number of entries claimed by the callbacks, the last ones may still be being written */
+uint32 CanIf_TraceGetCount(void);
+
+/** @brief Number of callbacks lost because the trace was full or not initialized */
+uint32 CanIf_TraceGetDropped(void);
+
+/** @brief Number of callbacks of one kind, dropped ones included */
+uint32 CanIf_TraceGetKindCount(CanIf_TraceKindType Kind);
+
+/**
+ * @brief Copy one entry
+ * @param Index entry index, in the order the callbacks claimed them
+ * @param Entry copy of the entry
+ * @return E_OK, or E_NOT_OK when the entry does not exist or is still being written
+ */
+Std_ReturnType CanIf_TraceGetEntry(uint32 Index, CanIf_TraceEntryType* Entry);
+
+/**
+ * @brief Direct access to the entries, for bulk post-processing
+ * @return the entries or NULL, only the first CanIf_TraceGetCount() ones are meaningful and only
+ *         once the callbacks are stopped
+ */
+const CanIf_TraceEntryType* CanIf_TraceGetEntries(void);
+
+/** @brief Time stamp of the trace clock, to compare entries with events of the caller */
+uint64 CanIf_TraceNow(void);
+
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* CANIF_TRACE_H */
+
+
+/**@} */ /* END OF addtogroup CanIf_Trace */
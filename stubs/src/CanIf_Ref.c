@@ -0,0 +1,171 @@
+/**
+ * @file CanIf_Ref.c
+ * @author Maxime Verreault
+ * @date 2026-10-19
+ * @copyright COPYRIGHT(c) Maxime Verreault All rights reserved.
+ * @brief STUB FILE ONLY, reference CanIf routing frames to the upper layers through generated tables
+ * @ingroup Stubs
+ * @addtogroup CanIf_Ref
+ * @{
+ */
+
+
+/*==================================================================================================
+*                                        INCLUDE FILES
+* 1) system and project includes
+* 2) needed interfaces from external units
+* 3) internal and external interfaces from this unit
+==================================================================================================*/
+#include <stddef.h>
+#include "CanIf_Can.h"
+#include "CanIf_Ref.h"
+
+
+/*==================================================================================================
+*                                      LOCAL VARIABLES
+==================================================================================================*/
+static const CanIf_RefConfigType* CanIf_RefActiveConfig = NULL;
+static CanIf_RefRxIndicationFctType CanIf_RefRxUsers[CANIF_REF_MAX_USERS];
+static CanIf_RefTxConfirmationFctType CanIf_RefTxUsers[CANIF_REF_MAX_USERS];
+static CanIf_RefStatisticsType CanIf_RefStatistics;
+
+
+/*==================================================================================================
+*                                       LOCAL FUNCTIONS
+==================================================================================================*/
+/**
+ * @brief Software filtering: binary search of the identifier in the sorted RX PDUs of the HRH
+ * @return the RX PDU, NULL when the identifier is not configured
+ */
+static const CanIf_RefRxPduCfgType* CanIf_RefFindRxPdu(const CanIf_RefHrhCfgType* Hrh, Can_IdType CanId)
+{
+    const CanIf_RefRxPduCfgType* first = &CanIf_RefActiveConfig->RxPdus[Hrh->FirstRxPdu];
+    uint32 low = 0u;
+    uint32 high = Hrh->RxPduCount;
+
+    while(low < high)
+    {
+        const uint32 middle = low + ((high - low) >> 1u);
+        if(first[middle].CanId < CanId)
+        {
+            low = middle + 1u;
+        }
+        else
+        {
+            high = middle;
+        }
+    }
+    return ((low < Hrh->RxPduCount) && (first[low].CanId == CanId)) ? &first[low] : NULL;
+}
+
+
+/*==================================================================================================
+*                                       GLOBAL FUNCTIONS
+==================================================================================================*/
+void CanIf_RefInit(const CanIf_RefConfigType* ConfigPtr)
+{
+    const CanIf_RefStatisticsType cleared = {0u, 0u, 0u, 0u, 0u, 0u};
+
+    CanIf_RefActiveConfig = ConfigPtr;
+    CanIf_RefStatistics = cleared;
+}
+
+Std_ReturnType CanIf_RefSetUser(uint8 User, CanIf_RefRxIndicationFctType RxIndication, CanIf_RefTxConfirmationFctType TxConfirmation)
+{
+    if(User >= CANIF_REF_MAX_USERS)
+    {
+        return E_NOT_OK;
+    }
+    CanIf_RefRxUsers[User] = RxIndication;
+    CanIf_RefTxUsers[User] = TxConfirmation;
+    return E_OK;
+}
+
+void CanIf_RefGetStatistics(CanIf_RefStatisticsType* Statistics)
+{
+    *Statistics = CanIf_RefStatistics;
+}
+
+void CanIf_ControllerBusOff(uint8 ControllerId)
+{
+    (void) ControllerId;
+}
+
+void CanIf_ControllerModeIndication(uint8 ControllerId, Can_ControllerStateType ControllerMode)
+{
+    (void) ControllerId;
+    (void) ControllerMode;
+}
+
+void CanIf_RxIndication(const Can_HwType* Mailbox, const PduInfoType* PduInfoPtr)
+{
+    const CanIf_RefHrhCfgType* hrh;
+    const CanIf_RefRxPduCfgType* rxPdu;
+    Can_IdType canId;
+    PduInfoType upperPduInfo;
+
+    if((CanIf_RefActiveConfig == NULL) || (Mailbox->Hoh >= CanIf_RefActiveConfig->HrhCount))
+    {
+        ++CanIf_RefStatistics.RxInvalidHrh;
+        return;
+    }
+    hrh = &CanIf_RefActiveConfig->Hrhs[Mailbox->Hoh];
+    canId = Mailbox->CanId & CANIF_REF_CAN_ID_MASK;
+    if((canId & hrh->FilterMask) != hrh->FilterCode)
+    {
+        ++CanIf_RefStatistics.RxFiltered;
+        return;
+    }
+    rxPdu = CanIf_RefFindRxPdu(hrh, canId);
+    if(rxPdu == NULL)
+    {
+        ++CanIf_RefStatistics.RxFiltered;
+        return;
+    }
+    if(PduInfoPtr->SduLength < rxPdu->Length)
+    {
+        ++CanIf_RefStatistics.RxDlcFailed;
+        return;
+    }
+    if(CanIf_RefRxUsers[rxPdu->User] != NULL)
+    {
+        /* the upper layer only receives the configured length, like a CanIf without DLC extension */
+        upperPduInfo.SduDataPtr = PduInfoPtr->SduDataPtr;
+        upperPduInfo.MetaDataPtr = PduInfoPtr->MetaDataPtr;
+        upperPduInfo.SduLength = rxPdu->Length;
+        CanIf_RefRxUsers[rxPdu->User](rxPdu->UpperPduId, &upperPduInfo);
+    }
+    ++CanIf_RefStatistics.RxIndicated;
+}
+
+void CanIf_ControllerErrorStatePassive(void)
+{
+
+}
+
+void CanIf_ErrorNotification(void)
+{
+
+}
+
+void CanIf_TxConfirmation(PduIdType CanTxPduId)
+{
+    const CanIf_RefTxPduCfgType* txPdu;
+
+    if((CanIf_RefActiveConfig == NULL) || (CanTxPduId >= CanIf_RefActiveConfig->TxPduCount))
+    {
+        ++CanIf_RefStatistics.TxInvalidPdu;
+        return;
+    }
+    txPdu = &CanIf_RefActiveConfig->TxPdus[CanTxPduId];
+    if(CanIf_RefTxUsers[txPdu->User] != NULL)
+    {
+        CanIf_RefTxUsers[txPdu->User](txPdu->UpperPduId, E_OK);
+    }
+    ++CanIf_RefStatistics.TxConfirmed;
+}
+
+
+
+
+/**@} */ /* END OF addtogroup CanIf_Ref */
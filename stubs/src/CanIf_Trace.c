@@ -0,0 +1,251 @@
+/**
+ * @file CanIf_Trace.c
+ * @author Maxime Verreault
+ * @date 2026-10-19
+ * @copyright COPYRIGHT(c) Maxime Verreault All rights reserved.
+ * @brief STUB FILE ONLY, CanIf recording every callback into a preallocated lock-free trace
+ * @ingroup Stubs
+ * @addtogroup CanIf_Trace
+ * @{
+ */
+
+
+#define _POSIX_C_SOURCE 199309L
+
+
+/*==================================================================================================
+*                                        INCLUDE FILES
+* 1) system and project includes
+* 2) needed interfaces from external units
+* 3) internal and external interfaces from this unit
+==================================================================================================*/
+#include <stdatomic.h>
+#include <stddef.h>
+#include <stdlib.h>
+#include <string.h>
+#if defined(_WIN32)
+#include <windows.h>
+#else
+#include <time.h>
+#endif
+#include "CanIf_Can.h"
+#include "CanIf_Trace.h"
+
+
+/*==================================================================================================
+*                                      LOCAL VARIABLES
+==================================================================================================*/
+static CanIf_TraceEntryType* CanIf_TraceEntries = NULL;    /**< @brief preallocated entries */
+static atomic_uchar* CanIf_TraceReady = NULL;              /**< @brief set once the entry of the same index is written */
+static uint32 CanIf_TraceCapacity = 0u;
+static CanIf_TraceClockType CanIf_TraceClock = NULL;
+static atomic_uint CanIf_TraceClaimed = 0u;                /**< @brief entries claimed, may exceed the capacity */
+static atomic_uint CanIf_TraceDropped = 0u;
+static atomic_uint CanIf_TraceKindCounts[CANIF_TRACE_KIND_COUNT];
+
+
+/*==================================================================================================
+*                                       LOCAL FUNCTIONS
+==================================================================================================*/
+static uint64 CanIf_TraceMonotonicClock(void)
+{
+#if defined(_WIN32)
+    LARGE_INTEGER counter;
+    LARGE_INTEGER frequency;
+    (void) QueryPerformanceCounter(&counter);
+    (void) QueryPerformanceFrequency(&frequency);
+    return (uint64) ((double) counter.QuadPart * (1e9 / (double) frequency.QuadPart));
+#else
+    struct timespec now;
+    (void) clock_gettime(CLOCK_MONOTONIC, &now);
+    return (uint64) now.tv_sec * 1000000000u + (uint64) now.tv_nsec;
+#endif
+}
+
+/**
+ * @brief Claim the next entry, NULL when the trace is full
+ * @details The index is claimed with one relaxed increment, callbacks of several threads never
+ *          wait for each other. The entry is published by CanIf_TraceCommit.
+ */
+static CanIf_TraceEntryType* CanIf_TraceClaim(CanIf_TraceKindType Kind, uint32* Index)
+{
+    CanIf_TraceEntryType* entry = NULL;
+    const uint64 timeStamp = CanIf_TraceNow();
+
+    (void) atomic_fetch_add_explicit(&CanIf_TraceKindCounts[Kind], 1u, memory_order_relaxed);
+    *Index = atomic_fetch_add_explicit(&CanIf_TraceClaimed, 1u, memory_order_relaxed);
+    if(*Index < CanIf_TraceCapacity)
+    {
+        entry = &CanIf_TraceEntries[*Index];
+        memset(entry, 0, offsetof(CanIf_TraceEntryType, Data));
+        entry->TimeStamp = timeStamp;
+        entry->Kind = Kind;
+    }
+    else
+    {
+        (void) atomic_fetch_add_explicit(&CanIf_TraceDropped, 1u, memory_order_relaxed);
+    }
+    return entry;
+}
+
+static void CanIf_TraceCommit(uint32 Index)
+{
+    atomic_store_explicit(&CanIf_TraceReady[Index], 1u, memory_order_release);
+}
+
+static void CanIf_TraceRecord(CanIf_TraceKindType Kind, uint8 ControllerId)
+{
+    uint32 index;
+    CanIf_TraceEntryType* entry = CanIf_TraceClaim(Kind, &index);
+
+    if(entry != NULL)
+    {
+        entry->ControllerId = ControllerId;
+        CanIf_TraceCommit(index);
+    }
+}
+
+
+/*==================================================================================================
+*                                       GLOBAL FUNCTIONS
+==================================================================================================*/
+Std_ReturnType CanIf_TraceInit(uint32 Capacity, CanIf_TraceClockType Clock)
+{
+    CanIf_TraceDeInit();
+    CanIf_TraceEntries = malloc((size_t) Capacity * sizeof(CanIf_TraceEntryType));
+    CanIf_TraceReady = malloc((size_t) Capacity * sizeof(atomic_uchar));
+    if((CanIf_TraceEntries == NULL) || (CanIf_TraceReady == NULL))
+    {
+        CanIf_TraceDeInit();
+        return E_NOT_OK;
+    }
+    CanIf_TraceClock = Clock;
+    CanIf_TraceCapacity = Capacity;
+    CanIf_TraceReset();
+    return E_OK;
+}
+
+void CanIf_TraceDeInit(void)
+{
+    CanIf_TraceCapacity = 0u;
+    free(CanIf_TraceEntries);
+    free((void*) CanIf_TraceReady);
+    CanIf_TraceEntries = NULL;
+    CanIf_TraceReady = NULL;
+}
+
+void CanIf_TraceReset(void)
+{
+    uint32 i;
+
+    for(i = 0u; i < CanIf_TraceCapacity; ++i)
+    {
+        atomic_init(&CanIf_TraceReady[i], 0u);
+    }
+    for(i = 0u; i < (uint32) CANIF_TRACE_KIND_COUNT; ++i)
+    {
+        atomic_store(&CanIf_TraceKindCounts[i], 0u);
+    }
+    atomic_store(&CanIf_TraceDropped, 0u);
+    atomic_store(&CanIf_TraceClaimed, 0u);
+}
+
+uint32 CanIf_TraceGetCount(void)
+{
+    const uint32 claimed = atomic_load_explicit(&CanIf_TraceClaimed, memory_order_relaxed);
+    return (claimed < CanIf_TraceCapacity) ? claimed : CanIf_TraceCapacity;
+}
+
+uint32 CanIf_TraceGetDropped(void)
+{
+    return atomic_load_explicit(&CanIf_TraceDropped, memory_order_relaxed);
+}
+
+uint32 CanIf_TraceGetKindCount(CanIf_TraceKindType Kind)
+{
+    return (Kind < CANIF_TRACE_KIND_COUNT) ? atomic_load_explicit(&CanIf_TraceKindCounts[Kind], memory_order_relaxed) : 0u;
+}
+
+Std_ReturnType CanIf_TraceGetEntry(uint32 Index, CanIf_TraceEntryType* Entry)
+{
+    if((Entry == NULL) || (Index >= CanIf_TraceGetCount()) ||
+       (atomic_load_explicit(&CanIf_TraceReady[Index], memory_order_acquire) == 0u))
+    {
+        return E_NOT_OK;
+    }
+    *Entry = CanIf_TraceEntries[Index];
+    return E_OK;
+}
+
+const CanIf_TraceEntryType* CanIf_TraceGetEntries(void)
+{
+    atomic_thread_fence(memory_order_acquire);
+    return CanIf_TraceEntries;
+}
+
+uint64 CanIf_TraceNow(void)
+{
+    return (CanIf_TraceClock != NULL) ? CanIf_TraceClock() : CanIf_TraceMonotonicClock();
+}
+
+void CanIf_ControllerBusOff(uint8 ControllerId)
+{
+    CanIf_TraceRecord(CANIF_TRACE_CONTROLLER_BUS_OFF, ControllerId);
+}
+
+void CanIf_ControllerModeIndication(uint8 ControllerId, Can_ControllerStateType ControllerMode)
+{
+    uint32 index;
+    CanIf_TraceEntryType* entry = CanIf_TraceClaim(CANIF_TRACE_CONTROLLER_MODE_INDICATION, &index);
+
+    if(entry != NULL)
+    {
+        entry->ControllerId = ControllerId;
+        entry->ControllerMode = ControllerMode;
+        CanIf_TraceCommit(index);
+    }
+}
+
+void CanIf_RxIndication(const Can_HwType* Mailbox, const PduInfoType* PduInfoPtr)
+{
+    uint32 index;
+    CanIf_TraceEntryType* entry = CanIf_TraceClaim(CANIF_TRACE_RX_INDICATION, &index);
+
+    if(entry != NULL)
+    {
+        entry->CanId = Mailbox->CanId;
+        entry->Hoh = Mailbox->Hoh;
+        entry->ControllerId = Mailbox->ControllerId;
+        entry->Length = PduInfoPtr->SduLength;
+        memcpy(entry->Data, PduInfoPtr->SduDataPtr,
+               (PduInfoPtr->SduLength < CANIF_TRACE_MAX_DATA_LENGTH) ? PduInfoPtr->SduLength : CANIF_TRACE_MAX_DATA_LENGTH);
+        CanIf_TraceCommit(index);
+    }
+}
+
+void CanIf_ControllerErrorStatePassive(void)
+{
+    CanIf_TraceRecord(CANIF_TRACE_CONTROLLER_ERROR_STATE_PASSIVE, 0u);
+}
+
+void CanIf_ErrorNotification(void)
+{
+    CanIf_TraceRecord(CANIF_TRACE_ERROR_NOTIFICATION, 0u);
+}
+
+void CanIf_TxConfirmation(PduIdType CanTxPduId)
+{
+    uint32 index;
+    CanIf_TraceEntryType* entry = CanIf_TraceClaim(CANIF_TRACE_TX_CONFIRMATION, &index);
+
+    if(entry != NULL)
+    {
+        entry->PduId = CanTxPduId;
+        CanIf_TraceCommit(index);
+    }
+}
+
+
+
+
+/**@} */ /* END OF addtogroup CanIf_Trace */
@@ -0,0 +1,2 @@
+/* STUB FILE ONLY, structure packing as with the Windows SDK header of the same name */
+#pragma pack(push, 1)
@@ -0,0 +1,20 @@
+/**
+ * @file synchapi.h
+ * @author Maxime Verreault
+ * @date 2026-10-19
+ * @copyright COPYRIGHT(c) Maxime Verreault All rights reserved.
+ * @brief STUB FILE ONLY, everything needed is declared in windows.h
+ * @ingroup Stubs
+ * @addtogroup xlsim
+ * @{
+ */
+
+
+#ifndef XLSIM_SYNCHAPI_H
+#define XLSIM_SYNCHAPI_H
+
+#include "windows.h"
+
+#endif //XLSIM_SYNCHAPI_H
+
+/**@} */ // END OF addtogroup xlsim
@@ -0,0 +1,37 @@
+/**
+ * @file windows.h
+ * @author Maxime Verreault
+ * @date 2026-10-19
+ * @copyright COPYRIGHT(c) Maxime Verreault All rights reserved.
+ * @brief STUB FILE ONLY, the few Win32 declarations used by vxlapi.h and the adapter on other hosts
+ * @ingroup Stubs
+ * @addtogroup xlsim
+ * @{
+ */
+
+
+#ifndef XLSIM_WINDOWS_H
+#define XLSIM_WINDOWS_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+typedef unsigned long DWORD;
+typedef void* HANDLE;
+
+#define INFINITE        0xFFFFFFFF
+#define WAIT_OBJECT_0   0x00000000L
+#define WAIT_TIMEOUT    0x00000102L
+#define WAIT_FAILED     0xFFFFFFFF
+
+/** @brief Wait on a notification handle returned by the simulated xlSetNotification */
+DWORD WaitForSingleObject(HANDLE hHandle, DWORD dwMilliseconds);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif //XLSIM_WINDOWS_H
+
+/**@} */ // END OF addtogroup xlsim
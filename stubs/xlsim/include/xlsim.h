@@ -0,0 +1,79 @@
+/**
+ * @file xlsim.h
+ * @author Maxime Verreault
+ * @date 2026-10-19
+ * @copyright COPYRIGHT(c) Maxime Verreault All rights reserved.
+ * @brief STUB FILE ONLY, control interface of the simulated XL driver used on hosts without the Vector driver
+ * @ingroup Stubs
+ * @addtogroup xlsim
+ * @{
+ */
+
+
+#ifndef XLSIM_H
+#define XLSIM_H
+
+/*==================================================================================================
+*                                         INCLUDE FILES
+* 1) system and project includes
+* 2) needed interfaces from external units
+* 3) internal and external interfaces from this unit
+==================================================================================================*/
+#include "vxlapi.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*==================================================================================================
+*                                       DEFINES AND MACROS
+==================================================================================================*/
+#define XLSIM_DEFAULT_CHANNEL_COUNT     2u      // like the two channels of the Vector virtual CAN bus
+#define XLSIM_MAX_PORTS                 16u
+#define XLSIM_TX_QUEUE_SIZE             256u    // frames of a channel waiting for the bus or an acknowledge, then XL_ERR_QUEUE_IS_FULL
+#define XLSIM_DEFAULT_BITRATE           500000u // bitrates of a channel paced before any configuration
+#define XLSIM_DEFAULT_DATA_BITRATE      2000000u
+
+
+/*==================================================================================================
+*                                     FUNCTION PROTOTYPES
+==================================================================================================*/
+/**
+ * @brief Set the number of simulated CAN FD channels, all connected to one virtual bus
+ * @details Takes effect at the next xlOpenDriver. A frame transmitted on one channel is confirmed
+ *          (TX_OK) to the ports that activated this channel and received (RX_OK) by the ports that
+ *          activated any other channel.
+ */
+void xlSimSetChannelCount(unsigned int channelCount);
+
+/**
+ * @brief Connect or remove the nodes acknowledging the frames, connected by default
+ * @details Without acknowledge a transmitted frame is neither confirmed nor received: it waits in
+ *          the transmit queue of its channel until xlCanFlushTransmitQueue, xlDeactivateChannel or
+ *          the acknowledge comes back, which transmits the waiting frames in order.
+ */
+void xlSimSetAcknowledge(unsigned int acknowledge);
+
+/**
+ * @brief Deliver the frames at the bitrates of their channels, or at once like the Vector virtual bus (default)
+ * @details Paced, a transmitted frame waits in the transmit queue of its channel until the bus is
+ *          free, the lowest identifier first, and is confirmed and received once its last bit, stuff
+ *          bits and intermission included, is on the bus. The bitrates are those of
+ *          xlCanSetChannelBitrate or xlCanFdSetConfiguration. Frames late on their bus time are
+ *          delivered together, with the timestamps of their bus time.
+ */
+void xlSimSetBusTiming(unsigned int paced);
+
+/** @brief Queue an event as if the driver received it, bypassing the bus */
+XLstatus xlSimInjectEvent(XLportHandle portHandle, const XLevent* pEvent);
+
+/** @brief Queue a CAN FD event as if the driver received it, bypassing the bus */
+XLstatus xlSimInjectCanFdEvent(XLportHandle portHandle, const XLcanRxEvent* pEvent);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif //XLSIM_H
+
+/**@} */ // END OF addtogroup xlsim
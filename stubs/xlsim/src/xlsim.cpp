@@ -0,0 +1,968 @@
+/**
+ * @file xlsim.cpp
+ * @author Maxime Verreault
+ * @date 2026-10-19
+ * @copyright COPYRIGHT(c) Maxime Verreault All rights reserved.
+ * @brief STUB FILE ONLY, in-process simulation of the Vector XL driver virtual CAN bus
+ * @ingroup Stubs
+ * @addtogroup xlsim
+ * @{
+ */
+
+
+/*==================================================================================================
+*                                        INCLUDE FILES
+* 1) system and project includes
+* 2) needed interfaces from external units
+* 3) internal and external interfaces from this unit
+==================================================================================================*/
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <condition_variable>
+#include <cstdio>
+#include <cstring>
+#include <deque>
+#include <mutex>
+#include <optional>
+#include <thread>
+#include <windows.h>
+#include "vxlapi.h"
+#include "xlbitstream.h"
+#include "xlsim.h"
+
+
+/*==================================================================================================
+*                                       LOCAL FUNCTIONS
+==================================================================================================*/
+namespace
+{
+constexpr unsigned int CanFdEventSize = XL_CANFD_RX_EVENT_HEADER_SIZE + sizeof(XL_CAN_EV_RX_MSG);
+constexpr XLportHandle NoPort = XL_INVALID_PORTHANDLE;
+
+/** @brief Auto-reset event handed out by xlSetNotification */
+struct Notification
+{
+    std::mutex mutex{};
+    std::condition_variable signal{};
+    bool signaled{false};
+    int level{1};
+};
+
+struct Port
+{
+    bool open{false};
+    XLaccess accessMask{0};
+    XLaccess activeMask{0};
+    unsigned int interfaceVersion{XL_INTERFACE_VERSION};
+    std::size_t capacity{0};
+    std::deque<XLevent> events{};
+    std::deque<XLcanRxEvent> canFdEvents{};
+    bool overrun{false};
+    bool notificationEnabled{false};
+    Notification notification{};
+
+    [[nodiscard]] bool isCanFd() const { return interfaceVersion >= XL_INTERFACE_VERSION_V4; }
+    [[nodiscard]] std::size_t level() const { return isCanFd() ? canFdEvents.size() : events.size(); }
+};
+
+/** @brief Frame as it travels on the virtual bus, flags in the XL_CAN_RXMSG_FLAG_* encoding */
+struct Frame
+{
+    unsigned int canId{0};
+    unsigned int msgFlags{0};
+    unsigned char dlc{0};
+    std::array<unsigned char, XL_CAN_MAX_DATA_LEN> data{};
+    XLuint64 queuedAt{0};       //!< time of the write (ns), a paced frame does not start before
+};
+
+/** @brief Frame holding the paced bus until its last bit */
+struct BusFrame
+{
+    unsigned int channel{0};
+    Frame frame{};
+    XLuint64 end{0};
+};
+
+struct Simulator
+{
+    std::mutex mutex{};
+    unsigned int channelCount{XLSIM_DEFAULT_CHANNEL_COUNT};
+    bool driverOpen{false};
+    std::array<Port, XLSIM_MAX_PORTS> ports{};
+    std::array<XLportHandle, XL_CONFIG_MAX_CHANNELS> initAccess{};
+    bool acknowledge{true};
+    std::array<std::deque<Frame>, XL_CONFIG_MAX_CHANNELS> txQueues{};     //!< frames waiting for the bus or an acknowledge
+    std::chrono::steady_clock::time_point origin{std::chrono::steady_clock::now()};
+    std::array<unsigned int, XL_CONFIG_MAX_CHANNELS> bitRates{};
+    std::array<unsigned int, XL_CONFIG_MAX_CHANNELS> dataBitRates{};
+    bool paced{false};
+    XLuint64 busFreeAt{0};                                                //!< end of the last frame on the paced bus (ns)
+    std::optional<BusFrame> onBus{};
+    std::condition_variable busChanged{};
+    std::thread bus{};
+
+    Simulator()
+    {
+        bitRates.fill(XLSIM_DEFAULT_BITRATE);
+        dataBitRates.fill(XLSIM_DEFAULT_DATA_BITRATE);
+    }
+
+    Simulator(const Simulator&) = delete;
+    Simulator& operator=(const Simulator&) = delete;
+
+    ~Simulator()
+    {
+        {
+            std::lock_guard lock(mutex);
+            paced = false;
+        }
+        busChanged.notify_all();
+        if(bus.joinable())
+        {
+            bus.join();
+        }
+    }
+
+    [[nodiscard]] XLaccess channelsMask() const
+    {
+        return channelCount >= 64 ? ~XLaccess{0} : (XLaccess{1} << channelCount) - 1;
+    }
+
+    Port* port(XLportHandle portHandle)
+    {
+        if(portHandle < 0 || static_cast<std::size_t>(portHandle) >= ports.size() || !ports[portHandle].open)
+        {
+            return nullptr;
+        }
+        return &ports[portHandle];
+    }
+
+    [[nodiscard]] XLuint64 now() const
+    {
+        return static_cast<XLuint64>(std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - origin).count());
+    }
+};
+
+Simulator& simulator()
+{
+    static Simulator instance;
+    return instance;
+}
+
+void notify(Port& port)
+{
+    if(port.notificationEnabled && port.level() >= static_cast<std::size_t>(std::max(port.notification.level, 1)))
+    {
+        {
+            std::lock_guard lock(port.notification.mutex);
+            port.notification.signaled = true;
+        }
+        port.notification.signal.notify_one();
+    }
+}
+
+void push(Port& port, const XLevent& event)
+{
+    if(port.events.size() >= port.capacity)
+    {
+        port.overrun = true;
+        return;
+    }
+    auto& queued = port.events.emplace_back(event);
+    if(port.overrun)
+    {
+        queued.flags |= XL_EVENT_FLAG_OVERRUN;
+        port.overrun = false;
+    }
+    notify(port);
+}
+
+void push(Port& port, const XLcanRxEvent& event)
+{
+    if(port.canFdEvents.size() >= port.capacity)
+    {
+        port.overrun = true;
+        return;
+    }
+    auto& queued = port.canFdEvents.emplace_back(event);
+    if(port.overrun)
+    {
+        queued.flagsChip |= XL_CAN_QUEUE_OVERFLOW;
+        port.overrun = false;
+    }
+    notify(port);
+}
+
+/** @brief Bits of a frame from SOF to the end of the intermission, stuff bits included */
+FrameBits frameBitsOf(const Frame& frame)
+{
+    const bool extended = (frame.canId & XL_CAN_EXT_MSG_ID) != 0;
+    const auto id = frame.canId & ~XL_CAN_EXT_MSG_ID;
+    return (frame.msgFlags & XL_CAN_RXMSG_FLAG_EDL)
+               ? fdFrameBits(extended, (frame.msgFlags & XL_CAN_RXMSG_FLAG_BRS) != 0, false, id, frame.dlc, frame.data.data())
+               : classicFrameBits(extended, (frame.msgFlags & XL_CAN_RXMSG_FLAG_RTR) != 0, id, frame.dlc, frame.data.data());
+}
+
+/** @brief Bits of a frame from SOF to EOF, stuff bits included, as the driver counts them */
+unsigned int totalBitCount(const Frame& frame)
+{
+    const auto bits = frameBitsOf(frame);
+    // without the intermission
+    return bits.nominal + bits.data - 3;
+}
+
+/** @brief Arbitration field of a frame as a number, the lowest wins: base identifier, then IDE, then the extension */
+uint64 arbitrationKey(const Frame& frame)
+{
+    const auto id = frame.canId & ~XL_CAN_EXT_MSG_ID;
+    return (frame.canId & XL_CAN_EXT_MSG_ID) ? (uint64{id >> 18} << 19 | 1u << 18 | (id & 0x3FFFF)) : uint64{id} << 19;
+}
+
+void pushFrame(Port& port, unsigned int channel, bool transmitted, const Frame& frame, XLuint64 timeStamp)
+{
+    if(port.isCanFd())
+    {
+        XLcanRxEvent event{};
+        event.size = CanFdEventSize;
+        event.tag = transmitted ? XL_CAN_EV_TAG_TX_OK : XL_CAN_EV_TAG_RX_OK;
+        event.channelIndex = static_cast<unsigned short>(channel);
+        event.timeStampSync = timeStamp;
+        event.tagData.canRxOkMsg.canId = frame.canId;
+        event.tagData.canRxOkMsg.msgFlags = frame.msgFlags;
+        event.tagData.canRxOkMsg.dlc = frame.dlc;
+        event.tagData.canRxOkMsg.totalBitCnt = totalBitCount(frame);
+        std::memcpy(event.tagData.canRxOkMsg.data, frame.data.data(), frame.data.size());
+        push(port, event);
+    }
+    else if(!(frame.msgFlags & XL_CAN_RXMSG_FLAG_EDL))
+    {
+        XLevent event{};
+        event.tag = XL_RECEIVE_MSG;
+        event.chanIndex = static_cast<unsigned char>(channel);
+        event.timeStamp = timeStamp;
+        event.tagData.msg.id = frame.canId;
+        event.tagData.msg.flags = static_cast<unsigned short>((transmitted ? XL_CAN_MSG_FLAG_TX_COMPLETED : 0) |
+                                                              ((frame.msgFlags & XL_CAN_RXMSG_FLAG_RTR) ? XL_CAN_MSG_FLAG_REMOTE_FRAME : 0));
+        event.tagData.msg.dlc = frame.dlc;
+        std::memcpy(event.tagData.msg.data, frame.data.data(), MAX_MSG_LEN);
+        push(port, event);
+    }
+}
+
+/** @brief Put a frame on the bus: confirmed on the sending channel, received on all the others */
+void transmitFrame(Simulator& sim, unsigned int channel, const Frame& frame, XLuint64 timeStamp)
+{
+    for(auto& port : sim.ports)
+    {
+        if(!port.open)
+        {
+            continue;
+        }
+        for(unsigned int i = 0; i < sim.channelCount; ++i)
+        {
+            if(port.activeMask & (XLaccess{1} << i))
+            {
+                pushFrame(port, i, i == channel, frame, timeStamp);
+            }
+        }
+    }
+}
+
+/** @brief Transmit a frame, or queue it for the paced bus or while no node acknowledges, false when the queue is full */
+bool sendFrame(Simulator& sim, unsigned int channel, const Frame& frame)
+{
+    if(sim.acknowledge && !sim.paced)
+    {
+        transmitFrame(sim, channel, frame, sim.now());
+        return true;
+    }
+    auto& txQueue = sim.txQueues[channel];
+    if(txQueue.size() >= XLSIM_TX_QUEUE_SIZE)
+    {
+        return false;
+    }
+    txQueue.push_back(frame);
+    txQueue.back().queuedAt = sim.now();
+    sim.busChanged.notify_all();
+    return true;
+}
+
+/** @brief Transmit the waiting frames at once, in order */
+void transmitQueued(Simulator& sim)
+{
+    for(unsigned int i = 0; i < sim.txQueues.size(); ++i)
+    {
+        for(const auto& frame : sim.txQueues[i])
+        {
+            transmitFrame(sim, i, frame, sim.now());
+        }
+        sim.txQueues[i].clear();
+    }
+}
+
+/**
+ * @brief Paced bus: the frame on the bus is delivered at its end, then the waiting frame of the
+ *        lowest identifier starts once the bus is free
+ */
+void runBus(Simulator& sim)
+{
+    std::unique_lock lock(sim.mutex);
+    while(sim.paced)
+    {
+        const auto now = sim.now();
+        if(sim.onBus)
+        {
+            if(sim.onBus->end > now)
+            {
+                sim.busChanged.wait_until(lock, sim.origin + std::chrono::nanoseconds(sim.onBus->end));
+                continue;
+            }
+            transmitFrame(sim, sim.onBus->channel, sim.onBus->frame, sim.onBus->end);
+            sim.busFreeAt = sim.onBus->end;
+            sim.onBus.reset();
+        }
+        std::optional<unsigned int> winner{};
+        for(unsigned int i = 0; i < sim.channelCount; ++i)
+        {
+            if(!sim.txQueues[i].empty() && (!winner || arbitrationKey(sim.txQueues[i].front()) < arbitrationKey(sim.txQueues[*winner].front())))
+            {
+                winner = i;
+            }
+        }
+        if(!sim.acknowledge || !winner)
+        {
+            sim.busChanged.wait(lock);
+            continue;
+        }
+        auto& txQueue = sim.txQueues[*winner];
+        const auto start = std::max(txQueue.front().queuedAt, sim.busFreeAt);
+        const auto duration = frameBitsOf(txQueue.front()).durationNs(sim.bitRates[*winner], sim.dataBitRates[*winner]);
+        sim.onBus = BusFrame{*winner, txQueue.front(), start + duration};
+        txQueue.pop_front();
+    }
+}
+
+template<typename Function>
+void forEachChannel(const Simulator& sim, XLaccess accessMask, Function function)
+{
+    for(unsigned int i = 0; i < sim.channelCount; ++i)
+    {
+        if(accessMask & (XLaccess{1} << i))
+        {
+            function(i);
+        }
+    }
+}
+
+char* toString(const char* text)
+{
+    return const_cast<char*>(text);
+}
+}
+
+
+/*==================================================================================================
+*                                       GLOBAL FUNCTIONS
+==================================================================================================*/
+void xlSimSetChannelCount(unsigned int channelCount)
+{
+    auto& sim = simulator();
+    std::lock_guard lock(sim.mutex);
+    sim.channelCount = std::clamp(channelCount, 1u, static_cast<unsigned int>(XL_CONFIG_MAX_CHANNELS));
+}
+
+void xlSimSetAcknowledge(unsigned int acknowledge)
+{
+    auto& sim = simulator();
+    std::lock_guard lock(sim.mutex);
+    sim.acknowledge = acknowledge != 0;
+    if(!sim.acknowledge)
+    {
+        return;
+    }
+    if(sim.paced)
+    {
+        // the waiting frames take their bus time from now on
+        sim.busFreeAt = std::max(sim.busFreeAt, sim.now());
+        sim.busChanged.notify_all();
+        return;
+    }
+    transmitQueued(sim);
+}
+
+void xlSimSetBusTiming(unsigned int paced)
+{
+    auto& sim = simulator();
+    std::unique_lock lock(sim.mutex);
+    if((paced != 0) == sim.paced)
+    {
+        return;
+    }
+    sim.paced = paced != 0;
+    if(sim.paced)
+    {
+        sim.busFreeAt = sim.now();
+        sim.bus = std::thread(runBus, std::ref(sim));
+        return;
+    }
+    sim.busChanged.notify_all();
+    lock.unlock();
+    sim.bus.join();
+    lock.lock();
+    if(sim.onBus)
+    {
+        transmitFrame(sim, sim.onBus->channel, sim.onBus->frame, sim.now());
+        sim.onBus.reset();
+    }
+    if(sim.acknowledge)
+    {
+        transmitQueued(sim);
+    }
+}
+
+XLstatus xlSimInjectEvent(XLportHandle portHandle, const XLevent* pEvent)
+{
+    auto& sim = simulator();
+    std::lock_guard lock(sim.mutex);
+    auto* port = sim.port(portHandle);
+    if(port == nullptr || pEvent == nullptr || port->isCanFd())
+    {
+        return XL_ERR_WRONG_PARAMETER;
+    }
+    push(*port, *pEvent);
+    return XL_SUCCESS;
+}
+
+XLstatus xlSimInjectCanFdEvent(XLportHandle portHandle, const XLcanRxEvent* pEvent)
+{
+    auto& sim = simulator();
+    std::lock_guard lock(sim.mutex);
+    auto* port = sim.port(portHandle);
+    if(port == nullptr || pEvent == nullptr || !port->isCanFd())
+    {
+        return XL_ERR_WRONG_PARAMETER;
+    }
+    push(*port, *pEvent);
+    return XL_SUCCESS;
+}
+
+DWORD WaitForSingleObject(HANDLE hHandle, DWORD dwMilliseconds)
+{
+    auto* notification = static_cast<Notification*>(hHandle);
+    if(notification == nullptr)
+    {
+        return WAIT_FAILED;
+    }
+    std::unique_lock lock(notification->mutex);
+    const auto signaled = [notification]() { return notification->signaled; };
+    if(dwMilliseconds == INFINITE)
+    {
+        notification->signal.wait(lock, signaled);
+    }
+    else if(!notification->signal.wait_for(lock, std::chrono::milliseconds(dwMilliseconds), signaled))
+    {
+        return WAIT_TIMEOUT;
+    }
+    notification->signaled = false;
+    return WAIT_OBJECT_0;
+}
+
+XLstatus xlOpenDriver(void)
+{
+    auto& sim = simulator();
+    std::lock_guard lock(sim.mutex);
+    sim.driverOpen = true;
+    sim.initAccess.fill(NoPort);
+    return XL_SUCCESS;
+}
+
+XLstatus xlCloseDriver(void)
+{
+    auto& sim = simulator();
+    std::lock_guard lock(sim.mutex);
+    sim.driverOpen = false;
+    for(auto& port : sim.ports)
+    {
+        port.open = false;
+        port.events.clear();
+        port.canFdEvents.clear();
+    }
+    for(auto& txQueue : sim.txQueues)
+    {
+        txQueue.clear();
+    }
+    sim.onBus.reset();
+    return XL_SUCCESS;
+}
+
+XLstatus xlGetDriverConfig(XLdriverConfig* pDriverConfig)
+{
+    auto& sim = simulator();
+    std::lock_guard lock(sim.mutex);
+    if(pDriverConfig == nullptr)
+    {
+        return XL_ERR_WRONG_PARAMETER;
+    }
+    std::memset(pDriverConfig, 0, sizeof(*pDriverConfig));
+    pDriverConfig->channelCount = sim.channelCount;
+    for(unsigned int i = 0; i < sim.channelCount; ++i)
+    {
+        auto& channel = pDriverConfig->channel[i];
+        std::snprintf(channel.name, sizeof(channel.name), "Virtual Channel %u", i + 1);
+        std::snprintf(channel.transceiverName, sizeof(channel.transceiverName), "Virtual CAN");
+        channel.hwType = XL_HWTYPE_VIRTUAL;
+        channel.hwChannel = static_cast<unsigned char>(i);
+        channel.transceiverType = XL_TRANSCEIVER_TYPE_CAN_VIRTUAL;
+        channel.channelIndex = static_cast<unsigned char>(i);
+        channel.channelMask = XLaccess{1} << i;
+        channel.channelCapabilities = XL_CHANNEL_FLAG_CANFD_ISO_SUPPORT | XL_CHANNEL_FLAG_CANFD_BOSCH_SUPPORT;
+        channel.channelBusCapabilities = XL_BUS_ACTIVE_CAP_CAN | XL_BUS_COMPATIBLE_CAN;
+        channel.interfaceVersion = XL_INTERFACE_VERSION_V4;
+    }
+    return XL_SUCCESS;
+}
+
+XLstatus xlOpenPort(XLportHandle* pPortHandle, char* userName, XLaccess accessMask, XLaccess* pPermissionMask,
+                    unsigned int rxQueueSize, unsigned int xlInterfaceVersion, unsigned int busType)
+{
+    (void) userName;
+    auto& sim = simulator();
+    std::lock_guard lock(sim.mutex);
+    if(!sim.driverOpen)
+    {
+        return XL_ERR_CANNOT_OPEN_DRIVER;
+    }
+    if(pPortHandle == nullptr || busType != XL_BUS_TYPE_CAN || (accessMask & ~sim.channelsMask()) != 0)
+    {
+        return XL_ERR_WRONG_PARAMETER;
+    }
+    const auto free = std::ranges::find_if(sim.ports, [](const Port& port) { return !port.open; });
+    if(free == sim.ports.end())
+    {
+        return XL_ERR_NO_RESOURCES;
+    }
+    auto& port = *free;
+    const auto portHandle = static_cast<XLportHandle>(std::distance(sim.ports.begin(), free));
+    port.open = true;
+    port.accessMask = accessMask;
+    port.activeMask = 0;
+    port.interfaceVersion = xlInterfaceVersion;
+    port.capacity = std::max<std::size_t>(xlInterfaceVersion >= XL_INTERFACE_VERSION_V4 ? rxQueueSize / CanFdEventSize : rxQueueSize, 1);
+    port.events.clear();
+    port.canFdEvents.clear();
+    port.overrun = false;
+    port.notificationEnabled = false;
+
+    XLaccess granted = 0;
+    const auto wanted = pPermissionMask != nullptr ? *pPermissionMask & accessMask : 0;
+    forEachChannel(sim, wanted, [&](unsigned int i) {
+        if(sim.initAccess[i] == NoPort)
+        {
+            sim.initAccess[i] = portHandle;
+            granted |= XLaccess{1} << i;
+        }
+    });
+    if(pPermissionMask != nullptr)
+    {
+        *pPermissionMask = granted;
+    }
+    *pPortHandle = portHandle;
+    return XL_SUCCESS;
+}
+
+XLstatus xlClosePort(XLportHandle portHandle)
+{
+    auto& sim = simulator();
+    std::lock_guard lock(sim.mutex);
+    auto* port = sim.port(portHandle);
+    if(port == nullptr)
+    {
+        return XL_ERR_INVALID_PORT;
+    }
+    std::ranges::replace(sim.initAccess, portHandle, NoPort);
+    port->open = false;
+    port->activeMask = 0;
+    port->events.clear();
+    port->canFdEvents.clear();
+    return XL_SUCCESS;
+}
+
+XLstatus xlActivateChannel(XLportHandle portHandle, XLaccess accessMask, unsigned int busType, unsigned int flags)
+{
+    auto& sim = simulator();
+    std::lock_guard lock(sim.mutex);
+    auto* port = sim.port(portHandle);
+    if(port == nullptr)
+    {
+        return XL_ERR_INVALID_PORT;
+    }
+    if(busType != XL_BUS_TYPE_CAN)
+    {
+        return XL_ERR_WRONG_BUS_TYPE;
+    }
+    port->activeMask |= accessMask & port->accessMask;
+    if(flags & XL_ACTIVATE_RESET_CLOCK)
+    {
+        sim.origin = std::chrono::steady_clock::now();
+        sim.busFreeAt = 0;
+    }
+    return XL_SUCCESS;
+}
+
+XLstatus xlDeactivateChannel(XLportHandle portHandle, XLaccess accessMask)
+{
+    auto& sim = simulator();
+    std::lock_guard lock(sim.mutex);
+    auto* port = sim.port(portHandle);
+    if(port == nullptr)
+    {
+        return XL_ERR_INVALID_PORT;
+    }
+    port->activeMask &= ~accessMask;
+    // an offline controller drops its transmit queue
+    forEachChannel(sim, accessMask & port->accessMask, [&](unsigned int i) { sim.txQueues[i].clear(); });
+    return XL_SUCCESS;
+}
+
+XLstatus xlCanSetChannelBitrate(XLportHandle portHandle, XLaccess accessMask, XLulong bitrate)
+{
+    auto& sim = simulator();
+    std::lock_guard lock(sim.mutex);
+    if(sim.port(portHandle) == nullptr)
+    {
+        return XL_ERR_INVALID_PORT;
+    }
+    bool missing = false;
+    forEachChannel(sim, accessMask, [&](unsigned int i) { missing |= sim.initAccess[i] != portHandle; });
+    if(missing || bitrate == 0)
+    {
+        return missing ? XL_ERR_INIT_ACCESS_MISSING : XL_ERR_WRONG_PARAMETER;
+    }
+    forEachChannel(sim, accessMask, [&](unsigned int i) {
+        sim.bitRates[i] = static_cast<unsigned int>(bitrate);
+        sim.dataBitRates[i] = static_cast<unsigned int>(bitrate);
+    });
+    return XL_SUCCESS;
+}
+
+XLstatus xlCanFdSetConfiguration(XLportHandle portHandle, XLaccess accessMask, XLcanFdConf* pCanFdConf)
+{
+    auto& sim = simulator();
+    std::lock_guard lock(sim.mutex);
+    auto* port = sim.port(portHandle);
+    if(port == nullptr)
+    {
+        return XL_ERR_INVALID_PORT;
+    }
+    if(pCanFdConf == nullptr || pCanFdConf->arbitrationBitRate == 0)
+    {
+        return XL_ERR_WRONG_PARAMETER;
+    }
+    bool missing = false;
+    forEachChannel(sim, accessMask, [&](unsigned int i) { missing |= sim.initAccess[i] != portHandle; });
+    if(missing)
+    {
+        return XL_ERR_INIT_ACCESS_MISSING;
+    }
+    if(port->activeMask & accessMask)
+    {
+        return XL_ERR_CHAN_IS_ONLINE;
+    }
+    forEachChannel(sim, accessMask, [&](unsigned int i) {
+        sim.bitRates[i] = pCanFdConf->arbitrationBitRate;
+        sim.dataBitRates[i] = pCanFdConf->dataBitRate != 0 ? pCanFdConf->dataBitRate : pCanFdConf->arbitrationBitRate;
+    });
+    return XL_SUCCESS;
+}
+
+XLstatus xlCanSetChannelMode(XLportHandle portHandle, XLaccess accessMask, int tx, int txrq)
+{
+    (void) accessMask;
+    (void) tx;
+    (void) txrq;
+    auto& sim = simulator();
+    std::lock_guard lock(sim.mutex);
+    return sim.port(portHandle) != nullptr ? XL_SUCCESS : XL_ERR_INVALID_PORT;
+}
+
+XLstatus xlSetNotification(XLportHandle portHandle, XLhandle* pHandle, int queueLevel)
+{
+    auto& sim = simulator();
+    std::lock_guard lock(sim.mutex);
+    auto* port = sim.port(portHandle);
+    if(port == nullptr || pHandle == nullptr)
+    {
+        return XL_ERR_INVALID_PORT;
+    }
+    port->notification.level = queueLevel;
+    port->notificationEnabled = true;
+    *pHandle = &port->notification;
+    notify(*port);
+    return XL_SUCCESS;
+}
+
+XLstatus xlGetReceiveQueueLevel(XLportHandle portHandle, int* level)
+{
+    auto& sim = simulator();
+    std::lock_guard lock(sim.mutex);
+    auto* port = sim.port(portHandle);
+    if(port == nullptr || level == nullptr)
+    {
+        return XL_ERR_INVALID_PORT;
+    }
+    *level = static_cast<int>(port->level());
+    return XL_SUCCESS;
+}
+
+XLstatus xlFlushReceiveQueue(XLportHandle portHandle)
+{
+    auto& sim = simulator();
+    std::lock_guard lock(sim.mutex);
+    auto* port = sim.port(portHandle);
+    if(port == nullptr)
+    {
+        return XL_ERR_INVALID_PORT;
+    }
+    port->events.clear();
+    port->canFdEvents.clear();
+    return XL_SUCCESS;
+}
+
+XLstatus xlCanFlushTransmitQueue(XLportHandle portHandle, XLaccess accessMask)
+{
+    auto& sim = simulator();
+    std::lock_guard lock(sim.mutex);
+    auto* port = sim.port(portHandle);
+    if(port == nullptr)
+    {
+        return XL_ERR_INVALID_PORT;
+    }
+    forEachChannel(sim, accessMask & port->accessMask, [&](unsigned int i) { sim.txQueues[i].clear(); });
+    return XL_SUCCESS;
+}
+
+XLstatus xlCanRequestChipState(XLportHandle portHandle, XLaccess accessMask)
+{
+    auto& sim = simulator();
+    std::lock_guard lock(sim.mutex);
+    auto* port = sim.port(portHandle);
+    if(port == nullptr)
+    {
+        return XL_ERR_INVALID_PORT;
+    }
+    const auto timeStamp = sim.now();
+    forEachChannel(sim, accessMask & port->accessMask, [&](unsigned int i) {
+        if(port->isCanFd())
+        {
+            XLcanRxEvent event{};
+            event.size = XL_CANFD_RX_EVENT_HEADER_SIZE + sizeof(XL_CAN_EV_CHIP_STATE);
+            event.tag = XL_CAN_EV_TAG_CHIP_STATE;
+            event.channelIndex = static_cast<unsigned short>(i);
+            event.timeStampSync = timeStamp;
+            event.tagData.canChipState.busStatus = XL_CHIPSTAT_ERROR_ACTIVE;
+            push(*port, event);
+        }
+        else
+        {
+            XLevent event{};
+            event.tag = XL_CHIP_STATE;
+            event.chanIndex = static_cast<unsigned char>(i);
+            event.timeStamp = timeStamp;
+            event.tagData.chipState.busStatus = XL_CHIPSTAT_ERROR_ACTIVE;
+            push(*port, event);
+        }
+    });
+    return XL_SUCCESS;
+}
+
+XLstatus xlCanTransmit(XLportHandle portHandle, XLaccess accessMask, unsigned int* pEventCount, void* pEvents)
+{
+    auto& sim = simulator();
+    std::lock_guard lock(sim.mutex);
+    auto* port = sim.port(portHandle);
+    if(port == nullptr)
+    {
+        return XL_ERR_INVALID_PORT;
+    }
+    if(pEventCount == nullptr || pEvents == nullptr)
+    {
+        return XL_ERR_WRONG_PARAMETER;
+    }
+    if((accessMask & port->activeMask) == 0)
+    {
+        return XL_ERR_INVALID_ACCESS;
+    }
+    const auto* events = static_cast<const XLevent*>(pEvents);
+    for(unsigned int n = 0; n < *pEventCount; ++n)
+    {
+        const auto& msg = events[n].tagData.msg;
+        Frame frame{};
+        frame.canId = msg.id;
+        frame.msgFlags = (msg.flags & XL_CAN_MSG_FLAG_REMOTE_FRAME) ? XL_CAN_RXMSG_FLAG_RTR : 0;
+        frame.dlc = static_cast<unsigned char>(std::min<unsigned short>(msg.dlc, MAX_MSG_LEN));
+        std::memcpy(frame.data.data(), msg.data, MAX_MSG_LEN);
+        bool queued = true;
+        forEachChannel(sim, accessMask & port->activeMask, [&](unsigned int i) { queued &= sendFrame(sim, i, frame); });
+        if(!queued)
+        {
+            *pEventCount = n;
+            return XL_ERR_QUEUE_IS_FULL;
+        }
+    }
+    return XL_SUCCESS;
+}
+
+XLstatus xlCanTransmitEx(XLportHandle portHandle, XLaccess accessMask, unsigned int msgCnt, unsigned int* pMsgCntSent, XLcanTxEvent* pXlCanTxEvt)
+{
+    auto& sim = simulator();
+    std::lock_guard lock(sim.mutex);
+    auto* port = sim.port(portHandle);
+    if(port == nullptr)
+    {
+        return XL_ERR_INVALID_PORT;
+    }
+    if(pMsgCntSent == nullptr || pXlCanTxEvt == nullptr)
+    {
+        return XL_ERR_WRONG_PARAMETER;
+    }
+    if((accessMask & port->activeMask) == 0)
+    {
+        return XL_ERR_INVALID_ACCESS;
+    }
+    for(unsigned int n = 0; n < msgCnt; ++n)
+    {
+        const auto& msg = pXlCanTxEvt[n].tagData.canMsg;
+        if(pXlCanTxEvt[n].tag != XL_CAN_EV_TAG_TX_MSG)
+        {
+            *pMsgCntSent = n;
+            return XL_ERR_INVALID_TAG;
+        }
+        if((msg.msgFlags & XL_CAN_TXMSG_FLAG_EDL) && (msg.msgFlags & XL_CAN_TXMSG_FLAG_RTR))
+        {
+            *pMsgCntSent = n;
+            return XL_ERR_EDL_RTR;
+        }
+        Frame frame{};
+        frame.canId = msg.canId;
+        frame.msgFlags = ((msg.msgFlags & XL_CAN_TXMSG_FLAG_EDL) ? XL_CAN_RXMSG_FLAG_EDL : 0u) |
+                         ((msg.msgFlags & XL_CAN_TXMSG_FLAG_BRS) ? XL_CAN_RXMSG_FLAG_BRS : 0u) |
+                         ((msg.msgFlags & XL_CAN_TXMSG_FLAG_RTR) ? XL_CAN_RXMSG_FLAG_RTR : 0u);
+        frame.dlc = static_cast<unsigned char>(msg.dlc & 0x0F);
+        std::memcpy(frame.data.data(), msg.data, frame.data.size());
+        bool queued = true;
+        forEachChannel(sim, accessMask & port->activeMask, [&](unsigned int i) { queued &= sendFrame(sim, i, frame); });
+        if(!queued)
+        {
+            *pMsgCntSent = n;
+            return XL_ERR_QUEUE_IS_FULL;
+        }
+    }
+    *pMsgCntSent = msgCnt;
+    return XL_SUCCESS;
+}
+
+XLstatus xlReceive(XLportHandle portHandle, unsigned int* pEventCount, XLevent* pEvents)
+{
+    auto& sim = simulator();
+    std::lock_guard lock(sim.mutex);
+    auto* port = sim.port(portHandle);
+    if(port == nullptr)
+    {
+        return XL_ERR_INVALID_PORT;
+    }
+    if(pEventCount == nullptr || pEvents == nullptr)
+    {
+        return XL_ERR_WRONG_PARAMETER;
+    }
+    unsigned int count = 0;
+    while(count < *pEventCount && !port->events.empty())
+    {
+        pEvents[count++] = port->events.front();
+        port->events.pop_front();
+    }
+    *pEventCount = count;
+    return count == 0 ? XL_ERR_QUEUE_IS_EMPTY : XL_SUCCESS;
+}
+
+XLstatus xlCanReceive(XLportHandle portHandle, XLcanRxEvent* pXlCanRxEvt)
+{
+    auto& sim = simulator();
+    std::lock_guard lock(sim.mutex);
+    auto* port = sim.port(portHandle);
+    if(port == nullptr)
+    {
+        return XL_ERR_INVALID_PORT;
+    }
+    if(pXlCanRxEvt == nullptr)
+    {
+        return XL_ERR_WRONG_PARAMETER;
+    }
+    if(port->canFdEvents.empty())
+    {
+        return XL_ERR_QUEUE_IS_EMPTY;
+    }
+    *pXlCanRxEvt = port->canFdEvents.front();
+    port->canFdEvents.pop_front();
+    return XL_SUCCESS;
+}
+
+XLstringType xlGetErrorString(XLstatus err)
+{
+    switch(err)
+    {
+        case XL_SUCCESS:                    return toString("XL_SUCCESS");
+        case XL_ERR_QUEUE_IS_EMPTY:         return toString("XL_ERR_QUEUE_IS_EMPTY");
+        case XL_ERR_QUEUE_IS_FULL:          return toString("XL_ERR_QUEUE_IS_FULL");
+        case XL_ERR_TX_NOT_POSSIBLE:        return toString("XL_ERR_TX_NOT_POSSIBLE");
+        case XL_ERR_WRONG_PARAMETER:        return toString("XL_ERR_WRONG_PARAMETER");
+        case XL_ERR_INVALID_ACCESS:         return toString("XL_ERR_INVALID_ACCESS");
+        case XL_ERR_CHAN_IS_ONLINE:         return toString("XL_ERR_CHAN_IS_ONLINE");
+        case XL_ERR_INVALID_PORT:           return toString("XL_ERR_INVALID_PORT");
+        case XL_ERR_INVALID_TAG:            return toString("XL_ERR_INVALID_TAG");
+        case XL_ERR_NO_RESOURCES:           return toString("XL_ERR_NO_RESOURCES");
+        case XL_ERR_INIT_ACCESS_MISSING:    return toString("XL_ERR_INIT_ACCESS_MISSING");
+        case XL_ERR_CANNOT_OPEN_DRIVER:     return toString("XL_ERR_CANNOT_OPEN_DRIVER");
+        case XL_ERR_WRONG_BUS_TYPE:         return toString("XL_ERR_WRONG_BUS_TYPE");
+        case XL_ERR_EDL_RTR:                return toString("XL_ERR_EDL_RTR");
+        case XL_ERROR:                      return toString("XL_ERROR");
+        default:                            return toString("XL_ERR_UNKNOWN");
+    }
+}
+
+XLstringType xlGetEventString(XLevent* pEv)
+{
+    thread_local char text[128];
+    if(pEv->tag == XL_RECEIVE_MSG)
+    {
+        const auto& msg = pEv->tagData.msg;
+        std::snprintf(text, sizeof(text), "RX_MSG c=%u, t=%llu, id=%04X l=%u, %02X%02X%02X%02X%02X%02X%02X%02X %s",
+                      pEv->chanIndex, static_cast<unsigned long long>(pEv->timeStamp), msg.id, msg.dlc,
+                      msg.data[0], msg.data[1], msg.data[2], msg.data[3], msg.data[4], msg.data[5], msg.data[6], msg.data[7],
+                      (msg.flags & XL_CAN_MSG_FLAG_TX_COMPLETED) ? "TX" : "");
+    }
+    else
+    {
+        std::snprintf(text, sizeof(text), "EVENT tag=%u c=%u, t=%llu", pEv->tag, pEv->chanIndex, static_cast<unsigned long long>(pEv->timeStamp));
+    }
+    return text;
+}
+
+XLstringType xlCanGetEventString(XLcanRxEvent* pEv)
+{
+    thread_local char text[128];
+    if(pEv->tag == XL_CAN_EV_TAG_RX_OK || pEv->tag == XL_CAN_EV_TAG_TX_OK)
+    {
+        const auto& msg = pEv->tagData.canRxOkMsg;
+        std::snprintf(text, sizeof(text), "%s c=%u, t=%llu, id=%X, dlc=%u, flags=%X",
+                      pEv->tag == XL_CAN_EV_TAG_RX_OK ? "RX_OK" : "TX_OK", pEv->channelIndex,
+                      static_cast<unsigned long long>(pEv->timeStampSync), msg.canId, msg.dlc, msg.msgFlags);
+    }
+    else
+    {
+        std::snprintf(text, sizeof(text), "EVENT tag=%X c=%u, t=%llu", pEv->tag, pEv->channelIndex, static_cast<unsigned long long>(pEv->timeStampSync));
+    }
+    return text;
+}
+
+/**@} */ // END OF addtogroup xlsim
@@ -0,0 +1,258 @@
+"""
+Import the Can driver configuration of an ECU extract into the YAML description of can_xldriver_cfg.py.
+
+The ARXML files are read with a streaming (SAX) parser: only the containers of the Can module that
+configure this adapter are kept (CanController, CanControllerBaudrateConfig,
+CanControllerFdBaudrateConfig, CanHardwareObject and CanHwFilter), everything else is skipped as it
+is read. The memory used depends on the size of the Can configuration, not of the extract. An
+extract split in several files can be read in parallel (--jobs), the references between the
+containers are resolved once all the files are read.
+
+The XL channel of a controller is its CanControllerId unless --channel maps it explicitly. Mode
+indications are polled, like the Can_MainFunction_Mode of an AUTOSAR driver, MIXED processing is
+polled as well.
+"""
+import argparse
+import multiprocessing
+import os
+import resource
+import sys
+import time
+import xml.parsers.expat
+
+# containers kept, by the last element of their DEFINITION-REF
+CONTAINERS = {"CanController", "CanControllerBaudrateConfig", "CanControllerFdBaudrateConfig", "CanHardwareObject", "CanHwFilter"}
+# elements whose SHORT-NAME is part of the path of a container
+IDENTIFIABLES = {"AR-PACKAGE", "ECUC-MODULE-CONFIGURATION-VALUES", "ECUC-CONTAINER-VALUE"}
+PARAMETERS = {"ECUC-NUMERICAL-PARAM-VALUE", "ECUC-TEXTUAL-PARAM-VALUE", "ECUC-REFERENCE-VALUE"}
+CAPTURED = {"SHORT-NAME", "DEFINITION-REF", "VALUE", "VALUE-REF"}
+STANDARD_MASK = 0x7FF
+EXTENDED_MASK = 0x1FFFFFFF
+
+
+class Frame:
+    __slots__ = ("tag", "name", "kind", "parameters", "children")
+
+    def __init__(self, tag):
+        self.tag = tag
+        self.name = None
+        self.kind = None
+        self.parameters = {}
+        self.children = []
+
+
+class CanConfigHandler:
+    """Expat handler keeping the path of the current container and the parameters of the kept ones."""
+
+    def __init__(self, parser):
+        self.parser = parser
+        self.skipped = 0
+        self.frames = []
+        self.path = []
+        self.text = None
+        self.parameter = None
+        self.controllers = {}
+        self.hohs = []
+
+    def start(self, tag, attributes):
+        if tag in IDENTIFIABLES:
+            self.frames.append(Frame(tag))
+        elif tag in PARAMETERS and self.frames and self.frames[-1].kind is not None:
+            self.parameter = [None, None]
+        elif tag in CAPTURED:
+            self.text = []
+            self.parser.CharacterDataHandler = self.text.append
+
+    def end(self, tag):
+        if tag in CAPTURED:
+            self.parser.CharacterDataHandler = None
+            self.captured(tag, "".join(self.text).strip() if self.text is not None else "")
+            self.text = None
+        elif tag in PARAMETERS:
+            if self.parameter is not None and self.parameter[0] is not None:
+                self.frames[-1].parameters[self.parameter[0]] = self.parameter[1]
+            self.parameter = None
+        elif tag in IDENTIFIABLES:
+            frame = self.frames.pop()
+            if frame.name is not None:
+                self.path.pop()
+            self.closed(frame)
+
+    def captured(self, tag, text):
+        if not self.frames:
+            return
+        frame = self.frames[-1]
+        if self.parameter is not None:
+            if tag == "DEFINITION-REF":
+                self.parameter[0] = text.rsplit("/", 1)[-1]
+            elif tag in ("VALUE", "VALUE-REF"):
+                self.parameter[1] = text
+        elif tag == "SHORT-NAME" and frame.name is None:
+            frame.name = text
+            self.path.append(text)
+        elif tag == "DEFINITION-REF" and frame.tag == "ECUC-CONTAINER-VALUE" and frame.kind is None:
+            kind = text.rsplit("/", 1)[-1]
+            frame.kind = kind if kind in CONTAINERS else None
+        elif tag == "DEFINITION-REF" and frame.tag == "ECUC-MODULE-CONFIGURATION-VALUES" and not text.endswith("/Can"):
+            # the other modules are the bulk of an extract: only their nesting is followed until they end
+            self.skipped = 1
+            self.parser.StartElementHandler = self.skip_start
+            self.parser.EndElementHandler = self.skip_end
+
+    def skip_start(self, tag, attributes):
+        self.skipped += 1
+
+    def skip_end(self, tag):
+        self.skipped -= 1
+        if self.skipped == 0:
+            self.parser.StartElementHandler = self.start
+            self.parser.EndElementHandler = self.end
+            self.end(tag)
+
+    def closed(self, frame):
+        if frame.kind is None:
+            return
+        parent = self.frames[-1] if self.frames else None
+        record = {"path": "/" + "/".join(self.path + [frame.name]), "name": frame.name,
+                  "parameters": frame.parameters, "children": frame.children}
+        if frame.kind == "CanController":
+            self.controllers[record["path"]] = record
+        elif frame.kind == "CanHardwareObject":
+            self.hohs.append(record)
+        elif parent is not None and parent.kind is not None:
+            parent.children.append((frame.kind, record))
+
+
+def parse(path):
+    parser = xml.parsers.expat.ParserCreate()
+    parser.buffer_text = True
+    parser.buffer_size = 1 << 20
+    handler = CanConfigHandler(parser)
+    parser.StartElementHandler = handler.start
+    parser.EndElementHandler = handler.end
+    with open(path, "rb") as stream:
+        parser.ParseFile(stream)
+    return handler.controllers, handler.hohs
+
+
+def number(value, default=0):
+    if value is None or value == "":
+        return default
+    return int(value, 0) if not any(c in value for c in ".eE") or value.lower().startswith("0x") else int(float(value))
+
+
+def kbps(value):
+    return int(round(float(value) * 1000))
+
+
+def flag(value):
+    return value is not None and value.lower() in ("true", "1")
+
+
+def processing(value):
+    return "interrupt" if value is None or value.upper() == "INTERRUPT" else "polling"
+
+
+def to_description(controllers, hohs, channels, polling_queue_size):
+    description = {"pollingQueueSize": polling_queue_size, "controllers": []}
+    ordered = sorted(controllers.values(), key=lambda record: number(record["parameters"].get("CanControllerId"), 0))
+    for record in ordered:
+        parameters = record["parameters"]
+        baudrates = sorted((child for kind, child in record["children"] if kind == "CanControllerBaudrateConfig"),
+                           key=lambda child: number(child["parameters"].get("CanControllerBaudRateConfigID"), 0))
+        entries = []
+        brs = False
+        for baudrate in baudrates:
+            entry = {"baudRate": kbps(baudrate["parameters"].get("CanControllerBaudRate", "500"))}
+            for kind, fd in baudrate["children"]:
+                if kind == "CanControllerFdBaudrateConfig":
+                    entry["fdBaudRate"] = kbps(fd["parameters"].get("CanControllerFdBaudRate", "0"))
+                    brs |= flag(fd["parameters"].get("CanControllerTxBitRateSwitch"))
+            entries.append(entry)
+        if not entries:
+            raise SystemExit(f"{record['path']}: no CanControllerBaudrateConfig")
+        default = parameters.get("CanControllerDefaultBaudrate")
+        paths = [baudrate["path"] for baudrate in baudrates]
+        controller = {
+            "name": record["name"],
+            "channel": channels.get(record["name"], number(parameters.get("CanControllerId"), len(description["controllers"]))),
+            "baudrates": entries,
+            "defaultBaudrate": paths.index(default) if default in paths else 0,
+            "processing": {
+                "rx": processing(parameters.get("CanRxProcessing")),
+                "tx": processing(parameters.get("CanTxProcessing")),
+                "busOff": processing(parameters.get("CanBusoffProcessing")),
+                "mode": "polling",
+            },
+            "hths": [],
+            "hrhs": [],
+        }
+        for hoh in sorted((hoh for hoh in hohs if hoh["parameters"].get("CanControllerRef") == record["path"]),
+                          key=lambda hoh: number(hoh["parameters"].get("CanObjectId"), 0)):
+            hoh_parameters = hoh["parameters"]
+            id_type = hoh_parameters.get("CanIdType", "STANDARD").lower()
+            if hoh_parameters.get("CanObjectType", "RECEIVE").upper() == "TRANSMIT":
+                controller["hths"].append({"idType": id_type, "brs": brs, "count": number(hoh_parameters.get("CanHwObjectCount"), 1)})
+                continue
+            mask = STANDARD_MASK if id_type == "standard" else EXTENDED_MASK
+            filters = [child["parameters"] for kind, child in hoh["children"] if kind == "CanHwFilter"] or [{}]
+            for hw_filter in filters:
+                code = number(hw_filter.get("CanHwFilterCode"), 0)
+                filter_mask = number(hw_filter.get("CanHwFilterMask"), 0)
+                if hoh_parameters.get("CanHandleType", "BASIC").upper() == "FULL" and id_type != "mixed" and filter_mask & mask == mask:
+                    controller["hrhs"].append({"idType": id_type, "canId": code & mask})
+                else:
+                    controller["hrhs"].append({"idType": id_type, "filterCode": code & filter_mask & mask, "filterMask": filter_mask & mask})
+        description["controllers"].append(controller)
+    return description
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__, formatter_class=argparse.RawDescriptionHelpFormatter)
+    parser.add_argument("arxml", nargs="+", help="ARXML files of the ECU extract")
+    parser.add_argument("--output", required=True, help="YAML description written for tools/can_xldriver_cfg.py")
+    parser.add_argument("--jobs", type=int, default=1, help="files parsed in parallel (default 1)")
+    parser.add_argument("--channel", action="append", default=[], metavar="NAME=INDEX", help="XL channel of a controller, by short name")
+    parser.add_argument("--polling-queue-size", type=int, default=256, help="pollingQueueSize of the description (default 256)")
+    parser.add_argument("--stats", action="store_true", help="print the parse time and the peak memory")
+    args = parser.parse_args()
+
+    channels = {}
+    for mapping in args.channel:
+        name, _, index = mapping.partition("=")
+        channels[name] = int(index, 0)
+
+    start = time.perf_counter()
+    if args.jobs > 1 and len(args.arxml) > 1:
+        with multiprocessing.Pool(min(args.jobs, len(args.arxml))) as pool:
+            results = pool.map(parse, args.arxml)
+    else:
+        results = [parse(path) for path in args.arxml]
+    parsed = time.perf_counter()
+
+    controllers = {}
+    hohs = []
+    for file_controllers, file_hohs in results:
+        controllers.update(file_controllers)
+        hohs += file_hohs
+    if not controllers:
+        raise SystemExit("no CanController found")
+    description = to_description(controllers, hohs, channels, args.polling_queue_size)
+
+    import yaml
+    with open(args.output, "w") as output:
+        output.write(f"# Imported by tools/arxml_can_import.py from {', '.join(os.path.basename(p) for p in args.arxml)}\n")
+        yaml.safe_dump(description, output, sort_keys=False, default_flow_style=None, width=160)
+
+    if args.stats:
+        size = sum(os.path.getsize(path) for path in args.arxml) / 1e6
+        elapsed = parsed - start
+        # ru_maxrss is in kB on Linux, the workers report through RUSAGE_CHILDREN
+        peak = max(resource.getrusage(resource.RUSAGE_SELF).ru_maxrss, resource.getrusage(resource.RUSAGE_CHILDREN).ru_maxrss) / 1024
+        print(f"- Parse            : {len(args.arxml)} files, {size:.1f} MB in {elapsed:.2f} s, {size / elapsed:.1f} MB/s, {args.jobs} jobs", file=sys.stderr)
+        print(f"- Configuration    : {len(controllers)} controllers, {len(hohs)} hardware objects", file=sys.stderr)
+        print(f"- Peak RSS         : {peak:.1f} MB", file=sys.stderr)
+
+
+if __name__ == "__main__":
+    main()
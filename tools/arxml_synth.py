@@ -0,0 +1,153 @@
+"""
+Synthesize a large ECU extract to benchmark tools/arxml_can_import.py.
+
+The Can module configures --controllers controllers with --hrhs FULL receive objects and --hths
+transmit objects each, the rest of the extract (up to --size-mb) is made of Com I-PDU containers
+like the bulk of a real extract. With --split the extract is written as several files, the Can
+module in the first one, to exercise the parallel pass of the importer.
+"""
+import argparse
+import os
+import random
+
+HEADER = """<?xml version="1.0" encoding="UTF-8"?>
+<AUTOSAR xmlns="http://autosar.org/schema/r4.0" xmlns:xsi="http://www.w3.org/2001/XMLSchema-instance">
+  <AR-PACKAGES>
+    <AR-PACKAGE>
+      <SHORT-NAME>Ecu</SHORT-NAME>
+      <ELEMENTS>
+"""
+FOOTER = """      </ELEMENTS>
+    </AR-PACKAGE>
+  </AR-PACKAGES>
+</AUTOSAR>
+"""
+DEFS = "/AUTOSAR/EcucDefs"
+
+
+def numerical(definition, value):
+    return (f"<ECUC-NUMERICAL-PARAM-VALUE><DEFINITION-REF DEST=\"ECUC-INTEGER-PARAM-DEF\">{definition}</DEFINITION-REF>"
+            f"<VALUE>{value}</VALUE></ECUC-NUMERICAL-PARAM-VALUE>\n")
+
+
+def textual(definition, value):
+    return (f"<ECUC-TEXTUAL-PARAM-VALUE><DEFINITION-REF DEST=\"ECUC-ENUMERATION-PARAM-DEF\">{definition}</DEFINITION-REF>"
+            f"<VALUE>{value}</VALUE></ECUC-TEXTUAL-PARAM-VALUE>\n")
+
+
+def reference(definition, value):
+    return (f"<ECUC-REFERENCE-VALUE><DEFINITION-REF DEST=\"ECUC-REFERENCE-DEF\">{definition}</DEFINITION-REF>"
+            f"<VALUE-REF DEST=\"ECUC-CONTAINER-VALUE\">{value}</VALUE-REF></ECUC-REFERENCE-VALUE>\n")
+
+
+def container(name, definition, parameters="", references="", children=""):
+    text = f"<ECUC-CONTAINER-VALUE><SHORT-NAME>{name}</SHORT-NAME><DEFINITION-REF DEST=\"ECUC-PARAM-CONF-CONTAINER-DEF\">{definition}</DEFINITION-REF>\n"
+    if parameters:
+        text += f"<PARAMETER-VALUES>\n{parameters}</PARAMETER-VALUES>\n"
+    if references:
+        text += f"<REFERENCE-VALUES>\n{references}</REFERENCE-VALUES>\n"
+    if children:
+        text += f"<SUB-CONTAINERS>\n{children}</SUB-CONTAINERS>\n"
+    return text + "</ECUC-CONTAINER-VALUE>\n"
+
+
+def module(name, definition, containers):
+    yield f"<ECUC-MODULE-CONFIGURATION-VALUES><SHORT-NAME>{name}</SHORT-NAME><DEFINITION-REF DEST=\"ECUC-MODULE-DEF\">{definition}</DEFINITION-REF>\n<CONTAINERS>\n"
+    yield from containers
+    yield "</CONTAINERS>\n</ECUC-MODULE-CONFIGURATION-VALUES>\n"
+
+
+def can_containers(controllers, hrhs, hths, rng):
+    config_set = "/Ecu/Can/CanConfigSet"
+    children = []
+    for index in range(controllers):
+        name = f"CanController_{index}"
+        rate_def = f"{DEFS}/Can/CanConfigSet/CanController/CanControllerBaudrateConfig"
+        fd = container("CanControllerFdBaudrateConfig", f"{rate_def}/CanControllerFdBaudrateConfig",
+                       numerical(f"{rate_def}/CanControllerFdBaudrateConfig/CanControllerFdBaudRate", 2000)
+                       + textual(f"{rate_def}/CanControllerFdBaudrateConfig/CanControllerTxBitRateSwitch", "true"))
+        rates = (container("Baudrate_500k_2M", rate_def, numerical(f"{rate_def}/CanControllerBaudRate", 500)
+                           + numerical(f"{rate_def}/CanControllerBaudRateConfigID", 0), children=fd)
+                 + container("Baudrate_500k", rate_def, numerical(f"{rate_def}/CanControllerBaudRate", 500)
+                             + numerical(f"{rate_def}/CanControllerBaudRateConfigID", 1)))
+        controller_def = f"{DEFS}/Can/CanConfigSet/CanController"
+        children.append(container(name, controller_def,
+                                  numerical(f"{controller_def}/CanControllerId", index)
+                                  + textual(f"{controller_def}/CanRxProcessing", "INTERRUPT" if index % 2 == 0 else "POLLING")
+                                  + textual(f"{controller_def}/CanTxProcessing", "INTERRUPT" if index % 2 == 0 else "POLLING")
+                                  + textual(f"{controller_def}/CanBusoffProcessing", "INTERRUPT"),
+                                  reference(f"{controller_def}/CanControllerDefaultBaudrate", f"{config_set}/{name}/Baudrate_500k_2M"),
+                                  rates))
+    hoh_def = f"{DEFS}/Can/CanConfigSet/CanHardwareObject"
+    object_id = 0
+    for index in range(controllers):
+        standard = rng.sample(range(0x001, 0x7FF), min(hrhs // 2, 0x7FE))
+        extended = rng.sample(range(0x800, 0x1FFFFFFF), hrhs - len(standard))
+        for can_id, id_type in [(i, "STANDARD") for i in standard] + [(i, "EXTENDED") for i in extended]:
+            mask = 0x7FF if id_type == "STANDARD" else 0x1FFFFFFF
+            hw_filter = container("Filter", f"{hoh_def}/CanHwFilter",
+                                  numerical(f"{hoh_def}/CanHwFilter/CanHwFilterCode", can_id)
+                                  + numerical(f"{hoh_def}/CanHwFilter/CanHwFilterMask", mask))
+            children.append(container(f"Hrh_{object_id}", hoh_def,
+                                      numerical(f"{hoh_def}/CanObjectId", object_id) + textual(f"{hoh_def}/CanObjectType", "RECEIVE")
+                                      + textual(f"{hoh_def}/CanHandleType", "FULL") + textual(f"{hoh_def}/CanIdType", id_type),
+                                      reference(f"{hoh_def}/CanControllerRef", f"{config_set}/CanController_{index}"), hw_filter))
+            object_id += 1
+    for index in range(controllers):
+        for _ in range(hths):
+            children.append(container(f"Hth_{object_id}", hoh_def,
+                                      numerical(f"{hoh_def}/CanObjectId", object_id) + textual(f"{hoh_def}/CanObjectType", "TRANSMIT")
+                                      + textual(f"{hoh_def}/CanHandleType", "FULL") + textual(f"{hoh_def}/CanIdType", "MIXED"),
+                                      reference(f"{hoh_def}/CanControllerRef", f"{config_set}/CanController_{index}")))
+            object_id += 1
+    yield container("CanConfigSet", f"{DEFS}/Can/CanConfigSet", children="".join(children))
+
+
+def com_containers(first, count):
+    ipdu_def = f"{DEFS}/Com/ComConfig/ComIPdu"
+    for index in range(first, first + count):
+        signals = "".join(container(f"Signal_{index}_{signal}", f"{DEFS}/Com/ComConfig/ComSignal",
+                                    numerical(f"{DEFS}/Com/ComConfig/ComSignal/ComBitPosition", signal * 8)
+                                    + numerical(f"{DEFS}/Com/ComConfig/ComSignal/ComBitSize", 8)
+                                    + textual(f"{DEFS}/Com/ComConfig/ComSignal/ComSignalType", "UINT8"))
+                          for signal in range(8))
+        yield container(f"IPdu_{index}", ipdu_def,
+                        numerical(f"{ipdu_def}/ComIPduHandleId", index) + textual(f"{ipdu_def}/ComIPduDirection", "RECEIVE"),
+                        reference(f"{ipdu_def}/ComPduIdRef", f"/Ecu/EcuC/Pdus/Pdu_{index}"), signals)
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__, formatter_class=argparse.RawDescriptionHelpFormatter)
+    parser.add_argument("--size-mb", type=float, default=200, help="size of the whole extract (default 200 MB)")
+    parser.add_argument("--controllers", type=int, default=8, help="CAN controllers (default 8)")
+    parser.add_argument("--hrhs", type=int, default=512, help="FULL receive objects per controller (default 512)")
+    parser.add_argument("--hths", type=int, default=64, help="transmit objects per controller (default 64)")
+    parser.add_argument("--split", type=int, default=1, help="files of the extract (default 1)")
+    parser.add_argument("--seed", type=int, default=1, help="seed of the synthesized identifiers")
+    parser.add_argument("--output", required=True, help="ARXML file, Ecu_<n>.arxml files in this directory with --split")
+    args = parser.parse_args()
+
+    rng = random.Random(args.seed)
+    paths = [args.output] if args.split <= 1 else [os.path.join(args.output, f"Ecu_{n}.arxml") for n in range(args.split)]
+    if args.split > 1:
+        os.makedirs(args.output, exist_ok=True)
+    budget = int(args.size_mb * 1e6 / len(paths))
+    ipdu = 0
+    for n, path in enumerate(paths):
+        with open(path, "w") as output:
+            output.write(HEADER)
+            if n == 0:
+                for text in module("Can", f"{DEFS}/Can", can_containers(args.controllers, args.hrhs, args.hths, rng)):
+                    output.write(text)
+            # streamed by blocks of I-PDUs, the synthesized extract is never held in memory
+            output.write(f"<ECUC-MODULE-CONFIGURATION-VALUES><SHORT-NAME>Com_{n}</SHORT-NAME><DEFINITION-REF DEST=\"ECUC-MODULE-DEF\">{DEFS}/Com</DEFINITION-REF>\n<CONTAINERS>\n")
+            while output.tell() < budget:
+                for text in com_containers(ipdu, 256):
+                    output.write(text)
+                ipdu += 256
+            output.write("</CONTAINERS>\n</ECUC-MODULE-CONFIGURATION-VALUES>\n")
+            output.write(FOOTER)
+
+
+if __name__ == "__main__":
+    main()
@@ -0,0 +1,360 @@
+"""
+Generate the configuration of the Can driver (include/Can_XLdriver.h) as constexpr tables.
+
+The description is a YAML file:
+
+    appName: xlCANdemo              # optional, application name of the XL port
+    rxQueueSize: 16384              # optional, XL receive queue size
+    rxBusLoad: 80                   # optional, bus load (%) sizing the XL receive queue without rxQueueSize
+    pollingQueueSize: 256           # events kept per polled controller between two main functions
+    rxTimeoutNotification: App_RxTimeout # optional, function called with each missed deadline
+    txTimeoutNotification: App_TxTimeout # optional, function called with each transmitted frame given up
+    controllers:
+      - name: Powertrain
+        channel: 0                  # XL channel index
+        baudrates:                  # selected by Can_XLdriver_SetBaudrate
+          - {baudRate: 500000, fdBaudRate: 2000000}
+          - {baudRate: 500000, fdBaudRate: 5000000, samplePoint: 800, fdSamplePoint: 700} # per mille
+        defaultBaudrate: 0
+        processing: {rx: interrupt, tx: polling, busOff: interrupt, mode: polling}
+        hths:
+          - {idType: standard, brs: true, count: 4}
+          - {idType: extended, minimalDlc: false, padding: 0xCC, highPriority: true} # full-length frames
+        hrhs:
+          - {idType: standard, canId: 0x123}                    # FULL object
+          - {idType: extended, canIds: [0x18FF0000, 0x18FF00FF]} # one FULL object per identifier
+          - {idType: mixed, filterCode: 0x100, filterMask: 0x700} # BASIC object
+        rxDeadlines:                # longest time (us) between two receptions of a cyclic identifier
+          - {idType: standard, canId: 0x123, timeout: 30000}
+          - {idType: extended, canIds: [0x18FF0000, 0x18FF00FF], timeout: 300000}
+        txTimeout: {timeout: 50000, actions: [notify, flush]} # optional, longest wait (us) for a transmit confirmation
+
+HTHs and HRHs are numbered in the order of the controllers. The HRH of every standard identifier
+is resolved here into a direct table: FULL objects first, then the BASIC ones in their order. The
+FULL extended objects are sorted for a binary search, the BASIC extended ones are kept in order.
+The deadlines are sorted by identifier, standard ones first. The bit timings of the baudrates are solved at compile time (src/xlbittiming.h) when the demo
+includes the tables, and again by Can_XLdriver_Init against the clock of the opened channels.
+"""
+import argparse
+import os
+
+STANDARD_IDS = 0x800
+STANDARD_MASK = 0x7FF
+EXTENDED_MASK = 0x1FFFFFFF
+EXTENDED_FLAG = 0x80000000
+NO_HRH = 0xFFFF
+MAX_CONTROLLERS = 64
+MAX_BAUDRATE = 1000000
+MAX_FD_BAUDRATE = 8000000
+SAMPLE_POINTS = range(500, 951)
+ID_TYPES = {"standard": "CAN_XLDRIVER_ID_STANDARD", "extended": "CAN_XLDRIVER_ID_EXTENDED", "mixed": "CAN_XLDRIVER_ID_MIXED"}
+PROCESSING = {"interrupt": "CAN_XLDRIVER_INTERRUPT", "polling": "CAN_XLDRIVER_POLLING"}
+TX_TIMEOUT_ACTIONS = {"notify": "CAN_XLDRIVER_TX_TIMEOUT_NOTIFY", "flush": "CAN_XLDRIVER_TX_TIMEOUT_FLUSH"}
+
+
+def number(value):
+    return int(value, 0) if isinstance(value, str) else int(value)
+
+
+def fail(where, message):
+    raise SystemExit(f"{where}: {message}")
+
+
+def id_mask(id_type):
+    return STANDARD_MASK if id_type == "standard" else EXTENDED_MASK
+
+
+class Controller:
+    def __init__(self, index, description, hth_base, hrh_base):
+        self.index = index
+        self.where = f"controller {description.get('name', index)}"
+        self.name = description.get("name", f"Controller{index}")
+        if not self.name.isidentifier():
+            fail(self.where, "the name must be a C identifier, it names CanXLdriverConf_CanController_<name>")
+        self.channel = number(description["channel"]) if "channel" in description else fail(self.where, "no channel")
+        if not 0 <= self.channel < MAX_CONTROLLERS:
+            fail(self.where, f"channel {self.channel} outside the XL channels")
+
+        self.baudrates = []
+        for rate in description.get("baudrates", []):
+            baud_rate = number(rate.get("baudRate", 0))
+            fd_baud_rate = number(rate.get("fdBaudRate", 0))
+            if not 0 < baud_rate <= MAX_BAUDRATE:
+                fail(self.where, f"nominal bitrate {baud_rate} outside ]0, {MAX_BAUDRATE}]")
+            if fd_baud_rate != 0 and not baud_rate <= fd_baud_rate <= MAX_FD_BAUDRATE:
+                fail(self.where, f"data bitrate {fd_baud_rate} outside [{baud_rate}, {MAX_FD_BAUDRATE}]")
+            sample_point = number(rate.get("samplePoint", 0))
+            fd_sample_point = number(rate.get("fdSamplePoint", 0))
+            for point in (sample_point, fd_sample_point):
+                if point != 0 and point not in SAMPLE_POINTS:
+                    fail(self.where, f"sample point {point} outside [{SAMPLE_POINTS.start}, {SAMPLE_POINTS.stop - 1}] per mille")
+            self.baudrates.append((baud_rate, fd_baud_rate, sample_point, fd_sample_point))
+        if not self.baudrates:
+            fail(self.where, "no baudrate configuration")
+        self.default_baudrate = number(description.get("defaultBaudrate", 0))
+        if not 0 <= self.default_baudrate < len(self.baudrates):
+            fail(self.where, f"default baudrate {self.default_baudrate} is not configured")
+
+        processing = description.get("processing", {})
+        self.processing = {}
+        for kind in ("rx", "tx", "busOff", "mode"):
+            value = processing.get(kind, "interrupt")
+            if value not in PROCESSING:
+                fail(self.where, f"{kind} processing \"{value}\" is neither interrupt nor polling")
+            self.processing[kind] = PROCESSING[value]
+
+        self.hths = []
+        for hth in description.get("hths", []):
+            id_type = self.id_type(hth)
+            brs = bool(hth.get("brs", False))
+            if brs and all(rate[1] == 0 for rate in self.baudrates):
+                fail(self.where, "HTH with bitrate switch on a controller without CAN FD baudrate")
+            padding = number(hth.get("padding", 0x55))
+            if not 0 <= padding <= 0xFF:
+                fail(self.where, f"padding value {padding} is not a byte")
+            flags = (int(brs), int(bool(hth.get("rtr", False))), int(bool(hth.get("highPriority", False))),
+                     int(bool(hth.get("minimalDlc", True))), padding)
+            self.hths += [(id_type, flags)] * number(hth.get("count", 1))
+        self.hth_base = hth_base
+
+        # HRHs: (id type, filter code, filter mask, FULL)
+        self.hrhs = []
+        for hrh in description.get("hrhs", []):
+            id_type = self.id_type(hrh)
+            mask = id_mask(id_type)
+            if "canId" in hrh or "canIds" in hrh:
+                if id_type == "mixed":
+                    fail(self.where, "a FULL HRH is either standard or extended")
+                first, last = (number(hrh["canId"]),) * 2 if "canId" in hrh else map(number, hrh["canIds"])
+                if not 0 <= first <= last <= mask:
+                    fail(self.where, f"{id_type} identifiers {first:#x}..{last:#x} out of range")
+                self.hrhs += [(id_type, can_id, mask, True) for can_id in range(first, last + 1)]
+            else:
+                code = number(hrh.get("filterCode", 0))
+                filter_mask = number(hrh.get("filterMask", 0))
+                if code & ~filter_mask or code & ~mask or filter_mask & ~mask:
+                    fail(self.where, f"filter {code:#x}/{filter_mask:#x} never matches a {id_type} identifier")
+                self.hrhs.append((id_type, code, filter_mask, False))
+        self.hrh_base = hrh_base
+
+        self.standard_table = [NO_HRH] * STANDARD_IDS
+        self.extended_full = []
+        self.extended_basic = []
+        for offset, (id_type, code, mask, full) in enumerate(self.hrhs):
+            hrh = hrh_base + offset
+            if full and id_type == "standard":
+                if self.standard_table[code] != NO_HRH:
+                    fail(self.where, f"standard identifier {code:#x} received by two FULL HRHs")
+                self.standard_table[code] = hrh
+            elif full:
+                self.extended_full.append((code, hrh))
+        self.extended_full.sort()
+        for previous, current in zip(self.extended_full, self.extended_full[1:]):
+            if previous[0] == current[0]:
+                fail(self.where, f"extended identifier {current[0]:#x} received by two FULL HRHs")
+        for offset, (id_type, code, mask, full) in enumerate(self.hrhs):
+            if full:
+                continue
+            hrh = hrh_base + offset
+            if id_type in ("standard", "mixed"):
+                for can_id in range(STANDARD_IDS):
+                    if self.standard_table[can_id] == NO_HRH and (can_id & mask) == code:
+                        self.standard_table[can_id] = hrh
+            if id_type in ("extended", "mixed"):
+                self.extended_basic.append(hrh)
+
+        # deadlines: (Can_IdType, timeout in us)
+        deadlines = {}
+        for deadline in description.get("rxDeadlines", []):
+            id_type = self.id_type(deadline)
+            if id_type == "mixed":
+                fail(self.where, "a deadline is either standard or extended")
+            mask = id_mask(id_type)
+            first, last = (number(deadline["canId"]),) * 2 if "canId" in deadline else map(number, deadline.get("canIds", (1, 0)))
+            if not 0 <= first <= last <= mask:
+                fail(self.where, f"{id_type} deadline identifiers {first:#x}..{last:#x} out of range")
+            timeout = number(deadline.get("timeout", 0))
+            if not 0 < timeout <= 0xFFFFFFFF:
+                fail(self.where, f"deadline timeout {timeout} outside ]0, {0xFFFFFFFF}] us")
+            for can_id in range(first, last + 1):
+                key = can_id | (EXTENDED_FLAG if id_type == "extended" else 0)
+                if key in deadlines:
+                    fail(self.where, f"{id_type} identifier {can_id:#x} has two deadlines")
+                deadlines[key] = timeout
+        if len(deadlines) > 0xFFFF:
+            fail(self.where, f"{len(deadlines)} deadlines do not fit in RxDeadlineCount")
+        self.rx_deadlines = sorted(deadlines.items())
+
+        tx_timeout = description.get("txTimeout", {})
+        self.tx_timeout = number(tx_timeout.get("timeout", 0))
+        if not 0 <= self.tx_timeout <= 0xFFFFFFFF:
+            fail(self.where, f"TX timeout {self.tx_timeout} outside [0, {0xFFFFFFFF}] us")
+        self.tx_timeout_actions = []
+        for action in tx_timeout.get("actions", []):
+            if action not in TX_TIMEOUT_ACTIONS:
+                fail(self.where, f"unknown TX timeout action \"{action}\"")
+            self.tx_timeout_actions.append(TX_TIMEOUT_ACTIONS[action])
+
+    def id_type(self, hoh):
+        id_type = hoh.get("idType", "standard")
+        if id_type not in ID_TYPES:
+            fail(self.where, f"unknown idType \"{id_type}\"")
+        return id_type
+
+
+def table(values, per_line=16, indent="    "):
+    return [indent + ", ".join(values[i:i + per_line]) + "," for i in range(0, len(values), per_line)]
+
+
+def generate(description, source_name):
+    controllers = []
+    hth_count = 0
+    hrh_count = 0
+    for index, controller in enumerate(description.get("controllers", [])):
+        controllers.append(Controller(index, controller, hth_count, hrh_count))
+        hth_count += len(controllers[-1].hths)
+        hrh_count += len(controllers[-1].hrhs)
+    if not 0 < len(controllers) <= MAX_CONTROLLERS:
+        raise SystemExit(f"between 1 and {MAX_CONTROLLERS} controllers are needed")
+    channels = [controller.channel for controller in controllers]
+    if len(set(channels)) != len(channels):
+        raise SystemExit("two controllers on the same XL channel")
+    names = [controller.name for controller in controllers]
+    if len(set(names)) != len(names):
+        raise SystemExit("two controllers with the same name")
+    if hth_count > 0xFFFF or hrh_count >= NO_HRH:
+        raise SystemExit(f"{hth_count} HTHs and {hrh_count} HRHs do not fit in Can_HwHandleType")
+    polling_queue_size = number(description.get("pollingQueueSize", 256))
+    if not 0 < polling_queue_size <= 0xFFFF:
+        raise SystemExit(f"pollingQueueSize {polling_queue_size} outside [1, 65535]")
+    app_name = f"\"{description['appName']}\"" if description.get("appName") else "nullptr"
+    rx_queue_size = number(description.get("rxQueueSize", 0))
+    rx_bus_load = number(description.get("rxBusLoad", 0))
+    if not 0 <= rx_bus_load <= 100:
+        raise SystemExit(f"rxBusLoad {rx_bus_load} outside [0, 100]")
+    rx_timeout_notification = description.get("rxTimeoutNotification")
+    if rx_timeout_notification is not None and not rx_timeout_notification.isidentifier():
+        raise SystemExit(f"rxTimeoutNotification \"{rx_timeout_notification}\" is not a C identifier")
+    tx_timeout_notification = description.get("txTimeoutNotification")
+    if tx_timeout_notification is not None and not tx_timeout_notification.isidentifier():
+        raise SystemExit(f"txTimeoutNotification \"{tx_timeout_notification}\" is not a C identifier")
+
+    lines = [
+        f"/* Generated by tools/can_xldriver_cfg.py from {source_name}, do not edit */",
+        "#ifndef CAN_XLDRIVER_CFG_H",
+        "#define CAN_XLDRIVER_CFG_H",
+        "",
+        "#include \"Can_XLdriver.h\"",
+        "",
+        f"#define CAN_XLDRIVER_CFG_CONTROLLER_COUNT   {len(controllers)}u",
+        f"#define CAN_XLDRIVER_CFG_HTH_COUNT          {hth_count}u",
+        f"#define CAN_XLDRIVER_CFG_HRH_COUNT          {hrh_count}u",
+        "",
+    ]
+    for controller in controllers:
+        lines.append(f"#define CanXLdriverConf_CanController_{controller.name} {controller.index}u")
+    lines.append("")
+
+    for controller in controllers:
+        suffix = controller.index
+        lines.append(f"inline constexpr Can_XLdriver_BaudrateConfigType Can_XLdriver_Baudrates_{suffix}[] = {{")
+        lines += [f"    {{{rate[0]}u, {rate[1]}u, {rate[2]}u, {rate[3]}u}}," for rate in controller.baudrates]
+        lines += ["};", ""]
+        lines.append(f"inline constexpr Can_HwHandleType Can_XLdriver_StandardIdHrhs_{suffix}[CAN_XLDRIVER_STANDARD_IDS] = {{")
+        lines += table([f"{hrh}u" for hrh in controller.standard_table])
+        lines += ["};", ""]
+        if controller.extended_full:
+            lines.append(f"inline constexpr Can_XLdriver_HrhIdType Can_XLdriver_ExtendedIdHrhs_{suffix}[] = {{")
+            lines += table([f"{{0x{can_id:08X}u, {hrh}u}}" for can_id, hrh in controller.extended_full], per_line=4)
+            lines += ["};", ""]
+        if controller.extended_basic:
+            lines.append(f"inline constexpr Can_HwHandleType Can_XLdriver_BasicExtendedHrhs_{suffix}[] = {{")
+            lines += table([f"{hrh}u" for hrh in controller.extended_basic])
+            lines += ["};", ""]
+        if controller.rx_deadlines:
+            lines.append(f"inline constexpr Can_XLdriver_RxDeadlineType Can_XLdriver_RxDeadlines_{suffix}[] = {{")
+            lines += table([f"{{0x{can_id:08X}u, {timeout}u}}" for can_id, timeout in controller.rx_deadlines], per_line=4)
+            lines += ["};", ""]
+
+    lines.append("inline constexpr Can_XLdriver_ControllerConfigType Can_XLdriver_Controllers[CAN_XLDRIVER_CFG_CONTROLLER_COUNT] = {")
+    for controller in controllers:
+        suffix = controller.index
+        extended_full = f"Can_XLdriver_ExtendedIdHrhs_{suffix}" if controller.extended_full else "nullptr"
+        extended_basic = f"Can_XLdriver_BasicExtendedHrhs_{suffix}" if controller.extended_basic else "nullptr"
+        rx_deadlines = f"Can_XLdriver_RxDeadlines_{suffix}" if controller.rx_deadlines else "nullptr"
+        tx_timeout_actions = " | ".join(dict.fromkeys(controller.tx_timeout_actions)) or "0u"
+        lines += [
+            f"    {{   /* {controller.name} */",
+            f"        {controller.channel}u, Can_XLdriver_StandardIdHrhs_{suffix}, {extended_full}, {extended_basic},",
+            f"        {len(controller.extended_full)}u, {len(controller.extended_basic)}u,",
+            f"        Can_XLdriver_Baudrates_{suffix}, {len(controller.baudrates)}u, {controller.default_baudrate}u,",
+            f"        {controller.processing['rx']}, {controller.processing['tx']}, "
+            f"{controller.processing['busOff']}, {controller.processing['mode']},",
+            f"        {rx_deadlines}, {len(controller.rx_deadlines)}u,",
+            f"        {controller.tx_timeout}u, {tx_timeout_actions}",
+            "    },",
+        ]
+    lines += ["};", ""]
+
+    if hth_count:
+        lines.append("inline constexpr Can_XLdriver_HthConfigType Can_XLdriver_Hths[CAN_XLDRIVER_CFG_HTH_COUNT] = {")
+        for controller in controllers:
+            lines += table([f"{{{controller.index}u, {ID_TYPES[id_type]}, {flags[0]}u, {flags[1]}u, {flags[2]}u, {flags[3]}u, 0x{flags[4]:02X}u}}"
+                            for id_type, flags in controller.hths], per_line=2)
+        lines += ["};", ""]
+    if hrh_count:
+        lines.append("inline constexpr Can_XLdriver_HrhConfigType Can_XLdriver_Hrhs[CAN_XLDRIVER_CFG_HRH_COUNT] = {")
+        for controller in controllers:
+            lines += table([f"{{{controller.index}u, {ID_TYPES[id_type]}, 0x{code:08X}u, 0x{mask:08X}u}}"
+                            for id_type, code, mask, _ in controller.hrhs], per_line=2)
+        lines += ["};", ""]
+
+    if rx_timeout_notification:
+        lines += [f"void {rx_timeout_notification}(uint8 Controller, Can_IdType CanId);", ""]
+    if tx_timeout_notification:
+        lines += [f"void {tx_timeout_notification}(uint8 Controller, Can_IdType CanId, PduIdType PduId);", ""]
+    lines += [
+        "inline constexpr Can_XLdriver_ConfigType Can_XLdriver_Config = {",
+        "    Can_XLdriver_Controllers,",
+        f"    {'Can_XLdriver_Hths' if hth_count else 'nullptr'},",
+        f"    {'Can_XLdriver_Hrhs' if hrh_count else 'nullptr'},",
+        f"    {app_name},",
+        f"    {rx_queue_size}u,",
+        f"    {rx_bus_load}u,",
+        "    CAN_XLDRIVER_CFG_CONTROLLER_COUNT,",
+        "    CAN_XLDRIVER_CFG_HTH_COUNT,",
+        "    CAN_XLDRIVER_CFG_HRH_COUNT,",
+        f"    {polling_queue_size}u,",
+        f"    {rx_timeout_notification or 'nullptr'},",
+        f"    {tx_timeout_notification or 'nullptr'}",
+        "};",
+        "",
+        "#endif /* CAN_XLDRIVER_CFG_H */",
+        "",
+    ]
+    return "\n".join(lines)
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__, formatter_class=argparse.RawDescriptionHelpFormatter)
+    parser.add_argument("config", help="YAML description of the controllers and hardware objects")
+    parser.add_argument("--output-dir", required=True, help="directory of Can_XLdriver_Cfg.h")
+    args = parser.parse_args()
+
+    import yaml
+    with open(args.config) as description:
+        content = generate(yaml.safe_load(description), os.path.basename(args.config))
+
+    os.makedirs(args.output_dir, exist_ok=True)
+    path = os.path.join(args.output_dir, "Can_XLdriver_Cfg.h")
+    # keep the timestamp when nothing changed, the adapter is then not rebuilt
+    if os.path.exists(path):
+        with open(path) as existing:
+            if existing.read() == content:
+                return
+    with open(path, "w") as output:
+        output.write(content)
+
+
+if __name__ == "__main__":
+    main()
@@ -0,0 +1,161 @@
+"""
+Generate the tables of the reference CanIf (stubs/src/CanIf_Ref.c).
+
+The tables are either read from a JSON description of a real configuration:
+
+    {
+      "hrhs":   [{"filterCode": 0, "filterMask": 0}],
+      "rxPdus": [{"canId": "0x123", "hrh": 0, "length": 8, "user": 0}],
+      "txPdus": [{"user": 0}]
+    }
+
+or synthesized with production-like counts (--rx-pdus, --tx-pdus, --hrhs, --users). Extended
+identifiers are given with bit 31 set, like Can_IdType. The RX PDUs are grouped by HRH and sorted
+by identifier so that CanIf_RxIndication filters with a binary search.
+"""
+import argparse
+import json
+import os
+import random
+
+CAN_EXTENDED_FLAG = 0x80000000
+MAX_USERS = 8
+
+
+def synthesize(rx_pdus, tx_pdus, hrhs, users, seed):
+    rng = random.Random(seed)
+    # standard identifiers first, then extended ones, spread over the identifier space like a real network
+    standard = rng.sample(range(0x001, 0x7FF), min(rx_pdus, 0x700))
+    extended = [CAN_EXTENDED_FLAG | i for i in rng.sample(range(0x800, 0x1FFFFFFF), rx_pdus - len(standard))]
+    config = {
+        "hrhs": [{"filterCode": 0, "filterMask": 0} for _ in range(hrhs)],
+        "rxPdus": [],
+        "txPdus": [{"user": i % users} for i in range(tx_pdus)],
+    }
+    for index, can_id in enumerate(standard + extended):
+        config["rxPdus"].append({
+            "canId": can_id,
+            "hrh": index % hrhs,
+            "length": rng.choice([1, 2, 4, 8, 8, 8, 12, 16, 32, 64]) if can_id & CAN_EXTENDED_FLAG else rng.choice([1, 2, 4, 8, 8, 8]),
+            "user": index % users,
+        })
+    return config
+
+
+def number(value):
+    return int(value, 0) if isinstance(value, str) else int(value)
+
+
+def generate(config, output_dir):
+    hrhs = config["hrhs"]
+    rx_pdus = sorted(config["rxPdus"], key=lambda pdu: (number(pdu["hrh"]), number(pdu["canId"])))
+    tx_pdus = config["txPdus"]
+    if not hrhs or not rx_pdus or not tx_pdus:
+        raise SystemExit("the reference CanIf needs at least one HRH, one RX PDU and one TX PDU")
+    if max(len(hrhs), len(rx_pdus), len(tx_pdus)) > 0xFFFF:
+        raise SystemExit("the reference CanIf indexes its tables on 16 bits")
+    for previous, pdu in zip(rx_pdus, rx_pdus[1:]):
+        if (number(previous["hrh"]), number(previous["canId"])) == (number(pdu["hrh"]), number(pdu["canId"])):
+            raise SystemExit(f"RX PDU {pdu['canId']} configured twice on HRH {pdu['hrh']}")
+    for pdu in rx_pdus + tx_pdus:
+        if number(pdu["user"]) >= MAX_USERS:
+            raise SystemExit(f"user {pdu['user']} beyond CANIF_REF_MAX_USERS ({MAX_USERS})")
+
+    first = [0] * len(hrhs)
+    count = [0] * len(hrhs)
+    for index, pdu in enumerate(rx_pdus):
+        hrh = number(pdu["hrh"])
+        if hrh >= len(hrhs):
+            raise SystemExit(f"RX PDU {pdu['canId']} refers to the unknown HRH {hrh}")
+        if count[hrh] == 0:
+            first[hrh] = index
+        count[hrh] += 1
+
+    header = [
+        "/* Generated by tools/canif_ref_cfg.py, do not edit */",
+        "#ifndef CANIF_REF_CFG_H",
+        "#define CANIF_REF_CFG_H",
+        "",
+        "#include \"CanIf_Ref.h\"",
+        "",
+        f"#define CANIF_REF_HRH_COUNT     {len(hrhs)}u",
+        f"#define CANIF_REF_RX_PDU_COUNT  {len(rx_pdus)}u",
+        f"#define CANIF_REF_TX_PDU_COUNT  {len(tx_pdus)}u",
+        "",
+        "#ifdef __cplusplus",
+        "extern \"C\" {",
+        "#endif",
+        "",
+        "extern const CanIf_RefConfigType CanIf_RefConfig;",
+        "",
+        "#ifdef __cplusplus",
+        "}",
+        "#endif",
+        "",
+        "#endif /* CANIF_REF_CFG_H */",
+        "",
+    ]
+    source = [
+        "/* Generated by tools/canif_ref_cfg.py, do not edit */",
+        "#include \"CanIf_Ref_Cfg.h\"",
+        "",
+        "static const CanIf_RefHrhCfgType CanIf_RefHrhs[CANIF_REF_HRH_COUNT] = {",
+    ]
+    for index, hrh in enumerate(hrhs):
+        source.append(f"    {{0x{number(hrh['filterCode']):08X}u, 0x{number(hrh['filterMask']):08X}u, {first[index]}u, {count[index]}u}},")
+    source += ["};", "", "static const CanIf_RefRxPduCfgType CanIf_RefRxPdus[CANIF_REF_RX_PDU_COUNT] = {"]
+    for index, pdu in enumerate(rx_pdus):
+        source.append(f"    {{0x{number(pdu['canId']):08X}u, {number(pdu['length'])}u, {index}u, {number(pdu['user'])}u}},")
+    source += ["};", "", "static const CanIf_RefTxPduCfgType CanIf_RefTxPdus[CANIF_REF_TX_PDU_COUNT] = {"]
+    for index, pdu in enumerate(tx_pdus):
+        source.append(f"    {{{index}u, {number(pdu['user'])}u}},")
+    source += [
+        "};",
+        "",
+        "const CanIf_RefConfigType CanIf_RefConfig = {",
+        "    CanIf_RefHrhs,",
+        "    CanIf_RefRxPdus,",
+        "    CanIf_RefTxPdus,",
+        "    CANIF_REF_HRH_COUNT,",
+        "    CANIF_REF_RX_PDU_COUNT,",
+        "    CANIF_REF_TX_PDU_COUNT",
+        "};",
+        "",
+    ]
+
+    os.makedirs(output_dir, exist_ok=True)
+    for name, lines in (("CanIf_Ref_Cfg.h", header), ("CanIf_Ref_Cfg.c", source)):
+        path = os.path.join(output_dir, name)
+        content = "\n".join(lines)
+        # keep the timestamps when nothing changed, the library is then not rebuilt
+        if os.path.exists(path):
+            with open(path) as existing:
+                if existing.read() == content:
+                    continue
+        with open(path, "w") as output:
+            output.write(content)
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__, formatter_class=argparse.RawDescriptionHelpFormatter)
+    parser.add_argument("--config", help="JSON description of the HRHs and PDUs")
+    parser.add_argument("--rx-pdus", type=int, default=4096, help="synthesized RX PDUs (default 4096)")
+    parser.add_argument("--tx-pdus", type=int, default=1024, help="synthesized TX PDUs (default 1024)")
+    parser.add_argument("--hrhs", type=int, default=1, help="synthesized HRHs, the RX PDUs are spread over them (default 1)")
+    parser.add_argument("--users", type=int, default=2, help="synthesized upper layers (default 2)")
+    parser.add_argument("--seed", type=int, default=1, help="seed of the synthesized identifiers and lengths")
+    parser.add_argument("--output-dir", required=True, help="directory of CanIf_Ref_Cfg.h and CanIf_Ref_Cfg.c")
+    args = parser.parse_args()
+
+    if args.config:
+        with open(args.config) as description:
+            config = json.load(description)
+    else:
+        if not 1 <= args.users <= MAX_USERS:
+            raise SystemExit(f"--users must be between 1 and {MAX_USERS}")
+        config = synthesize(args.rx_pdus, args.tx_pdus, max(args.hrhs, 1), args.users, args.seed)
+    generate(config, args.output_dir)
+
+
+if __name__ == "__main__":
+    main()